@@ -127,7 +127,7 @@ void BondingR12::compute(box::Box& box,
                 unsigned int ref_cell = m_lc->getCell(ref_pos);
 
                 //loop over neighbor cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
+                const locality::CellNeighbors neigh_cells = m_lc->getCellNeighbors(ref_cell);
                 for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
                     {
                     // get neighbor cell
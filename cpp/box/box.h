@@ -569,10 +569,11 @@ class Box
         //     }
 
 
-        // uchar3 getPeriodic() const
-        //     {
-        //     return m_periodic;
-        //     }
+        //! Get the periodic flags
+        uchar3 getPeriodic() const
+            {
+            return m_periodic;
+            }
 
         //! Set the periodic flags
         /*! \param periodic Flags to set
@@ -81,7 +81,8 @@ Cluster::Cluster(const box::Box& box, float rcut)
 // void Cluster::computeClusters(const float3 *points,
 //                               unsigned int Np)
 void Cluster::computeClusters(const vec3<float> *points,
-                              unsigned int Np)
+                              unsigned int Np,
+                              const locality::NeighborList *nlist)
     {
     assert(points);
     assert(Np > 0);
@@ -94,44 +95,64 @@ void Cluster::computeClusters(const vec3<float> *points,
     float rmaxsq = m_rcut * m_rcut;
     DisjointSet dj(m_num_particles);
 
-    // bin the particles
-    m_lc.computeCellList(m_box, points, m_num_particles);
-
-    // for each point
-    for (unsigned int i = 0; i < m_num_particles; i++)
+    if (nlist != NULL)
         {
-        // get the cell the point is in
-        vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
-
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        nlist->validate(m_num_particles, m_num_particles);
+        const size_t *index_i = nlist->getIndexI();
+        const size_t *index_j = nlist->getIndexJ();
+        const float *distances = nlist->getDistances();
+        for (size_t bond = 0; bond < nlist->getNumBonds(); bond++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
+            unsigned int i = index_i[bond];
+            unsigned int j = index_j[bond];
+            if (i != j && distances[bond] < m_rcut)
+                {
+                // merge the two sets using the disjoint set
+                uint32_t a = dj.find(i);
+                uint32_t b = dj.find(j);
+                if (a != b)
+                    dj.merge(a,b);
+                }
+            }
+        }
+    else
+        {
+        // bin the particles
+        m_lc.computeCellList(m_box, points, m_num_particles);
+        const unsigned int *cell_start = m_lc.getCellOffsets();
+        const unsigned int *cell_idx = m_lc.getCellIndices();
 
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+        // bonds are symmetric, so visit each unordered pair once: loop over every cell and its half neighbors
+        for (unsigned int cell = 0; cell < m_lc.getNumCells(); cell++)
+            {
+            const locality::CellNeighbors neigh_cells = m_lc.getCellHalfNeighbors(cell);
+            for (unsigned int a = cell_start[cell]; a != cell_start[cell + 1]; ++a)
                 {
-                if (i != j)
+                unsigned int i = cell_idx[a];
+                vec3<float> p = points[i];
+
+                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
                     {
-                    // compute r between the two particles
-                    vec3<float> delta = p - points[j];
-                    // float dx = float(p.x - points[j].x);
-                    // float dy = float(p.y - points[j].y);
-                    // float dz = float(p.z - points[j].z);
-                    delta = m_box.wrap(delta);
-
-                    // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                    float rsq = dot(delta, delta);
-                    if (rsq < rmaxsq)
+                    unsigned int neigh_cell = neigh_cells[neigh_idx];
+
+                    // pairs within the same cell are only taken once
+                    unsigned int first = (neigh_cell == cell) ? a + 1 : cell_start[neigh_cell];
+                    for (unsigned int k = first; k != cell_start[neigh_cell + 1]; ++k)
                         {
-                        // merge the two sets using the disjoint set
-                        uint32_t a = dj.find(i);
-                        uint32_t b = dj.find(j);
-                        if (a != b)
-                            dj.merge(a,b);
+                        unsigned int j = cell_idx[k];
+
+                        // compute r between the two particles
+                        vec3<float> delta = m_box.wrap(p - points[j]);
+
+                        float rsq = dot(delta, delta);
+                        if (rsq < rmaxsq)
+                            {
+                            // merge the two sets using the disjoint set
+                            uint32_t a_set = dj.find(i);
+                            uint32_t b_set = dj.find(j);
+                            if (a_set != b_set)
+                                dj.merge(a_set,b_set);
+                            }
                         }
                     }
                 }
@@ -10,6 +10,7 @@
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "box.h"
 
 #ifndef _CLUSTER_H__
@@ -73,7 +74,8 @@ class Cluster
         // void computeClusters(const float3 *points,
         //                      unsigned int Np);
         void computeClusters(const vec3<float> *points,
-                             unsigned int Np);
+                             unsigned int Np,
+                             const locality::NeighborList *nlist=NULL);
 
         // //! Python wrapper for computePointClusters
         // void computeClustersPy(boost::python::numeric::array points);
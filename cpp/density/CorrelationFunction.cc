@@ -24,7 +24,8 @@ namespace freud { namespace density {
 
 template<typename T>
 CorrelationFunction<T>::CorrelationFunction(float rmax, float dr)
-    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_frame_counter(0)
+    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_frame_counter(0),
+      m_bin_counter(size_t(floorf(rmax / dr))), m_value_sums(size_t(floorf(rmax / dr)))
     {
     if (dr <= 0.0f)
         throw invalid_argument("dr must be positive");
@@ -39,8 +40,6 @@ CorrelationFunction<T>::CorrelationFunction(float rmax, float dr)
     // Less efficient: initialize each bin sequentially using default ctor
     for(size_t i(0); i < m_nbins; ++i)
         m_rdf_array.get()[i] = T();
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_nbins], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins);
 
     // precompute the bin center positions
     m_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
@@ -56,14 +55,6 @@ CorrelationFunction<T>::CorrelationFunction(float rmax, float dr)
 template<typename T>
 CorrelationFunction<T>::~CorrelationFunction()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
-    for (typename tbb::enumerable_thread_specific<T *>::iterator i = m_local_rdf_array.begin(); i != m_local_rdf_array.end(); ++i)
-        {
-        delete[] (*i);
-        }
     delete m_lc;
     }
 
@@ -72,16 +63,14 @@ CorrelationFunction<T>::~CorrelationFunction()
 template<typename T>
 void CorrelationFunction<T>::reduceCorrelationFunction()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins);
-    for(size_t i(0); i < m_nbins; ++i)
-        m_rdf_array.get()[i] = T();
+    // move the counts and values of each thread into the totals
+    m_bin_counter.flush();
+    m_value_sums.flush();
     // now compute the rdf
     parallel_for(tbb::blocked_range<size_t>(0,m_nbins), CombineOCF<T>(m_nbins,
-                                                              m_bin_counts.get(),
-                                                              m_local_bin_counts,
-                                                              m_rdf_array.get(),
-                                                              m_local_rdf_array,
-                                                              (float)m_n_ref));
+                                                              m_bin_counter.getTotals().get(),
+                                                              m_value_sums.getTotals().get(),
+                                                              m_rdf_array.get()));
     }
 
 //! Get a reference to the RDF array
@@ -99,14 +88,8 @@ template<typename T>
 void CorrelationFunction<T>::resetCorrelationFunction()
     {
     // zero the bin counts for totaling
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_nbins);
-        }
-    for (typename tbb::enumerable_thread_specific<T *>::iterator i = m_local_rdf_array.begin(); i != m_local_rdf_array.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(T)*m_nbins);
-        }
+    m_bin_counter.reset();
+    m_value_sums.reset();
     // reset the frame counter
     m_frame_counter = 0;
     }
@@ -118,17 +101,27 @@ void CorrelationFunction<T>::accumulate(const box::Box &box,
                              unsigned int n_ref,
                              const vec3<float> *points,
                              const T *point_values,
-                             unsigned int Np)
+                             unsigned int Np,
+                             const locality::NeighborList *nlist)
     {
     m_box = box;
-    m_lc->computeCellList(m_box, points, Np);
+    if (nlist != NULL)
+        nlist->validate(n_ref, Np);
+    else
+        m_lc->computeCellList(m_box, points, Np);
+    // a single bin receives at most one count per bond, or per (ref point, candidate) pair
+    if (nlist != NULL)
+        m_bin_counter.beginFrame(nlist->getNumBonds());
+    else
+        m_bin_counter.beginFrame(uint64_t(n_ref) * std::min(size_t(Np), m_lc->getMaxNumCandidates()));
     parallel_for(tbb::blocked_range<size_t>(0, n_ref), ComputeOCF<T>(m_nbins,
-                                                                    m_local_bin_counts,
-                                                                    m_local_rdf_array,
+                                                                    m_bin_counter,
+                                                                    m_value_sums,
                                                                     m_box,
                                                                     m_rmax,
                                                                     m_dr,
                                                                     m_lc,
+                                                                    nlist,
                                                                     ref_points,
                                                                     ref_values,
                                                                     n_ref,
@@ -143,19 +136,10 @@ void CombineOCF<T>::operator()( const tbb::blocked_range<size_t> &myBin ) const
         {
         for (size_t i = myBin.begin(); i != myBin.end(); i++)
             {
-            for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                 local_bins != m_local_bin_counts.end(); ++local_bins)
-                {
-                m_bin_counts[i] += (*local_bins)[i];
-                }
-            for (typename tbb::enumerable_thread_specific<T *>::const_iterator local_rdf = m_local_rdf_array.begin();
-                 local_rdf != m_local_rdf_array.end(); ++local_rdf)
-                {
-                m_rdf_array[i] += (*local_rdf)[i];
-                }
+            m_rdf_array[i] = m_value_sums[i];
             if (m_bin_counts[i])
                 {
-                m_rdf_array[i] /= m_bin_counts[i];
+                m_rdf_array[i] /= double(m_bin_counts[i]);
                 }
             }
         }
@@ -173,63 +157,45 @@ void ComputeOCF<T>::operator()( const blocked_range<size_t> &myR ) const
     float dr_inv = 1.0f / m_dr;
     float rmaxsq = m_rmax * m_rmax;
 
-    bool bin_exists;
-    m_bin_counts.local(bin_exists);
-    if (! bin_exists)
-        {
-        m_bin_counts.local() = new unsigned int [m_nbins];
-        memset((void*)m_bin_counts.local(), 0, sizeof(unsigned int)*m_nbins);
-        }
+    util::ThreadLocalHistogram<uint32_t>::Accessor local_counts = m_bin_counts.local();
+    typename util::ThreadLocalHistogram<T>::Accessor local_values = m_rdf_array.local();
 
-    bool rdf_exists;
-    m_rdf_array.local(rdf_exists);
-    if (! rdf_exists)
-        {
-        m_rdf_array.local() = new T [m_nbins];
-        memset((void*)m_rdf_array.local(), 0, sizeof(T)*m_nbins);
-        }
+    std::vector<unsigned int> candidates;
 
     // for each reference point
     for (size_t i = myR.begin(); i != myR.end(); i++)
         {
         // get the cell the point is in
         vec3<float> ref = m_ref_points[i];
-        unsigned int ref_cell = m_lc->getCell(ref);
+        m_lc->getNeighborCandidates(ref, i, m_nlist, candidates);
 
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        // loop over all candidate neighbors
+        for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
+            unsigned int j = candidates[neigh_idx];
+            // compute r between the two particles
+            vec3<float> delta = m_box.wrap(m_points[j] - ref);
 
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
-                {
-                // compute r between the two particles
-                vec3<float> delta = m_box.wrap(m_points[j] - ref);
+            float rsq = dot(delta, delta);
 
-                float rsq = dot(delta, delta);
-
-                // check that the particle is not checking itself, if it is the same list
-                if ((i != j || m_points != m_ref_points) && rsq < rmaxsq)
+            // check that the particle is not checking itself, if it is the same list
+            if ((i != j || m_points != m_ref_points) && rsq < rmaxsq)
+                {
+                float r = sqrtf(rsq);
+
+                // bin that r
+                float binr = r * dr_inv;
+                // fast float to int conversion with truncation
+                #ifdef __SSE2__
+                unsigned int bin = _mm_cvtt_ss2si(_mm_load_ss(&binr));
+                #else
+                unsigned int bin = (unsigned int)(binr);
+                #endif
+
+                if (bin < m_nbins)
                     {
-                    float r = sqrtf(rsq);
-
-                    // bin that r
-                    float binr = r * dr_inv;
-                    // fast float to int conversion with truncation
-                    #ifdef __SSE2__
-                    unsigned int bin = _mm_cvtt_ss2si(_mm_load_ss(&binr));
-                    #else
-                    unsigned int bin = (unsigned int)(binr);
-                    #endif
-
-                    if (bin < m_nbins)
-                        {
-                        ++m_bin_counts.local()[bin];
-                        m_rdf_array.local()[bin] += m_ref_values[i]*m_point_values[j];
-                        }
+                    ++local_counts[bin];
+                    local_values[bin] += m_ref_values[i]*m_point_values[j];
                     }
                 }
             }
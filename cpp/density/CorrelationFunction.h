@@ -7,7 +7,9 @@
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "box.h"
+#include "ThreadLocalHistogram.h"
 
 #include <tbb/tbb.h>
 
@@ -76,7 +78,8 @@ class CorrelationFunction
                         unsigned int n_ref,
                         const vec3<float> *points,
                         const T *point_values,
-                        unsigned int Np);
+                        unsigned int Np,
+                        const locality::NeighborList *nlist=NULL);
 
         //! \internal
         //! helper function to reduce the thread specific arrays into the boost array
@@ -86,9 +89,10 @@ class CorrelationFunction
         std::shared_ptr<T> getRDF();
 
         //! Get a reference to the bin counts array
-        std::shared_ptr<unsigned int> getCounts()
+        std::shared_ptr<uint64_t> getCounts()
             {
-            return m_bin_counts;
+            m_bin_counter.flush();
+            return m_bin_counter.getTotals();
             }
 
         //! Get a reference to the r array
@@ -113,10 +117,9 @@ class CorrelationFunction
         unsigned int m_frame_counter;       //!< number of frames calc'd
 
         std::shared_ptr<T> m_rdf_array;         //!< rdf array computed
-        std::shared_ptr<unsigned int> m_bin_counts; //!< bin counts that go into computing the rdf array
+        util::ThreadLocalHistogram<uint32_t> m_bin_counter;   //!< bin counts that go into computing the rdf array
+        util::ThreadLocalHistogram<T> m_value_sums;           //!< sums of the value products of each bin
         std::shared_ptr<float> m_r_array;           //!< array of r values that the rdf is computed at
-        tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
-        tbb::enumerable_thread_specific<T *> m_local_rdf_array;
     };
 
 template<typename T>
@@ -124,20 +127,15 @@ class CombineOCF
     {
     private:
         unsigned int m_nbins;
-        unsigned int *m_bin_counts;
-        tbb::enumerable_thread_specific<unsigned int *>& m_local_bin_counts;
+        const uint64_t *m_bin_counts;
+        const T *m_value_sums;
         T *m_rdf_array;
-        tbb::enumerable_thread_specific<T *>& m_local_rdf_array;
-        float m_n_ref;
     public:
         CombineOCF(unsigned int nbins,
-                   unsigned int *bin_counts,
-                   tbb::enumerable_thread_specific<unsigned int *>& local_bin_counts,
-                   T *rdf_array,
-                   tbb::enumerable_thread_specific<T *>& local_rdf_array,
-                   float n_ref)
-            : m_nbins(nbins), m_bin_counts(bin_counts), m_local_bin_counts(local_bin_counts), m_rdf_array(rdf_array),
-              m_local_rdf_array(local_rdf_array), m_n_ref(n_ref)
+                   const uint64_t *bin_counts,
+                   const T *value_sums,
+                   T *rdf_array)
+            : m_nbins(nbins), m_bin_counts(bin_counts), m_value_sums(value_sums), m_rdf_array(rdf_array)
         {
         }
         void operator()( const tbb::blocked_range<size_t> &myBin ) const;
@@ -148,12 +146,13 @@ class ComputeOCF
     {
     private:
         const unsigned int m_nbins;
-        tbb::enumerable_thread_specific<unsigned int *>& m_bin_counts;
-        tbb::enumerable_thread_specific<T *>& m_rdf_array;
+        util::ThreadLocalHistogram<uint32_t>& m_bin_counts;
+        util::ThreadLocalHistogram<T>& m_rdf_array;
         const box::Box m_box;
         const float m_rmax;
         const float m_dr;
         const locality::LinkCell *m_lc;
+        const locality::NeighborList *m_nlist;
         const vec3<float> *m_ref_points;
         const T *m_ref_values;
         const unsigned int m_n_ref;
@@ -162,12 +161,13 @@ class ComputeOCF
         unsigned int m_Np;
     public:
         ComputeOCF(const unsigned int nbins,
-                   tbb::enumerable_thread_specific<unsigned int *>& bin_counts,
-                   tbb::enumerable_thread_specific<T *>& rdf_array,
+                   util::ThreadLocalHistogram<uint32_t>& bin_counts,
+                   util::ThreadLocalHistogram<T>& rdf_array,
                    const box::Box &box,
                    const float rmax,
                    const float dr,
                    const locality::LinkCell *lc,
+                   const locality::NeighborList *nlist,
                    const vec3<float> *ref_points,
                    const T *ref_values,
                    unsigned int n_ref,
@@ -175,7 +175,7 @@ class ComputeOCF
                    const T *point_values,
                    unsigned int Np)
             : m_nbins(nbins), m_bin_counts(bin_counts), m_rdf_array(rdf_array), m_box(box), m_rmax(rmax), m_dr(dr),
-              m_lc(lc), m_ref_points(ref_points), m_ref_values(ref_values), m_n_ref(n_ref), m_points(points),
+              m_lc(lc), m_nlist(nlist), m_ref_points(ref_points), m_ref_values(ref_values), m_n_ref(n_ref), m_points(points),
               m_point_values(point_values), m_Np(Np)
         {
         }
@@ -5,6 +5,7 @@
 #include "ScopedGILRelease.h"
 
 #include <stdexcept>
+#include <complex>
 
 using namespace std;
 
@@ -18,7 +19,8 @@ namespace freud { namespace density {
 
 
 GaussianDensity::GaussianDensity(unsigned int width, float r_cut, float sigma)
-    : m_box(box::Box()), m_width_x(width), m_width_y(width), m_width_z(width), m_rcut(r_cut), m_sigma(sigma)
+    : m_box(box::Box()), m_width_x(width), m_width_y(width), m_width_z(width), m_rcut(r_cut), m_sigma(sigma),
+      m_method(DirectSum), m_density_sums(size_t(width)*width*width)
     {
     if (width <= 0)
             throw invalid_argument("width must be a positive integer");
@@ -28,7 +30,8 @@ GaussianDensity::GaussianDensity(unsigned int width, float r_cut, float sigma)
 
 GaussianDensity::GaussianDensity(unsigned int width_x, unsigned int width_y,
                                  unsigned int width_z, float r_cut, float sigma)
-    : m_box(box::Box()), m_width_x(width_x), m_width_y(width_y), m_width_z(width_z), m_rcut(r_cut), m_sigma(sigma)
+    : m_box(box::Box()), m_width_x(width_x), m_width_y(width_y), m_width_z(width_z), m_rcut(r_cut), m_sigma(sigma),
+      m_method(DirectSum), m_density_sums(size_t(width_x)*width_y*width_z)
     {
     if (width_x <= 0 || width_y <=0 || width_z <=0)
             throw invalid_argument("width must be a positive integer");
@@ -36,29 +39,20 @@ GaussianDensity::GaussianDensity(unsigned int width_x, unsigned int width_y,
             throw invalid_argument("r_cut must be positive");
     }
 
-GaussianDensity::~GaussianDensity()
-    {
-    for (tbb::enumerable_thread_specific<float *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
-    }
-
 void GaussianDensity::reduceDensity()
     {
-    memset((void*)m_Density_array.get(), 0, sizeof(float)*m_bi.getNumElements());
+    // the other methods write the density directly
+    if (m_method != DirectSum)
+        return;
     // combine arrays
+    m_density_sums.flush();
+    const double *density_sums = m_density_sums.getTotals().get();
+    float *density = m_Density_array.get();
     parallel_for(blocked_range<size_t>(0,m_bi.getNumElements()),
       [=] (const blocked_range<size_t>& r)
       {
       for (size_t i = r.begin(); i != r.end(); i++)
-          {
-          for (tbb::enumerable_thread_specific<float *>::const_iterator local_bins = m_local_bin_counts.begin();
-               local_bins != m_local_bin_counts.end(); ++local_bins)
-              {
-              m_Density_array.get()[i] += (*local_bins)[i];
-              }
-          }
+          density[i] = float(density_sums[i]);
       });
     }
 
@@ -99,10 +93,7 @@ unsigned int GaussianDensity::getWidthZ()
 */
 void GaussianDensity::resetDensity()
     {
-    for (tbb::enumerable_thread_specific<float *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(float)*m_bi.getNumElements());
-        }
+    m_density_sums.reset();
     }
 
 //! internal
@@ -110,6 +101,11 @@ void GaussianDensity::resetDensity()
 */
 void GaussianDensity::compute(const box::Box &box, const vec3<float> *points, unsigned int Np)
     {
+    // Separable and FFTConvolution treat the box axes as independent, which only holds without tilt
+    const bool tilted = box.getTiltFactorXY() != 0 ||
+        (!box.is2D() && (box.getTiltFactorXZ() != 0 || box.getTiltFactorYZ() != 0));
+    if (m_method != DirectSum && tilted)
+        throw invalid_argument("the separable and fft methods require a box without tilt; use the direct method");
     resetDensity();
     m_box = box;
     if (m_box.is2D())
@@ -122,19 +118,24 @@ void GaussianDensity::compute(const box::Box &box, const vec3<float> *points, un
         }
     // this does not agree with rest of freud
     m_Density_array = std::shared_ptr<float>(new float[m_bi.getNumElements()], std::default_delete<float[]>());
+    if (m_method == Separable)
+        {
+        computeSeparable(points, Np);
+        return;
+        }
+    else if (m_method == FFTConvolution)
+        {
+        computeFFT(points, Np);
+        return;
+        }
+
     parallel_for(blocked_range<size_t>(0,Np),
       [=] (const blocked_range<size_t>& r)
       {
       assert(points);
       assert(Np > 0);
 
-      bool exists;
-      m_local_bin_counts.local(exists);
-      if (! exists)
-          {
-          m_local_bin_counts.local() = new float [m_bi.getNumElements()];
-          memset((void*)m_local_bin_counts.local(), 0, sizeof(float)*m_bi.getNumElements());
-          }
+      util::ThreadLocalHistogram<float>::Accessor local_bins = m_density_sums.local();
 
       // set up some constants first
       float lx = m_box.getLx();
@@ -204,7 +205,7 @@ void GaussianDensity::compute(const box::Box &box, const vec3<float> *points, un
                           unsigned int nk = (k + m_width_z) % m_width_z;
 
                           // store the product of these values in an array - n[i, j, k] = gx*gy*gz
-                          m_local_bin_counts.local()[m_bi(ni, nj, nk)] += x_gaussian*y_gaussian*z_gaussian;
+                          local_bins[m_bi(ni, nj, nk)] += x_gaussian*y_gaussian*z_gaussian;
                           }
                       }
                   }
@@ -212,4 +213,239 @@ void GaussianDensity::compute(const box::Box &box, const vec3<float> *points, un
           }
       });
   }
+
+//! \internal
+//! Minimum image of a separation along one axis of an orthorhombic box, the same steps as box::Box::minimalwrap
+static inline float wrapAxis(float d, float L)
+    {
+    if (d >= L/2.0f)
+        d -= L;
+    else if (d < -L/2.0f)
+        d += L;
+    return d;
+    }
+
+//! \internal
+/*! \brief Compute the density with the separable Gaussian, writing each grid row from a single task
+    exp(-r^2/(2 sigma^2)) = gx*gy*gz, so each particle needs 2*bin_cut+1 exponentials per axis instead of one per
+    grid point within the cutoff. The particles are sorted into buckets by the grid row (y bin) they are in, and
+    each task owns a block of rows: it visits only the buckets within bin_cut_y rows of its block and adds the
+    contributions to its own rows, directly into the density grid. No thread keeps a grid of its own.
+
+    The separations are wrapped along each axis of the box, so tilt factors are ignored.
+*/
+void GaussianDensity::computeSeparable(const vec3<float> *points, unsigned int Np)
+    {
+    float lx = m_box.getLx();
+    float ly = m_box.getLy();
+    float lz = m_box.getLz();
+
+    float grid_size_x = lx/m_width_x;
+    float grid_size_y = ly/m_width_y;
+    float grid_size_z = lz/m_width_z;
+
+    int bin_cut_x = int(m_rcut/grid_size_x);
+    int bin_cut_y = int(m_rcut/grid_size_y);
+    int bin_cut_z = int(m_rcut/grid_size_z);
+    // in 2D, only loop over the 0 z plane
+    if (m_box.is2D())
+        {
+        bin_cut_z = 0;
+        grid_size_z = 0;
+        }
+
+    float sigmasq = m_sigma*m_sigma;
+    float A = sqrt(1.0f/(2.0f*M_PI*sigmasq));
+    float rcutsq = m_rcut*m_rcut;
+    const Index3D bi = m_bi;
+    const int width_x = bi.getW();
+    const int width_y = bi.getH();
+    const int width_z = bi.getD();
+    float *density = m_Density_array.get();
+    memset((void*)density, 0, sizeof(float)*bi.getNumElements());
+
+    // bin of each particle, and the particles sorted by row
+    std::vector< vec3<int> > point_bins(Np);
+    std::vector<unsigned int> row_start(width_y + 1, 0);
+    for (unsigned int idx = 0; idx < Np; idx++)
+        {
+        vec3<int> b(int((points[idx].x+lx/2.0f)/grid_size_x), int((points[idx].y+ly/2.0f)/grid_size_y),
+                    m_box.is2D() ? 0 : int((points[idx].z+lz/2.0f)/grid_size_z));
+        point_bins[idx] = b;
+        ++row_start[((b.y % width_y) + width_y) % width_y + 1];
+        }
+    for (int j = 0; j < width_y; j++)
+        row_start[j + 1] += row_start[j];
+    std::vector<unsigned int> row_points(Np);
+    std::vector<unsigned int> row_fill(row_start.begin(), row_start.end() - 1);
+    for (unsigned int idx = 0; idx < Np; idx++)
+        row_points[row_fill[((point_bins[idx].y % width_y) + width_y) % width_y]++] = idx;
+
+    const vec3<int> *bins = point_bins.data();
+    const unsigned int *row_begin = row_start.data();
+    const unsigned int *sorted = row_points.data();
+    parallel_for(blocked_range<int>(0, width_y),
+      [=] (const blocked_range<int>& r)
+      {
+      std::vector<float> gx(2*bin_cut_x + 1), dx2(2*bin_cut_x + 1);
+      std::vector<float> gz(2*bin_cut_z + 1), dz2(2*bin_cut_z + 1);
+      std::vector<unsigned int> ni(2*bin_cut_x + 1);
+
+      // the rows whose particles reach the rows of this task, each once
+      int first_row = r.begin() - bin_cut_y;
+      int num_rows = std::min(int(r.size()) + 2*bin_cut_y, width_y);
+      for (int row = first_row; row < first_row + num_rows; row++)
+          {
+          int bucket = ((row % width_y) + width_y) % width_y;
+          for (unsigned int m = row_begin[bucket]; m != row_begin[bucket + 1]; m++)
+              {
+              unsigned int idx = sorted[m];
+              vec3<int> b = bins[idx];
+              vec3<float> p = points[idx];
+
+              // 1D factors along x and z, shared by all the rows
+              for (int di = -bin_cut_x; di <= bin_cut_x; di++)
+                  {
+                  int i = b.x + di;
+                  float dx = wrapAxis(float((grid_size_x*i + grid_size_x/2.0f) - p.x - lx/2.0f), lx);
+                  dx2[di + bin_cut_x] = dx*dx;
+                  gx[di + bin_cut_x] = A*exp((-1.0f)*(dx*dx)/(2.0f*sigmasq));
+                  ni[di + bin_cut_x] = (i + width_x) % width_x;
+                  }
+              for (int dk = -bin_cut_z; dk <= bin_cut_z; dk++)
+                  {
+                  int k = b.z + dk;
+                  float dz = wrapAxis(float((grid_size_z*k + grid_size_z/2.0f) - p.z - lz/2.0f), lz);
+                  dz2[dk + bin_cut_z] = dz*dz;
+                  gz[dk + bin_cut_z] = A*exp((-1.0f)*(dz*dz)/(2.0f*sigmasq));
+                  }
+
+              for (int j = b.y - bin_cut_y; j <= b.y + bin_cut_y; j++)
+                  {
+                  int nj = (j + width_y) % width_y;
+                  if (nj < r.begin() || nj >= r.end())
+                      continue;
+                  float dy = wrapAxis(float((grid_size_y*j + grid_size_y/2.0f) - p.y - ly/2.0f), ly);
+                  float gy = A*exp((-1.0f)*(dy*dy)/(2.0f*sigmasq));
+
+                  for (int dk = -bin_cut_z; dk <= bin_cut_z; dk++)
+                      {
+                      // only the grid points within r_cut, as in the direct sum
+                      float rem = rcutsq - dy*dy - dz2[dk + bin_cut_z];
+                      if (rem <= 0.0f)
+                          continue;
+                      float gyz = gy*gz[dk + bin_cut_z];
+                      float *row = density + bi(0, nj, (b.z + dk + width_z) % width_z);
+                      for (int di = 0; di <= 2*bin_cut_x; di++)
+                          {
+                          if (dx2[di] < rem)
+                              row[ni[di]] += gx[di]*gyz;
+                          }
+                      }
+                  }
+              }
+          }
+      });
+    }
+
+//! \internal
+/*! \brief Compute the density as the convolution of the particle counts on the grid with the Gaussian
+    The particles are assigned to the grid with cloud in cell weights (each grid point is at the center of its bin),
+    and the counts are convolved with the Gaussian, cut off at r_cut, by fast Fourier transforms. The cost does not
+    depend on sigma or r_cut, which makes this the fastest method for wide Gaussians; the transform of the Gaussian
+    is kept until the box or the grid changes. The placement of the particles on the grid smooths the density by
+    a fraction of a grid spacing, which is small compared to a Gaussian many grid spacings wide.
+*/
+void GaussianDensity::computeFFT(const vec3<float> *points, unsigned int Np)
+    {
+    float lx = m_box.getLx();
+    float ly = m_box.getLy();
+    float lz = m_box.getLz();
+    const bool is2D = m_box.is2D();
+
+    float grid_size_x = lx/m_width_x;
+    float grid_size_y = ly/m_width_y;
+    float grid_size_z = is2D ? 0.0f : lz/m_width_z;
+
+    const Index3D bi = m_bi;
+    const unsigned int width_x = bi.getW();
+    const unsigned int width_y = bi.getH();
+    const unsigned int width_z = bi.getD();
+    const size_t num_points = bi.getNumElements();
+
+    if (!m_fft || m_fft->getNumElements() != num_points || m_kernel_box != m_box
+        || m_kernel_bi.getW() != width_x || m_kernel_bi.getH() != width_y || m_kernel_bi.getD() != width_z)
+        {
+        m_fft = std::shared_ptr<util::FFT3D>(new util::FFT3D(width_x, width_y, width_z));
+        m_kernel_box = m_box;
+        m_kernel_bi = bi;
+
+        // the Gaussian at the minimum image of every grid offset
+        float sigmasq = m_sigma*m_sigma;
+        float A = sqrt(1.0f/(2.0f*M_PI*sigmasq));
+        float rcutsq = m_rcut*m_rcut;
+        m_kernel_ft.resize(num_points);
+        std::complex<double> *kernel = m_kernel_ft.data();
+        parallel_for(blocked_range<size_t>(0, num_points),
+          [=] (const blocked_range<size_t>& r)
+          {
+          for (size_t n = r.begin(); n != r.end(); n++)
+              {
+              vec3<unsigned int> node = bi(n);
+              float dx = grid_size_x * ((2*node.x <= width_x) ? int(node.x) : int(node.x) - int(width_x));
+              float dy = grid_size_y * ((2*node.y <= width_y) ? int(node.y) : int(node.y) - int(width_y));
+              float dz = grid_size_z * ((2*node.z <= width_z) ? int(node.z) : int(node.z) - int(width_z));
+              float value = 0.0f;
+              if (dx*dx + dy*dy + dz*dz < rcutsq)
+                  value = A*exp((-1.0f)*(dx*dx)/(2.0f*sigmasq)) * A*exp((-1.0f)*(dy*dy)/(2.0f*sigmasq))
+                          * A*exp((-1.0f)*(dz*dz)/(2.0f*sigmasq));
+              kernel[n] = std::complex<double>(value, 0.0);
+              }
+          });
+        m_fft->forward(kernel);
+        }
+
+    // cloud in cell counts, with grid point i at the center of bin i
+    m_fft_grid.assign(num_points, std::complex<double>(0.0, 0.0));
+    for (unsigned int idx = 0; idx < Np; idx++)
+        {
+        float u[3] = {(points[idx].x+lx/2.0f)/grid_size_x - 0.5f,
+                      (points[idx].y+ly/2.0f)/grid_size_y - 0.5f,
+                      is2D ? 0.0f : (points[idx].z+lz/2.0f)/grid_size_z - 0.5f};
+        const int width[3] = {int(width_x), int(width_y), int(width_z)};
+        unsigned int node[3][2];
+        float weight[3][2];
+        for (unsigned int d = 0; d < 3; d++)
+            {
+            int first = int(floorf(u[d]));
+            weight[d][1] = u[d] - float(first);
+            weight[d][0] = 1.0f - weight[d][1];
+            node[d][0] = ((first % width[d]) + width[d]) % width[d];
+            node[d][1] = (((first + 1) % width[d]) + width[d]) % width[d];
+            }
+        for (unsigned int c = 0; c < 2; c++)
+            for (unsigned int b = 0; b < 2; b++)
+                for (unsigned int a = 0; a < 2; a++)
+                    m_fft_grid[bi(node[0][a], node[1][b], node[2][c])] += weight[0][a]*weight[1][b]*weight[2][c];
+        }
+
+    m_fft->forward(m_fft_grid.data());
+    std::complex<double> *grid = m_fft_grid.data();
+    const std::complex<double> *kernel = m_kernel_ft.data();
+    float *density = m_Density_array.get();
+    parallel_for(blocked_range<size_t>(0, num_points),
+      [=] (const blocked_range<size_t>& r)
+      {
+      for (size_t n = r.begin(); n != r.end(); n++)
+          grid[n] *= kernel[n];
+      });
+    m_fft->inverse(grid);
+    parallel_for(blocked_range<size_t>(0, num_points),
+      [=] (const blocked_range<size_t>& r)
+      {
+      for (size_t n = r.begin(); n != r.end(); n++)
+          density[n] = float(grid[n].real());
+      });
+    }
+
 }; }; // end namespace freud::density
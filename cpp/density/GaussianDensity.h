@@ -9,12 +9,16 @@
 #define __APPLE__
 
 #include <memory>
+#include <complex>
+#include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "box.h"
 #include "Index1D.h"
+#include "FFT.h"
+#include "ThreadLocalHistogram.h"
 
 #ifndef _GaussianDensity_H__
 #define _GaussianDensity_H__
@@ -25,6 +29,21 @@
 
 namespace freud { namespace density {
 
+//! How GaussianDensity adds up the Gaussians of the particles
+/*! - DirectSum evaluates the Gaussian of each particle at each grid point within r_cut, into a full grid per thread
+    - Separable evaluates it as a product of 1D factors along each axis, and each thread writes its own block of
+      grid rows straight into the density, so no grid is kept per thread
+    - FFTConvolution spreads the particles over the grid and convolves them with the Gaussian by fast Fourier
+      transforms, whose cost does not depend on sigma or r_cut
+
+    Separable and FFTConvolution wrap along each box axis on its own, so compute() throws std::invalid_argument for
+    them when the box is tilted.
+*/
+enum GaussianDensityMethod {
+    DirectSum,
+    Separable,
+    FFTConvolution};
+
 //! Computes the the density of a system on a grid.
 /*! Replaces particle positions with a gaussian and calculates the
         contribution from the grid based upon the the distance of the grid cell
@@ -43,9 +62,6 @@ class GaussianDensity
                         float r_cut,
                         float sigma);
 
-        // Destructor
-        ~GaussianDensity();
-
         //! Get the simulation box
         const box::Box& getBox() const
                 {
@@ -71,6 +87,18 @@ class GaussianDensity
 
         unsigned int getWidthZ();
 
+        //! Set how the Gaussians are added up
+        void setMethod(GaussianDensityMethod method)
+            {
+            m_method = method;
+            }
+
+        //! Get how the Gaussians are added up
+        GaussianDensityMethod getMethod() const
+            {
+            return m_method;
+            }
+
     private:
         box::Box m_box;    //!< Simulation box the particles belong in
         unsigned int m_width_x,m_width_y,m_width_z;           //!< Num of bins on one side of the cube
@@ -78,9 +106,22 @@ class GaussianDensity
         float m_sigma;                  //!< Variance
         Index3D m_bi;                   //!< Bin indexer
         unsigned int m_frame_counter;       //!< number of frames calc'd
+        GaussianDensityMethod m_method;     //!< How the Gaussians are added up
 
         std::shared_ptr<float> m_Density_array;            //! computed density array
-        tbb::enumerable_thread_specific<float *> m_local_bin_counts;
+        util::ThreadLocalHistogram<float> m_density_sums;   //!< Sums of the Gaussians at each grid point (DirectSum)
+
+        std::shared_ptr<util::FFT3D> m_fft;                 //!< Transform of the grid (FFTConvolution)
+        std::vector< std::complex<double> > m_kernel_ft;    //!< Transform of the Gaussian (FFTConvolution)
+        box::Box m_kernel_box;                              //!< Box m_kernel_ft was computed for
+        Index3D m_kernel_bi;                                //!< Grid m_kernel_ft was computed for
+        std::vector< std::complex<double> > m_fft_grid;     //!< Particle counts and their transform (FFTConvolution)
+
+        //! Compute the density with the Separable method
+        void computeSeparable(const vec3<float> *points, unsigned int Np);
+
+        //! Compute the density with the FFTConvolution method
+        void computeFFT(const vec3<float> *points, unsigned int Np);
     };
 
 }; }; // end namespace freud::density
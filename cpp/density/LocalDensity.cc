@@ -6,6 +6,8 @@
 
 #include <stdexcept>
 #include <complex>
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 using namespace tbb;
@@ -17,9 +19,15 @@ using namespace tbb;
 namespace freud { namespace density {
 
 LocalDensity::LocalDensity(float rcut, float volume, float diameter)
-    : m_box(box::Box()), m_rcut(rcut), m_volume(volume), m_diameter(diameter), m_n_ref(0)
+    : m_box(box::Box()), m_rcuts(1, rcut), m_weight(LinearWeight), m_volume(volume), m_diameter(diameter), m_n_ref(0)
     {
-    m_lc = new locality::LinkCell(m_box, m_rcut);
+    initialize();
+    }
+
+LocalDensity::LocalDensity(const std::vector<float>& r_cuts, float volume, float diameter, LocalDensityWeight weight)
+    : m_box(box::Box()), m_rcuts(r_cuts), m_weight(weight), m_volume(volume), m_diameter(diameter), m_n_ref(0)
+    {
+    initialize();
     }
 
 LocalDensity::~LocalDensity()
@@ -27,74 +35,174 @@ LocalDensity::~LocalDensity()
     delete m_lc;
     }
 
-void LocalDensity::compute(const box::Box &box, const vec3<float> *ref_points, unsigned int n_ref, const vec3<float> *points, unsigned int Np)
+//! \internal
+//! Half of the width of r over which the weight falls from 1 to 0
+static float weightHalfWidth(LocalDensityWeight weight, float diameter)
+    {
+    if (weight == GaussianWeight)
+        return 3.0f * diameter / sqrtf(12.0f);
+    return diameter / 2.0f;
+    }
+
+void LocalDensity::initialize()
+    {
+    if (m_rcuts.empty())
+        throw invalid_argument("at least one r_cut is needed");
+    if (m_rcuts[0] <= 0.0f)
+        throw invalid_argument("r_cut must be positive");
+    for (size_t c = 1; c < m_rcuts.size(); c++)
+        if (!(m_rcuts[c] > m_rcuts[c - 1]))
+            throw invalid_argument("the r_cut values must be in increasing order");
+    if (m_diameter < 0.0f)
+        throw invalid_argument("diameter must not be negative");
+
+    // particles further than the largest rcut + the half width have no weight
+    m_half_width = weightHalfWidth(m_weight, m_diameter);
+    m_lc = new locality::LinkCell(m_box, m_rcuts.back() + m_half_width);
+    m_lc->setSortPoints(true);
+
+    // the error function is interpolated from a table, which vectorizes
+    if (m_weight == GaussianWeight && m_diameter > 0.0f)
+        {
+        m_weight_table.resize(WEIGHT_TABLE_SIZE + 1);
+        for (unsigned int k = 0; k <= WEIGHT_TABLE_SIZE; k++)
+            {
+            float x = -m_half_width + 2.0f * m_half_width * float(k) / float(WEIGHT_TABLE_SIZE);
+            m_weight_table[k] = 0.5f * erfcf(x * sqrtf(6.0f) / m_diameter);
+            }
+        }
+    }
+
+//! \internal
+/*! \brief Add the weights of neighbors at the given distances to the neighbor count of each probe radius
+    Every neighbor is weighed for every radius, with weights that are clamped to 1 inside and 0 outside of the
+    surface of the sphere instead of branching, so that the loops over the radii vectorize.
+*/
+void LocalDensity::addNeighbors(const float *distances, unsigned int num_found, float *num_neighbors) const
+    {
+    const unsigned int n_rcut = m_rcuts.size();
+    const float *rcuts = &m_rcuts[0];
+    if (m_diameter == 0.0f)
+        {
+        for (unsigned int m = 0; m < num_found; ++m)
+            for (unsigned int c = 0; c < n_rcut; c++)
+                num_neighbors[c] += (distances[m] < rcuts[c]) ? 1.0f : 0.0f;
+        }
+    else if (m_weight == LinearWeight)
+        {
+        // partially count particles that intersect the rcut sphere
+        // this is not particularly accurate for a single particle, but works well on average for
+        // lots of them. It smooths out the neighbor count distributions and avoids noisy spikes
+        // that obscure data
+        const float inv_diameter = 1.0f / m_diameter;
+        for (unsigned int m = 0; m < num_found; ++m)
+            for (unsigned int c = 0; c < n_rcut; c++)
+                num_neighbors[c] += std::min(std::max(0.5f - (distances[m] - rcuts[c]) * inv_diameter, 0.0f), 1.0f);
+        }
+    else if (m_weight == CubicSplineWeight)
+        {
+        const float inv_diameter = 1.0f / m_diameter;
+        for (unsigned int m = 0; m < num_found; ++m)
+            for (unsigned int c = 0; c < n_rcut; c++)
+                {
+                float t = std::min(std::max((distances[m] - rcuts[c]) * inv_diameter + 0.5f, 0.0f), 1.0f);
+                num_neighbors[c] += 1.0f - t * t * (3.0f - 2.0f * t);
+                }
+        }
+    else
+        {
+        const float *table = &m_weight_table[0];
+        const float half_width = m_half_width;
+        const float inv_step = float(WEIGHT_TABLE_SIZE) / (2.0f * m_half_width);
+        for (unsigned int m = 0; m < num_found; ++m)
+            for (unsigned int c = 0; c < n_rcut; c++)
+                {
+                float x = distances[m] - rcuts[c];
+                float u = std::min(std::max((x + half_width) * inv_step, 0.0f), float(WEIGHT_TABLE_SIZE) - 0.5f);
+                int k = int(u);
+                float w = table[k] + (u - float(k)) * (table[k + 1] - table[k]);
+                num_neighbors[c] += (x <= -half_width) ? 1.0f : ((x >= half_width) ? 0.0f : w);
+                }
+        }
+    }
+
+void LocalDensity::compute(const box::Box &box, const vec3<float> *ref_points, unsigned int n_ref, const vec3<float> *points, unsigned int Np,
+                           const locality::NeighborList *nlist)
     {
     m_box = box;
-    // compute the cell list
-    m_lc->computeCellList(m_box, points, Np);
+    // compute the cell list, unless the caller already found the neighbors
+    if (nlist != NULL)
+        nlist->validate(n_ref, Np);
+    else
+        m_lc->computeCellList(m_box, points, Np);
 
+    const unsigned int n_rcut = m_rcuts.size();
     // reallocate the output array if it is not the right size
     if (n_ref != m_n_ref)
         {
-        m_density_array = std::shared_ptr<float>(new float[n_ref], std::default_delete<float[]>());
-        m_num_neighbors_array = std::shared_ptr<float>(new float[n_ref], std::default_delete<float[]>());
+        m_density_array = std::shared_ptr<float>(new float[size_t(n_ref)*n_rcut], std::default_delete<float[]>());
+        m_num_neighbors_array = std::shared_ptr<float>(new float[size_t(n_ref)*n_rcut], std::default_delete<float[]>());
         }
 
     // compute the local density
     parallel_for(blocked_range<size_t>(0,n_ref),
       [=] (const blocked_range<size_t>& r)
       {
-      for(size_t i=r.begin(); i!=r.end(); ++i)
+      const locality::DistanceKernel kernel(m_box, m_rcuts.back() + m_half_width);
+      std::vector<unsigned int> found;
+      std::vector<float> found_r;
+      if (nlist == NULL)
           {
-          float num_neighbors = 0;
+          found.resize(m_lc->getMaxCellSize());
+          found_r.resize(m_lc->getMaxCellSize());
+          }
+      std::vector<float> num_neighbors(n_rcut);
 
-          // get cell point is in
-          vec3<float> ref = ref_points[i];
-          unsigned int ref_cell = m_lc->getCell(ref);
+      for(size_t i=r.begin(); i!=r.end(); ++i)
+          {
+          std::fill(num_neighbors.begin(), num_neighbors.end(), 0.0f);
 
-          //loop over neighboring cells
-          const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-          for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+          if (nlist != NULL)
+              {
+              const size_t *segments = nlist->getSegments();
+              const float *distances = nlist->getDistances();
+              addNeighbors(distances + segments[i], segments[i+1] - segments[i], num_neighbors.data());
+              }
+          else
               {
-              unsigned int neigh_cell = neigh_cells[neigh_idx];
+              // get cell point is in
+              vec3<float> ref = ref_points[i];
+              unsigned int ref_cell = m_lc->getCell(ref);
 
-              //iterate over particles in cell
-              locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-              for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
+              //loop over neighboring cells
+              const locality::CellNeighbors neigh_cells = m_lc->getCellNeighbors(ref_cell);
+              for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
                   {
-                  //compute r between the two particles
-                  vec3<float> delta = m_box.wrap(points[j] - ref);
-
-                  // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                  float rsq = dot(delta, delta);
-                  float r = sqrt(rsq);
-
-                  // count particles that are fully in the rcut sphere
-                  if (r < (m_rcut - m_diameter/2.0f))
-                      {
-                      num_neighbors += 1.0f;
-                      }
-                  else if (r < (m_rcut + m_diameter/2.0f))
-                      {
-                      // partially count particles that intersect the rcut sphere
-                      // this is not particularly accurate for a single particle, but works well on average for
-                      // lots of them. It smooths out the neighbor count distributions and avoids noisy spikes
-                      // that obscure data
-                      num_neighbors += 1.0f + (m_rcut - (r + m_diameter/2.0f)) / m_diameter;
-                      }
+                  unsigned int neigh_cell = neigh_cells[neigh_idx];
+
+                  // weigh the particles of that cell in range, which are contiguous in the sorted positions
+                  unsigned int num_found = kernel.compute(ref, m_lc->getSortedX(), m_lc->getSortedY(),
+                                                          m_lc->getSortedZ(), m_lc->getCellOffsets()[neigh_cell],
+                                                          m_lc->getCellOffsets()[neigh_cell + 1], found.data(),
+                                                          found_r.data());
+                  addNeighbors(found_r.data(), num_found, num_neighbors.data());
                   }
               }
 
-          m_num_neighbors_array.get()[i] = num_neighbors;
-          if (m_box.is2D())
-              {
-              // local density is area of particles divided by the area of the circle
-              m_density_array.get()[i] = (m_volume * m_num_neighbors_array.get()[i]) / (M_PI * m_rcut * m_rcut);
-              }
-          else
+          for (unsigned int c = 0; c < n_rcut; c++)
               {
-              // local density is volume of particles divided by the volume of the sphere
-              m_density_array.get()[i] = (m_volume * m_num_neighbors_array.get()[i]) / (4.0f/3.0f * M_PI * m_rcut * m_rcut * m_rcut);
+              float rcut = m_rcuts[c];
+              m_num_neighbors_array.get()[i*n_rcut + c] = num_neighbors[c];
+              if (m_box.is2D())
+                  {
+                  // local density is area of particles divided by the area of the circle
+                  m_density_array.get()[i*n_rcut + c] = (m_volume * num_neighbors[c]) / (M_PI * rcut * rcut);
+                  }
+              else
+                  {
+                  // local density is volume of particles divided by the volume of the sphere
+                  m_density_array.get()[i*n_rcut + c] = (m_volume * num_neighbors[c]) / (4.0f/3.0f * M_PI * rcut * rcut * rcut);
+                  }
               }
           }
       });
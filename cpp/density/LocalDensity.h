@@ -10,11 +10,13 @@
 #define __APPLE__
 
 #include <memory>
+#include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "box.h"
 
 #ifndef _LOCAL_DENSITY_H__
@@ -26,8 +28,21 @@
 
 namespace freud { namespace density {
 
+//! How a neighbor close to the surface of the probe sphere is counted
+/*! Neighbors well inside r_cut count fully and neighbors well outside do not count; in between, the weight falls
+    from 1 to 0 over a width set by the particle diameter d. With x = r - r_cut:
+    - LinearWeight: 1/2 - x/d for |x| < d/2, roughly the part of a particle of diameter d inside the sphere
+    - CubicSplineWeight: 1 - 3t^2 + 2t^3 with t = x/d + 1/2, for |x| < d/2, which also has a continuous slope
+    - GaussianWeight: erfc(x/(sqrt(2) s))/2 with s = d/sqrt(12) (the variance of the linear step), for |x| < 3s
+*/
+enum LocalDensityWeight {
+    LinearWeight,
+    CubicSplineWeight,
+    GaussianWeight};
+
 //! Compute the local density at each point
-/*!
+/*! The density can be computed for several probe radii r_cut at once, from a single search for the neighbors
+    within the largest radius. The results then hold the values of all radii for each point, point by point.
 */
 class LocalDensity
     {
@@ -35,6 +50,9 @@ class LocalDensity
         //! Constructor
         LocalDensity(float r_cut, float volume, float diameter);
 
+        //! Constructor for several probe radii, in increasing order
+        LocalDensity(const std::vector<float>& r_cuts, float volume, float diameter, LocalDensityWeight weight);
+
        //! Destructor
        ~LocalDensity();
 
@@ -49,11 +67,18 @@ class LocalDensity
                      const vec3<float> *ref_points,
                      unsigned int n_ref,
                      const vec3<float> *points,
-                     unsigned int Np);
+                     unsigned int Np,
+                     const locality::NeighborList *nlist=NULL);
 
         //! Get the number of reference particles
         unsigned int getNRef();
 
+        //! Get the number of probe radii
+        unsigned int getNumRCut() const
+            {
+            return m_rcuts.size();
+            }
+
         //! Get a reference to the last computed density
         std::shared_ptr< float > getDensity();
 
@@ -61,8 +86,20 @@ class LocalDensity
         std::shared_ptr< float > getNumNeighbors();
 
     private:
+        //! Check the parameters and set up the cell list
+        void initialize();
+
+        //! Add the weights of neighbors at the given distances to the neighbor count of each probe radius
+        void addNeighbors(const float *distances, unsigned int num_found, float *num_neighbors) const;
+
+        //! Number of intervals of the table of GaussianWeight
+        static const unsigned int WEIGHT_TABLE_SIZE = 1024;
+
         box::Box m_box;            //!< Simulation box the particles belong in
-        float m_rcut;                     //!< Maximum neighbor distance
+        std::vector<float> m_rcuts;       //!< Probe radii, in increasing order
+        LocalDensityWeight m_weight;      //!< How neighbors near the surface of the probe sphere are counted
+        float m_half_width;               //!< Half of the width of r over which the weight falls from 1 to 0
+        std::vector<float> m_weight_table;  //!< GaussianWeight at evenly spaced r - r_cut from -m_half_width to m_half_width
         float m_volume;                   //!< Volume (area in 2d) of a single particle
         float m_diameter;                 //!< Diameter of the particles
         locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
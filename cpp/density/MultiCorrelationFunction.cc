@@ -0,0 +1,255 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "ScopedGILRelease.h"
+
+#include <stdexcept>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <tbb/tbb.h>
+#include <complex>
+#include "MultiCorrelationFunction.h"
+
+using namespace std;
+
+using namespace tbb;
+
+/*! \file MultiCorrelationFunction.cc
+    \brief Pairwise correlation functions of several values per point at once
+*/
+
+namespace freud { namespace density {
+
+template<typename T>
+MultiCorrelationFunction<T>::MultiCorrelationFunction(float rmax, float dr, unsigned int num_channels)
+    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_num_channels(num_channels), m_frame_counter(0),
+      m_bin_counter(size_t(floorf(rmax / dr))), m_value_sums(size_t(floorf(rmax / dr)) * num_channels)
+    {
+    if (dr <= 0.0f)
+        throw invalid_argument("dr must be positive");
+    if (rmax <= 0.0f)
+        throw invalid_argument("rmax must be positive");
+    if (dr > rmax)
+        throw invalid_argument("rmax must be greater than dr");
+    if (num_channels < 1)
+        throw invalid_argument("must be at least 1 channel");
+
+    m_nbins = int(floorf(m_rmax / m_dr));
+    assert(m_nbins > 0);
+    m_rdf_array = std::shared_ptr<T>(new T[m_nbins*m_num_channels], std::default_delete<T[]>());
+    for(size_t i(0); i < m_nbins*m_num_channels; ++i)
+        m_rdf_array.get()[i] = T();
+
+    // precompute the bin center positions
+    m_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins; i++)
+        {
+        float r = float(i) * m_dr;
+        float nextr = float(i+1) * m_dr;
+        m_r_array.get()[i] = 2.0f / 3.0f * (nextr*nextr*nextr - r*r*r) / (nextr*nextr - r*r);
+        }
+    m_lc = new locality::LinkCell(m_box, m_rmax);
+    // stream the positions of each neighboring cell from contiguous memory
+    m_lc->setSortPoints(true);
+    }
+
+template<typename T>
+MultiCorrelationFunction<T>::~MultiCorrelationFunction()
+    {
+    delete m_lc;
+    }
+
+//! \internal
+//! helper function to reduce the thread specific arrays into the correlation functions
+template<typename T>
+void MultiCorrelationFunction<T>::reduceCorrelationFunction()
+    {
+    // move the counts and values of each thread into the totals
+    m_bin_counter.flush();
+    m_value_sums.flush();
+    const uint64_t *bin_counts = m_bin_counter.getTotals().get();
+    const T *value_sums = m_value_sums.getTotals().get();
+    parallel_for(blocked_range<size_t>(0, m_nbins),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            for (unsigned int c = 0; c < m_num_channels; c++)
+                {
+                T value = value_sums[i*m_num_channels + c];
+                if (bin_counts[i])
+                    value /= double(bin_counts[i]);
+                m_rdf_array.get()[i*m_num_channels + c] = value;
+                }
+            }
+        });
+    }
+
+//! Get a reference to the correlation functions
+template<typename T>
+std::shared_ptr<T> MultiCorrelationFunction<T>::getRDF()
+    {
+    reduceCorrelationFunction();
+    return m_rdf_array;
+    }
+
+//! \internal
+/*! \brief Function to reset the correlation functions
+*/
+template<typename T>
+void MultiCorrelationFunction<T>::resetCorrelationFunction()
+    {
+    m_bin_counter.reset();
+    m_value_sums.reset();
+    // reset the frame counter
+    m_frame_counter = 0;
+    }
+
+template<typename T>
+void MultiCorrelationFunction<T>::accumulate(const box::Box &box,
+                                             const vec3<float> *ref_points,
+                                             const T *ref_values,
+                                             unsigned int n_ref,
+                                             const vec3<float> *points,
+                                             const T *point_values,
+                                             unsigned int Np,
+                                             const locality::NeighborList *nlist)
+    {
+    m_box = box;
+    if (nlist != NULL)
+        nlist->validate(n_ref, Np);
+    else
+        m_lc->computeCellList(m_box, points, Np);
+
+    // a single bin receives at most one count per bond, or per (ref point, candidate) pair
+    if (nlist != NULL)
+        m_bin_counter.beginFrame(nlist->getNumBonds());
+    else
+        m_bin_counter.beginFrame(uint64_t(n_ref) * std::min(size_t(Np), m_lc->getMaxNumCandidates()));
+
+    const unsigned int num_channels = m_num_channels;
+    const bool same_points = (points == ref_points);
+
+    // the neighbor list already holds the distances, so only the binning is left
+    if (nlist != NULL)
+        {
+        parallel_for(blocked_range<size_t>(0, n_ref),
+            [=] (const blocked_range<size_t>& r)
+            {
+            util::ThreadLocalHistogram<uint32_t>::Accessor local_counts = m_bin_counter.local();
+            typename util::ThreadLocalHistogram<T>::Accessor local_values = m_value_sums.local();
+            float dr_inv = 1.0f / m_dr;
+            const size_t *segments = nlist->getSegments();
+            const size_t *index_j = nlist->getIndexJ();
+            const float *distances = nlist->getDistances();
+            for (size_t i = r.begin(); i != r.end(); i++)
+                {
+                const T *value_i = ref_values + i*num_channels;
+                for (size_t bond = segments[i]; bond != segments[i + 1]; ++bond)
+                    {
+                    size_t j = index_j[bond];
+                    float rij = distances[bond];
+                    if ((i != j || !same_points) && rij < m_rmax)
+                        {
+                        float binr = rij * dr_inv;
+                        #ifdef __SSE2__
+                        unsigned int bin = _mm_cvtt_ss2si(_mm_load_ss(&binr));
+                        #else
+                        unsigned int bin = (unsigned int)(binr);
+                        #endif
+
+                        if (bin < m_nbins)
+                            {
+                            ++local_counts[bin];
+                            const T *value_j = point_values + j*num_channels;
+                            for (unsigned int c = 0; c < num_channels; c++)
+                                local_values[bin*num_channels + c] += value_i[c]*value_j[c];
+                            }
+                        }
+                    }
+                }
+            });
+        m_frame_counter += 1;
+        return;
+        }
+
+    // copy the values of the points into cell list order, next to the sorted positions
+    const unsigned int *cell_idx = m_lc->getCellIndices();
+    m_sorted_values.resize(size_t(Np)*num_channels);
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t k = r.begin(); k != r.end(); k++)
+            std::copy(point_values + size_t(cell_idx[k])*num_channels,
+                      point_values + size_t(cell_idx[k] + 1)*num_channels,
+                      &m_sorted_values[k*num_channels]);
+        });
+
+    parallel_for(blocked_range<size_t>(0, n_ref),
+        [=] (const blocked_range<size_t>& r)
+        {
+        util::ThreadLocalHistogram<uint32_t>::Accessor local_counts = m_bin_counter.local();
+        typename util::ThreadLocalHistogram<T>::Accessor local_values = m_value_sums.local();
+        const T *sorted_values = &m_sorted_values[0];
+        const unsigned int *cell_start = m_lc->getCellOffsets();
+        const float *sorted_x = m_lc->getSortedX();
+        const float *sorted_y = m_lc->getSortedY();
+        const float *sorted_z = m_lc->getSortedZ();
+        const locality::DistanceKernel kernel(m_box, m_rmax, m_dr);
+        std::vector<unsigned int> found(m_lc->getMaxCellSize());
+        std::vector<unsigned int> bins(m_lc->getMaxCellSize());
+
+        // for each reference point
+        for (size_t i = r.begin(); i != r.end(); i++)
+            {
+            // get the cell the point is in
+            vec3<float> ref = ref_points[i];
+            const T *value_i = ref_values + i*num_channels;
+            unsigned int ref_cell = m_lc->getCell(ref);
+
+            // loop over all neighboring cells
+            const locality::CellNeighbors neigh_cells = m_lc->getCellNeighbors(ref_cell);
+            if (neigh_cells.hasShifts())
+                ref = m_lc->getCellImage(ref);
+            for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                {
+                unsigned int neigh_cell = neigh_cells[neigh_idx];
+
+                // find the particles of that cell within rmax
+                unsigned int num_found;
+                if (neigh_cells.hasShifts())
+                    {
+                    num_found = kernel.computeImage(ref - neigh_cells.getShift(neigh_idx), sorted_x, sorted_y,
+                                                    sorted_z, cell_start[neigh_cell], cell_start[neigh_cell + 1],
+                                                    found.data(), NULL, bins.data());
+                    }
+                else
+                    {
+                    num_found = kernel.compute(ref, sorted_x, sorted_y, sorted_z, cell_start[neigh_cell],
+                                               cell_start[neigh_cell + 1], found.data(), NULL, bins.data());
+                    }
+
+                // add the products of all channels of each pair
+                for (unsigned int m = 0; m < num_found; ++m)
+                    {
+                    unsigned int bin = bins[m];
+                    if (bin < m_nbins && (cell_idx[found[m]] != i || !same_points))
+                        {
+                        ++local_counts[bin];
+                        const T *value_j = sorted_values + size_t(found[m])*num_channels;
+                        for (unsigned int c = 0; c < num_channels; c++)
+                            local_values[bin*num_channels + c] += value_i[c]*value_j[c];
+                        }
+                    }
+                }
+            } // done looping over reference points
+        });
+    m_frame_counter += 1;
+    }
+
+template class MultiCorrelationFunction< complex<double> >;
+template class MultiCorrelationFunction< double >;
+
+}; }; // end namespace freud::density
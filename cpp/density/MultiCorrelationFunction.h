@@ -0,0 +1,118 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "LinkCell.h"
+#include "NeighborList.h"
+#include "box.h"
+#include "ThreadLocalHistogram.h"
+
+#include <tbb/tbb.h>
+
+#ifndef _MULTICORRELATIONFUNCTION_H__
+#define _MULTICORRELATIONFUNCTION_H__
+
+/*! \file MultiCorrelationFunction.h
+    \brief Pairwise correlation functions of several values per point at once
+*/
+
+namespace freud { namespace density {
+
+//! Computes several pairwise correlation functions <p_c*q_c>(r) in a single pass over the pairs of points
+/*! Like CorrelationFunction, but each point carries num_channels values (an N x num_channels array, one row per
+    point) and every pair found adds the products of all channels to the bin of its distance. The pair search,
+    which dominates the cost, is shared by all the channels; the products of one pair are a contiguous loop over
+    the channels that the compiler can vectorize. The values of the points are copied into cell list order at the
+    start of each frame, so they are read from the same contiguous blocks as the positions.
+
+    The result is an array of shape (nbins, num_channels): entry (b, c) is the average of
+    ref_values[i][c]*point_values[j][c] over the pairs (i, j) whose distance falls in bin b. As in
+    CorrelationFunction, the pairs of a point with itself are skipped when ref_points and points are the same
+    array.
+*/
+template<typename T>
+class MultiCorrelationFunction
+    {
+    public:
+        //! Constructor
+        MultiCorrelationFunction(float rmax, float dr, unsigned int num_channels);
+
+        //! Destructor
+        ~MultiCorrelationFunction();
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Reset the correlation functions to all zeros
+        void resetCorrelationFunction();
+
+        //! accumulate the correlation functions
+        void accumulate(const box::Box &box,
+                        const vec3<float> *ref_points,
+                        const T *ref_values,
+                        unsigned int n_ref,
+                        const vec3<float> *points,
+                        const T *point_values,
+                        unsigned int Np,
+                        const locality::NeighborList *nlist=NULL);
+
+        //! \internal
+        //! helper function to reduce the thread specific arrays into the correlation functions
+        void reduceCorrelationFunction();
+
+        //! Get a reference to the correlation functions, shape (nbins, num_channels)
+        std::shared_ptr<T> getRDF();
+
+        //! Get a reference to the bin counts array
+        std::shared_ptr<uint64_t> getCounts()
+            {
+            m_bin_counter.flush();
+            return m_bin_counter.getTotals();
+            }
+
+        //! Get a reference to the r array
+        std::shared_ptr<float> getR()
+            {
+            return m_r_array;
+            }
+
+        //! Get the number of r bins
+        unsigned int getNBins() const
+            {
+            return m_nbins;
+            }
+
+        //! Get the number of values per point
+        unsigned int getNumChannels() const
+            {
+            return m_num_channels;
+            }
+
+    private:
+        box::Box m_box;                     //!< Simulation box the particles belong in
+        float m_rmax;                       //!< Maximum r at which to compute the correlation functions
+        float m_dr;                         //!< Step size for r in the computation
+        unsigned int m_num_channels;        //!< Number of values per point
+        locality::LinkCell* m_lc;           //!< LinkCell to bin particles for the computation
+        unsigned int m_nbins;               //!< Number of r bins
+        unsigned int m_frame_counter;       //!< number of frames calc'd
+
+        util::ThreadLocalHistogram<uint32_t> m_bin_counter;   //!< pair counts of each r bin
+        util::ThreadLocalHistogram<T> m_value_sums;           //!< sums of the value products of each (r bin, channel)
+        std::vector<T> m_sorted_values;             //!< values of the points in cell list order
+        std::shared_ptr<T> m_rdf_array;             //!< correlation functions computed
+        std::shared_ptr<float> m_r_array;           //!< array of r values that the correlation is computed at
+    };
+
+}; }; // end namespace freud::density
+
+#endif // _MULTICORRELATIONFUNCTION_H__
@@ -0,0 +1,278 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "PartialRDF.h"
+#include "ScopedGILRelease.h"
+
+#include <stdexcept>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+using namespace tbb;
+
+/*! \file PartialRDF.cc
+    \brief Routines for computing the partial radial distribution functions of a mixture
+*/
+
+namespace freud { namespace density {
+
+PartialRDF::PartialRDF(float rmax, float dr, unsigned int num_types)
+    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_num_types(num_types), m_frame_counter(0), m_reduce(true),
+      m_bin_counter(size_t(num_types) * num_types * size_t(floorf(rmax / dr)))
+    {
+    if (dr <= 0.0f)
+        throw invalid_argument("dr must be positive");
+    if (rmax <= 0.0f)
+        throw invalid_argument("rmax must be positive");
+    if (dr > rmax)
+        throw invalid_argument("rmax must be greater than dr");
+    if (num_types < 1)
+        throw invalid_argument("must be at least 1 type");
+
+    m_nbins = int(floorf(m_rmax / m_dr));
+    assert(m_nbins > 0);
+    m_type_counts.resize(m_num_types, 0);
+    unsigned int num_bins = m_num_types*m_num_types*m_nbins;
+    m_rdf_array = std::shared_ptr<float>(new float[num_bins], std::default_delete<float[]>());
+    memset((void*)m_rdf_array.get(), 0, sizeof(float)*num_bins);
+    m_N_r_array = std::shared_ptr<float>(new float[num_bins], std::default_delete<float[]>());
+    memset((void*)m_N_r_array.get(), 0, sizeof(float)*num_bins);
+
+    // precompute the bin center positions
+    m_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins; i++)
+        {
+        float r = float(i) * m_dr;
+        float nextr = float(i+1) * m_dr;
+        m_r_array.get()[i] = 2.0f / 3.0f * (nextr*nextr*nextr - r*r*r) / (nextr*nextr - r*r);
+        }
+
+    m_lc = new locality::LinkCell(m_box, m_rmax);
+    // stream the positions of each neighboring cell from contiguous memory
+    m_lc->setSortPoints(true);
+    }
+
+PartialRDF::~PartialRDF()
+    {
+    delete m_lc;
+    }
+
+//! \internal
+//! helper function to fold the thread specific counts into the histograms and normalize them
+void PartialRDF::reduceRDF()
+    {
+    // move the counts of each thread into the 64 bit totals
+    m_bin_counter.flush();
+    const uint64_t *bin_counts = m_bin_counter.getTotals().get();
+    double volume = m_box.getVolume();
+    bool is2D = m_box.is2D();
+
+    // each pair of types is normalized like RDF::reduceRDF, with the type a particles as the reference points
+    parallel_for(blocked_range<size_t>(0, m_num_types*m_num_types),
+      [=] (const blocked_range<size_t>& r)
+      {
+      for (size_t pair = r.begin(); pair != r.end(); pair++)
+          {
+          unsigned int type_a = pair / m_num_types;
+          unsigned int type_b = pair % m_num_types;
+          float *rdf = m_rdf_array.get() + pair*m_nbins;
+          float *N_r = m_N_r_array.get() + pair*m_nbins;
+          const uint64_t *counts = bin_counts + pair*m_nbins;
+
+          double n_a = m_type_counts[type_a];
+          double ndens = double(m_type_counts[type_b]) / volume;
+          rdf[0] = 0.0f;
+          N_r[0] = 0.0f;
+          double sum = 0.0;
+          for (unsigned int i = 1; i < m_nbins; i++)
+              {
+              double avg_counts = (n_a > 0) ? double(counts[i]) / n_a : 0.0;
+              double r_in = double(i) * m_dr;
+              double r_out = double(i+1) * m_dr;
+              double vol = is2D ? M_PI * (r_out*r_out - r_in*r_in)
+                                : 4.0 / 3.0 * M_PI * (r_out*r_out*r_out - r_in*r_in*r_in);
+              sum += avg_counts;
+              rdf[i] = (ndens > 0) ? float(avg_counts / vol / ndens / m_frame_counter) : 0.0f;
+              N_r[i] = float(sum / m_frame_counter);
+              }
+          }
+      });
+    }
+
+//! Get a reference to the partial RDF histograms
+std::shared_ptr<float> PartialRDF::getRDF()
+    {
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
+    return m_rdf_array;
+    }
+
+//! Get a reference to the cumulative partial RDF histograms
+std::shared_ptr<float> PartialRDF::getNr()
+    {
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
+    return m_N_r_array;
+    }
+
+//! \internal
+/*! \brief Function to reset the histograms
+*/
+void PartialRDF::resetRDF()
+    {
+    m_bin_counter.reset();
+    // reset the frame counter
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Function to accumulate the given points to the histograms in memory
+*/
+void PartialRDF::accumulate(box::Box& box,
+                            const vec3<float> *points,
+                            const unsigned int *types,
+                            unsigned int Np,
+                            const locality::NeighborList *nlist)
+    {
+    // count the particles of each type, and check the types before any are used as an index
+    std::fill(m_type_counts.begin(), m_type_counts.end(), 0);
+    for (unsigned int i = 0; i < Np; i++)
+        {
+        if (types[i] >= m_num_types)
+            throw invalid_argument("types must be smaller than num_types");
+        ++m_type_counts[types[i]];
+        }
+
+    m_box = box;
+    if (nlist != NULL)
+        nlist->validate(Np, Np);
+    else
+        m_lc->computeCellList(m_box, points, Np);
+
+    // a single bin receives at most one count per bond, or per (point, candidate) pair
+    if (nlist != NULL)
+        m_bin_counter.beginFrame(nlist->getNumBonds());
+    else
+        m_bin_counter.beginFrame(uint64_t(Np) * std::min(size_t(Np), m_lc->getMaxNumCandidates()));
+
+    Index3D b_i = Index3D(m_nbins, m_num_types, m_num_types);
+
+    // the neighbor list already holds the distances, so only the binning is left
+    if (nlist != NULL)
+        {
+        parallel_for(blocked_range<size_t>(0, Np),
+          [=] (const blocked_range<size_t>& r)
+          {
+          util::ThreadLocalHistogram<uint32_t>::Accessor local_bins = m_bin_counter.local();
+          float dr_inv = 1.0f / m_dr;
+          const size_t *segments = nlist->getSegments();
+          const size_t *index_j = nlist->getIndexJ();
+          const float *distances = nlist->getDistances();
+          for (size_t i = r.begin(); i != r.end(); i++)
+              {
+              for (size_t bond = segments[i]; bond != segments[i + 1]; ++bond)
+                  {
+                  size_t j = index_j[bond];
+                  float rij = distances[bond];
+                  if (rij < m_rmax && j != i)
+                      {
+                      float binr = rij * dr_inv;
+                      #ifdef __SSE2__
+                      unsigned int bin = _mm_cvtt_ss2si(_mm_load_ss(&binr));
+                      #else
+                      unsigned int bin = (unsigned int)(binr);
+                      #endif
+
+                      if (bin < m_nbins)
+                          {
+                          ++local_bins[b_i(bin, types[j], types[i])];
+                          }
+                      }
+                  }
+              }
+          });
+        }
+    else
+        {
+        // look the types up in cell list order, next to the sorted positions
+        const unsigned int *cell_idx = m_lc->getCellIndices();
+        m_sorted_types.resize(Np);
+        parallel_for(blocked_range<size_t>(0, Np),
+          [=] (const blocked_range<size_t>& r)
+          {
+          for (size_t k = r.begin(); k != r.end(); k++)
+              m_sorted_types[k] = types[cell_idx[k]];
+          });
+
+        // visit each unordered pair once by looping over cells and their half neighbors, and count it for both of
+        // its points
+        parallel_for(blocked_range<size_t>(0, m_lc->getNumCells()),
+          [=] (const blocked_range<size_t>& r)
+          {
+          util::ThreadLocalHistogram<uint32_t>::Accessor local_bins = m_bin_counter.local();
+          const unsigned int *sorted_types = &m_sorted_types[0];
+          const unsigned int *cell_start = m_lc->getCellOffsets();
+          const float *sorted_x = m_lc->getSortedX();
+          const float *sorted_y = m_lc->getSortedY();
+          const float *sorted_z = m_lc->getSortedZ();
+          const locality::DistanceKernel kernel(m_box, m_rmax, m_dr);
+          std::vector<unsigned int> found(m_lc->getMaxCellSize());
+          std::vector<unsigned int> bins(m_lc->getMaxCellSize());
+
+          for (size_t cell = r.begin(); cell != r.end(); cell++)
+              {
+              const locality::CellNeighbors neigh_cells = m_lc->getCellHalfNeighbors(cell);
+              for (unsigned int a = cell_start[cell]; a != cell_start[cell + 1]; ++a)
+                  {
+                  vec3<float> ref(sorted_x[a], sorted_y[a], sorted_z[a]);
+                  unsigned int type_a = sorted_types[a];
+
+                  for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                      {
+                      unsigned int neigh_cell = neigh_cells[neigh_idx];
+
+                      // pairs within the same cell are only taken once
+                      unsigned int first = (neigh_cell == cell) ? a + 1 : cell_start[neigh_cell];
+                      unsigned int num_found;
+                      if (neigh_cells.hasShifts())
+                          {
+                          num_found = kernel.computeImage(ref - neigh_cells.getShift(neigh_idx), sorted_x, sorted_y,
+                                                          sorted_z, first, cell_start[neigh_cell + 1], found.data(),
+                                                          NULL, bins.data());
+                          }
+                      else
+                          {
+                          num_found = kernel.compute(ref, sorted_x, sorted_y, sorted_z, first,
+                                                     cell_start[neigh_cell + 1], found.data(), NULL, bins.data());
+                          }
+
+                      for (unsigned int m = 0; m < num_found; ++m)
+                          {
+                          if (bins[m] < m_nbins)
+                              {
+                              unsigned int type_b = sorted_types[found[m]];
+                              ++local_bins[b_i(bins[m], type_b, type_a)];
+                              ++local_bins[b_i(bins[m], type_a, type_b)];
+                              }
+                          }
+                      }
+                  }
+              }
+          });
+        }
+    m_frame_counter += 1;
+    // flag to reduce
+    m_reduce = true;
+    }
+
+}; }; // end namespace freud::density
@@ -0,0 +1,114 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "LinkCell.h"
+#include "NeighborList.h"
+#include "box.h"
+#include "Index1D.h"
+#include "ThreadLocalHistogram.h"
+
+#ifndef _PARTIAL_RDF_H__
+#define _PARTIAL_RDF_H__
+
+/*! \file PartialRDF.h
+    \brief Routines for computing the partial radial distribution functions of a mixture
+*/
+
+namespace freud { namespace density {
+
+//! Computes the partial RDFs g_ab(r) between all pairs of particle types in one pass
+/*! Each particle carries a type in [0, num_types). A single traversal of the cell list bins every pair into the
+    histogram of its two types, so the num_types*num_types partial RDFs cost about as much as one RDF of all
+    particles, instead of one RDF (and cell list) per pair of types on filtered subsets of the points.
+
+    The results are arrays of shape (num_types, num_types, nbins), where g_ab(r) is the density of type b
+    particles around the type a particles relative to the average density of type b, normalized like RDF: counts
+    are divided by the number of type a particles, the volume of the shell and the density of type b, and
+    averaged over the accumulated frames. N_ab(r) is the average number of type b particles within r of a type a
+    particle. A particle is never counted as its own neighbor.
+*/
+class PartialRDF
+    {
+    public:
+        //! Constructor
+        PartialRDF(float rmax, float dr, unsigned int num_types);
+
+        //! Destructor
+        ~PartialRDF();
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Reset the histograms to all zeros
+        void resetRDF();
+
+        //! Add the pairs of points to the histograms
+        /*! If \a nlist is given, its bonds (within the points) are used instead of building a cell list; bonds
+            longer than rmax are ignored.
+        */
+        void accumulate(box::Box& box,
+                        const vec3<float> *points,
+                        const unsigned int *types,
+                        unsigned int Np,
+                        const locality::NeighborList *nlist=NULL);
+
+        //! \internal
+        //! helper function to fold the thread specific counts into the histograms and normalize them
+        void reduceRDF();
+
+        //! Get a reference to the partial RDFs, shape (num_types, num_types, nbins)
+        std::shared_ptr<float> getRDF();
+
+        //! Get a reference to the cumulative counts N_ab(r), shape (num_types, num_types, nbins)
+        std::shared_ptr<float> getNr();
+
+        //! Get a reference to the r array
+        std::shared_ptr<float> getR()
+            {
+            return m_r_array;
+            }
+
+        //! Get the number of r bins
+        unsigned int getNBins() const
+            {
+            return m_nbins;
+            }
+
+        //! Get the number of particle types
+        unsigned int getNumTypes() const
+            {
+            return m_num_types;
+            }
+
+    private:
+        box::Box m_box;                     //!< Simulation box the particles belong in
+        float m_rmax;                       //!< Maximum r at which to compute g(r)
+        float m_dr;                         //!< Step size for r in the computation
+        unsigned int m_num_types;           //!< Number of particle types
+        locality::LinkCell* m_lc;           //!< LinkCell to bin particles for the computation
+        unsigned int m_nbins;               //!< Number of r bins to compute g(r) over
+        unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true if counts were accumulated since the last reduction
+
+        util::ThreadLocalHistogram<uint32_t> m_bin_counter;      //!< pair counts of each (type_a, type_b, r) bin
+        std::vector<unsigned int> m_type_counts;       //!< number of particles of each type in the last frame
+        std::vector<unsigned int> m_sorted_types;      //!< type of each particle in cell list order
+        std::shared_ptr<float> m_rdf_array;            //!< partial rdfs computed
+        std::shared_ptr<float> m_N_r_array;            //!< cumulative counts of the partial rdfs
+        std::shared_ptr<float> m_r_array;              //!< array of r values that the rdf is computed at
+    };
+
+}; }; // end namespace freud::density
+
+#endif // _PARTIAL_RDF_H__
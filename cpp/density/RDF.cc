@@ -20,7 +20,8 @@ using namespace tbb;
 namespace freud { namespace density {
 
 RDF::RDF(float rmax, float dr)
-    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_frame_counter(0)
+    : m_box(box::Box()), m_rmax(rmax), m_dr(dr), m_frame_counter(0), m_reduce(true),
+      m_bin_counter(size_t(floorf(rmax / dr)))
     {
     if (dr <= 0.0f)
         throw invalid_argument("dr must be positive");
@@ -33,8 +34,6 @@ RDF::RDF(float rmax, float dr)
     assert(m_nbins > 0);
     m_rdf_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
     memset((void*)m_rdf_array.get(), 0, sizeof(float)*m_nbins);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_nbins], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins);
     m_avg_counts = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
     memset((void*)m_avg_counts.get(), 0, sizeof(float)*m_nbins);
     m_N_r_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
@@ -65,15 +64,15 @@ RDF::RDF(float rmax, float dr)
         }
 
     m_lc = new locality::LinkCell(m_box, m_rmax);
+    // stream the positions of each neighboring cell from contiguous memory
+    m_lc->setSortPoints(true);
+    m_lc_next = NULL;
     }
 
 RDF::~RDF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
     delete m_lc;
+    delete m_lc_next;
     }
 
 //! \internal
@@ -123,11 +122,13 @@ class CumulativeCount
 
 
 //! \internal
-//! helper function to reduce the thread specific arrays into the boost array
+//! helper function to fold the thread specific counts into the global histogram and normalize it
 void RDF::reduceRDF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins);
     memset((void*)m_avg_counts.get(), 0, sizeof(float)*m_nbins);
+    // move the counts of each thread into the 64 bit totals so that they are only summed once
+    m_bin_counter.flush();
+    const uint64_t *bin_counts = m_bin_counter.getTotals().get();
     // now compute the rdf
     float ndens = float(m_Np) / m_box.getVolume();
     m_rdf_array.get()[0] = 0.0f;
@@ -143,16 +144,21 @@ void RDF::reduceRDF()
       {
       for (size_t i = r.begin(); i != r.end(); i++)
           {
-          for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-               local_bins != m_local_bin_counts.end(); ++local_bins)
-              {
-              m_bin_counts.get()[i] += (*local_bins)[i];
-              }
-          m_avg_counts.get()[i] = (float)m_bin_counts.get()[i] / m_n_ref;
+          m_avg_counts.get()[i] = float(double(bin_counts[i]) / m_n_ref);
           m_rdf_array.get()[i] = m_avg_counts.get()[i] / m_vol_array.get()[i] / ndens;
           }
       });
 
+    // the spread of the rdf of the blocks of frames
+    if (m_blocks)
+        {
+        const util::BlockAverage *blocks = m_blocks.get();
+        float *rdf_error = m_rdf_error.get();
+        rdf_error[0] = 0.0f;
+        for (unsigned int i = 1; i < m_nbins; i++)
+            rdf_error[i] = float(blocks->standardError(i) / m_n_ref / m_vol_array.get()[i] / ndens);
+        }
+
     CumulativeCount myN_r(m_N_r_array.get(), m_avg_counts.get());
     parallel_scan( blocked_range<size_t>(0, m_nbins), myN_r);
     for (unsigned int i=0; i<m_nbins; i++)
@@ -171,17 +177,38 @@ std::shared_ptr<float> RDF::getR()
 //! Get a reference to the RDF histogram array
 std::shared_ptr<float> RDF::getRDF()
     {
-    reduceRDF();
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
     return m_rdf_array;
     }
 
 //! Get a reference to the cumulative RDF histogram array
 std::shared_ptr<float> RDF::getNr()
     {
-    reduceRDF();
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
     return m_N_r_array;
     }
 
+//! Get a reference to the standard error of the RDF
+std::shared_ptr<float> RDF::getRDFStandardError()
+    {
+    if (!m_blocks)
+        throw invalid_argument("the standard error needs blocks of frames, see setNumBlocks()");
+    if (m_reduce == true)
+        {
+        reduceRDF();
+        }
+    m_reduce = false;
+    return m_rdf_error;
+    }
+
 //! Get number of bins
 unsigned int RDF::getNBins()
     {
@@ -193,12 +220,30 @@ unsigned int RDF::getNBins()
 */
 void RDF::resetRDF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_nbins);
-        }
+    m_bin_counter.reset();
+    if (m_blocks)
+        m_blocks->reset();
     // reset the frame counter
     m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Keep the counts of blocks of frames for the standard error of the rdf (see util::BlockAverage)
+*/
+void RDF::setNumBlocks(unsigned int num_blocks)
+    {
+    if (num_blocks == 0)
+        {
+        m_blocks.reset();
+        m_rdf_error.reset();
+        }
+    else
+        {
+        m_blocks = std::shared_ptr<util::BlockAverage>(new util::BlockAverage(m_nbins, num_blocks));
+        m_rdf_error = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+        }
+    resetRDF();
     }
 
 //! \internal
@@ -208,13 +253,59 @@ void RDF::accumulate(box::Box& box,
                      const vec3<float> *ref_points,
                      unsigned int Nref,
                      const vec3<float> *points,
-                     unsigned int Np)
+                     unsigned int Np,
+                     const locality::NeighborList *nlist)
+    {
+    if (nlist != NULL)
+        nlist->validate(Nref, Np);
+    else
+        m_lc->computeCellList(box, points, Np);
+    accumulateFrame(box, ref_points, Nref, points, Np, nlist);
+    }
+
+//! \internal
+/*! \brief Accumulate each frame of a trajectory, building the cell list of the next frame meanwhile
+*/
+void RDF::accumulateTrajectory(box::Box *boxes,
+                               const vec3<float> *ref_points,
+                               unsigned int Nref,
+                               const vec3<float> *points,
+                               unsigned int Np,
+                               unsigned int n_frames)
+    {
+    locality::pipelineCellLists(m_lc, m_lc_next, boxes, points, Np, n_frames,
+        [=] (unsigned int frame)
+            {
+            accumulateFrame(boxes[frame], ref_points + size_t(frame)*Nref, Nref, points + size_t(frame)*Np, Np, NULL);
+            });
+    }
+
+//! \internal
+/*! \brief Count the pairs of one frame, whose cell list is in m_lc unless nlist is given
+*/
+void RDF::accumulateFrame(box::Box& box,
+                          const vec3<float> *ref_points,
+                          unsigned int Nref,
+                          const vec3<float> *points,
+                          unsigned int Np,
+                          const locality::NeighborList *nlist)
     {
     m_box = box;
     m_Np = Np;
     m_n_ref = Nref;
-    m_lc->computeCellList(m_box, points, Np);
-    parallel_for(blocked_range<size_t>(0,Nref),
+
+    // when the reference points are the points, visit each unordered pair once by looping over cells and their
+    // half neighbors, and count it for both of its points
+    bool symmetric = (nlist == NULL && ref_points == points && Nref == Np);
+    size_t num_work = symmetric ? m_lc->getNumCells() : Nref;
+
+    // a single bin receives at most one count per bond, or per (ref point, candidate) pair, plus the self counts
+    if (nlist != NULL)
+        m_bin_counter.beginFrame(nlist->getNumBonds());
+    else
+        m_bin_counter.beginFrame(uint64_t(Nref) * (std::min(size_t(Np), m_lc->getMaxNumCandidates()) + 1));
+
+    parallel_for(blocked_range<size_t>(0,num_work),
       [=] (const blocked_range<size_t>& r)
       {
       assert(ref_points);
@@ -223,14 +314,89 @@ void RDF::accumulate(box::Box& box,
       assert(Np > 0);
 
       float dr_inv = 1.0f / m_dr;
-      float rmaxsq = m_rmax * m_rmax;
 
-      bool exists;
-      m_local_bin_counts.local(exists);
-      if (! exists)
+      util::ThreadLocalHistogram<uint32_t>::Accessor local_bins = m_bin_counter.local();
+
+      // the neighbor list already holds the distances, so only the binning is left
+      if (nlist != NULL)
+          {
+          const size_t *segments = nlist->getSegments();
+          const float *distances = nlist->getDistances();
+          for (size_t bond = segments[r.begin()]; bond != segments[r.end()]; ++bond)
+              {
+              float rij = distances[bond];
+              if (rij < m_rmax)
+                  {
+                  float binr = rij * dr_inv;
+                  #ifdef __SSE2__
+                  unsigned int bin = _mm_cvtt_ss2si(_mm_load_ss(&binr));
+                  #else
+                  unsigned int bin = (unsigned int)(binr);
+                  #endif
+
+                  if (bin < m_nbins)
+                      {
+                      ++local_bins[bin];
+                      }
+                  }
+              }
+          return;
+          }
+
+      // test the points of each neighboring cell as one block of the sorted positions
+      const unsigned int *cell_start = m_lc->getCellOffsets();
+      const float *sorted_x = m_lc->getSortedX();
+      const float *sorted_y = m_lc->getSortedY();
+      const float *sorted_z = m_lc->getSortedZ();
+      const locality::DistanceKernel kernel(m_box, m_rmax, m_dr);
+      std::vector<unsigned int> found(m_lc->getMaxCellSize());
+      std::vector<unsigned int> bins(m_lc->getMaxCellSize());
+
+      if (symmetric)
           {
-          m_local_bin_counts.local() = new unsigned int [m_nbins];
-          memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_nbins);
+          // for each cell
+          for (size_t cell = r.begin(); cell != r.end(); cell++)
+              {
+              const locality::CellNeighbors neigh_cells = m_lc->getCellHalfNeighbors(cell);
+              for (unsigned int a = cell_start[cell]; a != cell_start[cell + 1]; ++a)
+                  {
+                  vec3<float> ref(sorted_x[a], sorted_y[a], sorted_z[a]);
+
+                  // each point is its own neighbor at r = 0
+                  ++local_bins[0];
+
+                  for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                      {
+                      unsigned int neigh_cell = neigh_cells[neigh_idx];
+
+                      // pairs within the same cell are only taken once
+                      unsigned int first = (neigh_cell == cell) ? a + 1 : cell_start[neigh_cell];
+                      unsigned int num_found;
+                      if (neigh_cells.hasShifts())
+                          {
+                          // translate ref next to the neighbor cell instead of wrapping every pair
+                          num_found = kernel.computeImage(ref - neigh_cells.getShift(neigh_idx), sorted_x, sorted_y,
+                                                          sorted_z, first, cell_start[neigh_cell + 1], found.data(),
+                                                          NULL, bins.data());
+                          }
+                      else
+                          {
+                          num_found = kernel.compute(ref, sorted_x, sorted_y, sorted_z, first,
+                                                     cell_start[neigh_cell + 1], found.data(), NULL, bins.data());
+                          }
+
+                      // the pair counts once for each of its points
+                      for (unsigned int m = 0; m < num_found; ++m)
+                          {
+                          if (bins[m] < m_nbins)
+                              {
+                              local_bins[bins[m]] += 2;
+                              }
+                          }
+                      }
+                  }
+              }
+          return;
           }
 
       // for each reference point
@@ -241,43 +407,45 @@ void RDF::accumulate(box::Box& box,
           unsigned int ref_cell = m_lc->getCell(ref);
 
           // loop over all neighboring cells
-          const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
+          const locality::CellNeighbors neigh_cells = m_lc->getCellNeighbors(ref_cell);
+          if (neigh_cells.hasShifts())
+              ref = m_lc->getCellImage(ref);
           for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
               {
               unsigned int neigh_cell = neigh_cells[neigh_idx];
 
-              // iterate over the particles in that cell
-              locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-              for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+              // bin the particles of that cell within rmax
+              unsigned int num_found;
+              if (neigh_cells.hasShifts())
                   {
-                  // compute r between the two particles
-                  vec3<float> delta = m_box.wrap(points[j] - ref);
-
-                  float rsq = dot(delta, delta);
-
-                  if (rsq < rmaxsq)
+                  num_found = kernel.computeImage(ref - neigh_cells.getShift(neigh_idx), sorted_x, sorted_y, sorted_z,
+                                                  cell_start[neigh_cell], cell_start[neigh_cell + 1], found.data(),
+                                                  NULL, bins.data());
+                  }
+              else
+                  {
+                  num_found = kernel.compute(ref, sorted_x, sorted_y, sorted_z, cell_start[neigh_cell],
+                                             cell_start[neigh_cell + 1], found.data(), NULL, bins.data());
+                  }
+              for (unsigned int m = 0; m < num_found; ++m)
+                  {
+                  if (bins[m] < m_nbins)
                       {
-                      float r = sqrtf(rsq);
-
-                      // bin that r
-                      float binr = r * dr_inv;
-                      // fast float to int conversion with truncation
-                      #ifdef __SSE2__
-                      unsigned int bin = _mm_cvtt_ss2si(_mm_load_ss(&binr));
-                      #else
-                      unsigned int bin = (unsigned int)(binr);
-                      #endif
-
-                      if (bin < m_nbins)
-                          {
-                          ++m_local_bin_counts.local()[bin];
-                          }
+                      ++local_bins[bins[m]];
                       }
                   }
               }
           } // done looping over reference points
       });
     m_frame_counter += 1;
+    // the counts of a complete block are the totals since the end of the previous block
+    if (m_blocks && m_blocks->endFrame())
+        {
+        m_bin_counter.flush();
+        m_blocks->endBlock(m_bin_counter.getTotals().get());
+        }
+    // flag to reduce
+    m_reduce = true;
     }
 
 }; }; // end namespace freud::density
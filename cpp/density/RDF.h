@@ -10,13 +10,17 @@
 #define __APPLE__
 
 #include <memory>
+#include <stdint.h>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "box.h"
 #include "Index1D.h"
+#include "ThreadLocalHistogram.h"
+#include "BlockAverage.h"
 
 #ifndef _RDF_H__
 #define _RDF_H__
@@ -44,20 +48,64 @@ class RDF
         //! Reset the PCF array to all zeros
         void resetRDF();
 
+        //! Keep the counts of up to num_blocks blocks of frames for the standard error of the rdf, or none if 0;
+        //! resets the rdf
+        void setNumBlocks(unsigned int num_blocks);
+
+        //! Get the number of blocks kept for the standard error, 0 if none
+        unsigned int getNumBlocks() const
+            {
+            return m_blocks ? m_blocks->getNumBlocks() : 0;
+            }
+
+        //! Set how the threads count into the histogram (see util::HistogramMode), keeping the counts so far
+        void setHistogramMode(util::HistogramMode mode)
+            {
+            m_bin_counter.setMode(mode);
+            }
+
+        //! Get how the threads count into the histogram
+        util::HistogramMode getHistogramMode() const
+            {
+            return m_bin_counter.getMode();
+            }
+
         //! Compute the RDF
+        /*! If \a nlist is given, its bonds are used instead of building a cell list; bonds longer than rmax are
+            ignored.
+        */
         void accumulate(box::Box& box,
                         const vec3<float> *ref_points,
                         unsigned int n_ref,
                         const vec3<float> *points,
-                        unsigned int Np);
+                        unsigned int Np,
+                        const locality::NeighborList *nlist=NULL);
+
+        //! Compute the RDF of every frame of a trajectory
+        /*! The points of the frames follow each other, with frame f at points + f*Np and ref_points + f*n_ref. The
+            cell list of each frame is built while the previous frame is counted.
+        */
+        void accumulateTrajectory(box::Box *boxes,
+                                  const vec3<float> *ref_points,
+                                  unsigned int n_ref,
+                                  const vec3<float> *points,
+                                  unsigned int Np,
+                                  unsigned int n_frames);
 
         //! \internal
-        //! helper function to reduce the thread specific arrays into the boost array
+        //! helper function to fold the thread specific counts into the global histogram and normalize it
+        /*! The 32 bit counts of each thread are flushed into 64 bit totals, so each count is only summed once
+            however often the RDF is read; getRDF() and getNr() only call this when something was accumulated since
+            the last call.
+        */
         void reduceRDF();
 
         //! Get a reference to the last computed rdf
         std::shared_ptr<float> getRDF();
 
+        //! Get a reference to the standard error of the rdf, from the blocks of frames
+        std::shared_ptr<float> getRDFStandardError();
+
         //! Get a reference to the r array
         std::shared_ptr<float> getR();
 
@@ -67,24 +115,35 @@ class RDF
         unsigned int getNBins();
 
     private:
+        //! Count the pairs of one frame
+        void accumulateFrame(box::Box& box,
+                             const vec3<float> *ref_points,
+                             unsigned int n_ref,
+                             const vec3<float> *points,
+                             unsigned int Np,
+                             const locality::NeighborList *nlist);
+
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_rmax;                     //!< Maximum r at which to compute g(r)
         float m_dr;                       //!< Step size for r in the computation
         locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
+        locality::LinkCell* m_lc_next;     //!< LinkCell of the next frame of a trajectory
         unsigned int m_nbins;             //!< Number of r bins to compute g(r) over
         unsigned int m_n_ref;                  //!< number of reference particles
         unsigned int m_Np;                  //!< number of check particles
         unsigned int m_frame_counter;       //!< number of frames calc'd
+        bool m_reduce;                      //!< true if counts were accumulated since the last reduction
 
         std::shared_ptr<float> m_rdf_array;         //!< rdf array computed
-        std::shared_ptr<unsigned int> m_bin_counts; //!< bin counts that go into computing the rdf array
         std::shared_ptr<float> m_avg_counts; //!< bin counts that go into computing the rdf array
         std::shared_ptr<float> m_N_r_array;         //!< Cumulative bin sum N(r)
         std::shared_ptr<float> m_r_array;           //!< array of r values that the rdf is computed at
         std::shared_ptr<float> m_vol_array;         //!< array of volumes for each slice of r
         std::shared_ptr<float> m_vol_array2D;         //!< array of volumes for each slice of r
         std::shared_ptr<float> m_vol_array3D;         //!< array of volumes for each slice of r
-        tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
+        util::ThreadLocalHistogram<uint32_t> m_bin_counter;   //!< pair counts of each bin since the last reset
+        std::shared_ptr<util::BlockAverage> m_blocks;   //!< counts of blocks of frames, if the error is computed
+        std::shared_ptr<float> m_rdf_error;         //!< standard error of the rdf
     };
 
 }; }; // end namespace freud::density
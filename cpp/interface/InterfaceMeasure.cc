@@ -16,6 +16,7 @@ InterfaceMeasure::InterfaceMeasure(const box::Box& box, float r_cut)
     {
         if (r_cut < 0.0f)
             throw invalid_argument("r_cut must be positive");
+        m_lc.setSortPoints(true);
     }
 
 // unsigned int InterfaceMeasure::compute(const float3 *ref_points,
@@ -25,63 +26,32 @@ InterfaceMeasure::InterfaceMeasure(const box::Box& box, float r_cut)
 unsigned int InterfaceMeasure::compute(const vec3<float> *ref_points,
                                        unsigned int n_ref,
                                        const vec3<float> *points,
-                                       unsigned int Np)
+                                       unsigned int Np,
+                                       const locality::NeighborList *nlist)
 {
     assert(ref_points);
     assert(points);
     assert(n_ref > 0);
     assert(Np > 0);
 
-    // bin the second set of points
-    m_lc.computeCellList(m_box, points, Np);
+    // bin the second set of points, unless the neighbors were already found
+    if (nlist != NULL)
+        nlist->validate(n_ref, Np);
+    else
+        m_lc.computeCellList(m_box, points, Np);
+    const locality::DistanceKernel kernel(m_box, m_rcut);
+    std::vector<unsigned int> neighbors;
+    std::vector< vec3<float> > deltas;
 
     unsigned int interfaceCount = 0;
-    float rcutsq = m_rcut * m_rcut;
 
     // for each reference point
     for( unsigned int i = 0; i < n_ref; i++)
     {
-        bool inInterface = false;
-
-        // get the cell the point is in
-        // float3 ref = ref_points[i];
+        // a reference point is in the interface if any point is within the cutoff
         vec3<float> ref = ref_points[i];
-        unsigned int ref_cell = m_lc.getCell(ref);
-
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
-        {
-            if(inInterface)
-                break;
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
-            {
-                if(inInterface)
-                    break;
-                vec3<float> delta = ref - points[j];
-                // compute the distance between the two particles
-                // float dx = float(ref.x - points[j].x);
-                // float dy = float(ref.y - points[j].y);
-                // float dz = float(ref.z - points[j].z);
-
-                delta = m_box.wrap(delta);
-
-                // Check if the distance is less than the cutoff
-                // float deltasq = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
-                float rsq = dot(delta, delta);
-                // if (deltasq < rcutsq)
-                if (rsq < rcutsq)
-                {
-                    inInterface = true;
-                    break;
-                }
-            }
-        }
-        if(inInterface)
+        m_lc.getNeighbors(ref, i, nlist, points, kernel, neighbors, deltas);
+        if(!neighbors.empty())
             interfaceCount++;
     }
     return interfaceCount;
@@ -8,6 +8,7 @@
 
 #include "box.h"
 #include "LinkCell.h"
+#include "NeighborList.h"
 
 #ifndef _INTERFACEMEASURE_H_
 #define _INTERFACEMEASURE_H_
@@ -47,7 +48,8 @@ class InterfaceMeasure
         unsigned int compute(const vec3<float> *ref_points,
                              unsigned int n_ref,
                              const vec3<float> *points,
-                             unsigned int Np);
+                             unsigned int Np,
+                             const locality::NeighborList *nlist=NULL);
 
         // //! Python wrapper for compute
         // unsigned int computePy(boost::python::numeric::array ref_points,
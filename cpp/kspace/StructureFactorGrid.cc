@@ -0,0 +1,250 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "StructureFactorGrid.h"
+#include "ScopedGILRelease.h"
+
+#include <stdexcept>
+#include <cmath>
+#include <tbb/tbb.h>
+
+using namespace std;
+
+using namespace tbb;
+
+/*! \file StructureFactorGrid.cc
+    \brief Static structure factor of the whole periodic box from a fast Fourier transform of the density
+*/
+
+namespace freud { namespace kspace {
+
+//! \internal
+/*! \brief Nodes and weights that a point at grid coordinate u is spread over along one direction
+    \param u position in units of the node spacing; node i is at u = i
+    \param n number of nodes along the direction
+    \param order 1 (nearest grid point), 2 (cloud in cell) or 3 (triangular shaped cloud)
+    \param idx receives the (periodically wrapped) nodes
+    \param w receives the weights, which sum to 1
+*/
+static inline void assignmentWeights(float u, int n, unsigned int order, unsigned int *idx, float *w)
+    {
+    int first;
+    if (order == 1)
+        {
+        first = int(floorf(u + 0.5f));
+        w[0] = 1.0f;
+        }
+    else if (order == 2)
+        {
+        first = int(floorf(u));
+        float d = u - float(first);
+        w[0] = 1.0f - d;
+        w[1] = d;
+        }
+    else
+        {
+        int center = int(floorf(u + 0.5f));
+        float d = u - float(center);
+        first = center - 1;
+        w[0] = 0.5f * (0.5f - d) * (0.5f - d);
+        w[1] = 0.75f - d * d;
+        w[2] = 0.5f * (0.5f + d) * (0.5f + d);
+        }
+    for (unsigned int m = 0; m < order; m++)
+        idx[m] = (unsigned int)((((first + int(m)) % n) + n) % n);
+    }
+
+StructureFactorGrid::StructureFactorGrid(unsigned int width, float kmax, float dk, unsigned int order)
+    : m_box(box::Box()), m_width_x(width), m_width_y(width), m_width_z(width), m_kmax(kmax), m_dk(dk),
+      m_order(order), m_reduce(true), m_grid_sums(size_t(width) * width * width),
+      m_mode_counter(size_t(floorf(kmax / dk))), m_sk_sums(size_t(floorf(kmax / dk)))
+    {
+    initialize();
+    }
+
+StructureFactorGrid::StructureFactorGrid(unsigned int width_x, unsigned int width_y, unsigned int width_z,
+                                         float kmax, float dk, unsigned int order)
+    : m_box(box::Box()), m_width_x(width_x), m_width_y(width_y), m_width_z(width_z), m_kmax(kmax), m_dk(dk),
+      m_order(order), m_reduce(true), m_grid_sums(size_t(width_x) * width_y * width_z),
+      m_mode_counter(size_t(floorf(kmax / dk))), m_sk_sums(size_t(floorf(kmax / dk)))
+    {
+    initialize();
+    }
+
+void StructureFactorGrid::initialize()
+    {
+    if (m_width_x == 0 || m_width_y == 0 || m_width_z == 0)
+        throw invalid_argument("width must be a positive integer");
+    if (m_dk <= 0.0f)
+        throw invalid_argument("dk must be positive");
+    if (m_kmax <= 0.0f)
+        throw invalid_argument("kmax must be positive");
+    if (m_dk > m_kmax)
+        throw invalid_argument("kmax must be greater than dk");
+    if (m_order < 1 || m_order > 3)
+        throw invalid_argument("order must be 1 (NGP), 2 (CIC) or 3 (TSC)");
+
+    m_nbins = int(floorf(m_kmax / m_dk));
+    assert(m_nbins > 0);
+    m_sk_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    memset((void*)m_sk_array.get(), 0, sizeof(float)*m_nbins);
+
+    // the shell centers
+    m_k_array = std::shared_ptr<float>(new float[m_nbins], std::default_delete<float[]>());
+    for (unsigned int i = 0; i < m_nbins; i++)
+        m_k_array.get()[i] = (float(i) + 0.5f) * m_dk;
+    }
+
+//! \internal
+//! helper function to average the shells
+void StructureFactorGrid::reduceStructureFactor()
+    {
+    m_mode_counter.flush();
+    m_sk_sums.flush();
+    const uint64_t *counts = m_mode_counter.getTotals().get();
+    const double *sk_sums = m_sk_sums.getTotals().get();
+    for (unsigned int i = 0; i < m_nbins; i++)
+        m_sk_array.get()[i] = counts[i] ? float(sk_sums[i] / double(counts[i])) : 0.0f;
+    }
+
+//! Get a reference to the shell averaged structure factor
+std::shared_ptr<float> StructureFactorGrid::getStructureFactor()
+    {
+    if (m_reduce == true)
+        {
+        reduceStructureFactor();
+        }
+    m_reduce = false;
+    return m_sk_array;
+    }
+
+//! \internal
+/*! \brief Function to reset the structure factor
+*/
+void StructureFactorGrid::resetStructureFactor()
+    {
+    m_mode_counter.reset();
+    m_sk_sums.reset();
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Spread the points over the grid nodes and store the node totals in m_grid
+*/
+void StructureFactorGrid::assignPoints(const vec3<float> *points, unsigned int Np)
+    {
+    m_grid_sums.reset();
+    const Index3D gi = m_gi;
+    const unsigned int order = m_order;
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        util::ThreadLocalHistogram<double>::Accessor local_grid = m_grid_sums.local();
+        unsigned int ix[3], iy[3], iz[3];
+        float wx[3], wy[3], wz[3];
+        for (size_t p = r.begin(); p != r.end(); p++)
+            {
+            // fractional coordinates are periodic with period 1 in every direction, also in tilted boxes
+            vec3<float> f = m_box.makeFraction(points[p]);
+            assignmentWeights(f.x * gi.getW(), gi.getW(), order, ix, wx);
+            assignmentWeights(f.y * gi.getH(), gi.getH(), order, iy, wy);
+            assignmentWeights(f.z * gi.getD(), gi.getD(), order, iz, wz);
+            for (unsigned int c = 0; c < order; c++)
+                for (unsigned int b = 0; b < order; b++)
+                    {
+                    float wyz = wy[b] * wz[c];
+                    for (unsigned int a = 0; a < order; a++)
+                        local_grid[gi(ix[a], iy[b], iz[c])] += wx[a] * wyz;
+                    }
+            }
+        });
+    m_grid_sums.flush();
+
+    const double *grid_sums = m_grid_sums.getTotals().get();
+    m_grid.resize(gi.getNumElements());
+    for (size_t g = 0; g < gi.getNumElements(); g++)
+        m_grid[g] = complex<double>(grid_sums[g], 0.0);
+    }
+
+//! \internal
+/*! \brief Function to add the wave vectors of one frame to the structure factor
+*/
+void StructureFactorGrid::accumulate(const box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    m_box = box;
+    if (Np == 0)
+        return;
+
+    unsigned int width_z = m_box.is2D() ? 1 : m_width_z;
+    if (!m_fft || m_gi.getW() != m_width_x || m_gi.getH() != m_width_y || m_gi.getD() != width_z)
+        {
+        m_gi = Index3D(m_width_x, m_width_y, width_z);
+        m_fft = std::shared_ptr<util::FFT3D>(new util::FFT3D(m_width_x, m_width_y, width_z));
+        }
+
+    assignPoints(points, Np);
+    m_fft->forward(&m_grid[0]);
+
+    // reciprocal vectors b_i with a_i . b_j = 2 pi delta_ij, so that h b_1 + k b_2 + l b_3 is periodic in the box
+    vec3<double> a[3];
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        vec3<float> v = (d == 2 && m_box.is2D()) ? vec3<float>(0, 0, 1) : m_box.getLatticeVector(d);
+        a[d] = vec3<double>(v.x, v.y, v.z);
+        }
+    double volume = dot(a[0], cross(a[1], a[2]));
+    const vec3<double> b0 = cross(a[1], a[2]) * (2.0 * M_PI / volume);
+    const vec3<double> b1 = cross(a[2], a[0]) * (2.0 * M_PI / volume);
+    const vec3<double> b2 = cross(a[0], a[1]) * (2.0 * M_PI / volume);
+
+    // signed frequency of each node along each direction, and the inverse of the squared assignment window of
+    // that frequency, or 0 at the Nyquist frequency of even grids and beyond
+    const Index3D gi = m_gi;
+    const unsigned int n[3] = {gi.getW(), gi.getH(), gi.getD()};
+    std::vector<int> freq[3];
+    std::vector<double> deconv[3];
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        freq[d].resize(n[d]);
+        deconv[d].resize(n[d]);
+        for (unsigned int i = 0; i < n[d]; i++)
+            {
+            int f = (2 * i <= n[d]) ? int(i) : int(i) - int(n[d]);
+            double x = M_PI * double(f) / double(n[d]);
+            double window = (f == 0) ? 1.0 : pow(sin(x) / x, int(m_order));
+            freq[d][i] = f;
+            deconv[d][i] = (2 * abs(f) >= int(n[d]) && n[d] > 1) ? 0.0 : 1.0 / (window * window);
+            }
+        }
+    const int *freq_x = &freq[0][0], *freq_y = &freq[1][0], *freq_z = &freq[2][0];
+    const double *deconv_x = &deconv[0][0], *deconv_y = &deconv[1][0], *deconv_z = &deconv[2][0];
+
+    const double inv_Np = 1.0 / double(Np);
+    const complex<double> *rho = &m_grid[0];
+    m_mode_counter.beginFrame(gi.getNumElements());
+    parallel_for(blocked_range<size_t>(0, gi.getNumElements()),
+        [=] (const blocked_range<size_t>& r)
+        {
+        util::ThreadLocalHistogram<uint32_t>::Accessor local_counts = m_mode_counter.local();
+        util::ThreadLocalHistogram<double>::Accessor local_sums = m_sk_sums.local();
+        for (size_t g = r.begin(); g != r.end(); g++)
+            {
+            vec3<unsigned int> node = gi(g);
+            double deconv_xyz = deconv_x[node.x] * deconv_y[node.y] * deconv_z[node.z];
+            if (deconv_xyz == 0.0 || g == 0)
+                continue;
+
+            vec3<double> k = b0 * double(freq_x[node.x]) + b1 * double(freq_y[node.y]) + b2 * double(freq_z[node.z]);
+            double kmag = sqrt(dot(k, k));
+            unsigned int bin = (kmag < m_kmax) ? (unsigned int)(kmag / m_dk) : m_nbins;
+            if (bin < m_nbins)
+                {
+                ++local_counts[bin];
+                local_sums[bin] += norm(rho[g]) * inv_Np * deconv_xyz;
+                }
+            }
+        });
+    m_reduce = true;
+    }
+
+}; }; // end namespace freud::kspace
@@ -0,0 +1,129 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <complex>
+#include <vector>
+#include <stdint.h>
+
+#include "HOOMDMath.h"
+#include "VectorMath.h"
+
+#include "box.h"
+#include "Index1D.h"
+#include "ThreadLocalHistogram.h"
+#include "FFT.h"
+
+#ifndef _STRUCTUREFACTORGRID_H__
+#define _STRUCTUREFACTORGRID_H__
+
+/*! \file StructureFactorGrid.h
+    \brief Static structure factor of the whole periodic box from a fast Fourier transform of the density
+*/
+
+namespace freud { namespace kspace {
+
+//! Computes the spherically averaged static structure factor S(|k|) on a grid
+/*! FTdelta evaluates rho(k) = sum_j exp(-i k.r_j) directly at a list of K points, which costs O(N NK). Here the
+    points are instead assigned to a periodic grid of width_x x width_y x width_z nodes spanning the box, and one
+    fast Fourier transform of the grid gives rho(k) at every wave vector of the box up to the Nyquist frequency of
+    the grid, in O(N + G log G) for G grid nodes. The wave vectors are k = h b_1 + k b_2 + l b_3 for the reciprocal
+    vectors b_i of the (possibly tilted) box.
+
+    The assignment spreads each point over the nearest 1 (NGP), 2 (CIC) or 3 (TSC) nodes in each direction, which
+    multiplies rho(k) by the window W(k) = prod_d sinc(pi h_d / n_d)^order. The transform is divided by W(k)
+    (deconvolution), so that S(k) = |rho(k)|^2 / N matches the direct sum well below the Nyquist frequency;
+    close to it, aliasing of the higher harmonics remains and finer grids or higher orders help.
+
+    S(k) of all wave vectors with 0 < |k| < kmax is averaged over spherical shells of width dk. Successive calls to
+    accumulate() add their wave vectors to the same averages. In 2D boxes the z direction of the grid is ignored.
+*/
+class StructureFactorGrid
+    {
+    public:
+        //! Constructor
+        StructureFactorGrid(unsigned int width, float kmax, float dk, unsigned int order);
+        StructureFactorGrid(unsigned int width_x, unsigned int width_y, unsigned int width_z,
+                            float kmax, float dk, unsigned int order);
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Reset the structure factor to all zeros
+        void resetStructureFactor();
+
+        //! Add the wave vectors of one frame to the structure factor
+        void accumulate(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! \internal
+        //! helper function to average the shells
+        void reduceStructureFactor();
+
+        //! Get a reference to the shell averaged structure factor
+        std::shared_ptr<float> getStructureFactor();
+
+        //! Get a reference to the number of wave vectors in each shell
+        std::shared_ptr<uint64_t> getCounts()
+            {
+            m_mode_counter.flush();
+            return m_mode_counter.getTotals();
+            }
+
+        //! Get a reference to the centers of the shells
+        std::shared_ptr<float> getK()
+            {
+            return m_k_array;
+            }
+
+        //! Get the number of shells
+        unsigned int getNBins() const
+            {
+            return m_nbins;
+            }
+
+        unsigned int getWidthX() const
+            {
+            return m_width_x;
+            }
+
+        unsigned int getWidthY() const
+            {
+            return m_width_y;
+            }
+
+        unsigned int getWidthZ() const
+            {
+            return m_width_z;
+            }
+
+    private:
+        //! Check the parameters and allocate the shells
+        void initialize();
+
+        //! Spread the points over the grid nodes, into m_grid
+        void assignPoints(const vec3<float> *points, unsigned int Np);
+
+        box::Box m_box;                         //!< Simulation box the particles belong in
+        unsigned int m_width_x, m_width_y, m_width_z;  //!< Number of grid nodes in each direction
+        float m_kmax;                           //!< Maximum |k| of the structure factor
+        float m_dk;                             //!< Width of the shells
+        unsigned int m_order;                   //!< Number of nodes each point is spread over in each direction
+        unsigned int m_nbins;                   //!< Number of shells
+        bool m_reduce;                          //!< Whether the shells need to be averaged
+        Index3D m_gi;                           //!< Grid indexer of the current frame
+        std::shared_ptr<util::FFT3D> m_fft;     //!< Transform of the grid, rebuilt when the grid shape changes
+
+        util::ThreadLocalHistogram<double> m_grid_sums;   //!< number of points assigned to each node
+        std::vector< std::complex<double> > m_grid;  //!< density grid and its transform
+        util::ThreadLocalHistogram<uint32_t> m_mode_counter;   //!< number of wave vectors in each shell
+        util::ThreadLocalHistogram<double> m_sk_sums;     //!< sum of S(k) over the wave vectors in each shell
+        std::shared_ptr<float> m_sk_array;      //!< shell averaged structure factor
+        std::shared_ptr<float> m_k_array;       //!< centers of the shells
+    };
+
+}; }; // end namespace freud::kspace
+
+#endif // _STRUCTUREFACTORGRID_H__
@@ -7,15 +7,82 @@
 #include <stdexcept>
 #include <cmath>
 #include <complex>
+#include <tbb/tbb.h>
 
 
 using namespace std;
 
+using namespace tbb;
+
 namespace freud { namespace kspace {
 
+//! \internal
+/*! \brief sin(x) and cos(x) from polynomials, with no branches so that loops over many x vectorize
+    The argument is reduced to r = x - q pi/2 with |r| <= pi/4 (pi/2 in three parts, so that the reduction stays
+    accurate for |x| up to ~10^5), and the quadrant q picks the sign and order of the polynomials of r. The error is
+    a few float ulp, like sinf() and cosf().
+*/
+static inline void sinCos(float x, float& s, float& c)
+    {
+    // nearest integer to 2x/pi, rounded by truncation since floorf() keeps the loops from vectorizing
+    int quadrant = int(x * float(M_2_PI) + (x < 0.0f ? -0.5f : 0.5f));
+    float q = float(quadrant);
+    float r = ((x - q * 1.5703125f) - q * 4.837512969970703125e-4f) - q * 7.54978995489188216e-8f;
+    float r2 = r * r;
+    float sin_r = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    float cos_r = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f
+                                                                              + r2 * 2.443315711809948e-5f));
+    float sin_x = (quadrant & 1) ? cos_r : sin_r;
+    float cos_x = (quadrant & 1) ? sin_r : cos_r;
+    s = (quadrant & 2) ? -sin_x : sin_x;
+    c = ((quadrant + 1) & 2) ? -cos_x : cos_x;
+    }
+
+//! \internal
+/*! \brief Sums of cos(K.r) and sin(K.r) over the points r
+    The points are taken in blocks of 16, each summed into its own lane, so that the compiler can run a whole block
+    through sinCos() in SIMD registers; the lanes are added up in double precision at the end.
+*/
+static void sumCosSin(const vec3<float>& K, const vec3<float> *r, unsigned int Np, double& sum_cos, double& sum_sin)
+    {
+    const unsigned int block = 16;
+    float lane_cos[block] = {0};
+    float lane_sin[block] = {0};
+    unsigned int j = 0;
+    for (; j + block <= Np; j += block)
+        {
+        for (unsigned int l = 0; l < block; l++)
+            {
+            float sin_d, cos_d;
+            sinCos(dot(K, r[j + l]), sin_d, cos_d);
+            lane_cos[l] += cos_d;
+            lane_sin[l] += sin_d;
+            }
+        }
+    for (unsigned int l = 0; j + l < Np; l++)
+        {
+        float sin_d, cos_d;
+        sinCos(dot(K, r[j + l]), sin_d, cos_d);
+        lane_cos[l] += cos_d;
+        lane_sin[l] += sin_d;
+        }
+
+    sum_cos = 0.0;
+    sum_sin = 0.0;
+    for (unsigned int l = 0; l < block; l++)
+        {
+        sum_cos += lane_cos[l];
+        sum_sin += lane_sin[l];
+        }
+    }
+
 FTdelta::FTdelta()
     : m_NK(0),
       m_Np(0),
+      m_K_data(NULL),
+      m_r_data(NULL),
+      m_q_data(NULL),
+      m_FT_data(NULL),
       m_density_Im(0),
       m_density_Re(1)
     {
@@ -23,8 +90,8 @@ FTdelta::FTdelta()
 
 FTdelta::~FTdelta()
     {
-    // S_Re and S_Im are boost::shared_array which need to be passed to Python and which should clean up after themselves.
-    // m_K, m_r, and m_q should point to arrays managed by the calling code.
+    // m_arr is a shared_ptr which is passed to Python and which should clean up after itself.
+    // Views given to computeView() are managed by the calling code.
     }
 
 void FTdelta::compute()
@@ -33,33 +100,24 @@ void FTdelta::compute()
        -> S_Re += cos(dot(K, r))
        -> S_Im += - sin(dot(K, r))
     */
-    unsigned int NK = m_NK;
     unsigned int Np = m_Np;
-    // float3* K = m_K;
-    // float3* r = m_r;
-    vec3<float>* K = &m_K.front();
-    vec3<float>* r = &m_r.front();
-    // float4* q = m_q;
+    const vec3<float>* K = m_K_data;
+    const vec3<float>* r = m_r_data;
     float density_Im = m_density_Im;
     float density_Re = m_density_Re;
-    m_S_Re = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    m_S_Im = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    memset((void*)m_S_Re.get(), 0, sizeof(float) * NK);
-    memset((void*)m_S_Im.get(), 0, sizeof(float) * NK);
-    for(unsigned int i=0; i < NK; i++)
+    complex<float> *FT = m_FT_data;
+    parallel_for(blocked_range<size_t>(0, m_NK),
+        [=] (const blocked_range<size_t>& range)
         {
-        for(unsigned int j=0; j < Np; j++)
+        for (size_t i = range.begin(); i != range.end(); i++)
             {
-            float d = dot(K[i], r[j]); // dot product of K and r
-            // d = K[i].x * r[j].x + K[i].y * r[j].y + K[i].z * r[j].z;
-            float CosKr, negSinKr; // real and (negative) imaginary components of exp(-i K r)
-            CosKr = cos(d);
-            negSinKr = sin(d);
-            // S += rho * exp(-i K r)
-            m_S_Re.get()[i] += CosKr * density_Re + negSinKr * density_Im;
-            m_S_Im.get()[i] += CosKr * density_Im - negSinKr * density_Re;
+            // S = rho * sum_j exp(-i K r_j) = rho * (sum_j cos(K r_j) - i sum_j sin(K r_j))
+            double CosKr, negSinKr;
+            sumCosSin(K[i], r, Np, CosKr, negSinKr);
+            FT[i] = complex<float>(CosKr * density_Re + negSinKr * density_Im,
+                                   CosKr * density_Im - negSinKr * density_Re);
             }
-        }
+        });
     }
 
 void FTdelta::computePy()
@@ -69,6 +127,42 @@ void FTdelta::computePy()
     compute();
     }
 
+/*! The K points, positions and orientations are read in place and the FT values are written straight to FT
+    (NK values), instead of copying them in with set_K() and set_rq() and out with getFT(). The arrays are only
+    borrowed while computeView() runs; the K points and particles set before are used again by later compute()
+    calls, and getFT() is not changed.
+*/
+void FTdelta::computeView(const vec3<float> *K, unsigned int NK, const vec3<float> *position,
+                          const quat<float> *orientation, unsigned int Np, complex<float> *FT)
+    {
+    m_K_data = K;
+    m_NK = NK;
+    m_r_data = position;
+    m_q_data = orientation;
+    m_Np = Np;
+    m_FT_data = FT;
+    try
+        {
+        compute();
+        }
+    catch (...)
+        {
+        restoreOwnedData();
+        throw;
+        }
+    restoreOwnedData();
+    }
+
+void FTdelta::restoreOwnedData()
+    {
+    m_K_data = m_K.data();
+    m_NK = m_K.size();
+    m_r_data = m_r.data();
+    m_q_data = m_q.data();
+    m_Np = m_r.size();
+    m_FT_data = m_arr.get();
+    }
+
 FTsphere::FTsphere()
     : m_radius(0.5f), m_volume(4.0f * M_PI * 0.125f / 3.0f)
     {
@@ -78,41 +172,37 @@ FTsphere::FTsphere()
 // Complex scattering amplitude S(K) = F(K) * f(K) for the structure factor F(K) and form factor f(K).
 void FTsphere::compute()
     {
-    unsigned int NK = m_NK;
     unsigned int Np = m_Np;
-    // float3* K = m_K;
-    // float3* r = m_r;
-    vec3<float>* K = &m_K.front();
-    vec3<float>* r = &m_r.front();
-    // float4* q = m_q;
+    const vec3<float>* K = m_K_data;
+    const vec3<float>* r = m_r_data;
     float radius = m_radius;
+    float volume = m_volume;
+    float density_Im = m_density_Im;
+    float density_Re = m_density_Re;
+    complex<float> *FT = m_FT_data;
 
     /* S += e**(-i * dot(K, r))
        -> S_Re += cos(dot(K, r))
        -> S_Im += - sin(dot(K, r))
     */
-    m_S_Re = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    m_S_Im = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    memset((void*)m_S_Re.get(), 0, sizeof(float) * NK);
-    memset((void*)m_S_Im.get(), 0, sizeof(float) * NK);
-    for(unsigned int i=0; i < NK; i++)
+    parallel_for(blocked_range<size_t>(0, m_NK),
+        [=] (const blocked_range<size_t>& range)
         {
-        for(unsigned int j=0; j < Np; j++)
+        for (size_t i = range.begin(); i != range.end(); i++)
             {
-            // Get form factor
+            // Get form factor, which is the same for all the particles
             // Initialize with scattering density
-            float f_Im(m_density_Im);
-            float f_Re(m_density_Re);
+            float f_Im(density_Im);
+            float f_Re(density_Re);
 
-            // float K2 = K[i].x * K[i].x + K[i].y * K[i].y + K[i].z * K[i].z;
             float K2 = dot(K[i], K[i]);
             // FT evaluated at K=0 is just the scattering volume
             // f(0) = volume
             // f(K) = (4.*pi*R) / K**2 * (sinc(K*R) - cos(K*R)))
             if (K2 == 0.0f)
                 {
-                f_Im *= m_volume;
-                f_Re *= m_volume;
+                f_Im *= volume;
+                f_Re *= volume;
                 }
             else
                 {
@@ -123,17 +213,13 @@ void FTsphere::compute()
                 }
 
             // Get structure factor
-            float CosKr, negSinKr; // real and (negative) imaginary components of exp(-i K r)
-            float d = dot(K[i], r[j]); // dot product of K and r
-            // d = K[i].x * r[j].x + K[i].y * r[j].y + K[i].z * r[j].z;
-            CosKr = cos(d);
-            negSinKr = sin(d);
-
-            // S += rho * f * exp(-i K r)
-            m_S_Re.get()[i] += CosKr * f_Re + negSinKr * f_Im;
-            m_S_Im.get()[i] += CosKr * f_Im - negSinKr * f_Re;
+            double CosKr, negSinKr; // sums of the real and (negative) imaginary components of exp(-i K r)
+            sumCosSin(K[i], r, Np, CosKr, negSinKr);
+
+            // S = rho * f * sum_j exp(-i K r_j)
+            FT[i] = complex<float>(CosKr * f_Re + negSinKr * f_Im, CosKr * f_Im - negSinKr * f_Re);
             }
-        }
+        });
     }
 
 FTpolyhedron::FTpolyhedron()
@@ -156,124 +242,123 @@ void FTpolyhedron::compute()
        -> S_Re += cos(dot(K, r))
        -> S_Im += - sin(dot(K, r))
     */
-    m_S_Re = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    m_S_Im = std::shared_ptr<float>(new float[NK], std::default_delete<float[]>());
-    memset((void*)m_S_Re.get(), 0, sizeof(float) * NK);
-    memset((void*)m_S_Im.get(), 0, sizeof(float) * NK);
     // For each K point
-    for(unsigned int K_idx=0; K_idx < NK; K_idx++)
+    parallel_for(blocked_range<size_t>(0, NK),
+        [=] (const blocked_range<size_t>& range)
         {
-        float S_Re(0.0f);
-        float S_Im(0.0f);
-        // For each particle
-        for(unsigned int p_idx=0; p_idx < Np; p_idx++)
+        for(size_t K_idx = range.begin(); K_idx != range.end(); K_idx++)
             {
-            vec3<float> r(m_r[p_idx]);
-            /* The FT of an object with orientation q at a given k-space point is the same as the FT
-               of the unrotated object at a k-space point rotated the opposite way.
-               The opposite of the rotation represented by a quaternion is the conjugate of the quaternion,
-               found by inverting the sign of the imaginary components.
-            */
-            quat<float> q(m_q[p_idx]);
-            vec3<float> K(m_K[K_idx]);
-            K = rotate(conj(q), K);
-
-            // Get form factor
-            // Initialize with scattering density
-            float f_Im(0.0f);
-            float f_Re(0.0f);
-
-            float K2 = dot(K,K);
-            // FT evaluated at K=0 is just the scattering volume
-            // f(0) = volume
-            if (K2 == 0.0f)
-                {
-                f_Re = m_params.volume;
-                f_Im = 0;
-                }
-            else
+            float S_Re(0.0f);
+            float S_Im(0.0f);
+            // For each particle
+            for(unsigned int p_idx=0; p_idx < Np; p_idx++)
                 {
-                // Use some calculus rules to rearrange into a loop over facets.
-
-                for(unsigned int facet_idx=0; facet_idx < N_facet; facet_idx++)
+                vec3<float> r(m_r_data[p_idx]);
+                /* The FT of an object with orientation q at a given k-space point is the same as the FT
+                   of the unrotated object at a k-space point rotated the opposite way.
+                   The opposite of the rotation represented by a quaternion is the conjugate of the quaternion,
+                   found by inverting the sign of the imaginary components.
+                */
+                quat<float> q(m_q_data[p_idx]);
+                vec3<float> K(m_K_data[K_idx]);
+                K = rotate(conj(q), K);
+
+                // Get form factor
+                // Initialize with scattering density
+                float f_Im(0.0f);
+                float f_Re(0.0f);
+
+                float K2 = dot(K,K);
+                // FT evaluated at K=0 is just the scattering volume
+                // f(0) = volume
+                if (K2 == 0.0f)
                     {
-                    // Project K into plane of face
-                    vec3<float> norm(m_params.norm[facet_idx]);
-                    float dotKnorm(dot(K,norm));
-                    vec3<float> K_proj = K - norm * dotKnorm;
-                    float K_proj2 = dot(K_proj, K_proj);
-
-                    // get polygon FT (may be accelerated in the future by converting to 2D)
-                    float f2D_Im(0.0f);
-                    float f2D_Re(0.0f);
-                    // FT evaluated at K_proj==0 is the scattering volume (area)
-                    if (K_proj2 == 0.0f)
-                        {
-                        f2D_Re = m_params.area[facet_idx];
-                        f2D_Im = 0;
-                        }
-                    else
+                    f_Re = m_params.volume;
+                    f_Im = 0;
+                    }
+                else
+                    {
+                    // Use some calculus rules to rearrange into a loop over facets.
+
+                    for(unsigned int facet_idx=0; facet_idx < N_facet; facet_idx++)
                         {
-                        // f2D = -i/k^2 * \sum_0^{Nfacets - 1) \hat(z) \cdot (l_n \times k) \exp(-ik \cdot c_n) \sinc (k \cdot l/2)
-                        // Noting that -i \exp(-i x) == \sin(x) - i \cos(x), we can get the real and imarginary parts as
-                        // For each element in the sum,
-                        // f_n = \hat(z) \cdot (l_n \times k) \sinc (k \cdot l/2) / k^2
-                        // f_Re = \sin(k \cdot c_n) * f_n
-                        // f_Im = - \cos(k \cdot c_n) * f_n
-                        unsigned int N_vert = m_params.facet[facet_idx].size();
-                        float f_n(0.0f);
-                        float K2inv = 1.0f/K_proj2;
-                        for(unsigned int edge_idx=0; edge_idx < N_vert; edge_idx++)
+                        // Project K into plane of face
+                        vec3<float> norm(m_params.norm[facet_idx]);
+                        float dotKnorm(dot(K,norm));
+                        vec3<float> K_proj = K - norm * dotKnorm;
+                        float K_proj2 = dot(K_proj, K_proj);
+
+                        // get polygon FT (may be accelerated in the future by converting to 2D)
+                        float f2D_Im(0.0f);
+                        float f2D_Re(0.0f);
+                        // FT evaluated at K_proj==0 is the scattering volume (area)
+                        if (K_proj2 == 0.0f)
                             {
-                            vec3<float> r0 = m_params.vert[m_params.facet[facet_idx][edge_idx]];
-                            unsigned int next_idx = edge_idx + 1;
-                            if (next_idx == N_vert) next_idx = 0;
-                            vec3<float> r1 = m_params.vert[m_params.facet[facet_idx][next_idx]];
-                            vec3<float> l_n = r1 - r0;
-                            vec3<float> c_n = (r1 + r0)*0.5f;
-                            float dotKc = dot(K_proj, c_n);
-                            float dotKl = dot(K_proj, l_n);
-                            vec3<float> crosslK = cross(l_n, K_proj);
-
-                            float x = dotKl*0.5f; // argument to sinc function
-//                            float x = dotKl; // argument to sinc function
-                            float sinc = 1.0;
-                            const float eps = 0.000001;
-                            if (fabs(x) > eps) sinc = sinf(x)/x;
-                            f_n = dot(norm, crosslK) * sinc * K2inv;
-                            f2D_Re -= sinf(dotKc) * f_n;
-                            f2D_Im -= cosf(dotKc) * f_n;
-                            } // end foreach edge
-                        }
-
-                    float d = m_params.d[facet_idx];
-
-                    // accumulate
-                    float re_exp = cosf(dotKnorm*d);
-                    float im_exp = -sinf(dotKnorm*d);
-                    f_Im += dotKnorm*(f2D_Re*re_exp-f2D_Im*im_exp);
-                    f_Re -= dotKnorm*(f2D_Im*re_exp+f2D_Re*im_exp);
-                    } // end for each facet
-
-                f_Re /= K2;
-                f_Im /= K2;
-                } // end if K != 0
-
-            // Get structure factor
-            float CosKr, negSinKr; // real and (negative) imaginary components of exp(-i K r)
-            float d = dot(K, rotate(conj(q),r)); // dot product of K and r (rotated back)
-            // d = K.x * r.x + K.y * r.y + K.z * r.z;
-            CosKr = cosf(d);
-            negSinKr = sinf(d);
-
-            // S += rho * f * exp(-i K r)
-            S_Re += CosKr * f_Re + negSinKr * f_Im;
-            S_Im += CosKr * f_Im - negSinKr * f_Re;
-            } // end for each ptl
-
-        m_S_Re.get()[K_idx] = S_Re * rho_Re - S_Im * rho_Im;
-        m_S_Im.get()[K_idx] = S_Re * rho_Im + S_Im * rho_Re;
-        } // end foreach K
+                            f2D_Re = m_params.area[facet_idx];
+                            f2D_Im = 0;
+                            }
+                        else
+                            {
+                            // f2D = -i/k^2 * \sum_0^{Nfacets - 1) \hat(z) \cdot (l_n \times k) \exp(-ik \cdot c_n) \sinc (k \cdot l/2)
+                            // Noting that -i \exp(-i x) == \sin(x) - i \cos(x), we can get the real and imarginary parts as
+                            // For each element in the sum,
+                            // f_n = \hat(z) \cdot (l_n \times k) \sinc (k \cdot l/2) / k^2
+                            // f_Re = \sin(k \cdot c_n) * f_n
+                            // f_Im = - \cos(k \cdot c_n) * f_n
+                            unsigned int N_vert = m_params.facet[facet_idx].size();
+                            float f_n(0.0f);
+                            float K2inv = 1.0f/K_proj2;
+                            for(unsigned int edge_idx=0; edge_idx < N_vert; edge_idx++)
+                                {
+                                vec3<float> r0 = m_params.vert[m_params.facet[facet_idx][edge_idx]];
+                                unsigned int next_idx = edge_idx + 1;
+                                if (next_idx == N_vert) next_idx = 0;
+                                vec3<float> r1 = m_params.vert[m_params.facet[facet_idx][next_idx]];
+                                vec3<float> l_n = r1 - r0;
+                                vec3<float> c_n = (r1 + r0)*0.5f;
+                                float dotKc = dot(K_proj, c_n);
+                                float dotKl = dot(K_proj, l_n);
+                                vec3<float> crosslK = cross(l_n, K_proj);
+
+                                float x = dotKl*0.5f; // argument to sinc function
+    //                            float x = dotKl; // argument to sinc function
+                                float sinc = 1.0;
+                                const float eps = 0.000001;
+                                if (fabs(x) > eps) sinc = sinf(x)/x;
+                                f_n = dot(norm, crosslK) * sinc * K2inv;
+                                f2D_Re -= sinf(dotKc) * f_n;
+                                f2D_Im -= cosf(dotKc) * f_n;
+                                } // end foreach edge
+                            }
+
+                        float d = m_params.d[facet_idx];
+
+                        // accumulate
+                        float re_exp = cosf(dotKnorm*d);
+                        float im_exp = -sinf(dotKnorm*d);
+                        f_Im += dotKnorm*(f2D_Re*re_exp-f2D_Im*im_exp);
+                        f_Re -= dotKnorm*(f2D_Im*re_exp+f2D_Re*im_exp);
+                        } // end for each facet
+
+                    f_Re /= K2;
+                    f_Im /= K2;
+                    } // end if K != 0
+
+                // Get structure factor
+                float CosKr, negSinKr; // real and (negative) imaginary components of exp(-i K r)
+                float d = dot(K, rotate(conj(q),r)); // dot product of K and r (rotated back)
+                // d = K.x * r.x + K.y * r.y + K.z * r.z;
+                CosKr = cosf(d);
+                negSinKr = sinf(d);
+
+                // S += rho * f * exp(-i K r)
+                S_Re += CosKr * f_Re + negSinKr * f_Im;
+                S_Im += CosKr * f_Im - negSinKr * f_Re;
+                } // end for each ptl
+
+            m_FT_data[K_idx] = complex<float>(S_Re * rho_Re - S_Im * rho_Im, S_Re * rho_Im + S_Im * rho_Re);
+            } // end foreach K
+        });
     }
 
 //! Helper function to build FTpolyhedron parameters
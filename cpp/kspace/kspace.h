@@ -4,6 +4,7 @@
 #include <memory>
 #include <complex>
 #include <vector>
+#include <algorithm>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
@@ -29,12 +30,17 @@ class FTdelta
         // void set_K(float3* K, unsigned int NK)
         void set_K(vec3<float>* K, unsigned int NK)
             {
-            m_NK = NK;
+            // initialize output array, which is reused by every compute() with the same number of K points
+            if (!m_arr || NK != m_K.size())
+                {
+                m_arr = std::shared_ptr< std::complex<float> >(new std::complex<float>[NK], std::default_delete<std::complex<float>[]>());
+                std::fill(m_arr.get(), m_arr.get() + NK, std::complex<float>(0.0f, 0.0f));
+                }
             m_K.resize(NK);
             std::copy(K, K+NK, m_K.begin());
-
-            // initialize output array
-            m_arr = std::shared_ptr< std::complex<float> >(new std::complex<float>[m_NK], std::default_delete<std::complex<float>[]>());
+            m_NK = NK;
+            m_K_data = m_K.data();
+            m_FT_data = m_arr.get();
             }
 
         // /*! Python wrapper to set_K
@@ -66,6 +72,8 @@ class FTdelta
             m_q.resize(Np);
             std::copy(position, position + Np, m_r.begin());
             std::copy(orientation, orientation + Np, m_q.begin());
+            m_r_data = m_r.data();
+            m_q_data = m_q.data();
             }
         // /*! Python wrapper to set_rq
         // \param position Np x 3 ndrray of particle position vectors
@@ -110,13 +118,13 @@ class FTdelta
         //! Python wrapper for compute method
         virtual void computePy();
 
+        //! Perform transform of caller owned arrays without copying them
+        void computeView(const vec3<float> *K, unsigned int NK, const vec3<float> *position,
+                         const quat<float> *orientation, unsigned int Np, std::complex<float> *FT);
+
         //! C++ interface to return the FT values
         std::shared_ptr< std::complex<float> > getFT()
             {
-            for(unsigned int i = 0; i < m_NK; i++)
-                {
-                m_arr.get()[i] = std::complex<float>(m_S_Re.get()[i], m_S_Im.get()[i]);
-                }
             return m_arr;
             }
 
@@ -132,14 +140,19 @@ class FTdelta
         //     }
 
     protected:
-        std::shared_ptr< std::complex<float> > m_arr;
-        std::shared_ptr<float> m_S_Re;  //!< Real component of structure factor
-        std::shared_ptr<float> m_S_Im;  //!< Imaginary component of structure factor
+        //! Point compute() back at the arrays given to set_K() and set_rq()
+        void restoreOwnedData();
+
+        std::shared_ptr< std::complex<float> > m_arr;  //!< FT values of the K points given to set_K
         unsigned int m_NK;                  //!< number of K points evaluated
         unsigned int m_Np;                  //!< number of particles (length of r and q arrays)
         std::vector<vec3<float> > m_K;      //!< array of K points
         std::vector<vec3<float> > m_r;      //!< array of particle positions
         std::vector<quat<float> > m_q;      //!< array of particle orientations
+        const vec3<float> *m_K_data;        //!< K points used by compute(): m_K, or borrowed by computeView()
+        const vec3<float> *m_r_data;        //!< particle positions used by compute()
+        const quat<float> *m_q_data;        //!< particle orientations used by compute()
+        std::complex<float> *m_FT_data;     //!< FT values written by compute(): m_arr, or borrowed by computeView()
         float m_density_Re;                 //!< real component of the scattering density
         float m_density_Im;                 //!< imaginary component of the scattering density
     };
@@ -0,0 +1,389 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+#include "DistanceKernel.h"
+
+using namespace std;
+
+/*! \file DistanceKernel.cc
+    \brief Batched minimum image distance tests between a point and a block of points
+*/
+
+namespace freud { namespace locality {
+
+DistanceKernel::DistanceKernel(const box::Box& box, float rmax, float dr)
+    : m_rmax(rmax), m_rmaxsq(rmax*rmax), m_dr_inv(1.0f/dr), m_L(box.getL()), m_hi(box.getL()/float(2.0)),
+      m_xy(box.getTiltFactorXY()), m_xz(box.getTiltFactorXZ()), m_yz(box.getTiltFactorYZ())
+    {
+    if (rmax < 0.0f)
+        throw invalid_argument("rmax must be positive");
+    if (dr <= 0.0f)
+        throw invalid_argument("dr must be positive");
+    uchar3 periodic = box.getPeriodic();
+    m_periodic_x = periodic.x;
+    m_periodic_y = periodic.y;
+    m_periodic_z = periodic.z;
+    }
+
+unsigned int DistanceKernel::getVectorWidth()
+    {
+    #if defined(__AVX512F__)
+    return 16;
+    #elif defined(__AVX__)
+    return 8;
+    #elif defined(__SSE2__)
+    return 4;
+    #else
+    return 1;
+    #endif
+    }
+
+unsigned int DistanceKernel::computeOne(float dx, float dy, float dz, unsigned int k, unsigned int *idx, float *r,
+                                        unsigned int *bins, vec3<float> *delta, bool wrap) const
+    {
+    // same steps as box::Box::minimalwrap
+    if (wrap && m_periodic_x)
+        {
+        float tilt_x = (m_xz - m_xy*m_yz) * dz + m_xy * dy;
+        if (dx >= m_hi.x + tilt_x)
+            dx -= m_L.x;
+        else if (dx < -m_hi.x + tilt_x)
+            dx += m_L.x;
+        }
+    if (wrap && m_periodic_y)
+        {
+        float tilt_y = m_yz * dz;
+        if (dy >= m_hi.y + tilt_y)
+            {
+            dy -= m_L.y;
+            dx -= m_L.y * m_xy;
+            }
+        else if (dy < -m_hi.y + tilt_y)
+            {
+            dy += m_L.y;
+            dx += m_L.y * m_xy;
+            }
+        }
+    if (wrap && m_periodic_z)
+        {
+        if (dz >= m_hi.z)
+            {
+            dz -= m_L.z;
+            dy -= m_L.z * m_yz;
+            dx -= m_L.z * m_xz;
+            }
+        else if (dz < -m_hi.z)
+            {
+            dz += m_L.z;
+            dy += m_L.z * m_yz;
+            dx += m_L.z * m_xz;
+            }
+        }
+
+    float rsq = dx*dx + dy*dy + dz*dz;
+    if (!(rsq < m_rmaxsq))
+        return 0;
+
+    idx[0] = k;
+    float rij = sqrtf(rsq);
+    if (r != NULL)
+        r[0] = rij;
+    if (bins != NULL)
+        {
+        float binr = rij * m_dr_inv;
+        #ifdef __SSE2__
+        bins[0] = _mm_cvtt_ss2si(_mm_load_ss(&binr));
+        #else
+        bins[0] = (unsigned int)(binr);
+        #endif
+        }
+    if (delta != NULL)
+        delta[0] = vec3<float>(dx, dy, dz);
+    return 1;
+    }
+
+unsigned int DistanceKernel::computeBlock(const vec3<float>& ref, const float *x, const float *y, const float *z,
+                                          unsigned int begin, unsigned int end, unsigned int *idx, float *r,
+                                          unsigned int *bins, vec3<float> *delta, bool wrap) const
+    {
+    unsigned int n = 0;
+    unsigned int k = begin;
+    const bool wrap_x = wrap && m_periodic_x;
+    const bool wrap_y = wrap && m_periodic_y;
+    const bool wrap_z = wrap && m_periodic_z;
+
+    #if defined(__AVX512F__)
+    const __m512 rx = _mm512_set1_ps(ref.x);
+    const __m512 ry = _mm512_set1_ps(ref.y);
+    const __m512 rz = _mm512_set1_ps(ref.z);
+    const __m512 Lx = _mm512_set1_ps(m_L.x);
+    const __m512 Ly = _mm512_set1_ps(m_L.y);
+    const __m512 Lz = _mm512_set1_ps(m_L.z);
+    const __m512 hix = _mm512_set1_ps(m_hi.x);
+    const __m512 hiy = _mm512_set1_ps(m_hi.y);
+    const __m512 hiz = _mm512_set1_ps(m_hi.z);
+    const __m512 lox = _mm512_set1_ps(-m_hi.x);
+    const __m512 loy = _mm512_set1_ps(-m_hi.y);
+    const __m512 loz = _mm512_set1_ps(-m_hi.z);
+    const __m512 tilt_xz = _mm512_set1_ps(m_xz - m_xy*m_yz);
+    const __m512 xy = _mm512_set1_ps(m_xy);
+    const __m512 yz = _mm512_set1_ps(m_yz);
+    const __m512 Lyxy = _mm512_set1_ps(m_L.y * m_xy);
+    const __m512 Lzyz = _mm512_set1_ps(m_L.z * m_yz);
+    const __m512 Lzxz = _mm512_set1_ps(m_L.z * m_xz);
+    const __m512 rmaxsq = _mm512_set1_ps(m_rmaxsq);
+    const __m512 dr_inv = _mm512_set1_ps(m_dr_inv);
+    const __m512i lane = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+
+    for (; k + 16 <= end; k += 16)
+        {
+        __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(x + k), rx);
+        __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(y + k), ry);
+        __m512 dz = _mm512_sub_ps(_mm512_loadu_ps(z + k), rz);
+
+        if (wrap_x)
+            {
+            __m512 tilt_x = _mm512_add_ps(_mm512_mul_ps(tilt_xz, dz), _mm512_mul_ps(xy, dy));
+            __mmask16 hi = _mm512_cmp_ps_mask(dx, _mm512_add_ps(hix, tilt_x), _CMP_GE_OQ);
+            __mmask16 lo = _mm512_cmp_ps_mask(dx, _mm512_add_ps(lox, tilt_x), _CMP_LT_OQ);
+            dx = _mm512_mask_sub_ps(dx, hi, dx, Lx);
+            dx = _mm512_mask_add_ps(dx, lo, dx, Lx);
+            }
+        if (wrap_y)
+            {
+            __m512 tilt_y = _mm512_mul_ps(yz, dz);
+            __mmask16 hi = _mm512_cmp_ps_mask(dy, _mm512_add_ps(hiy, tilt_y), _CMP_GE_OQ);
+            __mmask16 lo = _mm512_cmp_ps_mask(dy, _mm512_add_ps(loy, tilt_y), _CMP_LT_OQ);
+            dy = _mm512_mask_sub_ps(dy, hi, dy, Ly);
+            dx = _mm512_mask_sub_ps(dx, hi, dx, Lyxy);
+            dy = _mm512_mask_add_ps(dy, lo, dy, Ly);
+            dx = _mm512_mask_add_ps(dx, lo, dx, Lyxy);
+            }
+        if (wrap_z)
+            {
+            __mmask16 hi = _mm512_cmp_ps_mask(dz, hiz, _CMP_GE_OQ);
+            __mmask16 lo = _mm512_cmp_ps_mask(dz, loz, _CMP_LT_OQ);
+            dz = _mm512_mask_sub_ps(dz, hi, dz, Lz);
+            dy = _mm512_mask_sub_ps(dy, hi, dy, Lzyz);
+            dx = _mm512_mask_sub_ps(dx, hi, dx, Lzxz);
+            dz = _mm512_mask_add_ps(dz, lo, dz, Lz);
+            dy = _mm512_mask_add_ps(dy, lo, dy, Lzyz);
+            dx = _mm512_mask_add_ps(dx, lo, dx, Lzxz);
+            }
+
+        __m512 rsq = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy)),
+                                   _mm512_mul_ps(dz, dz));
+        __mmask16 in_range = _mm512_cmp_ps_mask(rsq, rmaxsq, _CMP_LT_OQ);
+        if (!in_range)
+            continue;
+
+        // compact the points within the cutoff to the front of the outputs; the zero-masked forms leave no lane
+        // undefined
+        __m512 rij = _mm512_maskz_sqrt_ps(in_range, rsq);
+        _mm512_mask_compressstoreu_epi32(idx + n, in_range, _mm512_add_epi32(_mm512_set1_epi32(k), lane));
+        if (r != NULL)
+            _mm512_mask_compressstoreu_ps(r + n, in_range, rij);
+        if (bins != NULL)
+            {
+            __m512i rbins = _mm512_maskz_cvttps_epi32(in_range, _mm512_mul_ps(rij, dr_inv));
+            _mm512_mask_compressstoreu_epi32(bins + n, in_range, rbins);
+            }
+        unsigned int count = __builtin_popcount(in_range);
+        if (delta != NULL)
+            {
+            float cdx[16], cdy[16], cdz[16];
+            _mm512_mask_compressstoreu_ps(cdx, in_range, dx);
+            _mm512_mask_compressstoreu_ps(cdy, in_range, dy);
+            _mm512_mask_compressstoreu_ps(cdz, in_range, dz);
+            for (unsigned int m = 0; m < count; ++m)
+                delta[n + m] = vec3<float>(cdx[m], cdy[m], cdz[m]);
+            }
+        n += count;
+        }
+    #elif defined(__AVX__)
+    const __m256 rx = _mm256_set1_ps(ref.x);
+    const __m256 ry = _mm256_set1_ps(ref.y);
+    const __m256 rz = _mm256_set1_ps(ref.z);
+    const __m256 Lx = _mm256_set1_ps(m_L.x);
+    const __m256 Ly = _mm256_set1_ps(m_L.y);
+    const __m256 Lz = _mm256_set1_ps(m_L.z);
+    const __m256 hix = _mm256_set1_ps(m_hi.x);
+    const __m256 hiy = _mm256_set1_ps(m_hi.y);
+    const __m256 hiz = _mm256_set1_ps(m_hi.z);
+    const __m256 lox = _mm256_set1_ps(-m_hi.x);
+    const __m256 loy = _mm256_set1_ps(-m_hi.y);
+    const __m256 loz = _mm256_set1_ps(-m_hi.z);
+    const __m256 tilt_xz = _mm256_set1_ps(m_xz - m_xy*m_yz);
+    const __m256 xy = _mm256_set1_ps(m_xy);
+    const __m256 yz = _mm256_set1_ps(m_yz);
+    const __m256 Lyxy = _mm256_set1_ps(m_L.y * m_xy);
+    const __m256 Lzyz = _mm256_set1_ps(m_L.z * m_yz);
+    const __m256 Lzxz = _mm256_set1_ps(m_L.z * m_xz);
+    const __m256 rmaxsq = _mm256_set1_ps(m_rmaxsq);
+    const __m256 dr_inv = _mm256_set1_ps(m_dr_inv);
+
+    for (; k + 8 <= end; k += 8)
+        {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + k), rx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + k), ry);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + k), rz);
+
+        // the wrap masks are all ones or all zeros, so and-ing them with a shift applies it conditionally
+        if (wrap_x)
+            {
+            __m256 tilt_x = _mm256_add_ps(_mm256_mul_ps(tilt_xz, dz), _mm256_mul_ps(xy, dy));
+            __m256 hi = _mm256_cmp_ps(dx, _mm256_add_ps(hix, tilt_x), _CMP_GE_OQ);
+            __m256 lo = _mm256_cmp_ps(dx, _mm256_add_ps(lox, tilt_x), _CMP_LT_OQ);
+            dx = _mm256_add_ps(_mm256_sub_ps(dx, _mm256_and_ps(hi, Lx)), _mm256_and_ps(lo, Lx));
+            }
+        if (wrap_y)
+            {
+            __m256 tilt_y = _mm256_mul_ps(yz, dz);
+            __m256 hi = _mm256_cmp_ps(dy, _mm256_add_ps(hiy, tilt_y), _CMP_GE_OQ);
+            __m256 lo = _mm256_cmp_ps(dy, _mm256_add_ps(loy, tilt_y), _CMP_LT_OQ);
+            dy = _mm256_add_ps(_mm256_sub_ps(dy, _mm256_and_ps(hi, Ly)), _mm256_and_ps(lo, Ly));
+            dx = _mm256_add_ps(_mm256_sub_ps(dx, _mm256_and_ps(hi, Lyxy)), _mm256_and_ps(lo, Lyxy));
+            }
+        if (wrap_z)
+            {
+            __m256 hi = _mm256_cmp_ps(dz, hiz, _CMP_GE_OQ);
+            __m256 lo = _mm256_cmp_ps(dz, loz, _CMP_LT_OQ);
+            dz = _mm256_add_ps(_mm256_sub_ps(dz, _mm256_and_ps(hi, Lz)), _mm256_and_ps(lo, Lz));
+            dy = _mm256_add_ps(_mm256_sub_ps(dy, _mm256_and_ps(hi, Lzyz)), _mm256_and_ps(lo, Lzyz));
+            dx = _mm256_add_ps(_mm256_sub_ps(dx, _mm256_and_ps(hi, Lzxz)), _mm256_and_ps(lo, Lzxz));
+            }
+
+        __m256 rsq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                   _mm256_mul_ps(dz, dz));
+        int in_range = _mm256_movemask_ps(_mm256_cmp_ps(rsq, rmaxsq, _CMP_LT_OQ));
+        if (!in_range)
+            continue;
+
+        // compact the points within the cutoff to the front of the outputs
+        float lr[8], ldx[8], ldy[8], ldz[8];
+        int lbins[8];
+        __m256 rij = _mm256_sqrt_ps(rsq);
+        _mm256_storeu_ps(lr, rij);
+        _mm256_storeu_si256((__m256i*)lbins, _mm256_cvttps_epi32(_mm256_mul_ps(rij, dr_inv)));
+        if (delta != NULL)
+            {
+            _mm256_storeu_ps(ldx, dx);
+            _mm256_storeu_ps(ldy, dy);
+            _mm256_storeu_ps(ldz, dz);
+            }
+        while (in_range)
+            {
+            int m = __builtin_ctz(in_range);
+            in_range &= in_range - 1;
+            idx[n] = k + m;
+            if (r != NULL)
+                r[n] = lr[m];
+            if (bins != NULL)
+                bins[n] = lbins[m];
+            if (delta != NULL)
+                delta[n] = vec3<float>(ldx[m], ldy[m], ldz[m]);
+            n++;
+            }
+        }
+    #elif defined(__SSE2__)
+    const __m128 rx = _mm_set1_ps(ref.x);
+    const __m128 ry = _mm_set1_ps(ref.y);
+    const __m128 rz = _mm_set1_ps(ref.z);
+    const __m128 Lx = _mm_set1_ps(m_L.x);
+    const __m128 Ly = _mm_set1_ps(m_L.y);
+    const __m128 Lz = _mm_set1_ps(m_L.z);
+    const __m128 hix = _mm_set1_ps(m_hi.x);
+    const __m128 hiy = _mm_set1_ps(m_hi.y);
+    const __m128 hiz = _mm_set1_ps(m_hi.z);
+    const __m128 lox = _mm_set1_ps(-m_hi.x);
+    const __m128 loy = _mm_set1_ps(-m_hi.y);
+    const __m128 loz = _mm_set1_ps(-m_hi.z);
+    const __m128 tilt_xz = _mm_set1_ps(m_xz - m_xy*m_yz);
+    const __m128 xy = _mm_set1_ps(m_xy);
+    const __m128 yz = _mm_set1_ps(m_yz);
+    const __m128 Lyxy = _mm_set1_ps(m_L.y * m_xy);
+    const __m128 Lzyz = _mm_set1_ps(m_L.z * m_yz);
+    const __m128 Lzxz = _mm_set1_ps(m_L.z * m_xz);
+    const __m128 rmaxsq = _mm_set1_ps(m_rmaxsq);
+    const __m128 dr_inv = _mm_set1_ps(m_dr_inv);
+
+    for (; k + 4 <= end; k += 4)
+        {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + k), rx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + k), ry);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + k), rz);
+
+        // the wrap masks are all ones or all zeros, so and-ing them with a shift applies it conditionally
+        if (wrap_x)
+            {
+            __m128 tilt_x = _mm_add_ps(_mm_mul_ps(tilt_xz, dz), _mm_mul_ps(xy, dy));
+            __m128 hi = _mm_cmpge_ps(dx, _mm_add_ps(hix, tilt_x));
+            __m128 lo = _mm_cmplt_ps(dx, _mm_add_ps(lox, tilt_x));
+            dx = _mm_add_ps(_mm_sub_ps(dx, _mm_and_ps(hi, Lx)), _mm_and_ps(lo, Lx));
+            }
+        if (wrap_y)
+            {
+            __m128 tilt_y = _mm_mul_ps(yz, dz);
+            __m128 hi = _mm_cmpge_ps(dy, _mm_add_ps(hiy, tilt_y));
+            __m128 lo = _mm_cmplt_ps(dy, _mm_add_ps(loy, tilt_y));
+            dy = _mm_add_ps(_mm_sub_ps(dy, _mm_and_ps(hi, Ly)), _mm_and_ps(lo, Ly));
+            dx = _mm_add_ps(_mm_sub_ps(dx, _mm_and_ps(hi, Lyxy)), _mm_and_ps(lo, Lyxy));
+            }
+        if (wrap_z)
+            {
+            __m128 hi = _mm_cmpge_ps(dz, hiz);
+            __m128 lo = _mm_cmplt_ps(dz, loz);
+            dz = _mm_add_ps(_mm_sub_ps(dz, _mm_and_ps(hi, Lz)), _mm_and_ps(lo, Lz));
+            dy = _mm_add_ps(_mm_sub_ps(dy, _mm_and_ps(hi, Lzyz)), _mm_and_ps(lo, Lzyz));
+            dx = _mm_add_ps(_mm_sub_ps(dx, _mm_and_ps(hi, Lzxz)), _mm_and_ps(lo, Lzxz));
+            }
+
+        __m128 rsq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        int in_range = _mm_movemask_ps(_mm_cmplt_ps(rsq, rmaxsq));
+        if (!in_range)
+            continue;
+
+        // compact the points within the cutoff to the front of the outputs
+        float lr[4], ldx[4], ldy[4], ldz[4];
+        int lbins[4];
+        __m128 rij = _mm_sqrt_ps(rsq);
+        _mm_storeu_ps(lr, rij);
+        _mm_storeu_si128((__m128i*)lbins, _mm_cvttps_epi32(_mm_mul_ps(rij, dr_inv)));
+        if (delta != NULL)
+            {
+            _mm_storeu_ps(ldx, dx);
+            _mm_storeu_ps(ldy, dy);
+            _mm_storeu_ps(ldz, dz);
+            }
+        while (in_range)
+            {
+            int m = __builtin_ctz(in_range);
+            in_range &= in_range - 1;
+            idx[n] = k + m;
+            if (r != NULL)
+                r[n] = lr[m];
+            if (bins != NULL)
+                bins[n] = lbins[m];
+            if (delta != NULL)
+                delta[n] = vec3<float>(ldx[m], ldy[m], ldz[m]);
+            n++;
+            }
+        }
+    #endif
+
+    // remainder of the block (or all of it without SIMD)
+    for (; k < end; ++k)
+        {
+        n += computeOne(x[k] - ref.x, y[k] - ref.y, z[k] - ref.z, k, idx + n, (r != NULL) ? r + n : NULL,
+                        (bins != NULL) ? bins + n : NULL, (delta != NULL) ? delta + n : NULL, wrap);
+        }
+    return n;
+    }
+
+}; }; // end namespace freud::locality
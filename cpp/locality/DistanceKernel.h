@@ -0,0 +1,117 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "../box/box.h"
+#include "VectorMath.h"
+
+#ifndef _DISTANCE_KERNEL_H__
+#define _DISTANCE_KERNEL_H__
+
+/*! \file DistanceKernel.h
+    \brief Batched minimum image distance tests between a point and a block of points
+*/
+
+namespace freud { namespace locality {
+
+//! Batched minimum image distance test between one reference point and a block of points
+/*! Neighbor loops spend most of their time wrapping bond vectors into the box and comparing their lengths with a
+    cutoff, one pair at a time. DistanceKernel does this for a whole block of points stored as separate x, y and z
+    arrays (structure of arrays, see LinkCell::getSortedX()), using the widest SIMD instruction set the code is
+    compiled for: AVX-512 (16 points per instruction), AVX/AVX2 (8), SSE2 (4) or plain scalar code. The minimum image
+    convention is applied the same way as in box::Box::wrap(), tilt factors included.
+
+    The points of the block within the cutoff are returned as a compacted list: their indices in the block arrays,
+    and optionally their distances, the histogram bin of each distance, and the wrapped bond vectors.
+
+    A loop over the neighbors of ref in cell c of a LinkCell can be accomplished with the following code in c++.
+\code
+ unsigned int n = kernel.compute(ref, lc.getSortedX(), lc.getSortedY(), lc.getSortedZ(),
+                                 lc.getCellOffsets()[c], lc.getCellOffsets()[c+1], idx, r);
+ for (unsigned int m = 0; m < n; ++m)
+     {
+     unsigned int j = lc.getCellIndices()[idx[m]];
+     // do something with the pair (ref, j) at distance r[m]
+     }
+\endcode
+*/
+class DistanceKernel
+    {
+    public:
+        //! Constructor
+        /*! \param box Simulation box
+            \param rmax Cutoff; points at a distance of rmax or more are rejected
+            \param dr Bin width used to bin the distances when bins are requested
+        */
+        DistanceKernel(const box::Box& box, float rmax, float dr=1.0f);
+
+        //! Get the cutoff
+        float getRMax() const
+            {
+            return m_rmax;
+            }
+
+        //! Get the number of points tested per instruction
+        static unsigned int getVectorWidth();
+
+        //! Find the points of a block that are within the cutoff of ref
+        /*! Tests the points (x[k], y[k], z[k]) for k in [begin, end).
+
+            \param ref Reference point
+            \param x x coordinates of the points
+            \param y y coordinates of the points
+            \param z z coordinates of the points
+            \param begin First point of the block
+            \param end One past the last point of the block
+            \param idx Output: index k of each point within the cutoff
+            \param r Output (may be NULL): distance of each of those points
+            \param bins Output (may be NULL): bin (unsigned int)(r/dr) of each of those points
+            \param delta Output (may be NULL): minimum image bond vector from ref to each of those points
+            \returns The number of points within the cutoff
+
+            Each output array must have room for end - begin entries.
+        */
+        unsigned int compute(const vec3<float>& ref, const float *x, const float *y, const float *z,
+                             unsigned int begin, unsigned int end, unsigned int *idx, float *r,
+                             unsigned int *bins=NULL, vec3<float> *delta=NULL) const
+            {
+            return computeBlock(ref, x, y, z, begin, end, idx, r, bins, delta, true);
+            }
+
+        //! Find the points of a block that are within the cutoff of ref, without the minimum image wrap
+        /*! Same as compute(), but the bond vectors are the plain differences of the positions. This is for blocks
+            whose points are known to be in the periodic image closest to ref, such as a neighbor cell of a
+            LinkCell with ref translated by CellNeighbors::getShift().
+        */
+        unsigned int computeImage(const vec3<float>& ref, const float *x, const float *y, const float *z,
+                                  unsigned int begin, unsigned int end, unsigned int *idx, float *r,
+                                  unsigned int *bins=NULL, vec3<float> *delta=NULL) const
+            {
+            return computeBlock(ref, x, y, z, begin, end, idx, r, bins, delta, false);
+            }
+
+    private:
+        //! Implementation of compute() and computeImage()
+        unsigned int computeBlock(const vec3<float>& ref, const float *x, const float *y, const float *z,
+                                  unsigned int begin, unsigned int end, unsigned int *idx, float *r,
+                                  unsigned int *bins, vec3<float> *delta, bool wrap) const;
+
+        //! Test a single point with scalar code
+        unsigned int computeOne(float dx, float dy, float dz, unsigned int k, unsigned int *idx, float *r,
+                                unsigned int *bins, vec3<float> *delta, bool wrap) const;
+
+        float m_rmax;               //!< Cutoff
+        float m_rmaxsq;             //!< Cutoff squared
+        float m_dr_inv;             //!< Inverse bin width
+        vec3<float> m_L;            //!< Box lengths
+        vec3<float> m_hi;           //!< Upper box bounds (the lower bounds are -m_hi)
+        float m_xy;                 //!< xy tilt factor
+        float m_xz;                 //!< xz tilt factor
+        float m_yz;                 //!< yz tilt factor
+        bool m_periodic_x;          //!< True if the box is periodic along x
+        bool m_periodic_y;          //!< True if the box is periodic along y
+        bool m_periodic_z;          //!< True if the box is periodic along z
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _DISTANCE_KERNEL_H__
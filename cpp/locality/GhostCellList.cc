@@ -0,0 +1,280 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+#include <algorithm>
+#include <tbb/tbb.h>
+
+#include "GhostCellList.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file GhostCellList.cc
+    \brief Cell list padded with the periodic images of the points near the box faces
+*/
+
+namespace freud { namespace locality {
+
+GhostCellList::GhostCellList(const box::Box& box, float rmax)
+    : m_box(box), m_rmax(rmax), m_Np(0), m_num_copies(0)
+    {
+    if (rmax <= 0.0f)
+        throw invalid_argument("rmax must be positive");
+    updateBox(box);
+    }
+
+void GhostCellList::updateBox(const box::Box& box)
+    {
+    // the ghost layer must not reach past the opposite face, or a point would need more than one ghost per face
+    vec3<float> L = box.getNearestPlaneDistance();
+    bool too_wide = m_rmax > L.x/2.0 || m_rmax > L.y/2.0;
+    if (!box.is2D())
+        {
+        too_wide |= m_rmax > L.z/2.0;
+        }
+    if (too_wide)
+        {
+        throw runtime_error("Cannot generate a cell list where rmax is larger than half the box.");
+        }
+    m_box = box;
+
+    // pad each periodic dimension by rmax on both sides and split the padded width into cells at least rmax wide
+    uchar3 periodic = box.getPeriodic();
+    const float widths[3] = {L.x, L.y, L.z};
+    const bool padded[3] = {bool(periodic.x), bool(periodic.y), bool(periodic.z) && !box.is2D()};
+    float ghost_width[3], cell_scale[3];
+    unsigned int dims[3];
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        ghost_width[d] = padded[d] ? m_rmax / widths[d] : 0.0f;
+        float span = 1.0f + 2.0f*ghost_width[d];
+        dims[d] = max(1u, (unsigned int)(span * widths[d] / m_rmax));
+        cell_scale[d] = float(dims[d]) / span;
+        }
+    if (box.is2D())
+        {
+        dims[2] = 1;
+        cell_scale[2] = 0.0f;
+        }
+    m_ghost_width = vec3<float>(ghost_width[0], ghost_width[1], ghost_width[2]);
+    m_cell_scale = vec3<float>(cell_scale[0], cell_scale[1], cell_scale[2]);
+    m_cell_index = Index3D(dims[0], dims[1], dims[2]);
+    }
+
+void GhostCellList::computeCellList(const box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    updateBox(box);
+    if (Np == 0)
+        {
+        throw runtime_error("Cannot generate a cell list of 0 particles");
+        }
+    assert(points);
+
+    const unsigned int Nc = getNumCells();
+    const vec3<float> g = m_ghost_width;
+    const vec3<float> a0 = m_box.getLatticeVector(0);
+    const vec3<float> a1 = m_box.getLatticeVector(1);
+    const vec3<float> a2 = m_box.is2D() ? vec3<float>(0, 0, 0) : m_box.getLatticeVector(2);
+
+    // a point within the ghost layer of the lower face of a dimension gets an image past the upper face (+1), and
+    // the other way around; the point itself (image 0) always comes first
+    auto images = [] (float alpha, float width, int *img)
+        {
+        unsigned int n = 0;
+        img[n++] = 0;
+        if (width > 0.0f && alpha < width)
+            img[n++] = 1;
+        if (width > 0.0f && alpha >= 1.0f - width)
+            img[n++] = -1;
+        return n;
+        };
+
+    // count the copies of each point
+    m_copy_start.resize(Np + 1);
+    unsigned int *copy_start = &m_copy_start[0];
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        int img[3];
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            vec3<float> alpha = m_box.makeFraction(points[i]);
+            copy_start[i + 1] = images(alpha.x, g.x, img) * images(alpha.y, g.y, img) * images(alpha.z, g.z, img);
+            }
+        });
+    copy_start[0] = 0;
+    for (unsigned int i = 0; i < Np; i++)
+        copy_start[i + 1] += copy_start[i];
+    const unsigned int num_copies = copy_start[Np];
+
+    // make the copies and find their cells
+    m_copies.resize(num_copies);
+    m_copy_cell.resize(num_copies);
+    m_copy_point.resize(num_copies);
+    vec3<float> *copies = &m_copies[0];
+    unsigned int *copy_cell = &m_copy_cell[0];
+    unsigned int *copy_point = &m_copy_point[0];
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        int imgx[3], imgy[3], imgz[3];
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            const vec3<float> p = points[i];
+            const vec3<float> alpha = m_box.makeFraction(p);
+            unsigned int nx = images(alpha.x, g.x, imgx);
+            unsigned int ny = images(alpha.y, g.y, imgy);
+            unsigned int nz = images(alpha.z, g.z, imgz);
+            unsigned int copy = copy_start[i];
+            for (unsigned int k = 0; k < nz; k++)
+                for (unsigned int j = 0; j < ny; j++)
+                    for (unsigned int l = 0; l < nx; l++)
+                        {
+                        copies[copy] = p + a0*float(imgx[l]) + a1*float(imgy[j]) + a2*float(imgz[k]);
+                        vec3<unsigned int> c = getCellCoordFraction(
+                            alpha + vec3<float>(float(imgx[l]), float(imgy[j]), float(imgz[k])));
+                        copy_cell[copy] = m_cell_index(c.x, c.y, c.z);
+                        copy_point[copy] = i;
+                        copy++;
+                        }
+            }
+        });
+
+    // counting sort of the copies by cell; scattering in copy order keeps each cell in ascending point order
+    m_cell_start.resize(Nc + 1);
+    m_cell_fill.assign(Nc, 0);
+    m_cell_copy.resize(num_copies);
+    for (unsigned int copy = 0; copy < num_copies; copy++)
+        m_cell_fill[copy_cell[copy]]++;
+    m_cell_start[0] = 0;
+    for (unsigned int cell = 0; cell < Nc; cell++)
+        {
+        m_cell_start[cell + 1] = m_cell_start[cell] + m_cell_fill[cell];
+        m_cell_fill[cell] = m_cell_start[cell];
+        }
+    for (unsigned int copy = 0; copy < num_copies; copy++)
+        m_cell_copy[m_cell_fill[copy_cell[copy]]++] = copy;
+
+    // gather the positions in cell order, and map each copy back to its point
+    m_sorted_idx.resize(num_copies);
+    m_sorted_x.resize(num_copies);
+    m_sorted_y.resize(num_copies);
+    m_sorted_z.resize(num_copies);
+    const unsigned int *cell_copy = &m_cell_copy[0];
+    unsigned int *sorted_idx = &m_sorted_idx[0];
+    float *sorted_x = &m_sorted_x[0];
+    float *sorted_y = &m_sorted_y[0];
+    float *sorted_z = &m_sorted_z[0];
+    parallel_for(blocked_range<size_t>(0, num_copies),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t k = r.begin(); k != r.end(); ++k)
+            {
+            const unsigned int copy = cell_copy[k];
+            sorted_idx[k] = copy_point[copy];
+            sorted_x[k] = copies[copy].x;
+            sorted_y[k] = copies[copy].y;
+            sorted_z[k] = copies[copy].z;
+            }
+        });
+
+    m_Np = Np;
+    m_num_copies = num_copies;
+    }
+
+void GhostCellList::compute(const box::Box& box,
+                            const vec3<float> *ref_points,
+                            unsigned int Nref,
+                            const vec3<float> *points,
+                            unsigned int Np,
+                            bool exclude_ii)
+    {
+    computeCellList(box, points, Np);
+
+    // every copy in reach is already at its minimum image, so the kernel never wraps
+    const DistanceKernel kernel(m_box, m_rmax);
+    m_neighbor_list.resize(m_neighbor_list.getNumBonds(), Nref, Np);
+
+    // first pass: count the bonds of each reference point so that every thread can write its own segment
+    std::vector<size_t> counts(Nref + 1, 0);
+    parallel_for(blocked_range<size_t>(0, Nref),
+        [=, &kernel, &counts] (const blocked_range<size_t>& r)
+        {
+        std::vector<unsigned int> neighbors;
+        std::vector<float> distances;
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            getNeighbors(ref_points[i], kernel, neighbors, distances);
+            size_t num_bonds = neighbors.size();
+            if (exclude_ii)
+                num_bonds -= std::count(neighbors.begin(), neighbors.end(), i);
+            counts[i + 1] = num_bonds;
+            }
+        });
+
+    for (size_t i = 0; i < Nref; ++i)
+        counts[i + 1] += counts[i];
+    m_neighbor_list.resize(counts[Nref], Nref, Np);
+
+    // second pass: fill the bonds of each reference point, in cell order
+    size_t *index_i = m_neighbor_list.getIndexI();
+    size_t *index_j = m_neighbor_list.getIndexJ();
+    float *distances = m_neighbor_list.getDistances();
+    float *weights = m_neighbor_list.getWeights();
+    parallel_for(blocked_range<size_t>(0, Nref),
+        [=, &kernel, &counts] (const blocked_range<size_t>& r)
+        {
+        std::vector<unsigned int> neighbors;
+        std::vector<float> neighbor_r;
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            getNeighbors(ref_points[i], kernel, neighbors, neighbor_r);
+            size_t bond = counts[i];
+            for (unsigned int m = 0; m < neighbors.size(); ++m)
+                {
+                if (exclude_ii && i == neighbors[m])
+                    continue;
+                index_i[bond] = i;
+                index_j[bond] = neighbors[m];
+                distances[bond] = neighbor_r[m];
+                weights[bond] = 1.0f;
+                bond++;
+                }
+            }
+        });
+    m_neighbor_list.updateSegments();
+    }
+
+void GhostCellList::getNeighbors(const vec3<float>& ref, const DistanceKernel& kernel,
+                                 std::vector<unsigned int>& neighbors, std::vector<float>& distances) const
+    {
+    neighbors.clear();
+    distances.clear();
+
+    // the grid does not wrap, so the surrounding cells are clamped at its edges
+    const vec3<unsigned int> c = getCellCoord(ref);
+    const unsigned int kmin = (c.z > 0) ? c.z - 1 : 0, kmax = min(c.z + 1, m_cell_index.getD() - 1);
+    const unsigned int jmin = (c.y > 0) ? c.y - 1 : 0, jmax = min(c.y + 1, m_cell_index.getH() - 1);
+    const unsigned int lmin = (c.x > 0) ? c.x - 1 : 0, lmax = min(c.x + 1, m_cell_index.getW() - 1);
+    for (unsigned int k = kmin; k <= kmax; k++)
+        for (unsigned int j = jmin; j <= jmax; j++)
+            for (unsigned int l = lmin; l <= lmax; l++)
+                {
+                const unsigned int cell = m_cell_index(l, j, k);
+                const size_t n = neighbors.size();
+                const unsigned int cell_size = m_cell_start[cell + 1] - m_cell_start[cell];
+                neighbors.resize(n + cell_size);
+                distances.resize(n + cell_size);
+                const unsigned int num_found = kernel.computeImage(ref, &m_sorted_x[0], &m_sorted_y[0],
+                                                                   &m_sorted_z[0], m_cell_start[cell],
+                                                                   m_cell_start[cell + 1], &neighbors[n],
+                                                                   &distances[n]);
+                for (unsigned int m = 0; m < num_found; ++m)
+                    neighbors[n + m] = m_sorted_idx[neighbors[n + m]];
+                neighbors.resize(n + num_found);
+                distances.resize(n + num_found);
+                }
+    }
+
+}; }; // end namespace freud::locality
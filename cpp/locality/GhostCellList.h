@@ -0,0 +1,191 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "../box/box.h"
+#include "HOOMDMath.h"
+#include "Index1D.h"
+#include "NeighborList.h"
+#include "DistanceKernel.h"
+
+#ifndef _GHOST_CELL_LIST_H__
+#define _GHOST_CELL_LIST_H__
+
+/*! \file GhostCellList.h
+    \brief Cell list padded with the periodic images of the points near the box faces
+*/
+
+namespace freud { namespace locality {
+
+//! Cell list over a set of points and the periodic images (ghosts) of the points within rmax of a box face
+/*! Like VoronoiBuffer, GhostCellList replicates every point that lies within rmax of a face of a periodic dimension
+    to just outside the opposite face. The points and their ghosts are then binned into a grid of cells that covers
+    the box plus a margin of rmax and does not wrap around. For a reference point inside the box, every point
+    closer than rmax has exactly one copy (real or ghost) in the 27 (9 in 2D) cells surrounding it, at its minimum
+    image position, so neighbor searches use plain subtraction and never wrap. Each copy maps back to the index of
+    the point it was made from.
+
+    Compared with the image shifts of LinkCell, this also works in boxes with fewer than 3 cells along a dimension,
+    at the cost of storing the ghosts. Cells are laid out in fractional coordinates, so triclinic boxes are
+    supported; rmax may be no larger than half the distance between opposite box faces.
+
+    <b>Data structures:</b><br>
+    The copies in cell c are the entries k in [getCellOffsets()[c], getCellOffsets()[c+1]), whose positions are
+    (getSortedX()[k], getSortedY()[k], getSortedZ()[k]) and which were made from point getSortedIndices()[k].
+*/
+class GhostCellList
+    {
+    public:
+        //! Constructor
+        GhostCellList(const box::Box& box, float rmax);
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Get the cutoff
+        float getRMax() const
+            {
+            return m_rmax;
+            }
+
+        //! Get the cell indexer
+        const Index3D& getCellIndexer() const
+            {
+            return m_cell_index;
+            }
+
+        //! Get the number of cells
+        unsigned int getNumCells() const
+            {
+            return m_cell_index.getNumElements();
+            }
+
+        //! Get the number of points last placed in the cell list
+        unsigned int getNumPoints() const
+            {
+            return m_Np;
+            }
+
+        //! Get the number of ghosts made by the last call to computeCellList()
+        unsigned int getNumGhosts() const
+            {
+            return m_num_copies - m_Np;
+            }
+
+        //! Compute the cell of a position inside the padded box
+        unsigned int getCell(const vec3<float>& p) const
+            {
+            vec3<unsigned int> c = getCellCoord(p);
+            return m_cell_index(c.x, c.y, c.z);
+            }
+
+        //! Get the first entry of each cell in the sorted arrays (getNumCells() + 1 entries)
+        const unsigned int *getCellOffsets() const
+            {
+            return &m_cell_start[0];
+            }
+
+        //! Get the index of the point each entry was made from
+        const unsigned int *getSortedIndices() const
+            {
+            return &m_sorted_idx[0];
+            }
+
+        //! Get the x coordinates of the points and ghosts sorted by cell
+        const float *getSortedX() const
+            {
+            return &m_sorted_x[0];
+            }
+
+        //! Get the y coordinates of the points and ghosts sorted by cell
+        const float *getSortedY() const
+            {
+            return &m_sorted_y[0];
+            }
+
+        //! Get the z coordinates of the points and ghosts sorted by cell
+        const float *getSortedZ() const
+            {
+            return &m_sorted_z[0];
+            }
+
+        //! Make the ghosts of points and bin everything into cells
+        void computeCellList(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! Compute the cell list of points and the NeighborList of all (ref_point, point) pairs within rmax
+        /*! Bonds (i, i) are only dropped when \a exclude_ii is set, which callers should do when ref_points and
+            points are the same array.
+        */
+        void compute(const box::Box& box, const vec3<float> *ref_points, unsigned int Nref,
+                     const vec3<float> *points, unsigned int Np, bool exclude_ii=false);
+
+        //! Find the points closer than kernel.getRMax() to ref
+        /*! \param ref Reference point inside the box
+            \param kernel Distance kernel; its cutoff may be no larger than rmax
+            \param neighbors Output: indices of the points found, in cell order
+            \param distances Output: distance of each of those points
+        */
+        void getNeighbors(const vec3<float>& ref, const DistanceKernel& kernel, std::vector<unsigned int>& neighbors,
+                          std::vector<float>& distances) const;
+
+        //! Get the NeighborList computed by the last call to compute()
+        NeighborList *getNList()
+            {
+            return &m_neighbor_list;
+            }
+
+    private:
+        //! Compute the coordinates of the cell of a position, clamped to the grid
+        vec3<unsigned int> getCellCoord(const vec3<float>& p) const
+            {
+            return getCellCoordFraction(m_box.makeFraction(p));
+            }
+
+        //! Compute the coordinates of the cell of a position given in fractional coordinates
+        vec3<unsigned int> getCellCoordFraction(const vec3<float>& alpha) const
+            {
+            int cx = (int)floorf((alpha.x + m_ghost_width.x) * m_cell_scale.x);
+            int cy = (int)floorf((alpha.y + m_ghost_width.y) * m_cell_scale.y);
+            int cz = (int)floorf((alpha.z + m_ghost_width.z) * m_cell_scale.z);
+            vec3<unsigned int> c;
+            c.x = std::min(std::max(cx, 0), (int)m_cell_index.getW() - 1);
+            c.y = std::min(std::max(cy, 0), (int)m_cell_index.getH() - 1);
+            c.z = std::min(std::max(cz, 0), (int)m_cell_index.getD() - 1);
+            return c;
+            }
+
+        //! Set up the cell grid for a box
+        void updateBox(const box::Box& box);
+
+        box::Box m_box;                 //!< Simulation box the particles belong in
+        float m_rmax;                   //!< Cutoff, and minimum cell width
+        Index3D m_cell_index;           //!< Indexer to compute cell indices
+        vec3<float> m_ghost_width;      //!< Width of the ghost layer in fractional coordinates
+        vec3<float> m_cell_scale;       //!< Number of cells per unit of fractional coordinates
+        unsigned int m_Np;              //!< Number of points last placed into the cell list
+        unsigned int m_num_copies;      //!< Number of points plus ghosts last placed into the cell list
+
+        std::vector<unsigned int> m_copy_start;   //!< First copy of each point
+        std::vector< vec3<float> > m_copies;      //!< Positions of the points and their ghosts
+        std::vector<unsigned int> m_copy_cell;    //!< Cell of each copy
+        std::vector<unsigned int> m_copy_point;   //!< Point each copy was made from
+        std::vector<unsigned int> m_cell_start;   //!< First entry of each cell in the sorted arrays
+        std::vector<unsigned int> m_cell_fill;    //!< Per cell counters used while sorting
+        std::vector<unsigned int> m_cell_copy;    //!< Copies sorted by cell
+        std::vector<unsigned int> m_sorted_idx;   //!< Point each sorted entry was made from
+        std::vector<float> m_sorted_x;            //!< x coordinates sorted by cell
+        std::vector<float> m_sorted_y;            //!< y coordinates sorted by cell
+        std::vector<float> m_sorted_z;            //!< z coordinates sorted by cell
+
+        NeighborList m_neighbor_list;    //!< Bonds computed by the last call to compute()
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _GHOST_CELL_LIST_H__
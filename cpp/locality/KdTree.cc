@@ -0,0 +1,390 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+#include <algorithm>
+#include <climits>
+#include <cfloat>
+#include <tbb/tbb.h>
+
+#include "KdTree.h"
+
+using namespace std;
+using namespace tbb;
+
+/*! \file KdTree.cc
+    \brief Periodic k-d tree for neighbor searches in systems of uneven density
+*/
+
+namespace freud { namespace locality {
+
+//! Subtrees with fewer points than this are built by a single thread
+const unsigned int kd_tree_parallel_grain = 4096;
+
+//! Deepest tree that can be traversed with a fixed size stack
+const unsigned int kd_tree_max_stack = 64;
+
+KdTree::KdTree(const box::Box& box, float rmax)
+    : m_box(box), m_rmax(rmax), m_max_search(FLT_MAX), m_Np(0)
+    {
+    if (rmax <= 0.0f)
+        throw invalid_argument("rmax must be positive");
+    updateBox(box);
+    }
+
+void KdTree::updateBox(const box::Box& box)
+    {
+    m_box = box;
+
+    // a point is found at most once as long as the search radius is below half the distance between opposite faces
+    uchar3 periodic = box.getPeriodic();
+    const bool periodic_dims[3] = {bool(periodic.x), bool(periodic.y), bool(periodic.z) && !box.is2D()};
+    vec3<float> L = box.getNearestPlaneDistance();
+    const float widths[3] = {L.x, L.y, L.z};
+    m_max_search = FLT_MAX;
+    for (unsigned int d = 0; d < 3; d++)
+        if (periodic_dims[d])
+            m_max_search = min(m_max_search, widths[d]/2.0f);
+
+    // the query point is translated by every combination of -1, 0 and +1 lattice vectors of the periodic dimensions
+    const vec3<float> a0 = box.getLatticeVector(0);
+    const vec3<float> a1 = box.getLatticeVector(1);
+    const vec3<float> a2 = box.is2D() ? vec3<float>(0, 0, 0) : box.getLatticeVector(2);
+    m_image_shifts.clear();
+    m_image_shifts.push_back(vec3<float>(0, 0, 0));
+    for (int k = -1; k <= 1; k++)
+        for (int j = -1; j <= 1; j++)
+            for (int i = -1; i <= 1; i++)
+                {
+                if ((i == 0 && j == 0 && k == 0) || (i != 0 && !periodic_dims[0]) ||
+                    (j != 0 && !periodic_dims[1]) || (k != 0 && !periodic_dims[2]))
+                    continue;
+                m_image_shifts.push_back(a0*float(i) + a1*float(j) + a2*float(k));
+                }
+    }
+
+void KdTree::computeTree(const box::Box& box, const vec3<float> *points, unsigned int Np)
+    {
+    updateBox(box);
+    if (Np == 0)
+        {
+        throw runtime_error("Cannot generate a tree of 0 particles");
+        }
+    assert(points);
+
+    // halve the points until the leaves hold at most getLeafSize() of them
+    unsigned int depth = 0;
+    while (((Np - 1) >> depth) + 1 > getLeafSize())
+        depth++;
+    m_nodes.resize((2u << depth) - 1);
+
+    m_sorted_idx.resize(Np);
+    for (unsigned int i = 0; i < Np; i++)
+        m_sorted_idx[i] = i;
+    buildNode(0, 0, Np, points);
+
+    // gather the positions in leaf order
+    m_sorted_x.resize(Np);
+    m_sorted_y.resize(Np);
+    m_sorted_z.resize(Np);
+    const unsigned int *sorted_idx = &m_sorted_idx[0];
+    float *sorted_x = &m_sorted_x[0];
+    float *sorted_y = &m_sorted_y[0];
+    float *sorted_z = &m_sorted_z[0];
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t k = r.begin(); k != r.end(); ++k)
+            {
+            const vec3<float> p = points[sorted_idx[k]];
+            sorted_x[k] = p.x;
+            sorted_y[k] = p.y;
+            sorted_z[k] = p.z;
+            }
+        });
+
+    m_Np = Np;
+    }
+
+void KdTree::buildNode(unsigned int n, unsigned int begin, unsigned int end, const vec3<float> *points)
+    {
+    Node& node = m_nodes[n];
+    node.begin = begin;
+    node.end = end;
+    node.lower = vec3<float>(FLT_MAX, FLT_MAX, FLT_MAX);
+    node.upper = vec3<float>(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (unsigned int k = begin; k < end; k++)
+        {
+        const vec3<float> p = points[m_sorted_idx[k]];
+        node.lower = vec3<float>(min(node.lower.x, p.x), min(node.lower.y, p.y), min(node.lower.z, p.z));
+        node.upper = vec3<float>(max(node.upper.x, p.x), max(node.upper.y, p.y), max(node.upper.z, p.z));
+        }
+
+    const unsigned int left = 2*n + 1;
+    if (left >= m_nodes.size())
+        return;
+
+    // split at the median along the longest extent; both halves differ by at most one point
+    const vec3<float> extent = node.upper - node.lower;
+    unsigned int *idx = &m_sorted_idx[0];
+    const unsigned int mid = begin + (end - begin)/2;
+    if (extent.x >= extent.y && extent.x >= extent.z)
+        nth_element(idx + begin, idx + mid, idx + end,
+                    [=] (unsigned int a, unsigned int b) { return points[a].x < points[b].x; });
+    else if (extent.y >= extent.z)
+        nth_element(idx + begin, idx + mid, idx + end,
+                    [=] (unsigned int a, unsigned int b) { return points[a].y < points[b].y; });
+    else
+        nth_element(idx + begin, idx + mid, idx + end,
+                    [=] (unsigned int a, unsigned int b) { return points[a].z < points[b].z; });
+
+    // the subtrees write disjoint nodes and ranges of m_sorted_idx
+    if (end - begin > kd_tree_parallel_grain)
+        parallel_invoke([=] { buildNode(left, begin, mid, points); },
+                        [=] { buildNode(left + 1, mid, end, points); });
+    else
+        {
+        buildNode(left, begin, mid, points);
+        buildNode(left + 1, mid, end, points);
+        }
+    }
+
+void KdTree::compute(const box::Box& box,
+                     const vec3<float> *ref_points,
+                     unsigned int Nref,
+                     const vec3<float> *points,
+                     unsigned int Np,
+                     bool exclude_ii)
+    {
+    updateBox(box);
+    if (m_rmax > m_max_search)
+        {
+        throw runtime_error("Cannot find neighbors where rmax is larger than half the box.");
+        }
+    computeTree(box, points, Np);
+
+    const DistanceKernel kernel(m_box, m_rmax);
+    m_neighbor_list.resize(m_neighbor_list.getNumBonds(), Nref, Np);
+
+    // first pass: count the bonds of each reference point so that every thread can write its own segment
+    std::vector<size_t> counts(Nref + 1, 0);
+    parallel_for(blocked_range<size_t>(0, Nref),
+        [=, &kernel, &counts] (const blocked_range<size_t>& r)
+        {
+        std::vector<unsigned int> neighbors;
+        std::vector<float> distances;
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            getNeighbors(ref_points[i], kernel, neighbors, distances);
+            size_t num_bonds = neighbors.size();
+            if (exclude_ii)
+                num_bonds -= std::count(neighbors.begin(), neighbors.end(), i);
+            counts[i + 1] = num_bonds;
+            }
+        });
+
+    for (size_t i = 0; i < Nref; ++i)
+        counts[i + 1] += counts[i];
+    m_neighbor_list.resize(counts[Nref], Nref, Np);
+
+    // second pass: fill the bonds of each reference point, in tree order
+    size_t *index_i = m_neighbor_list.getIndexI();
+    size_t *index_j = m_neighbor_list.getIndexJ();
+    float *distances = m_neighbor_list.getDistances();
+    float *weights = m_neighbor_list.getWeights();
+    parallel_for(blocked_range<size_t>(0, Nref),
+        [=, &kernel, &counts] (const blocked_range<size_t>& r)
+        {
+        std::vector<unsigned int> neighbors;
+        std::vector<float> neighbor_r;
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            getNeighbors(ref_points[i], kernel, neighbors, neighbor_r);
+            size_t bond = counts[i];
+            for (unsigned int m = 0; m < neighbors.size(); ++m)
+                {
+                if (exclude_ii && i == neighbors[m])
+                    continue;
+                index_i[bond] = i;
+                index_j[bond] = neighbors[m];
+                distances[bond] = neighbor_r[m];
+                weights[bond] = 1.0f;
+                bond++;
+                }
+            }
+        });
+    m_neighbor_list.updateSegments();
+    }
+
+void KdTree::computeNearest(const box::Box& box,
+                            const vec3<float> *ref_points,
+                            unsigned int Nref,
+                            const vec3<float> *points,
+                            unsigned int Np,
+                            unsigned int num_neighbors,
+                            bool exclude_ii)
+    {
+    computeTree(box, points, Np);
+
+    // every reference point has at most num_neighbors bonds; find them into padded arrays, then pack
+    std::vector<unsigned int> found_j(size_t(Nref)*num_neighbors);
+    std::vector<float> found_r(size_t(Nref)*num_neighbors);
+    std::vector<size_t> counts(Nref + 1, 0);
+    parallel_for(blocked_range<size_t>(0, Nref),
+        [=, &found_j, &found_r, &counts] (const blocked_range<size_t>& r)
+        {
+        std::vector<unsigned int> neighbors;
+        std::vector<float> distances;
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            getNearest(ref_points[i], num_neighbors, exclude_ii ? (unsigned int)i : UINT_MAX,
+                       neighbors, distances);
+            std::copy(neighbors.begin(), neighbors.end(), found_j.begin() + i*num_neighbors);
+            std::copy(distances.begin(), distances.end(), found_r.begin() + i*num_neighbors);
+            counts[i + 1] = neighbors.size();
+            }
+        });
+
+    for (size_t i = 0; i < Nref; ++i)
+        counts[i + 1] += counts[i];
+    m_neighbor_list.resize(counts[Nref], Nref, Np);
+
+    size_t *index_i = m_neighbor_list.getIndexI();
+    size_t *index_j = m_neighbor_list.getIndexJ();
+    float *distances = m_neighbor_list.getDistances();
+    float *weights = m_neighbor_list.getWeights();
+    parallel_for(blocked_range<size_t>(0, Nref),
+        [=, &found_j, &found_r, &counts] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            size_t bond = counts[i];
+            for (size_t m = 0; m < counts[i + 1] - counts[i]; ++m)
+                {
+                index_i[bond] = i;
+                index_j[bond] = found_j[i*num_neighbors + m];
+                distances[bond] = found_r[i*num_neighbors + m];
+                weights[bond] = 1.0f;
+                bond++;
+                }
+            }
+        });
+    m_neighbor_list.updateSegments();
+    }
+
+void KdTree::getNeighbors(const vec3<float>& ref, const DistanceKernel& kernel,
+                          std::vector<unsigned int>& neighbors, std::vector<float>& distances) const
+    {
+    neighbors.clear();
+    distances.clear();
+
+    const float rmaxsq = kernel.getRMax()*kernel.getRMax();
+    const unsigned int num_nodes = getNumNodes();
+    unsigned int stack[kd_tree_max_stack];
+    for (unsigned int s = 0; s < m_image_shifts.size(); s++)
+        {
+        // the points seen from this image of ref are exactly the points seen from ref at their shifted image
+        const vec3<float> query = ref - m_image_shifts[s];
+        unsigned int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+            {
+            const unsigned int n = stack[--top];
+            const Node& node = m_nodes[n];
+            if (boundsDistanceSq(node, query) >= rmaxsq)
+                continue;
+            if (2*n + 1 < num_nodes)
+                {
+                stack[top++] = 2*n + 1;
+                stack[top++] = 2*n + 2;
+                continue;
+                }
+
+            const size_t k = neighbors.size();
+            neighbors.resize(k + node.end - node.begin);
+            distances.resize(k + node.end - node.begin);
+            const unsigned int num_found = kernel.computeImage(query, &m_sorted_x[0], &m_sorted_y[0],
+                                                               &m_sorted_z[0], node.begin, node.end,
+                                                               &neighbors[k], &distances[k]);
+            for (unsigned int m = 0; m < num_found; ++m)
+                neighbors[k + m] = m_sorted_idx[neighbors[k + m]];
+            neighbors.resize(k + num_found);
+            distances.resize(k + num_found);
+            }
+        }
+    }
+
+void KdTree::getNearest(const vec3<float>& ref, unsigned int num_neighbors, unsigned int exclude,
+                        std::vector<unsigned int>& neighbors, std::vector<float>& distances) const
+    {
+    neighbors.clear();
+    distances.clear();
+    if (num_neighbors == 0)
+        return;
+
+    // max-heap on the squared distance of the nearest points found so far; its top is the current search radius
+    std::vector< pair<float, unsigned int> > heap;
+    heap.reserve(num_neighbors);
+    const float limitsq = (m_max_search < FLT_MAX) ? m_max_search*m_max_search : FLT_MAX;
+    float searchsq = limitsq;
+
+    const unsigned int num_nodes = getNumNodes();
+    unsigned int stack[kd_tree_max_stack];
+    for (unsigned int s = 0; s < m_image_shifts.size(); s++)
+        {
+        const vec3<float> query = ref - m_image_shifts[s];
+        unsigned int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+            {
+            const unsigned int n = stack[--top];
+            const Node& node = m_nodes[n];
+            if (boundsDistanceSq(node, query) >= searchsq)
+                continue;
+            if (2*n + 1 < num_nodes)
+                {
+                // visit the nearer child first so that the search radius shrinks early
+                const unsigned int left = 2*n + 1;
+                if (boundsDistanceSq(m_nodes[left], query) < boundsDistanceSq(m_nodes[left + 1], query))
+                    {
+                    stack[top++] = left + 1;
+                    stack[top++] = left;
+                    }
+                else
+                    {
+                    stack[top++] = left;
+                    stack[top++] = left + 1;
+                    }
+                continue;
+                }
+
+            for (unsigned int k = node.begin; k < node.end; k++)
+                {
+                const float dx = m_sorted_x[k] - query.x;
+                const float dy = m_sorted_y[k] - query.y;
+                const float dz = m_sorted_z[k] - query.z;
+                const float rsq = dx*dx + dy*dy + dz*dz;
+                if (rsq >= searchsq || m_sorted_idx[k] == exclude)
+                    continue;
+                if (heap.size() == num_neighbors)
+                    {
+                    pop_heap(heap.begin(), heap.end());
+                    heap.pop_back();
+                    }
+                heap.push_back(pair<float, unsigned int>(rsq, m_sorted_idx[k]));
+                push_heap(heap.begin(), heap.end());
+                if (heap.size() == num_neighbors)
+                    searchsq = heap.front().first;
+                }
+            }
+        }
+
+    sort_heap(heap.begin(), heap.end());
+    for (unsigned int m = 0; m < heap.size(); m++)
+        {
+        neighbors.push_back(heap[m].second);
+        distances.push_back(sqrtf(heap[m].first));
+        }
+    }
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,200 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "../box/box.h"
+#include "HOOMDMath.h"
+#include "NeighborList.h"
+#include "DistanceKernel.h"
+
+#ifndef _KD_TREE_H__
+#define _KD_TREE_H__
+
+/*! \file KdTree.h
+    \brief Periodic k-d tree for neighbor searches in systems of uneven density
+*/
+
+namespace freud { namespace locality {
+
+//! Periodic k-d tree over a set of points
+/*! LinkCell sizes its cells for the average density, so dense clusters put many points into each cell while sparse
+    regions leave most cells empty, and NearestNeighbors grows its cutoff for the whole system when a single point
+    lacks neighbors. KdTree instead splits the points at the median along the longest extent of each node until at
+    most getLeafSize() points are left, so its depth follows the local density. Every node stores the tight bounding
+    box of its points, and queries skip the nodes farther away than the current search radius.
+
+    Periodic boundaries are handled by translating the query point by the lattice vectors of the periodic
+    dimensions (27 images in 3D, 9 in 2D) rather than by wrapping every pair; an image is only searched when it
+    is within the search radius of the bounding box of all points. Searches are limited to half the distance
+    between opposite faces of the periodic dimensions, so each point is found at most once, at its minimum image.
+    Points must lie inside the box.
+
+    The tree supports the same queries as LinkCell: compute() finds all pairs closer than rmax, and
+    computeNearest() finds the num_neighbors nearest points of each reference point without a cutoff, which
+    NearestNeighbors can only do by growing rmax. Both produce a NeighborList.
+
+    <b>Data structures:</b><br>
+    Nodes are stored as an implicit balanced binary tree: node n has children 2n+1 and 2n+2, and the leaves are
+    the last getNumLeaves() nodes. The points of node n are the entries k in [begin, end) of the sorted arrays,
+    whose positions are (getSortedX()[k], getSortedY()[k], getSortedZ()[k]) and whose indices are
+    getSortedIndices()[k].
+*/
+class KdTree
+    {
+    public:
+        //! Constructor
+        /*! \param box Simulation box
+            \param rmax Cutoff used by compute()
+        */
+        KdTree(const box::Box& box, float rmax);
+
+        //! Get the simulation box
+        const box::Box& getBox() const
+            {
+            return m_box;
+            }
+
+        //! Get the cutoff
+        float getRMax() const
+            {
+            return m_rmax;
+            }
+
+        //! Get the largest number of points in a leaf
+        static unsigned int getLeafSize()
+            {
+            return 64;
+            }
+
+        //! Get the number of points last placed in the tree
+        unsigned int getNumPoints() const
+            {
+            return m_Np;
+            }
+
+        //! Get the number of nodes
+        unsigned int getNumNodes() const
+            {
+            return (unsigned int)m_nodes.size();
+            }
+
+        //! Get the number of leaves
+        unsigned int getNumLeaves() const
+            {
+            return (getNumNodes() + 1) / 2;
+            }
+
+        //! Get the index of the point of each entry of the sorted arrays
+        const unsigned int *getSortedIndices() const
+            {
+            return &m_sorted_idx[0];
+            }
+
+        //! Get the x coordinates of the points sorted by leaf
+        const float *getSortedX() const
+            {
+            return &m_sorted_x[0];
+            }
+
+        //! Get the y coordinates of the points sorted by leaf
+        const float *getSortedY() const
+            {
+            return &m_sorted_y[0];
+            }
+
+        //! Get the z coordinates of the points sorted by leaf
+        const float *getSortedZ() const
+            {
+            return &m_sorted_z[0];
+            }
+
+        //! Build the tree over points
+        void computeTree(const box::Box& box, const vec3<float> *points, unsigned int Np);
+
+        //! Build the tree over points and the NeighborList of all (ref_point, point) pairs within rmax
+        /*! Bonds (i, i) are only dropped when \a exclude_ii is set, which callers should do when ref_points and
+            points are the same array.
+        */
+        void compute(const box::Box& box, const vec3<float> *ref_points, unsigned int Nref,
+                     const vec3<float> *points, unsigned int Np, bool exclude_ii=false);
+
+        //! Build the tree over points and the NeighborList of the num_neighbors nearest points of each ref_point
+        /*! Bonds (i, i) are only dropped when \a exclude_ii is set, which callers should do when ref_points and
+            points are the same array.
+        */
+        void computeNearest(const box::Box& box, const vec3<float> *ref_points, unsigned int Nref,
+                            const vec3<float> *points, unsigned int Np, unsigned int num_neighbors,
+                            bool exclude_ii=false);
+
+        //! Find the points closer than kernel.getRMax() to ref
+        /*! \param ref Reference point inside the box
+            \param kernel Distance kernel; its cutoff may be no larger than half the distance between opposite faces
+            \param neighbors Output: indices of the points found, in tree order
+            \param distances Output: distance of each of those points
+        */
+        void getNeighbors(const vec3<float>& ref, const DistanceKernel& kernel, std::vector<unsigned int>& neighbors,
+                          std::vector<float>& distances) const;
+
+        //! Find the num_neighbors points nearest to ref
+        /*! \param ref Reference point inside the box
+            \param num_neighbors Number of points to find; fewer are found if the search limit is reached
+            \param exclude Index of a point to skip (UINT_MAX to skip none)
+            \param neighbors Output: indices of the points found, nearest first
+            \param distances Output: distance of each of those points
+        */
+        void getNearest(const vec3<float>& ref, unsigned int num_neighbors, unsigned int exclude,
+                        std::vector<unsigned int>& neighbors, std::vector<float>& distances) const;
+
+        //! Get the NeighborList computed by the last call to compute() or computeNearest()
+        NeighborList *getNList()
+            {
+            return &m_neighbor_list;
+            }
+
+    private:
+        //! Bounding box and range of sorted points of a node
+        struct Node
+            {
+            vec3<float> lower;      //!< Lower corner of the bounding box
+            vec3<float> upper;      //!< Upper corner of the bounding box
+            unsigned int begin;     //!< First point of the node in the sorted arrays
+            unsigned int end;       //!< One past the last point of the node in the sorted arrays
+            };
+
+        //! Squared distance from a position to the bounding box of a node
+        static float boundsDistanceSq(const Node& node, const vec3<float>& p)
+            {
+            float dx = std::max(std::max(node.lower.x - p.x, p.x - node.upper.x), 0.0f);
+            float dy = std::max(std::max(node.lower.y - p.y, p.y - node.upper.y), 0.0f);
+            float dz = std::max(std::max(node.lower.z - p.z, p.z - node.upper.z), 0.0f);
+            return dx*dx + dy*dy + dz*dz;
+            }
+
+        //! Split the points of node n and build its subtree
+        void buildNode(unsigned int n, unsigned int begin, unsigned int end, const vec3<float> *points);
+
+        //! Set up the image shifts and search limit for a box
+        void updateBox(const box::Box& box);
+
+        box::Box m_box;                 //!< Simulation box the particles belong in
+        float m_rmax;                   //!< Cutoff used by compute()
+        float m_max_search;             //!< Largest search radius that finds each point at most once
+        unsigned int m_Np;              //!< Number of points last placed into the tree
+
+        std::vector< vec3<float> > m_image_shifts;   //!< Translations of the query point, the identity first
+        std::vector<Node> m_nodes;                   //!< Nodes of the tree
+        std::vector<unsigned int> m_sorted_idx;      //!< Point of each sorted entry
+        std::vector<float> m_sorted_x;               //!< x coordinates sorted by leaf
+        std::vector<float> m_sorted_y;               //!< y coordinates sorted by leaf
+        std::vector<float> m_sorted_z;               //!< z coordinates sorted by leaf
+
+        NeighborList m_neighbor_list;    //!< Bonds computed by the last call to compute() or computeNearest()
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _KD_TREE_H__
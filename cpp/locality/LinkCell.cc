@@ -3,12 +3,14 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <tbb/tbb.h>
 
 #include "LinkCell.h"
 #include "../box/box.h"
 #include "ScopedGILRelease.h"
 
 using namespace std;
+using namespace tbb;
 
 /*! \file LinkCell.cc
     \brief Build a cell list from a set of points
@@ -19,12 +21,19 @@ namespace freud { namespace locality {
 // This is only used to initialize a pointer for the new triclinic setup
 // this shouldn't be needed any longer, but will be left for now
 // but until then, enjoy this mediocre hack
-LinkCell::LinkCell() : m_box(box::Box()), m_Np(0), m_cell_width(0)
+LinkCell::LinkCell()
+    : m_box(box::Box()), m_Np(0), m_Nc(0), m_cell_width(0), m_sort_points(false), m_max_Np(0), m_max_Nc(0),
+      m_max_sorted_points(0), m_max_cell_size(0), m_num_neighbor_cells(0), m_max_cell_neighbors(0),
+      m_image_shifts_valid(false)
     {
     m_celldim = vec3<unsigned int>(0,0,0);
+    computeImageShifts();
     }
 
-LinkCell::LinkCell(const box::Box& box, float cell_width) : m_box(box), m_Np(0), m_cell_width(cell_width)
+LinkCell::LinkCell(const box::Box& box, float cell_width)
+    : m_box(box), m_Np(0), m_Nc(0), m_cell_width(cell_width), m_sort_points(false), m_max_Np(0), m_max_Nc(0),
+      m_max_sorted_points(0), m_max_cell_size(0), m_num_neighbor_cells(0), m_max_cell_neighbors(0),
+      m_image_shifts_valid(false)
     {
     // check if the cell width is too wide for the box
     m_celldim  = computeDimensions(m_box, m_cell_width);
@@ -50,6 +59,7 @@ LinkCell::LinkCell(const box::Box& box, float cell_width) : m_box(box), m_Np(0),
         }
     m_cell_index = Index3D(m_celldim.x, m_celldim.y, m_celldim.z);
     computeCellNeighbors();
+    computeImageShifts();
     }
 
 void LinkCell::setCellWidth(float cell_width)
@@ -83,6 +93,7 @@ void LinkCell::setCellWidth(float cell_width)
                 }
             m_celldim  = celldim;
             computeCellNeighbors();
+            computeImageShifts();
             }
         m_cell_width = cell_width;
         }
@@ -120,6 +131,8 @@ void LinkCell::updateBox(const box::Box& box)
         m_celldim  = celldim;
         computeCellNeighbors();
         }
+    // the image translations follow the box lengths and tilts, which may change without the cell dimensions
+    computeImageShifts();
     }
 
 unsigned int LinkCell::roundDown(unsigned int v, unsigned int m)
@@ -211,117 +224,369 @@ void LinkCell::computeCellList(box::Box& box,
     // determine the number of cells and allocate memory
     unsigned int Nc = getNumCells();
     assert(Nc > 0);
-    if ((m_Np != Np) || (m_Nc != Nc))
+    // only grow the buffers, so that rebuilding the cell list every frame does not reallocate
+    if (Np > m_max_Np)
         {
-        m_cell_list = std::shared_ptr<unsigned int>(new unsigned int[Np + Nc], std::default_delete<unsigned int[]>());
+        m_cell_idx = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
+        m_point_cell = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
+        m_max_Np = Np;
+        }
+    if (Nc > m_max_Nc)
+        {
+        m_cell_start = std::shared_ptr<unsigned int>(new unsigned int[Nc + 1], std::default_delete<unsigned int[]>());
+        m_cell_fill = std::shared_ptr< std::atomic<unsigned int> >(new std::atomic<unsigned int>[Nc],
+                                                                    std::default_delete<std::atomic<unsigned int>[]>());
+        m_max_Nc = Nc;
+        }
+    if (m_sort_points && Np > m_max_sorted_points)
+        {
+        m_sorted_x = std::shared_ptr<float>(new float[Np], std::default_delete<float[]>());
+        m_sorted_y = std::shared_ptr<float>(new float[Np], std::default_delete<float[]>());
+        m_sorted_z = std::shared_ptr<float>(new float[Np], std::default_delete<float[]>());
+        m_max_sorted_points = Np;
         }
     m_Np = Np;
     m_Nc = Nc;
 
-    // initialize memory
+    // generate the cell list
+    assert(points);
+    unsigned int *cell_start = m_cell_start.get();
+    unsigned int *cell_idx = m_cell_idx.get();
+    unsigned int *point_cell = m_point_cell.get();
+    std::atomic<unsigned int> *cell_fill = m_cell_fill.get();
+    float *sorted_x = m_sorted_x.get();
+    float *sorted_y = m_sorted_y.get();
+    float *sorted_z = m_sorted_z.get();
+
     for (unsigned int cell = 0; cell < Nc; cell++)
         {
-        m_cell_list.get()[Np + cell] = LINK_CELL_TERMINATOR;
+        cell_fill[cell].store(0, std::memory_order_relaxed);
         }
 
-    // generate the cell list
-    assert(points);
+    // bin the points and count the occupancy of each cell
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            unsigned int cell = getCell(points[i]);
+            point_cell[i] = cell;
+            cell_fill[cell].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
 
-    for (int i = Np-1; i >= 0; i--)
+    // the exclusive prefix sum of the occupancies gives the first entry of each cell
+    cell_start[0] = 0;
+    unsigned int max_cell_size = 0;
+    for (unsigned int cell = 0; cell < Nc; cell++)
         {
-        unsigned int cell = getCell(points[i]);
-        m_cell_list.get()[i] = m_cell_list.get()[Np+cell];
-        m_cell_list.get()[Np+cell] = i;
+        unsigned int cell_size = cell_fill[cell].load(std::memory_order_relaxed);
+        max_cell_size = std::max(max_cell_size, cell_size);
+        cell_start[cell + 1] = cell_start[cell] + cell_size;
+        cell_fill[cell].store(cell_start[cell], std::memory_order_relaxed);
         }
-    }
+    m_max_cell_size = max_cell_size;
 
-void LinkCell::computeCellNeighbors()
-    {
-    // clear the list
-    m_cell_neighbors.clear();
-    m_cell_neighbors.resize(getNumCells());
-
-    // for each cell
-    for (unsigned int k = 0; k < m_cell_index.getD(); k++)
-        for (unsigned int j = 0; j < m_cell_index.getH(); j++)
-            for (unsigned int i = 0; i < m_cell_index.getW(); i++)
+    // scatter the indices into their cells
+    parallel_for(blocked_range<size_t>(0, Np),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            cell_idx[cell_fill[point_cell[i]].fetch_add(1, std::memory_order_relaxed)] = i;
+            }
+        });
+
+    // the scatter order within a cell depends on the thread schedule, so sort each cell to keep the iteration
+    // order deterministic (ascending index), then gather the sorted positions if requested
+    parallel_for(blocked_range<size_t>(0, Nc),
+        [=] (const blocked_range<size_t>& r)
+        {
+        for (size_t cell = r.begin(); cell != r.end(); ++cell)
+            {
+            std::sort(cell_idx + cell_start[cell], cell_idx + cell_start[cell + 1]);
+            if (sorted_x != NULL)
                 {
-                // clear the list
-                unsigned int cur_cell = m_cell_index(i,j,k);
-                m_cell_neighbors[cur_cell].clear();
-
-                // loop over the neighbor cells
-                int starti, startj, startk;
-                int endi, endj, endk;
-                if (m_celldim.x < 3)
+                for (unsigned int k = cell_start[cell]; k != cell_start[cell + 1]; ++k)
                     {
-                    starti = (int)i;
-                    }
-                else
-                    {
-                    starti = (int)i - 1;
-                    }
-                if (m_celldim.y < 3)
-                    {
-                    startj = (int)j;
-                    }
-                else
-                    {
-                    startj = (int)j - 1;
-                    }
-                if (m_celldim.z < 3)
-                    {
-                    startk = (int)k;
-                    }
-                else
-                    {
-                    startk = (int)k - 1;
+                    const vec3<float> point = getCellImage(points[cell_idx[k]]);
+                    sorted_x[k] = point.x;
+                    sorted_y[k] = point.y;
+                    sorted_z[k] = point.z;
                     }
+                }
+            }
+        });
+    }
 
-                if (m_celldim.x < 2)
-                    {
-                    endi = (int)i;
-                    }
-                else
-                    {
-                    endi = (int)i + 1;
-                    }
-                if (m_celldim.y < 2)
-                    {
-                    endj = (int)j;
-                    }
-                else
-                    {
-                    endj = (int)j + 1;
-                    }
-                if (m_celldim.z < 2)
+void LinkCell::getNeighborCandidates(const vec3<float>& p, unsigned int i, const NeighborList *nlist,
+                                     std::vector<unsigned int>& candidates) const
+    {
+    candidates.clear();
+    if (nlist != NULL)
+        {
+        const size_t *segments = nlist->getSegments();
+        const size_t *index_j = nlist->getIndexJ();
+        for (size_t bond = segments[i]; bond != segments[i+1]; ++bond)
+            candidates.push_back(index_j[bond]);
+        return;
+        }
+
+    // the particles of each neighboring cell are a contiguous range of the sorted index array
+    const unsigned int *cell_start = m_cell_start.get();
+    const unsigned int *cell_idx = m_cell_idx.get();
+    const CellNeighbors neigh_cells = getCellNeighbors(getCell(p));
+    for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        {
+        unsigned int neigh_cell = neigh_cells[neigh_idx];
+        candidates.insert(candidates.end(), cell_idx + cell_start[neigh_cell], cell_idx + cell_start[neigh_cell + 1]);
+        }
+    }
+
+void LinkCell::getNeighbors(const vec3<float>& p, unsigned int i, const NeighborList *nlist, const vec3<float> *points,
+                            const DistanceKernel& kernel, std::vector<unsigned int>& neighbors,
+                            std::vector< vec3<float> >& deltas) const
+    {
+    neighbors.clear();
+    deltas.clear();
+    const float rmaxsq = kernel.getRMax() * kernel.getRMax();
+    if (nlist != NULL)
+        {
+        const size_t *segments = nlist->getSegments();
+        const size_t *index_j = nlist->getIndexJ();
+        for (size_t bond = segments[i]; bond != segments[i+1]; ++bond)
+            {
+            const vec3<float> delta = m_box.wrap(points[index_j[bond]] - p);
+            if (dot(delta, delta) < rmaxsq)
+                {
+                neighbors.push_back(index_j[bond]);
+                deltas.push_back(delta);
+                }
+            }
+        return;
+        }
+
+    // test each neighboring cell as one block of the sorted positions, compacting the hits onto the end
+    assert(m_sorted_x.get() != NULL);
+    const unsigned int *cell_start = m_cell_start.get();
+    const unsigned int *cell_idx = m_cell_idx.get();
+    const vec3<float> ref = getCellImage(p);
+    const CellNeighbors neigh_cells = getCellNeighbors(getCell(p));
+    for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        {
+        unsigned int neigh_cell = neigh_cells[neigh_idx];
+        size_t n = neighbors.size();
+        unsigned int cell_size = cell_start[neigh_cell + 1] - cell_start[neigh_cell];
+        neighbors.resize(n + cell_size);
+        deltas.resize(n + cell_size);
+        unsigned int found = findInCell(kernel, neigh_cells, neigh_idx, ref, &neighbors[n], NULL, &deltas[n]);
+        for (unsigned int m = 0; m < found; ++m)
+            neighbors[n + m] = cell_idx[neighbors[n + m]];
+        neighbors.resize(n + found);
+        deltas.resize(n + found);
+        }
+    }
+
+unsigned int LinkCell::findInCell(const DistanceKernel& kernel, const CellNeighbors& neigh_cells, unsigned int n,
+                                  const vec3<float>& ref, unsigned int *idx, float *r, vec3<float> *delta) const
+    {
+    const unsigned int neigh_cell = neigh_cells[n];
+    const unsigned int begin = m_cell_start.get()[neigh_cell];
+    const unsigned int end = m_cell_start.get()[neigh_cell + 1];
+    // the image shifts only give the minimum image for pairs closer than the cell width
+    if (neigh_cells.hasShifts() && kernel.getRMax() <= m_cell_width)
+        return kernel.computeImage(ref - neigh_cells.getShift(n), m_sorted_x.get(), m_sorted_y.get(),
+                                   m_sorted_z.get(), begin, end, idx, r, NULL, delta);
+    return kernel.compute(ref, m_sorted_x.get(), m_sorted_y.get(), m_sorted_z.get(), begin, end, idx, r, NULL, delta);
+    }
+
+void LinkCell::compute(const box::Box& box,
+                       const vec3<float> *ref_points,
+                       unsigned int Nref,
+                       const vec3<float> *points,
+                       unsigned int Np,
+                       bool exclude_ii)
+    {
+    // the bond search reads the positions sorted by cell
+    box::Box b = box;
+    bool sort_points = m_sort_points;
+    m_sort_points = true;
+    computeCellList(b, points, Np);
+    m_sort_points = sort_points;
+
+    const DistanceKernel kernel(m_box, m_cell_width);
+    const unsigned int max_cell_size = m_max_cell_size;
+    m_neighbor_list.resize(m_neighbor_list.getNumBonds(), Nref, Np);
+
+    // both passes walk the cells in sorted order and test each one as a block of the sorted positions
+    const unsigned int *cell_idx = m_cell_idx.get();
+
+    // first pass: count the bonds of each reference point so that every thread can write its own segment
+    std::vector<size_t> counts(Nref + 1, 0);
+    parallel_for(blocked_range<size_t>(0, Nref),
+        [=, &counts] (const blocked_range<size_t>& r)
+        {
+        std::vector<unsigned int> found(max_cell_size);
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            const vec3<float> ref = getCellImage(ref_points[i]);
+            size_t num_bonds = 0;
+            const CellNeighbors neigh_cells = getCellNeighbors(getCell(ref_points[i]));
+            for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                {
+                const unsigned int num_found = findInCell(kernel, neigh_cells, neigh_idx, ref,
+                                                          found.data(), NULL, NULL);
+                for (unsigned int m = 0; m < num_found; ++m)
                     {
-                    endk = (int)k;
+                    if (!(exclude_ii && i == cell_idx[found[m]]))
+                        num_bonds++;
                     }
-                else
+                }
+            counts[i + 1] = num_bonds;
+            }
+        });
+
+    for (size_t i = 0; i < Nref; ++i)
+        counts[i + 1] += counts[i];
+    m_neighbor_list.resize(counts[Nref], Nref, Np);
+
+    // second pass: fill the bonds of each reference point, in cell order
+    size_t *index_i = m_neighbor_list.getIndexI();
+    size_t *index_j = m_neighbor_list.getIndexJ();
+    float *distances = m_neighbor_list.getDistances();
+    float *weights = m_neighbor_list.getWeights();
+    parallel_for(blocked_range<size_t>(0, Nref),
+        [=, &counts] (const blocked_range<size_t>& r)
+        {
+        std::vector<unsigned int> found(max_cell_size);
+        std::vector<float> found_r(max_cell_size);
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            const vec3<float> ref = getCellImage(ref_points[i]);
+            size_t bond = counts[i];
+            const CellNeighbors neigh_cells = getCellNeighbors(getCell(ref_points[i]));
+            for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                {
+                const unsigned int num_found = findInCell(kernel, neigh_cells, neigh_idx, ref,
+                                                          found.data(), found_r.data(), NULL);
+                for (unsigned int m = 0; m < num_found; ++m)
                     {
-                    endk = (int)k + 1;
+                    const unsigned int j = cell_idx[found[m]];
+                    if (exclude_ii && i == j)
+                        continue;
+                    index_i[bond] = i;
+                    index_j[bond] = j;
+                    distances[bond] = found_r[m];
+                    weights[bond] = 1.0f;
+                    bond++;
                     }
-                if (m_box.is2D())
-                    startk = endk = k;
-
-                for (int neighk = startk; neighk <= endk; neighk++)
-                    for (int neighj = startj; neighj <= endj; neighj++)
-                        for (int neighi = starti; neighi <= endi; neighi++)
-                            {
-                            // wrap back into the box
-                            int wrapi = (m_cell_index.getW()+neighi) % m_cell_index.getW();
-                            int wrapj = (m_cell_index.getH()+neighj) % m_cell_index.getH();
-                            int wrapk = (m_cell_index.getD()+neighk) % m_cell_index.getD();
-
-                            unsigned int neigh_cell = m_cell_index(wrapi, wrapj, wrapk);
-                            // add to the list
-                            m_cell_neighbors[cur_cell].push_back(neigh_cell);
-                            }
-
-                // sort the list
-                sort(m_cell_neighbors[cur_cell].begin(), m_cell_neighbors[cur_cell].end());
                 }
+            }
+        });
+    m_neighbor_list.updateSegments();
+    }
+
+void LinkCell::computeCellNeighbors()
+    {
+    // build the stencil of offsets to the neighbors of a cell; it is the same for every cell. Dimensions with
+    // fewer than 3 cells only get the offsets that reach distinct cells.
+    int start[3], end[3];
+    const unsigned int dims[3] = {m_celldim.x, m_celldim.y, m_celldim.z};
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        start[d] = (dims[d] < 3) ? 0 : -1;
+        end[d] = (dims[d] < 2) ? 0 : 1;
+        }
+    if (m_box.is2D())
+        start[2] = end[2] = 0;
+
+    std::vector< vec3<int> > stencil;
+    for (int dk = start[2]; dk <= end[2]; dk++)
+        for (int dj = start[1]; dj <= end[1]; dj++)
+            for (int di = start[0]; di <= end[0]; di++)
+                stencil.push_back(vec3<int>(di, dj, dk));
+
+    unsigned int Nc = getNumCells();
+    unsigned int num_neighbor_cells = stencil.size();
+    size_t size = size_t(Nc)*num_neighbor_cells;
+    if (size > m_max_cell_neighbors)
+        {
+        m_cell_neighbors = std::shared_ptr<unsigned int>(new unsigned int[size], std::default_delete<unsigned int[]>());
+        m_cell_neighbor_images = std::shared_ptr<unsigned char>(new unsigned char[size],
+                                                                std::default_delete<unsigned char[]>());
+        m_max_cell_neighbors = size;
+        }
+    m_num_neighbor_cells = num_neighbor_cells;
+
+    // apply the stencil to every cell, wrapping back into the box and recording which image of the neighbor cell
+    // borders the cell
+    unsigned int *cell_neighbors = m_cell_neighbors.get();
+    unsigned char *cell_neighbor_images = m_cell_neighbor_images.get();
+    const Index3D cell_index = m_cell_index;
+    parallel_for(blocked_range<size_t>(0, Nc),
+        [=, &stencil] (const blocked_range<size_t>& r)
+        {
+        const int w = cell_index.getW();
+        const int h = cell_index.getH();
+        const int d = cell_index.getD();
+        std::vector< std::pair<unsigned int, unsigned char> > entries(num_neighbor_cells);
+        for (size_t cell = r.begin(); cell != r.end(); ++cell)
+            {
+            vec3<unsigned int> c = cell_index(cell);
+            for (unsigned int n = 0; n < num_neighbor_cells; n++)
+                {
+                int i = (int)c.x + stencil[n].x;
+                int j = (int)c.y + stencil[n].y;
+                int k = (int)c.z + stencil[n].z;
+                int imgi = (i < 0) ? -1 : ((i >= w) ? 1 : 0);
+                int imgj = (j < 0) ? -1 : ((j >= h) ? 1 : 0);
+                int imgk = (k < 0) ? -1 : ((k >= d) ? 1 : 0);
+                entries[n].first = cell_index(i - imgi*w, j - imgj*h, k - imgk*d);
+                entries[n].second = (imgk + 1)*9 + (imgj + 1)*3 + (imgi + 1);
+                }
+
+            // sort the list
+            std::sort(entries.begin(), entries.end());
+            unsigned int *neighbors = cell_neighbors + cell*num_neighbor_cells;
+            unsigned char *images = cell_neighbor_images + cell*num_neighbor_cells;
+            for (unsigned int n = 0; n < num_neighbor_cells; n++)
+                {
+                neighbors[n] = entries[n].first;
+                images[n] = entries[n].second;
+                }
+            }
+        });
+    }
+
+void LinkCell::computeImageShifts()
+    {
+    // a neighbor cell across the boundary of a periodic dimension is translated by a lattice vector, one across the
+    // boundary of a non periodic dimension is not a neighbor at all and stays out of reach
+    uchar3 periodic = m_box.getPeriodic();
+    vec3<float> a[3];
+    for (unsigned int d = 0; d < 3; d++)
+        a[d] = (d < 2 || !m_box.is2D()) ? m_box.getLatticeVector(d) : vec3<float>(0, 0, 0);
+    if (!periodic.x)
+        a[0] = vec3<float>(0, 0, 0);
+    if (!periodic.y)
+        a[1] = vec3<float>(0, 0, 0);
+    if (!periodic.z)
+        a[2] = vec3<float>(0, 0, 0);
+    for (int imgk = -1; imgk <= 1; imgk++)
+        for (int imgj = -1; imgj <= 1; imgj++)
+            for (int imgi = -1; imgi <= 1; imgi++)
+                m_image_shifts[(imgk + 1)*9 + (imgj + 1)*3 + (imgi + 1)] =
+                    a[0]*float(imgi) + a[1]*float(imgj) + a[2]*float(imgk);
+
+    // with fewer than 3 cells along a periodic dimension, a neighbor cell borders the cell through more than one
+    // image, and the pairs have to be wrapped one at a time
+    m_image_shifts_valid = m_num_neighbor_cells > 0;
+    if (periodic.x && m_celldim.x < 3)
+        m_image_shifts_valid = false;
+    if (periodic.y && m_celldim.y < 3)
+        m_image_shifts_valid = false;
+    if (periodic.z && m_celldim.z < 3 && !m_box.is2D())
+        m_image_shifts_valid = false;
     }
 
 // void export_LinkCell()
@@ -3,10 +3,15 @@
 
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <algorithm>
+#include <tbb/task_group.h>
 
 #include "../box/box.h"
 #include "HOOMDMath.h"
 #include "Index1D.h"
+#include "NeighborList.h"
+#include "DistanceKernel.h"
 
 #ifndef _LINKCELL_H__
 #define _LINKCELL_H__
@@ -18,19 +23,19 @@
 namespace freud { namespace locality {
 
 /*! \internal
-    \brief Signfies the end of the linked list
+    \brief Signfies the end of the iteration over a cell
 */
 const unsigned int LINK_CELL_TERMINATOR = 0xffffffff;
 
-//! Iterates over particles in a link cell list generated by LinkCell
-/*! The link-cell structure is not trivial to iterate over. This helper class makes that easier both in c++ and
-    provides a python compatibile interface for direct usage there.
+//! Iterates over particles in a cell list generated by LinkCell
+/*! The particles of each cell are stored contiguously in the cell list, so iterating over a cell is a walk over a
+    range of the sorted index array. This helper class makes that easy both in c++ and provides a python compatibile
+    interface for direct usage there.
 
-    An IteratorLinkCell is given the bare essentials it needs to iterate over a given cell, the cell list,
-    the number of particles, number of cells and the cell to iterate over. Call next() to get the index of the next
-    particle in the cell, atEnd() will return true if you are at the end. In C++, next() will crash the code if you
-    attempt to iterate past the end (no bounds checking for performance). When called from python, a different version
-    of next is used that will throw StopIteration at the end.
+    An IteratorLinkCell is given the bare essentials it needs to iterate over a given cell: the sorted index array and
+    the range of that array holding the cell. Call next() to get the index of the next particle in the cell, atEnd()
+    will return true if you are at the end. When called from python, a different version of next is used that will
+    throw StopIteration at the end.
 
     A loop over all of the particles in a cell can be acomplished with the following code in c++.
 \code
@@ -47,29 +52,24 @@ class IteratorLinkCell
     {
     public:
         IteratorLinkCell():
-            m_cell_list(NULL), m_Np(0), m_Nc(0), m_cur_idx(LINK_CELL_TERMINATOR), m_cell(0) {}
+            m_cell_idx(NULL), m_begin(0), m_end(0), m_pos(0), m_cur_idx(LINK_CELL_TERMINATOR) {}
 
-        IteratorLinkCell(const std::shared_ptr<unsigned int>& cell_list,
-                         unsigned int Np,
-                         unsigned int Nc,
-                         unsigned int cell)
-                         : m_cell_list(cell_list.get()), m_Np(Np), m_Nc(Nc)
+        IteratorLinkCell(const std::shared_ptr<unsigned int>& cell_idx,
+                         unsigned int begin,
+                         unsigned int end)
+                         : m_cell_idx(cell_idx.get()), m_begin(begin), m_end(end), m_pos(begin), m_cur_idx(0)
             {
-            assert(cell < Nc);
-            assert(Np > 0);
-            assert(Nc > 0);
-            m_cell = cell;
-            m_cur_idx = m_Np + cell;
+            assert(begin <= end);
             }
 
         //! Copy the position of rhs into this object
         void copy(const IteratorLinkCell &rhs)
         {
-            m_cell_list = rhs.m_cell_list;
-            m_Np = rhs.m_Np;
-            m_Nc = rhs.m_Nc;
+            m_cell_idx = rhs.m_cell_idx;
+            m_begin = rhs.m_begin;
+            m_end = rhs.m_end;
+            m_pos = rhs.m_pos;
             m_cur_idx = rhs.m_cur_idx;
-            m_cell = rhs.m_cell;
         }
 
         //! Test if the iteration over the cell is complete
@@ -78,46 +78,99 @@ class IteratorLinkCell
             return (m_cur_idx == LINK_CELL_TERMINATOR);
             }
 
-        //! Get the next particle index in the list
+        //! Get the next particle index in the cell
         unsigned int next()
             {
-            m_cur_idx = m_cell_list[m_cur_idx];
+            if (m_pos == m_end)
+                m_cur_idx = LINK_CELL_TERMINATOR;
+            else
+                m_cur_idx = m_cell_idx[m_pos++];
             return m_cur_idx;
             }
 
-        //! Get the first particle index in the list
+        //! Get the first particle index in the cell
         unsigned int begin()
             {
-            m_cur_idx = m_Np + m_cell;
-            m_cur_idx = m_cell_list[m_cur_idx];
-            return m_cur_idx;
+            m_pos = m_begin;
+            m_cur_idx = 0;
+            return next();
             }
 
-//         //! Get the next particle index in the list with python StopIteration
-//         unsigned int nextPy()
-//             {
-//             m_cur_idx = m_cell_list[m_cur_idx];
+    private:
+        const unsigned int *m_cell_idx;                   //!< Particle indices sorted by cell
+        unsigned int m_begin;                             //!< First entry of the cell in m_cell_idx
+        unsigned int m_end;                               //!< One past the last entry of the cell in m_cell_idx
+        unsigned int m_pos;                               //!< Next entry to read
+        unsigned int m_cur_idx;                           //!< Current index
+    };
 
-//             if (atEnd())
-//                 {
-//                 PyErr_SetNone(PyExc_StopIteration);
-//                 boost::python::throw_error_already_set();
-//                 }
+//! Contiguous list of the cells neighboring a cell, as returned by LinkCell::getCellNeighbors()
+/*! This is a lightweight view into the flat neighbor cell table of a LinkCell; it stays valid until the cell
+    dimensions of the parent LinkCell change.
 
-//             return m_cur_idx;
-//             }
+    When hasShifts() is true, getShift(n) is the lattice translation that takes the points of neighboring cell n to
+    their periodic image adjacent to the cell, so that for a point p stored in neighboring cell n and a reference
+    point ref in the cell (see LinkCell::getCellImage()), p - (ref - getShift(n)) is the minimum image bond vector
+    whenever it is shorter than the cell width. Cells away from the box boundaries have no nonzero shift.
+*/
+class CellNeighbors
+    {
+    public:
+        CellNeighbors() : m_cells(NULL), m_images(NULL), m_image_shifts(NULL), m_size(0) {}
+
+        CellNeighbors(const unsigned int *cells, unsigned int size)
+            : m_cells(cells), m_images(NULL), m_image_shifts(NULL), m_size(size) {}
+
+        CellNeighbors(const unsigned int *cells, const unsigned char *images, const vec3<float> *image_shifts,
+                      unsigned int size)
+            : m_cells(cells), m_images(images), m_image_shifts(image_shifts), m_size(size) {}
+
+        //! Get the number of neighboring cells
+        unsigned int size() const
+            {
+            return m_size;
+            }
+
+        //! Get the index of neighboring cell n
+        unsigned int operator[](unsigned int n) const
+            {
+            return m_cells[n];
+            }
+
+        //! Pointer to the first neighboring cell
+        const unsigned int *begin() const
+            {
+            return m_cells;
+            }
+
+        //! Pointer past the last neighboring cell
+        const unsigned int *end() const
+            {
+            return m_cells + m_size;
+            }
+
+        //! True if the neighboring cells come with image shifts
+        bool hasShifts() const
+            {
+            return m_image_shifts != NULL;
+            }
+
+        //! Get the lattice translation from neighboring cell n to its image adjacent to the cell
+        const vec3<float>& getShift(unsigned int n) const
+            {
+            return m_image_shifts[m_images[n]];
+            }
 
     private:
-        const unsigned int *m_cell_list;                  //!< The cell list
-        unsigned int m_Np;                                //!< Number of particles in the cell list
-        unsigned int m_Nc;                                //!< Number of cells in the cell list
-        unsigned int m_cur_idx;                           //!< Current index
-        unsigned int m_cell;                              //!< Cell being considered
+        const unsigned int *m_cells;                      //!< Neighbor cell indices
+        const unsigned char *m_images;                    //!< Image code of each neighbor cell
+        const vec3<float> *m_image_shifts;                //!< Translation of each image code (NULL if unusable)
+        unsigned int m_size;                              //!< Number of neighbor cells
     };
 
 //! Computes a cell id for each particle and a link cell data structure for iterating through it
-/*! For simplicity in only needing a small number of arrays, the link cell algorithm is used to generate and store
-    the cell list data for particles.
+/*! The cell list is built with a parallel counting sort: the particles are binned into cells, the cell occupancies
+    are prefix summed into cell offsets, and the particle indices are scattered into an array sorted by cell.
 
     Cells are given a nominal minimum width \a cell_width. Each dimension of the box is split into an integer number of
     cells no smaller than \a cell_width wide in that dimension. The actual number of cells along each dimension is
@@ -129,9 +182,22 @@ class IteratorLinkCell
     \endcode
     and so on for j,k (y,z). Call getCellCoord to do this computation for an arbitrary point.
 
+    All buffers are capacity based: they are only reallocated when the number of particles or cells grows, so
+    rebuilding the cell list every frame of a trajectory (even with a fluctuating box) does not allocate.
+
     <b>Data structures:</b><br>
-    The internal data structure used in LinkCell is a linked list of particle indices. See IteratorLinkCell
-    for information on how to iterate through these.
+    The particles in cell c are getCellIndices()[k] for k in [getCellOffsets()[c], getCellOffsets()[c+1]), in
+    ascending index order. Neighbor loops can walk these ranges directly, or use IteratorLinkCell. When
+    setSortPoints(true) is set, a copy of the positions in the same order is kept as well, one array per coordinate
+    (getSortedX()[k] is the x coordinate of getCellIndices()[k]), so that the positions of the particles in a cell
+    are read contiguously and can be handed to a DistanceKernel.
+
+    <b>Triclinic boxes:</b><br>
+    Cells are binned in fractional coordinates, so they tile sheared boxes as well. Along with each neighbor cell, the
+    neighbor table stores which periodic image of that cell borders the cell. When every periodic dimension has at
+    least 3 cells, these images are unique and CellNeighbors::getShift() gives the translation to them; pairs within
+    the cell width can then be found with plain subtraction (DistanceKernel::computeImage()) instead of a minimum
+    image wrap with tilt factors for every pair.
 
     <b>2D:</b><br>
     LinkCell properly handles 2D boxes. When a 2D box is handed to LinkCell, it creates an m x n x 1 cell list and
@@ -257,14 +323,125 @@ class LinkCell
         //! Iterate over particles in a cell
         iteratorcell itercell(unsigned int cell) const
             {
-            assert(m_cell_list.get() != NULL);
-            return iteratorcell(m_cell_list, m_Np, getNumCells(), cell);
+            assert(m_cell_idx.get() != NULL);
+            return iteratorcell(m_cell_idx, m_cell_start.get()[cell], m_cell_start.get()[cell + 1]);
+            }
+
+        //! Get the first entry of each cell in the sorted index array (getNumCells() + 1 entries)
+        const unsigned int *getCellOffsets() const
+            {
+            return m_cell_start.get();
+            }
+
+        //! Get the particle indices sorted by cell
+        const unsigned int *getCellIndices() const
+            {
+            return m_cell_idx.get();
+            }
+
+        //! Get the x coordinates of the particles sorted by cell, or NULL unless setSortPoints(true) was called
+        const float *getSortedX() const
+            {
+            return m_sorted_x.get();
+            }
+
+        //! Get the y coordinates of the particles sorted by cell, or NULL unless setSortPoints(true) was called
+        const float *getSortedY() const
+            {
+            return m_sorted_y.get();
+            }
+
+        //! Get the z coordinates of the particles sorted by cell, or NULL unless setSortPoints(true) was called
+        const float *getSortedZ() const
+            {
+            return m_sorted_z.get();
+            }
+
+        //! Get the number of particles in the fullest cell
+        unsigned int getMaxCellSize() const
+            {
+            return m_max_cell_size;
+            }
+
+        //! Get whether computeCellList keeps a copy of the positions sorted by cell
+        bool getSortPoints() const
+            {
+            return m_sort_points;
+            }
+
+        //! Set whether computeCellList keeps a copy of the positions sorted by cell
+        void setSortPoints(bool sort_points)
+            {
+            m_sort_points = sort_points;
+            if (!sort_points)
+                {
+                m_sorted_x.reset();
+                m_sorted_y.reset();
+                m_sorted_z.reset();
+                m_max_sorted_points = 0;
+                }
             }
 
         //! Get a list of neighbors to a cell
-        const std::vector<unsigned int>& getCellNeighbors(unsigned int cell) const
+        CellNeighbors getCellNeighbors(unsigned int cell) const
+            {
+            return CellNeighbors(m_cell_neighbors.get() + cell*m_num_neighbor_cells,
+                                 m_cell_neighbor_images.get() + cell*m_num_neighbor_cells,
+                                 m_image_shifts_valid ? m_image_shifts : NULL, m_num_neighbor_cells);
+            }
+
+        //! Get the half of the neighbors of a cell used for symmetric (self) traversals
+        /*! The half neighbors of \a cell are the cell itself plus the neighbors with a larger index (13 on average
+            in 3D, 4 in 2D). Since the neighbor relation between cells is symmetric, looping over every cell and its
+            half neighbors visits each unordered pair of points exactly once, provided pairs within the same cell
+            are only taken once.
+        */
+        CellNeighbors getCellHalfNeighbors(unsigned int cell) const
+            {
+            const unsigned int *begin = m_cell_neighbors.get() + cell*m_num_neighbor_cells;
+            const unsigned int *end = begin + m_num_neighbor_cells;
+            // the neighbor list of a cell is sorted, so its half is a suffix of it
+            const unsigned int *half = std::lower_bound(begin, end, cell);
+            return CellNeighbors(half, m_cell_neighbor_images.get() + (half - m_cell_neighbors.get()),
+                                 m_image_shifts_valid ? m_image_shifts : NULL, end - half);
+            }
+
+        //! True if the neighbor cells come with usable image shifts (see CellNeighbors::getShift())
+        bool hasImageShifts() const
+            {
+            return m_image_shifts_valid;
+            }
+
+        //! Get the image of p inside the cell that getCell(p) returns
+        /*! Points on the upper box boundaries (or slightly outside the box) are assigned to the cells at the
+            opposite boundaries; this translates them there. Points inside the box are returned unchanged. The
+            positions returned by getSortedX() and friends are such images.
+        */
+        vec3<float> getCellImage(const vec3<float>& p) const
+            {
+            // same binning as getCellCoord()
+            vec3<float> alpha = m_box.makeFraction(p);
+            float fx = floorf(alpha.x * float(m_cell_index.getW()));
+            float fy = floorf(alpha.y * float(m_cell_index.getH()));
+            float fz = floorf(alpha.z * float(m_cell_index.getD()));
+            int ix = (fx >= float(m_cell_index.getW())) ? 1 : ((fx < 0.0f) ? -1 : 0);
+            int iy = (fy >= float(m_cell_index.getH())) ? 1 : ((fy < 0.0f) ? -1 : 0);
+            int iz = (fz >= float(m_cell_index.getD())) ? 1 : ((fz < 0.0f) ? -1 : 0);
+            if (ix == 0 && iy == 0 && iz == 0)
+                return p;
+            return p - m_image_shifts[(iz + 1)*9 + (iy + 1)*3 + (ix + 1)];
+            }
+
+        //! Get the number of neighbors of every cell (the size of the neighbor stencil)
+        unsigned int getNumCellNeighbors() const
+            {
+            return m_num_neighbor_cells;
+            }
+
+        //! Get the largest number of points in the neighboring cells of any cell, e.g. to bound histogram counts
+        size_t getMaxNumCandidates() const
             {
-            return m_cell_neighbors[cell];
+            return size_t(m_num_neighbor_cells) * m_max_cell_size;
             }
 
         // //! Python wrapper for getCellNeighbors
@@ -281,6 +458,55 @@ class LinkCell
 
         // //! Python wrapper for computeCellList
         // void computeCellListPy(box::Box& box, boost::python::numeric::array points);
+
+        //! Compute the cell list of points and the NeighborList of all (ref_point, point) pairs within cell_width
+        /*! Bonds (i, i) are only dropped when \a exclude_ii is set, which callers should do when ref_points and
+            points are the same array.
+        */
+        void compute(const box::Box& box, const vec3<float> *ref_points, unsigned int Nref,
+                     const vec3<float> *points, unsigned int Np, bool exclude_ii=false);
+
+        //! Gather the candidate neighbors of reference point i at position p
+        /*! If \a nlist is given, the candidates are the bonds of i in nlist; otherwise they are all points in the
+            cells neighboring the cell of p, and computeCellList() must have been called first. Candidates are not
+            filtered by distance.
+        */
+        void getNeighborCandidates(const vec3<float>& p, unsigned int i, const NeighborList *nlist,
+                                   std::vector<unsigned int>& candidates) const;
+
+        //! Find the neighbors of reference point i at position p within the cutoff of \a kernel
+        /*! If \a nlist is given, the candidates are the bonds of i in nlist and their bond vectors are wrapped one at
+            a time. Otherwise the points in the cells neighboring the cell of p are tested with \a kernel, which
+            requires computeCellList() to have been called with setSortPoints(true). On return, neighbors[m] is
+            the index of a point closer than kernel.getRMax() to p and deltas[m] its minimum image bond vector from
+            p.
+        */
+        void getNeighbors(const vec3<float>& p, unsigned int i, const NeighborList *nlist, const vec3<float> *points,
+                          const DistanceKernel& kernel, std::vector<unsigned int>& neighbors,
+                          std::vector< vec3<float> >& deltas) const;
+
+        //! Find the points of neighboring cell n of a cell that are within the cutoff of \a kernel
+        /*! \param kernel Distance kernel
+            \param neigh_cells Neighbors of the cell of ref
+            \param n Index of the neighboring cell in \a neigh_cells
+            \param ref Reference point, as returned by getCellImage()
+            \param idx Output: entries of the points found in the sorted arrays (see DistanceKernel::compute())
+            \param r Output (may be NULL): distances of the points found
+            \param delta Output (may be NULL): bond vectors from ref to the points found
+            \returns The number of points found
+
+            Requires computeCellList() to have been called with setSortPoints(true). The pairs are not wrapped one
+            at a time if the neighbor cells have image shifts and the cutoff is no larger than the cell width.
+        */
+        unsigned int findInCell(const DistanceKernel& kernel, const CellNeighbors& neigh_cells, unsigned int n,
+                                const vec3<float>& ref, unsigned int *idx, float *r, vec3<float> *delta) const;
+
+        //! Get the NeighborList computed by the last call to compute()
+        NeighborList *getNList()
+            {
+            return &m_neighbor_list;
+            }
+
     private:
 
         //! Rounding helper function.
@@ -293,14 +519,73 @@ class LinkCell
         float m_cell_width;         //!< Minimum necessary cell width cutoff
         vec3<unsigned int> m_celldim; //!< Cell dimensions
 
-        std::shared_ptr<unsigned int> m_cell_list;    //!< The cell list last computed
+        bool m_sort_points;         //!< True if computeCellList keeps the sorted positions
+
+        std::shared_ptr<unsigned int> m_cell_start;   //!< First entry of each cell in m_cell_idx
+        std::shared_ptr<unsigned int> m_cell_idx;     //!< Particle indices sorted by cell
+        std::shared_ptr<unsigned int> m_point_cell;   //!< Cell of each particle
+        std::shared_ptr< std::atomic<unsigned int> > m_cell_fill; //!< Per cell counters used while sorting
+        std::shared_ptr<float> m_sorted_x;            //!< x coordinates sorted by cell (if m_sort_points)
+        std::shared_ptr<float> m_sorted_y;            //!< y coordinates sorted by cell (if m_sort_points)
+        std::shared_ptr<float> m_sorted_z;            //!< z coordinates sorted by cell (if m_sort_points)
+
+        unsigned int m_max_Np;      //!< Number of particles that fit in the per particle buffers
+        unsigned int m_max_Nc;      //!< Number of cells that fit in the per cell buffers
+        unsigned int m_max_sorted_points; //!< Number of positions that fit in m_sorted_x, m_sorted_y and m_sorted_z
+        unsigned int m_max_cell_size;     //!< Number of particles in the fullest cell
+
+        unsigned int m_num_neighbor_cells;            //!< Number of neighbors of each cell
+        size_t m_max_cell_neighbors;                  //!< Number of entries that fit in m_cell_neighbors
+        std::shared_ptr<unsigned int> m_cell_neighbors; //!< Flat table of the neighbors of each cell
+        std::shared_ptr<unsigned char> m_cell_neighbor_images; //!< Image code of each entry of m_cell_neighbors
+
+        vec3<float> m_image_shifts[27];  //!< Lattice translation of each image code (dx + 3*dy + 9*dz + 13)
+        bool m_image_shifts_valid;       //!< True if every neighbor cell has a unique image
 
-        std::vector< std::vector<unsigned int> > m_cell_neighbors;    //!< List of cell neighborts to each cell
+        NeighborList m_neighbor_list;    //!< Bonds computed by the last call to compute()
 
         //! Helper function to compute cell neighbors
         void computeCellNeighbors();
+
+        //! Helper function to compute the image translations for the current box
+        void computeImageShifts();
     };
 
+//! Compute the cell lists of the frames of a trajectory one frame ahead of processing them
+/*! process(frame) is called for frames 0 ... n_frames - 1 in order, with the cell list of points + frame * Np in
+    boxes[frame] in \a lc. While a frame is processed, the cell list of the next frame is built in \a lc_next (created
+    with the settings of \a lc if NULL), and the two are swapped before the next frame. Both are owned by the caller.
+*/
+template<typename Process>
+void pipelineCellLists(LinkCell *&lc, LinkCell *&lc_next, box::Box *boxes, const vec3<float> *points,
+                       unsigned int Np, unsigned int n_frames, const Process& process)
+    {
+    if (n_frames == 0)
+        return;
+    if (lc_next == NULL)
+        {
+        lc_next = new LinkCell(boxes[0], lc->getCellWidth());
+        lc_next->setSortPoints(lc->getSortPoints());
+        }
+
+    lc->computeCellList(boxes[0], points, Np);
+    for (unsigned int frame = 0; frame < n_frames; frame++)
+        {
+        tbb::task_group next_frame;
+        if (frame + 1 < n_frames)
+            {
+            LinkCell *next = lc_next;
+            next_frame.run([=] ()
+                {
+                next->computeCellList(boxes[frame + 1], points + size_t(frame + 1) * Np, Np);
+                });
+            }
+        process(frame);
+        next_frame.wait();
+        std::swap(lc, lc_next);
+        }
+    }
+
 }; }; // end namespace freud::locality
 
 #endif // _LINKCELL_H__
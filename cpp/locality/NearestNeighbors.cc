@@ -24,22 +24,21 @@ namespace freud { namespace locality {
 
 // stop using
 NearestNeighbors::NearestNeighbors():
-    m_box(box::Box()), m_rmax(0), m_num_neighbors(0), m_scale(0), m_strict_cut(false), m_num_points(0), m_num_ref(0),
-    m_deficits()
+    m_box(box::Box()), m_rmax(0), m_num_neighbors(0), m_strict_cut(false), m_num_points(0), m_num_ref(0),
+    m_shell_width(0)
     {
     m_lc = new locality::LinkCell();
-    m_deficits = 0;
+    m_lc->setSortPoints(true);
     }
 
 NearestNeighbors::NearestNeighbors(float rmax,
                                    unsigned int num_neighbors,
-                                   float scale,
                                    bool strict_cut):
-    m_box(box::Box()), m_rmax(rmax), m_num_neighbors(num_neighbors), m_scale(scale), m_strict_cut(strict_cut), m_num_points(0),
-    m_num_ref(0), m_deficits()
+    m_box(box::Box()), m_rmax(rmax), m_num_neighbors(num_neighbors), m_strict_cut(strict_cut), m_num_points(0),
+    m_num_ref(0), m_shell_width(0)
     {
     m_lc = new locality::LinkCell(m_box, m_rmax);
-    m_deficits = 0;
+    m_lc->setSortPoints(true);
     }
 
 NearestNeighbors::~NearestNeighbors()
@@ -47,17 +46,83 @@ NearestNeighbors::~NearestNeighbors()
     delete m_lc;
     }
 
-//! Utility function to sort a pair<float, unsigned int> on the first
-//! element of the pair
-bool compareRsqVectors(const pair<float, pair<unsigned int, vec3<float> > > &left,
-                       const pair<float, pair<unsigned int, vec3<float> > > &right)
+void NearestNeighbors::setCutMode(const bool strict_cut)
     {
-    return left.first < right.first;
+    m_strict_cut = strict_cut;
     }
 
-void NearestNeighbors::setCutMode(const bool strict_cut)
+void NearestNeighbors::findNearest(const vec3<float>& p, unsigned int i, const vec3<float> *pos,
+                                   std::vector< pair<float, unsigned int> >& heap) const
     {
-    m_strict_cut = strict_cut;
+    heap.clear();
+    const Index3D& cell_index = m_lc->getCellIndexer();
+    const int dims[3] = {int(cell_index.getW()), int(cell_index.getH()), int(cell_index.getD())};
+    const vec3<unsigned int> c = m_lc->getCellCoord(p);
+    const int center[3] = {int(c.x), int(c.y), int(c.z)};
+    const unsigned int *cell_offsets = m_lc->getCellOffsets();
+    const unsigned int *cell_indices = m_lc->getCellIndices();
+
+    // range of cell offsets along each dimension: every cell is visited once, at the offset of its image closest
+    // to the center cell. LinkCell bins open dimensions periodically too, and the offset between two cells
+    // counted around the grid never exceeds their true offset, so the shells remain ordered by distance
+    int lo[3], hi[3];
+    int max_shell = 0;
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        lo[d] = -((dims[d] - 1)/2);
+        hi[d] = dims[d]/2;
+        max_shell = max(max_shell, hi[d]);
+        }
+
+    const float rmaxsq = m_rmax * m_rmax;
+    for (int shell = 0; shell <= max_shell; shell++)
+        {
+        // every point in shell s or beyond is at least (s - 1) cell widths away
+        if (shell > 0)
+            {
+            const float reach = float(shell - 1) * m_shell_width;
+            if (heap.size() == m_num_neighbors && heap.front().first <= reach*reach)
+                break;
+            if (m_strict_cut && reach >= m_rmax)
+                break;
+            }
+
+        for (int dz = max(-shell, lo[2]); dz <= min(shell, hi[2]); dz++)
+            for (int dy = max(-shell, lo[1]); dy <= min(shell, hi[1]); dy++)
+                {
+                // inside the faces of the shell only the two ends of each row belong to it
+                const bool on_face = (dz == -shell || dz == shell || dy == -shell || dy == shell);
+                const int step = on_face ? 1 : 2*shell;
+                for (int dx = on_face ? max(-shell, lo[0]) : -shell; dx <= min(shell, hi[0]); dx += step)
+                    {
+                    if (dx < lo[0])
+                        continue;
+                    const unsigned int cell = cell_index((center[0] + dx + dims[0]) % dims[0],
+                                                         (center[1] + dy + dims[1]) % dims[1],
+                                                         (center[2] + dz + dims[2]) % dims[2]);
+                    for (unsigned int k = cell_offsets[cell]; k < cell_offsets[cell + 1]; k++)
+                        {
+                        const unsigned int j = cell_indices[k];
+                        if (j == i)
+                            continue;
+                        const vec3<float> rij = m_box.wrap(pos[j] - p);
+                        const float rsq = dot(rij, rij);
+                        if (m_strict_cut && rsq >= rmaxsq)
+                            continue;
+                        if (heap.size() == m_num_neighbors)
+                            {
+                            if (rsq >= heap.front().first)
+                                continue;
+                            pop_heap(heap.begin(), heap.end());
+                            heap.pop_back();
+                            }
+                        heap.push_back(pair<float, unsigned int>(rsq, j));
+                        push_heap(heap.begin(), heap.end());
+                        }
+                    }
+                }
+        }
+    sort_heap(heap.begin(), heap.end());
     }
 
 void NearestNeighbors::compute(const box::Box& box,
@@ -81,105 +146,119 @@ void NearestNeighbors::compute(const box::Box& box,
         {
         m_wvec_array.get()[i] = vec3<float>(-1,-1,-1);
         }
-    // find the nearest neighbors
-    do
-        {
-        // compute the cell list
-        m_lc->computeCellList(m_box, pos, num_points);
 
-        m_deficits = 0;
-        parallel_for(blocked_range<size_t>(0,num_ref),
-            [=] (const blocked_range<size_t>& r)
+    // compute the cell list
+    m_lc->computeCellList(m_box, pos, num_points);
+    const Index3D& cell_index = m_lc->getCellIndexer();
+    vec3<float> L = m_box.getNearestPlaneDistance();
+    m_shell_width = min(L.x / cell_index.getW(), L.y / cell_index.getH());
+    if (!m_box.is2D())
+        m_shell_width = min(m_shell_width, L.z / cell_index.getD());
+
+    // first pass: most points have all of their neighbors within rmax, that is within the cells adjacent to their
+    // own, where the distance kernel needs no wrapping; the points short of neighbors are queued
+    const DistanceKernel kernel(m_box, m_rmax);
+    m_deficient.clear();
+    parallel_for(blocked_range<size_t>(0,num_ref),
+        [=, &kernel] (const blocked_range<size_t>& r)
+        {
+        vector<unsigned int> found;
+        vector< vec3<float> > found_delta;
+        vector< pair<float, unsigned int> > neighbors;
+        Index2D b_i = Index2D(m_num_neighbors, num_ref);
+        for(size_t i=r.begin(); i!=r.end(); ++i)
             {
-            float rmaxsq = m_rmax * m_rmax;
-            // tuple<> is c++11, so for now just make a pair with pairs inside
-            // this data structure holds rsq, idx
-            // vector< pair<float, unsigned int> > neighbors;
-            vector< pair<float, pair<unsigned int, vec3<float> > > > neighbors;
-            Index2D b_i = Index2D(m_num_neighbors, num_ref);
-            for(size_t i=r.begin(); i!=r.end(); ++i)
+            vec3<float> posi = ref_pos[i];
+            m_lc->getNeighbors(posi, i, NULL, pos, kernel, found, found_delta);
+            neighbors.clear();
+            for (unsigned int m = 0; m < found.size(); m++)
+                if (found[m] != i)
+                    neighbors.push_back(pair<float, unsigned int>(dot(found_delta[m], found_delta[m]), m));
+            if (neighbors.size() < m_num_neighbors && !m_strict_cut)
                 {
-                // If we have found an incomplete set of neighbors, end now and rebuild
-                if((m_deficits > 0) && !(m_strict_cut))
-                    break;
-                neighbors.clear();
-
-                //get cell point is in
-                vec3<float> posi = ref_pos[i];
-                unsigned int ref_cell = m_lc->getCell(posi);
-                unsigned int num_adjacent = 0;
-
-                //loop over neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
-                    {
-                    unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-                    //iterate over particles in cell
-                    locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-                    for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
-                        {
-
-                        //compute r between the two particles
-                        vec3<float>rij = m_box.wrap(pos[j] - posi);
-                        const float rsq = dot(rij, rij);
-
-                        // adds all neighbors within rsq to list of possible neighbors
-                        if ((rsq < rmaxsq) && (i != j))
-                            {
-                            pair<float, pair<unsigned int, vec3<float> > > l_neighbor;
-                            l_neighbor.first = rsq;
-                            l_neighbor.second = pair<unsigned int, vec3<float> > (j, rij);
-                            neighbors.push_back(l_neighbor);
-                            num_adjacent++;
-                            }
-                        }
-                    }
-
-                // Add to the deficit count if necessary
-                if((num_adjacent < m_num_neighbors) && !(m_strict_cut))
-                    m_deficits += (m_num_neighbors - num_adjacent);
-                else
-                    {
-                    // sort based on rsq
-                    sort(neighbors.begin(), neighbors.end(), compareRsqVectors);
-                    unsigned int k_max = (neighbors.size() < m_num_neighbors) ? neighbors.size() : m_num_neighbors;
-                    for (unsigned int k = 0; k < k_max; k++)
-                        {
-                        // put the idx into the neighbor array
-                        m_rsq_array.get()[b_i(k, i)] = neighbors[k].first;
-                        m_neighbor_array.get()[b_i(k, i)] = (neighbors[k].second).first;
-                        m_wvec_array.get()[b_i(k, i)] = (neighbors[k].second).second;
-                        }
-                    }
+                m_deficient.push_back(i);
+                continue;
                 }
-            });
 
-        // Increase m_rmax
-        if((m_deficits > 0) && !(m_strict_cut))
-            {
-            m_rmax *= m_scale;
-            // check if new r_max would be too large for the cell width
-            vec3<float> L = m_box.getNearestPlaneDistance();
-            bool too_wide =  m_rmax > L.x/2.0 || m_rmax > L.y/2.0;
-            if (!m_box.is2D())
+            unsigned int k_max = min((unsigned int)neighbors.size(), m_num_neighbors);
+            partial_sort(neighbors.begin(), neighbors.begin() + k_max, neighbors.end());
+            for (unsigned int k = 0; k < k_max; k++)
                 {
-                too_wide |=  m_rmax > L.z/2.0;
+                // put the idx into the neighbor array
+                const unsigned int m = neighbors[k].second;
+                m_rsq_array.get()[b_i(k, i)] = neighbors[k].first;
+                m_neighbor_array.get()[b_i(k, i)] = found[m];
+                m_wvec_array.get()[b_i(k, i)] = found_delta[m];
                 }
-            if (too_wide)
+            }
+        });
+
+    // second pass: only the queued points extend their search, shell by shell, until they have all neighbors
+    parallel_for(blocked_range<size_t>(0,m_deficient.size()),
+        [=] (const blocked_range<size_t>& r)
+        {
+        vector< pair<float, unsigned int> > neighbors;
+        neighbors.reserve(m_num_neighbors);
+        Index2D b_i = Index2D(m_num_neighbors, num_ref);
+        for(size_t d=r.begin(); d!=r.end(); ++d)
+            {
+            const unsigned int i = m_deficient[d];
+            vec3<float> posi = ref_pos[i];
+            findNearest(posi, i, pos, neighbors);
+            for (unsigned int k = 0; k < neighbors.size(); k++)
                 {
-                // throw runtime_warning("r_max has become too large to create a viable cell.");
-                // for now print
-                printf("r_max has become too large to create a viable cell. Returning neighbors found\n");
-                m_deficits = 0;
-                break;
+                m_rsq_array.get()[b_i(k, i)] = neighbors[k].first;
+                m_neighbor_array.get()[b_i(k, i)] = neighbors[k].second;
+                m_wvec_array.get()[b_i(k, i)] = m_box.wrap(pos[neighbors[k].second] - posi);
                 }
-            m_lc->setCellWidth(m_rmax);
             }
-        } while((m_deficits > 0) && !(m_strict_cut));
+        });
+
     // save the last computed number of particles
     m_num_ref = num_ref;
     m_num_points = num_points;
+
+    // pack the padded neighbor array into the NeighborList, dropping missing neighbors
+    std::vector<size_t> counts(num_ref + 1, 0);
+    parallel_for(blocked_range<size_t>(0,num_ref),
+        [=, &counts] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            size_t num_found = 0;
+            for (unsigned int k = 0; k < m_num_neighbors; k++)
+                if (m_neighbor_array.get()[i*m_num_neighbors + k] != UINT_MAX)
+                    num_found++;
+            counts[i + 1] = num_found;
+            }
+        });
+    for (size_t i = 0; i < num_ref; ++i)
+        counts[i + 1] += counts[i];
+    m_neighbor_list.resize(counts[num_ref], num_ref, num_points);
+    size_t *index_i = m_neighbor_list.getIndexI();
+    size_t *index_j = m_neighbor_list.getIndexJ();
+    float *distances = m_neighbor_list.getDistances();
+    float *weights = m_neighbor_list.getWeights();
+    parallel_for(blocked_range<size_t>(0,num_ref),
+        [=, &counts] (const blocked_range<size_t>& r)
+        {
+        for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+            size_t bond = counts[i];
+            for (unsigned int k = 0; k < m_num_neighbors; k++)
+                {
+                unsigned int j = m_neighbor_array.get()[i*m_num_neighbors + k];
+                if (j == UINT_MAX)
+                    continue;
+                index_i[bond] = i;
+                index_j[bond] = j;
+                distances[bond] = sqrtf(m_rsq_array.get()[i*m_num_neighbors + k]);
+                weights[bond] = 1.0f;
+                bond++;
+                }
+            }
+        });
+    m_neighbor_list.updateSegments();
     }
 
 }; }; // end namespace freud::locality
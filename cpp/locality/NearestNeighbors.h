@@ -2,16 +2,21 @@
 // This file is part of the Freud project, released under the BSD 3-Clause License.
 
 #include <memory>
+#include <climits>
+#include <utility>
+#include <vector>
 
 #include <algorithm>
 #include "LinkCell.h"
+#include "NeighborList.h"
 // hack to keep VectorMath's swap from polluting the global namespace
 // if this is a problem, we need to solve it
 #include "VectorMath.h"
 #include "box.h"
 #include "Index1D.h"
+#include "DistanceKernel.h"
 
-#include "tbb/atomic.h"
+#include "tbb/concurrent_vector.h"
 
 #ifndef _NEAREST_NEIGHBORS_H__
 #define _NEAREST_NEIGHBORS_H__
@@ -85,6 +90,14 @@ class IteratorNeighborList
     };
 
 /*! Find the requested number of nearest neighbors
+
+    The points are binned into a LinkCell whose cells are at least rmax wide. A first pass finds the points within
+    rmax of each reference point in the cells adjacent to its own; a reference point with at least num_neighbors
+    of them is done. The others are queued, and only they search the cells around their own cell shell by shell
+    (the cells at a Chebyshev distance of 0, 1, 2, ... cells), keeping the nearest points found in a bounded
+    max-heap. That search stops as soon as the farthest of the kept points is closer than any point in the shells
+    not yet visited, so rmax is only a guess of the neighbor distance that sets the cell size. With strict_cut,
+    points farther than rmax are never kept and nothing is queued.
 */
 class NearestNeighbors
     {
@@ -96,7 +109,6 @@ class NearestNeighbors
         //! Constructor
         NearestNeighbors(float rmax,
                          unsigned int num_neighbors,
-                         float scale=1.1,
                          bool strict_cut=false);
 
         ~NearestNeighbors();
@@ -138,6 +150,12 @@ class NearestNeighbors
             return m_num_neighbors;
             }
 
+        //! Get the number of reference points that had fewer than num_neighbors neighbors within rmax in the last compute
+        unsigned int getNumDeficient() const
+            {
+            return (unsigned int)m_deficient.size();
+            }
+
         //! Get the number of reference points we've computed for
         unsigned int getNref() const
             {
@@ -208,24 +226,40 @@ class NearestNeighbors
             return m_wvec_array;
             }
 
+        //! Get the NeighborList built from the neighbors found by the last call to compute()
+        NeighborList *getNList()
+            {
+            return &m_neighbor_list;
+            }
+
         void setCutMode(const bool strict_cut);
 
         //! find the requested nearest neighbors
         void compute(const box::Box& box, const vec3<float> *ref_pos, unsigned int n_ref, const vec3<float> *pos, unsigned int Np);
 
     private:
+        //! Find the m_num_neighbors points nearest to p (excluding point i) by searching shells of cells
+        /*! \param p Reference point
+            \param i Index of the point to exclude
+            \param pos Points placed in the cell list
+            \param heap Output: (squared distance, index) of the neighbors found, nearest first
+        */
+        void findNearest(const vec3<float>& p, unsigned int i, const vec3<float> *pos,
+                         std::vector< std::pair<float, unsigned int> >& heap) const;
+
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_rmax;                     //!< Maximum r at which to determine neighbors
         unsigned int m_num_neighbors;            //!< Number of neighbors to calculate
-        float m_scale;                    //!< scale by which to increase neighbor search radius
         bool m_strict_cut;                  //!< use a strict r_cut, or allow freud to expand the r_cut as needed
         unsigned int m_num_points;                //!< Number of particles for which nearest neighbors checks
         unsigned int m_num_ref;                //!< Number of particles for which nearest neighbors calcs
         locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
-        tbb::atomic<unsigned int> m_deficits; //!< Neighbor deficit count from the last compute step
+        float m_shell_width;               //!< Smallest distance between opposite faces of a cell
+        tbb::concurrent_vector<unsigned int> m_deficient; //!< Reference points short of neighbors within rmax
         std::shared_ptr<unsigned int> m_neighbor_array;         //!< array of nearest neighbors computed
         std::shared_ptr<float> m_rsq_array;         //!< array of distances to neighbors
         std::shared_ptr<vec3<float> > m_wvec_array;         //!< array of distances to neighbors
+        NeighborList m_neighbor_list;                       //!< neighbors found by the last compute, in CSR layout
         };
 
 }; }; // end namespace freud::locality
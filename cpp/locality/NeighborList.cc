@@ -0,0 +1,98 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+#include "NeighborList.h"
+
+using namespace std;
+
+/*! \file NeighborList.cc
+    \brief Store a reusable list of bonds between two sets of points
+*/
+
+namespace freud { namespace locality {
+
+NeighborList::NeighborList()
+    : m_num_bonds(0), m_max_bonds(0), m_num_i(0), m_num_j(0), m_max_i(0)
+    {
+    // always keep a valid segments array so that an empty list can be iterated
+    m_segments = std::shared_ptr<size_t>(new size_t[1], std::default_delete<size_t[]>());
+    m_segments.get()[0] = 0;
+    }
+
+NeighborList::NeighborList(size_t max_bonds)
+    : m_num_bonds(0), m_max_bonds(0), m_num_i(0), m_num_j(0), m_max_i(0)
+    {
+    m_segments = std::shared_ptr<size_t>(new size_t[1], std::default_delete<size_t[]>());
+    m_segments.get()[0] = 0;
+    resize(max_bonds, 0, 0);
+    m_num_bonds = 0;
+    }
+
+void NeighborList::resize(size_t num_bonds, size_t num_i, size_t num_j)
+    {
+    if (num_bonds > m_max_bonds)
+        {
+        m_index_i = std::shared_ptr<size_t>(new size_t[num_bonds], std::default_delete<size_t[]>());
+        m_index_j = std::shared_ptr<size_t>(new size_t[num_bonds], std::default_delete<size_t[]>());
+        m_distances = std::shared_ptr<float>(new float[num_bonds], std::default_delete<float[]>());
+        m_weights = std::shared_ptr<float>(new float[num_bonds], std::default_delete<float[]>());
+        m_max_bonds = num_bonds;
+        }
+    if (num_i > m_max_i || !m_counts)
+        {
+        m_segments = std::shared_ptr<size_t>(new size_t[num_i + 1], std::default_delete<size_t[]>());
+        m_counts = std::shared_ptr<unsigned int>(new unsigned int[num_i + 1], std::default_delete<unsigned int[]>());
+        m_max_i = num_i;
+        }
+    m_num_bonds = num_bonds;
+    m_num_i = num_i;
+    m_num_j = num_j;
+    }
+
+void NeighborList::updateSegments()
+    {
+    memset((void*)m_counts.get(), 0, sizeof(unsigned int)*m_num_i);
+    for (size_t bond = 0; bond < m_num_bonds; ++bond)
+        {
+        if (bond > 0 && m_index_i.get()[bond] < m_index_i.get()[bond - 1])
+            throw runtime_error("NeighborList bonds must be sorted by reference point index");
+        m_counts.get()[m_index_i.get()[bond]]++;
+        }
+    m_segments.get()[0] = 0;
+    for (size_t i = 0; i < m_num_i; ++i)
+        m_segments.get()[i + 1] = m_segments.get()[i] + m_counts.get()[i];
+    }
+
+void NeighborList::validate(size_t num_i, size_t num_j) const
+    {
+    if (num_i != m_num_i)
+        throw invalid_argument("NeighborList was built for a different number of reference points");
+    if (num_j != m_num_j)
+        throw invalid_argument("NeighborList was built for a different number of points");
+    }
+
+void NeighborList::filterR(float rmin, float rmax)
+    {
+    // compact in place; the relative order of the bonds is preserved so the list stays sorted by i
+    size_t num_kept = 0;
+    for (size_t bond = 0; bond < m_num_bonds; ++bond)
+        {
+        const float r = m_distances.get()[bond];
+        if (r >= rmin && r < rmax)
+            {
+            m_index_i.get()[num_kept] = m_index_i.get()[bond];
+            m_index_j.get()[num_kept] = m_index_j.get()[bond];
+            m_distances.get()[num_kept] = r;
+            m_weights.get()[num_kept] = m_weights.get()[bond];
+            num_kept++;
+            }
+        }
+    m_num_bonds = num_kept;
+    updateSegments();
+    }
+
+}; }; // end namespace freud::locality
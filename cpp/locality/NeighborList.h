@@ -0,0 +1,168 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <memory>
+#include <cstddef>
+
+#include "../box/box.h"
+#include "VectorMath.h"
+
+#ifndef _NEIGHBOR_LIST_H__
+#define _NEIGHBOR_LIST_H__
+
+/*! \file NeighborList.h
+    \brief Store a reusable list of bonds between two sets of points
+*/
+
+namespace freud { namespace locality {
+
+//! Stores the bonds found by a neighbor search in compressed sparse row (CSR) layout
+/*! A NeighborList holds num_bonds (i, j) pairs, where i indexes a set of reference points and j indexes a set of
+    points. Bonds are always sorted by i, so all bonds of reference point i are found in the contiguous range
+    [getSegments()[i], getSegments()[i+1]). getCounts()[i] holds the number of bonds of reference point i. For each
+    bond the distance |r_j - r_i| (minimum image) and a weight (1 by default) are stored as well.
+
+    A NeighborList is produced by LinkCell::compute() or NearestNeighbors::compute() and can then be handed to any
+    number of analyses so that they can skip their internal pair search. Analyses that take a NeighborList still
+    apply their own cutoff to every bond, so a list built with a larger radius can be shared by analyses with
+    different cutoffs.
+
+    The storage is capacity based: resizing to a number of bonds no larger than the current capacity does not
+    reallocate, so the same NeighborList can be refilled frame after frame.
+
+    A loop over all of the bonds of a reference point can be accomplished with the following code in c++.
+\code
+ const size_t *segments = nlist->getSegments();
+ const size_t *index_j = nlist->getIndexJ();
+ for (size_t bond = segments[i]; bond < segments[i+1]; ++bond)
+     {
+     size_t j = index_j[bond];
+     // do something with the pair (i, j)
+     }
+\endcode
+*/
+class NeighborList
+    {
+    public:
+        //! Default constructor
+        NeighborList();
+
+        //! Constructor preallocating space for max_bonds bonds
+        NeighborList(size_t max_bonds);
+
+        //! Get the number of bonds stored in this list
+        size_t getNumBonds() const
+            {
+            return m_num_bonds;
+            }
+
+        //! Get the number of reference points this list was built for
+        size_t getNumI() const
+            {
+            return m_num_i;
+            }
+
+        //! Get the number of points this list was built for
+        size_t getNumJ() const
+            {
+            return m_num_j;
+            }
+
+        //! Get the number of bonds that fit without reallocating
+        size_t getCapacity() const
+            {
+            return m_max_bonds;
+            }
+
+        //! Get the reference point index of each bond
+        const size_t *getIndexI() const
+            {
+            return m_index_i.get();
+            }
+
+        //! Get the point index of each bond
+        const size_t *getIndexJ() const
+            {
+            return m_index_j.get();
+            }
+
+        //! Get the distance of each bond
+        const float *getDistances() const
+            {
+            return m_distances.get();
+            }
+
+        //! Get the weight of each bond
+        const float *getWeights() const
+            {
+            return m_weights.get();
+            }
+
+        //! Get the first bond index of each reference point (num_i + 1 entries)
+        const size_t *getSegments() const
+            {
+            return m_segments.get();
+            }
+
+        //! Get the number of bonds of each reference point
+        const unsigned int *getCounts() const
+            {
+            return m_counts.get();
+            }
+
+        //! Get writable access to the reference point indices
+        size_t *getIndexI()
+            {
+            return m_index_i.get();
+            }
+
+        //! Get writable access to the point indices
+        size_t *getIndexJ()
+            {
+            return m_index_j.get();
+            }
+
+        //! Get writable access to the bond distances
+        float *getDistances()
+            {
+            return m_distances.get();
+            }
+
+        //! Get writable access to the bond weights
+        float *getWeights()
+            {
+            return m_weights.get();
+            }
+
+        //! Resize the list to hold num_bonds bonds between num_i reference points and num_j points
+        /*! Only reallocates when num_bonds (or num_i) exceeds the current capacity. The contents of the bond arrays
+            are undefined after a call to resize; fill them and call updateSegments().
+        */
+        void resize(size_t num_bonds, size_t num_i, size_t num_j);
+
+        //! Rebuild the segment offsets and per-point counts from the (sorted) index_i array
+        void updateSegments();
+
+        //! Check that this list was built for num_i reference points and num_j points
+        void validate(size_t num_i, size_t num_j) const;
+
+        //! Remove all bonds whose distance is not in [rmin, rmax)
+        void filterR(float rmin, float rmax);
+
+    private:
+        size_t m_num_bonds;                      //!< Number of bonds in the list
+        size_t m_max_bonds;                      //!< Number of bonds that fit in the current allocation
+        size_t m_num_i;                          //!< Number of reference points
+        size_t m_num_j;                          //!< Number of points
+        size_t m_max_i;                          //!< Number of reference points that fit in the current allocation
+        std::shared_ptr<size_t> m_index_i;       //!< Reference point index of each bond
+        std::shared_ptr<size_t> m_index_j;       //!< Point index of each bond
+        std::shared_ptr<float> m_distances;      //!< Distance of each bond
+        std::shared_ptr<float> m_weights;        //!< Weight of each bond
+        std::shared_ptr<size_t> m_segments;      //!< First bond of each reference point
+        std::shared_ptr<unsigned int> m_counts;  //!< Number of bonds of each reference point
+    };
+
+}; }; // end namespace freud::locality
+
+#endif // _NEIGHBOR_LIST_H__
@@ -70,14 +70,17 @@ void LocalQl::Ylm(const float theta, const float phi, std::vector<std::complex<f
 
 
 // void LocalQl::compute(const float3 *points, unsigned int Np)
-void LocalQl::compute(const vec3<float> *points, unsigned int Np)
+void LocalQl::compute(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist)
     {
 
     //Set local data size
     m_Np = Np;
 
-    //Initialize cell list
-    m_lc.computeCellList(m_box,points,m_Np);
+    //Initialize cell list, unless the neighbors were already found
+    if (nlist != NULL)
+        nlist->validate(m_Np, m_Np);
+    else
+        m_lc.computeCellList(m_box,points,m_Np);
 
     float rminsq = m_rmin * m_rmin;
     float rmaxsq = m_rmax * m_rmax;
@@ -93,84 +96,121 @@ void LocalQl::compute(const vec3<float> *points, unsigned int Np)
     memset((void*)m_Qli.get(), 0, sizeof(float)*m_Np);
     memset((void*)m_Qlm.get(), 0, sizeof(complex<float>)*(2*m_l+1));
 
-    for (unsigned int i = 0; i<m_Np; i++)
+    std::vector<unsigned int> neighborcount(m_Np, 0);
+    std::vector<std::complex<float> > Y;
+    // Ylm of the reversed bond is Ylm(pi - theta, phi + pi) = (-1)^l Ylm(theta, phi)
+    const float parity = (m_l % 2 == 0) ? 1.0f : -1.0f;
+
+    // add the contribution of the bond from i to j to Qlmi, and of the reversed bond to Qlmj if both_ends is set
+    auto addBond = [&] (unsigned int i, unsigned int j, bool both_ends)
         {
-        //get cell point is in
-        // float3 ref = points[i];
-        vec3<float> ref = points[i];
-        unsigned int ref_cell = m_lc.getCell(ref);
-        unsigned int neighborcount=0;
+        if (i == j)
+        {
+            return;
+        }
+        // rij = rj - ri, from i pointing to j.
+        vec3<float> delta = m_box.wrap(points[j] - points[i]);
+        float rsq = dot(delta, delta);
 
-        //loop over neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        if (rsq < rmaxsq and rsq > rminsq)
+            {
+            // phi is usually in range 0..2Pi, but
+            // it only appears in Ylm as exp(im\phi),
+            // so range -Pi..Pi will give same results.
+            float phi = atan2(delta.y,delta.x);      //-Pi..Pi
+            float theta = acos(delta.z / sqrt(rsq)); //0..Pi
+            // if the points are directly on top of each other for whatever reason,
+            // theta should be zero instead of nan.
+
+            if (rsq == float(0))
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
+                theta = 0;
+            }
 
-            //iterate over particles in neighboring cells
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
-                {
-                if (i == j)
+            LocalQl::Ylm(theta, phi,Y);  //Fill up Ylm vector
+
+            for(unsigned int k = 0; k < (2*m_l+1); ++k)
                 {
-                    continue;
+                m_Qlmi.get()[(2*m_l+1)*i+k]+=Y[k];
                 }
-                // rij = rj - ri, from i pointing to j.
-                // float dx = float(points[j].x - ref.x);
-                // float dy = float(points[j].y - ref.y);
-                // float dz = float(points[j].z - ref.z);
-
-                // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
-                vec3<float> delta = m_box.wrap(points[j] - ref);
-                // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                float rsq = dot(delta, delta);
+            neighborcount[i]++;
 
-                if (rsq < rmaxsq and rsq > rminsq)
-                    {
-                    // phi is usually in range 0..2Pi, but
-                    // it only appears in Ylm as exp(im\phi),
-                    // so range -Pi..Pi will give same results.
-                    float phi = atan2(delta.y,delta.x);      //-Pi..Pi
-                    float theta = acos(delta.z / sqrt(rsq)); //0..Pi
-                    // if the points are directly on top of each other for whatever reason,
-                    // theta should be zero instead of nan.
-
-                    if (rsq == float(0))
+            if (both_ends)
+                {
+                // points on top of each other get theta = 0 from both ends
+                float sign = (rsq == float(0)) ? 1.0f : parity;
+                for(unsigned int k = 0; k < (2*m_l+1); ++k)
                     {
-                        theta = 0;
+                    m_Qlmi.get()[(2*m_l+1)*j+k]+=sign*Y[k];
                     }
+                neighborcount[j]++;
+                }
+            }
+        };
 
-                    std::vector<std::complex<float> > Y;
-                    LocalQl::Ylm(theta, phi,Y);  //Fill up Ylm vector
+    if (nlist != NULL)
+        {
+        const size_t *segments = nlist->getSegments();
+        const size_t *index_j = nlist->getIndexJ();
+        for (unsigned int i = 0; i<m_Np; i++)
+            {
+            for (size_t bond = segments[i]; bond != segments[i+1]; ++bond)
+                {
+                addBond(i, index_j[bond], false);
+                }
+            }
+        }
+    else
+        {
+        // every bond is seen from both of its ends, so visit each unordered pair once by looping over every cell
+        // and its half neighbors
+        const unsigned int *cell_start = m_lc.getCellOffsets();
+        const unsigned int *cell_idx = m_lc.getCellIndices();
+        for (unsigned int cell = 0; cell < m_lc.getNumCells(); cell++)
+            {
+            const locality::CellNeighbors neigh_cells = m_lc.getCellHalfNeighbors(cell);
+            for (unsigned int a = cell_start[cell]; a != cell_start[cell + 1]; ++a)
+                {
+                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                    {
+                    unsigned int neigh_cell = neigh_cells[neigh_idx];
 
-                    for(unsigned int k = 0; k < (2*m_l+1); ++k)
+                    // pairs within the same cell are only taken once
+                    unsigned int first = (neigh_cell == cell) ? a + 1 : cell_start[neigh_cell];
+                    for (unsigned int k = first; k != cell_start[neigh_cell + 1]; ++k)
                         {
-                        m_Qlmi.get()[(2*m_l+1)*i+k]+=Y[k];
+                        addBond(cell_idx[a], cell_idx[k], true);
                         }
-                    neighborcount++;
                     }
                 }
-            } //End loop going over neighbor cells (and thus all neighboring particles);
-            //Normalize!
-            for(unsigned int k = 0; k < (2*m_l+1); ++k)
-                {
-                m_Qlmi.get()[(2*m_l+1)*i+k]/= neighborcount;
-                m_Qli.get()[i]+= abs( m_Qlmi.get()[(2*m_l+1)*i+k]*conj(m_Qlmi.get()[(2*m_l+1)*i+k]) ); //Square by multiplying self w/ complex conj, then take real comp
-                m_Qlm.get()[k]+= m_Qlmi.get()[(2*m_l+1)*i+k];
-                }
+            }
+        }
+
+    for (unsigned int i = 0; i<m_Np; i++)
+        {
+        //Normalize!
+        for(unsigned int k = 0; k < (2*m_l+1); ++k)
+            {
+            m_Qlmi.get()[(2*m_l+1)*i+k]/= neighborcount[i];
+            m_Qli.get()[i]+= abs( m_Qlmi.get()[(2*m_l+1)*i+k]*conj(m_Qlmi.get()[(2*m_l+1)*i+k]) ); //Square by multiplying self w/ complex conj, then take real comp
+            m_Qlm.get()[k]+= m_Qlmi.get()[(2*m_l+1)*i+k];
+            }
         m_Qli.get()[i]*=normalizationfactor;
         m_Qli.get()[i]=sqrt(m_Qli.get()[i]);
         } //Ends loop over particles i for Qlmi calcs
     }
 
 // void LocalQl::computeAve(const float3 *points, unsigned int Np)
-void LocalQl::computeAve(const vec3<float> *points, unsigned int Np)
+void LocalQl::computeAve(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist)
     {
     //Set local data size
     m_Np = Np;
 
-    //Initialize cell list
-    m_lc.computeCellList(m_box,points,m_Np);
+    //Initialize cell list, unless the neighbors were already found
+    if (nlist != NULL)
+        nlist->validate(m_Np, m_Np);
+    else
+        m_lc.computeCellList(m_box,points,m_Np);
 
     float rminsq = m_rmin * m_rmin;
     float rmaxsq = m_rmax * m_rmax;
@@ -191,81 +231,126 @@ void LocalQl::computeAve(const vec3<float> *points, unsigned int Np)
         //get cell point is in
         // float3 ref = points[i];
         vec3<float> ref = points[i];
-        unsigned int ref_cell = m_lc.getCell(ref);
         unsigned int neighborcount=1;
 
-        //loop over neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        if (nlist != NULL)
             {
-            //get cell points of 1st neighbor
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            //iterate over particles in neighboring cells
-            locality::LinkCell::iteratorcell shell1 = m_lc.itercell(neigh_cell);
-            for (unsigned int n1 = shell1.next(); !shell1.atEnd(); n1 = shell1.next())
+            const size_t *segments = nlist->getSegments();
+            const size_t *index_j = nlist->getIndexJ();
+            for (size_t bond1 = segments[i]; bond1 != segments[i+1]; ++bond1)
                 {
-                // float3 ref1 = points[n1];
-                vec3<float> ref1 = points[n1];
-                unsigned int ref1_cell = m_lc.getCell(ref1);
+                unsigned int n1 = index_j[bond1];
                 if (n1 == i)
                     {
-                        continue;
+                    continue;
                     }
-                // rij = rj - ri, from i pointing to j.
-                // float dx = float(points[n1].x - ref.x);
-                // float dy = float(points[n1].y - ref.y);
-                // float dz = float(points[n1].z - ref.z);
-
-                // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
+                vec3<float> ref1 = points[n1];
                 vec3<float> delta = m_box.wrap(ref1 - ref);
-                // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
                 float rsq = dot(delta, delta);
+                if (!(rsq < rmaxsq and rsq > rminsq))
+                    {
+                    continue;
+                    }
+                // second shell: the neighbors of n1
+                for (size_t bond2 = segments[n1]; bond2 != segments[n1+1]; ++bond2)
+                    {
+                    unsigned int j = index_j[bond2];
+                    if (n1 == j)
+                        {
+                        continue;
+                        }
+                    vec3<float> delta1 = m_box.wrap(points[j] - ref1);
+                    float rsq1 = dot(delta1, delta1);
 
-                if (rsq < rmaxsq and rsq > rminsq)
+                    if (rsq1 < rmaxsq and rsq1 > rminsq)
+                        {
+                        for(unsigned int k = 0; k < (2*m_l+1); ++k)
+                            {
+                            //adding all the Qlm of the neighbors
+                            m_AveQlmi.get()[(2*m_l+1)*i+k] += m_Qlmi.get()[(2*m_l+1)*j+k];
+                            }
+                        neighborcount++;
+                        }
+                    }
+                }
+            }
+        else
+            {
+            unsigned int ref_cell = m_lc.getCell(ref);
+
+            //loop over neighboring cells
+            const locality::CellNeighbors neigh_cells = m_lc.getCellNeighbors(ref_cell);
+            for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                {
+                //get cell points of 1st neighbor
+                unsigned int neigh_cell = neigh_cells[neigh_idx];
+
+                //iterate over particles in neighboring cells
+                locality::LinkCell::iteratorcell shell1 = m_lc.itercell(neigh_cell);
+                for (unsigned int n1 = shell1.next(); !shell1.atEnd(); n1 = shell1.next())
                     {
+                    // float3 ref1 = points[n1];
+                    vec3<float> ref1 = points[n1];
+                    unsigned int ref1_cell = m_lc.getCell(ref1);
+                    if (n1 == i)
+                        {
+                            continue;
+                        }
+                    // rij = rj - ri, from i pointing to j.
+                    // float dx = float(points[n1].x - ref.x);
+                    // float dy = float(points[n1].y - ref.y);
+                    // float dz = float(points[n1].z - ref.z);
+
+                    // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
+                    vec3<float> delta = m_box.wrap(ref1 - ref);
+                    // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
+                    float rsq = dot(delta, delta);
 
-                    //loop over 2nd neighboring cells
-                    const std::vector<unsigned int>& neigh1_cells = m_lc.getCellNeighbors(ref1_cell);
-                    for (unsigned int neigh1_idx = 0; neigh1_idx < neigh1_cells.size(); neigh1_idx++)
+                    if (rsq < rmaxsq and rsq > rminsq)
                         {
-                        //get cell points of 2nd neighbor
-                        unsigned int neigh1_cell = neigh1_cells[neigh1_idx];
 
-                        //iterate over particles in neighboring cells
-                        locality::LinkCell::iteratorcell it = m_lc.itercell(neigh1_cell);
-                        for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
+                        //loop over 2nd neighboring cells
+                        const locality::CellNeighbors neigh1_cells = m_lc.getCellNeighbors(ref1_cell);
+                        for (unsigned int neigh1_idx = 0; neigh1_idx < neigh1_cells.size(); neigh1_idx++)
                             {
-                            if (n1 == j)
+                            //get cell points of 2nd neighbor
+                            unsigned int neigh1_cell = neigh1_cells[neigh1_idx];
+
+                            //iterate over particles in neighboring cells
+                            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh1_cell);
+                            for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
                                 {
-                                    continue;
-                                }
-                            // rij = rj - ri, from i pointing to j.
-                            // float dx1 = float(points[j].x - ref1.x);
-                            // float dy1 = float(points[j].y - ref1.y);
-                            // float dz1 = float(points[j].z - ref1.z);
+                                if (n1 == j)
+                                    {
+                                        continue;
+                                    }
+                                // rij = rj - ri, from i pointing to j.
+                                // float dx1 = float(points[j].x - ref1.x);
+                                // float dy1 = float(points[j].y - ref1.y);
+                                // float dz1 = float(points[j].z - ref1.z);
 
-                            // float3 delta1 = m_box.wrap(make_float3(dx1, dy1, dz1));
-                            vec3<float> delta1 = m_box.wrap(points[j] - ref1);
-                            // float rsq1 = delta1.x*delta1.x + delta1.y*delta1.y + delta1.z*delta1.z;
-                            float rsq1 = dot(delta1, delta1);
+                                // float3 delta1 = m_box.wrap(make_float3(dx1, dy1, dz1));
+                                vec3<float> delta1 = m_box.wrap(points[j] - ref1);
+                                // float rsq1 = delta1.x*delta1.x + delta1.y*delta1.y + delta1.z*delta1.z;
+                                float rsq1 = dot(delta1, delta1);
 
-                            if (rsq1 < rmaxsq and rsq1 > rminsq)
-                                {
-                                for(unsigned int k = 0; k < (2*m_l+1); ++k)
+                                if (rsq1 < rmaxsq and rsq1 > rminsq)
                                     {
-                                    //adding all the Qlm of the neighbors
-                                    // change to Index?
-                                    // Seg fault is here
-                                    // m_Qlmi is not instantiated in this loop method, compute must be called first?
-                                    m_AveQlmi.get()[(2*m_l+1)*i+k] += m_Qlmi.get()[(2*m_l+1)*j+k];
+                                    for(unsigned int k = 0; k < (2*m_l+1); ++k)
+                                        {
+                                        //adding all the Qlm of the neighbors
+                                        // change to Index?
+                                        // Seg fault is here
+                                        // m_Qlmi is not instantiated in this loop method, compute must be called first?
+                                        m_AveQlmi.get()[(2*m_l+1)*i+k] += m_Qlmi.get()[(2*m_l+1)*j+k];
+                                        }
+                                    neighborcount++;
                                     }
-                                neighborcount++;
                                 }
                             }
                         }
-                    }
-                } //End loop going over neighbor cells (and thus all neighboring particles);
+                    } //End loop going over neighbor cells (and thus all neighboring particles);
+                }
             }
         //Normalize!
         for (unsigned int k = 0; k < (2*m_l+1); ++k)
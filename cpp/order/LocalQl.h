@@ -9,6 +9,7 @@
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "box.h"
 #include "../../extern/fsph/src/spherical_harmonics.hpp"
 
@@ -73,7 +74,8 @@ class LocalQl
         // void compute(const float3 *points,
         //              unsigned int Np);
         void compute(const vec3<float> *points,
-                     unsigned int Np);
+                     unsigned int Np,
+                     const locality::NeighborList *nlist=NULL);
 
         // //! Python wrapper for computing the order parameter from a Nx3 numpy array of float32.
         // void computePy(boost::python::numeric::array points);
@@ -82,7 +84,8 @@ class LocalQl
         // void computeAve(const float3 *points,
         //                 unsigned int Np);
         void computeAve(const vec3<float> *points,
-                        unsigned int Np);
+                        unsigned int Np,
+                        const locality::NeighborList *nlist=NULL);
 
         // //! Python wrapper for computing the order parameter (with 2nd shell) from a Nx3 numpy array of float32.
         // void computeAvePy(boost::python::numeric::array points);
@@ -109,7 +109,7 @@ void LocalWl::compute(const vec3<float> *points, unsigned int Np)
         unsigned int neighborcount=0;
 
         //loop over neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
+        const locality::CellNeighbors neigh_cells = m_lc.getCellNeighbors(ref_cell);
         for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
             {
             unsigned int neigh_cell = neigh_cells[neigh_idx];
@@ -210,7 +210,7 @@ void LocalWl::computeAve(const vec3<float> *points, unsigned int Np)
         unsigned int neighborcount=1;
 
         //loop over neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
+        const locality::CellNeighbors neigh_cells = m_lc.getCellNeighbors(ref_cell);
         for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
             {
             //get cell points of 1st neighbor
@@ -240,7 +240,7 @@ void LocalWl::computeAve(const vec3<float> *points, unsigned int Np)
                     {
 
                     //loop over 2nd neighboring cells
-                    const std::vector<unsigned int>& neigh1_cells = m_lc.getCellNeighbors(ref1_cell);
+                    const locality::CellNeighbors neigh1_cells = m_lc.getCellNeighbors(ref1_cell);
                     for (unsigned int neigh1_idx = 0; neigh1_idx < neigh1_cells.size(); neigh1_idx++)
                         {
                         //get cell points of 2nd neighbor
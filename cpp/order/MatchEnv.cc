@@ -328,7 +328,7 @@ Environment MatchEnv::buildEnv(const vec3<float> *points, unsigned int i, unsign
         {
         // loop over everyone who could possibly be within m_rmax of particle i
         unsigned int cell = m_lc->getCell(p);
-        const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(cell);
+        const locality::CellNeighbors neigh_cells = m_lc->getCellNeighbors(cell);
         // loop over neighboring cells
         for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
             {
@@ -132,50 +132,60 @@ void SolLiq::Y4m(const float theta, const float phi, std::vector<std::complex<fl
 //Begins calculation of the solid-liq order parameters.
 //Note that the SolLiq container class conatins the threshold cutoffs
 // void SolLiq::compute(const float3 *points, unsigned int Np)
-void SolLiq::compute(const vec3<float> *points, unsigned int Np)
+void SolLiq::compute(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist)
     {
-    m_lc.computeCellList(m_box,points,Np);
+    if (nlist != NULL)
+        nlist->validate(Np, Np);
+    else
+        m_lc.computeCellList(m_box,points,Np);
 
     //Initialize Qlmi
-    computeClustersQ(points,Np);
+    computeClustersQ(points,Np,nlist);
     //Determines number of solid or liquid like bonds
-    computeClustersQdot(points,Np);
+    computeClustersQdot(points,Np,nlist);
     //Determines if particles are solid or liquid by clustering those with sufficient solid-like bonds
-    computeClustersQS(points,Np);
+    computeClustersQS(points,Np,nlist);
     m_Np = Np;
     }
 
 //Begins calculation of solliq order parameter.  This variant requires particles to share at least S_threshold neighbors
 // in order to cluster them, rather than each possess S_threshold neighbors.
 // void SolLiq::computeSolLiqVariant(const float3 *points, unsigned int Np)
-void SolLiq::computeSolLiqVariant(const vec3<float> *points, unsigned int Np)
+void SolLiq::computeSolLiqVariant(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist)
     {
-    m_lc.computeCellList(m_box,points,Np);
+    if (nlist != NULL)
+        nlist->validate(Np, Np);
+    else
+        m_lc.computeCellList(m_box,points,Np);
     //Initialize Qlmi
-    computeClustersQ(points,Np);
+    computeClustersQ(points,Np,nlist);
     vector< vector<unsigned int> > SolidlikeNeighborlist;
-    computeListOfSolidLikeNeighbors(points, Np, SolidlikeNeighborlist);
-    computeClustersSharedNeighbors(points, Np, SolidlikeNeighborlist);
+    computeListOfSolidLikeNeighbors(points, Np, SolidlikeNeighborlist, nlist);
+    computeClustersSharedNeighbors(points, Np, SolidlikeNeighborlist, nlist);
     m_Np = Np;
     }
 
 //Calculate solliq order parameter, without doing normalization.
 // void SolLiq::computeSolLiqNoNorm(const float3 *points, unsigned int Np)
-void SolLiq::computeSolLiqNoNorm(const vec3<float> *points, unsigned int Np)
+void SolLiq::computeSolLiqNoNorm(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist)
     {
-    m_lc.computeCellList(m_box,points,Np);
+    if (nlist != NULL)
+        nlist->validate(Np, Np);
+    else
+        m_lc.computeCellList(m_box,points,Np);
     //Initialize Qlmi
-    computeClustersQ(points,Np);
+    computeClustersQ(points,Np,nlist);
     //Determines number of solid or liquid like bonds
-    computeClustersQdotNoNorm(points,Np);
+    computeClustersQdotNoNorm(points,Np,nlist);
     //Determines if particles are solid or liquid by clustering those with sufficient solid-like bonds
-    computeClustersQS(points,Np);
+    computeClustersQS(points,Np,nlist);
     m_Np = Np;
     }
 
 // void SolLiq::computeClustersQ(const float3 *points, unsigned int Np)
-void SolLiq::computeClustersQ(const vec3<float> *points, unsigned int Np)
+void SolLiq::computeClustersQ(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist)
     {
+    std::vector<unsigned int> candidates;
     float rmaxsq = m_rmax * m_rmax;
     if (m_Np != Np)
         {
@@ -187,65 +197,93 @@ void SolLiq::computeClustersQ(const vec3<float> *points, unsigned int Np)
 
 
     std::vector<std::complex<float> > Y;  Y.resize(2*m_l+1);
+    // Ylm of the reversed bond is Ylm(pi - theta, phi + pi) = (-1)^l Ylm(theta, phi)
+    const float parity = (m_l % 2 == 0) ? 1.0f : -1.0f;
 
-    for (unsigned int i = 0; i<Np; i++)
+    // add the contribution of the bond from i to j to Qlmi, and of the reversed bond to Qlmj if both_ends is set
+    auto addBond = [&] (unsigned int i, unsigned int j, bool both_ends)
         {
-        //get cell point is in
-        // float3 ref = points[i];
-        vec3<float> ref = points[i];
-        unsigned int ref_cell = m_lc.getCell(ref);
-
-        //loop over neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(ref_cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        vec3<float> delta = m_box.wrap(points[j] - points[i]);
+        float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
+
+        if (rsq < rmaxsq && i != j)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
+            float phi = atan2(delta.y,delta.x);      //0..2Pi
+            float theta = acos(delta.z / sqrt(rsq)); //0..Pi
+
+            /*if (m_l == 6)
+                SolLiq::Y6m(theta,phi,Y);
+            else if (m_l == 4)
+                SolLiq::Y4m(theta,phi,Y);
+            else
+            */
+            SolLiq::Ylm(theta,phi,Y);
+
+            for(unsigned int k = 0; k < (2*m_l+1); ++k)
+                {
+                m_Qlmi_array.get()[(2*m_l+1)*i+k]+=Y[k];
+                }
+            m_number_of_neighbors.get()[i]++;
 
-            //iterate over particles in neighboring cells
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j = it.next())
+            if (both_ends)
                 {
-                vec3<float> delta = m_box.wrap(points[j] - ref);
-                float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
+                for(unsigned int k = 0; k < (2*m_l+1); ++k)
+                    {
+                    m_Qlmi_array.get()[(2*m_l+1)*j+k]+=parity*Y[k];
+                    }
+                m_number_of_neighbors.get()[j]++;
+                }
+            }
+        };
+
+    if (nlist != NULL)
+        {
+        for (unsigned int i = 0; i<Np; i++)
+            {
+            m_lc.getNeighborCandidates(points[i], i, nlist, candidates);
 
-                if (rsq < rmaxsq && i != j)
+            // loop over all candidate neighbors
+            for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
+                {
+                addBond(i, candidates[neigh_idx], false);
+                }
+            }
+        }
+    else
+        {
+        // every bond is seen from both of its ends, so visit each unordered pair once by looping over every cell
+        // and its half neighbors
+        const unsigned int *cell_start = m_lc.getCellOffsets();
+        const unsigned int *cell_idx = m_lc.getCellIndices();
+        for (unsigned int cell = 0; cell < m_lc.getNumCells(); cell++)
+            {
+            const locality::CellNeighbors neigh_cells = m_lc.getCellHalfNeighbors(cell);
+            for (unsigned int a = cell_start[cell]; a != cell_start[cell + 1]; ++a)
+                {
+                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
                     {
-                    float phi = atan2(delta.y,delta.x);      //0..2Pi
-                    float theta = acos(delta.z / sqrt(rsq)); //0..Pi
-
-                    /*if (m_l == 6)
-                        SolLiq::Y6m(theta,phi,Y);
-                    else if (m_l == 4)
-                        SolLiq::Y4m(theta,phi,Y);
-                    else
-                    */
-                    SolLiq::Ylm(theta,phi,Y);
-
-                    for(unsigned int k = 0; k < (2*m_l+1); ++k)
+                    unsigned int neigh_cell = neigh_cells[neigh_idx];
+
+                    // pairs within the same cell are only taken once
+                    unsigned int first = (neigh_cell == cell) ? a + 1 : cell_start[neigh_cell];
+                    for (unsigned int k = first; k != cell_start[neigh_cell + 1]; ++k)
                         {
-                        m_Qlmi_array.get()[(2*m_l+1)*i+k]+=Y[k];
+                        addBond(cell_idx[a], cell_idx[k], true);
                         }
-                    m_number_of_neighbors.get()[i]++;
                     }
-                }//End loop over a particular neighbor cell
-            }  //End loops of neighboring cells
-        //if (m_number_of_neighbors[i] != 0)
-        //    {
-        //    for(unsigned int k = 0; k < (2*m_l+1); ++k)
-        //        {
-        //        m_Qlmi_array[(2*m_l+1)*i+k]/=m_number_of_neighbors[i];
-        //        }
-        //    }
-        } //Ends loop over particles i for Qlmi calcs}
-
+                }
+            }
+        }
     }
 
 //Initializes Q6lmi, and number of solid-like neighbors per particle.
 // void SolLiq::computeClustersQdot(const float3 *points,
 //                               unsigned int Np)
 void SolLiq::computeClustersQdot(const vec3<float> *points,
-                              unsigned int Np)
+                              unsigned int Np,
+                              const locality::NeighborList *nlist)
     {
+    std::vector<unsigned int> candidates;
     //clear vector
     m_qldot_ij.clear();     //Stores all the q dot products between all particles i,j
 
@@ -264,46 +302,39 @@ void SolLiq::computeClustersQdot(const vec3<float> *points,
         // get the cell the point is in
         // float3 p = points[i];
         vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
+        m_lc.getNeighborCandidates(p, i, nlist, candidates);
 
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        // loop over all candidate neighbors
+        for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            unsigned int j = candidates[neigh_idx];
+            if (i < j)
                 {
-                if (i < j)
-                    {
-                    vec3<float> delta = m_box.wrap(p - points[j]);
-                    float rsq = dot(delta, delta);
+                vec3<float> delta = m_box.wrap(p - points[j]);
+                float rsq = dot(delta, delta);
 
-                    if (rsq < rmaxsq)  //Check distance for candidate i,j
+                if (rsq < rmaxsq)  //Check distance for candidate i,j
+                    {
+                    //Calc Q dotproduct.
+                    std::complex<float> Qdot(0.0,0.0);
+                    std::complex<float> Qlminorm(0.0,0.0);//qlmi norm sq
+                    std::complex<float> Qlmjnorm(0.0,0.0);
+                    for (unsigned int k = 0; k < (elements); ++k)  // loop over m
                         {
-                        //Calc Q dotproduct.
-                        std::complex<float> Qdot(0.0,0.0);
-                        std::complex<float> Qlminorm(0.0,0.0);//qlmi norm sq
-                        std::complex<float> Qlmjnorm(0.0,0.0);
-                        for (unsigned int k = 0; k < (elements); ++k)  // loop over m
-                            {
-                            Qdot += m_Qlmi_array.get()[(elements)*i+k] * conj(m_Qlmi_array.get()[(elements)*j+k]);
-                            Qlminorm += m_Qlmi_array.get()[(elements)*i+k]*conj(m_Qlmi_array.get()[(elements)*i+k]);
-                            Qlmjnorm += m_Qlmi_array.get()[(elements)*j+k]*conj(m_Qlmi_array.get()[(elements)*j+k]);
-                            }
-                        Qlminorm = sqrt(Qlminorm);
-                        Qlmjnorm = sqrt(Qlmjnorm);
-                        Qdot = Qdot/real((Qlminorm*Qlmjnorm));
-                        m_qldot_ij.push_back(Qdot);  // Only i < j, other pairs not added.
-                        //Check if we're bonded via the threshold criterion
-                        if( real(Qdot) > m_Qthreshold)
-                            {
-                            //Tick up counts of number of connections these particles have
-                            m_number_of_connections.get()[i]++;
-                            m_number_of_connections.get()[j]++;
-                            }
+                        Qdot += m_Qlmi_array.get()[(elements)*i+k] * conj(m_Qlmi_array.get()[(elements)*j+k]);
+                        Qlminorm += m_Qlmi_array.get()[(elements)*i+k]*conj(m_Qlmi_array.get()[(elements)*i+k]);
+                        Qlmjnorm += m_Qlmi_array.get()[(elements)*j+k]*conj(m_Qlmi_array.get()[(elements)*j+k]);
+                        }
+                    Qlminorm = sqrt(Qlminorm);
+                    Qlmjnorm = sqrt(Qlmjnorm);
+                    Qdot = Qdot/real((Qlminorm*Qlmjnorm));
+                    m_qldot_ij.push_back(Qdot);  // Only i < j, other pairs not added.
+                    //Check if we're bonded via the threshold criterion
+                    if( real(Qdot) > m_Qthreshold)
+                        {
+                        //Tick up counts of number of connections these particles have
+                        m_number_of_connections.get()[i]++;
+                        m_number_of_connections.get()[j]++;
                         }
                     }
                 }
@@ -315,8 +346,10 @@ void SolLiq::computeClustersQdot(const vec3<float> *points,
 // void SolLiq::computeClustersQdotNoNorm(const float3 *points,
 //                               unsigned int Np)
 void SolLiq::computeClustersQdotNoNorm(const vec3<float> *points,
-                              unsigned int Np)
+                              unsigned int Np,
+                              const locality::NeighborList *nlist)
     {
+    std::vector<unsigned int> candidates;
     m_qldot_ij.clear();
 
     // reallocate the cluster_idx array if the size doesn't match the last one
@@ -334,41 +367,34 @@ void SolLiq::computeClustersQdotNoNorm(const vec3<float> *points,
         // get the cell the point is in
         // float3 p = points[i];
         vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
+        m_lc.getNeighborCandidates(p, i, nlist, candidates);
 
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        // loop over all candidate neighbors
+        for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            unsigned int j = candidates[neigh_idx];
+            if (i < j)
                 {
-                if (i < j)
-                    {
-                    // compute r between the two particles
-                    vec3<float> delta = m_box.wrap(p - points[j]);
-                    float rsq = dot(delta, delta);
+                // compute r between the two particles
+                vec3<float> delta = m_box.wrap(p - points[j]);
+                float rsq = dot(delta, delta);
 
-                    if (rsq < rmaxsq)  //Check distance for candidate i,j
+                if (rsq < rmaxsq)  //Check distance for candidate i,j
+                    {
+                    //Calc Q dotproduct.
+                    std::complex<float> Qdot(0.0,0.0);
+                    for (unsigned int k = 0; k < (elements); ++k)  // loop over m
                         {
-                        //Calc Q dotproduct.
-                        std::complex<float> Qdot(0.0,0.0);
-                        for (unsigned int k = 0; k < (elements); ++k)  // loop over m
-                            {
-                            // Index here?
-                            Qdot += m_Qlmi_array.get()[(elements)*i+k] * conj(m_Qlmi_array.get()[(elements)*j+k]);
-                            }
-                        m_qldot_ij.push_back(Qdot);  // Only i < j, other pairs not added.
-                        //Check if we're bonded via the threshold criterion
-                        if( real(Qdot) > m_Qthreshold)
-                            {
-                            //Tick up counts of number of connections these particles have
-                            m_number_of_connections.get()[i]++;
-                            m_number_of_connections.get()[j]++;
-                            }
+                        // Index here?
+                        Qdot += m_Qlmi_array.get()[(elements)*i+k] * conj(m_Qlmi_array.get()[(elements)*j+k]);
+                        }
+                    m_qldot_ij.push_back(Qdot);  // Only i < j, other pairs not added.
+                    //Check if we're bonded via the threshold criterion
+                    if( real(Qdot) > m_Qthreshold)
+                        {
+                        //Tick up counts of number of connections these particles have
+                        m_number_of_connections.get()[i]++;
+                        m_number_of_connections.get()[j]++;
                         }
                     }
                 }
@@ -379,8 +405,9 @@ void SolLiq::computeClustersQdotNoNorm(const vec3<float> *points,
 
 //Computes the clusters for sol-liq order parameter by using the Sthreshold.
 // void SolLiq::computeClustersQS(const float3 *points, unsigned int Np)
-void SolLiq::computeClustersQS(const vec3<float> *points, unsigned int Np)
+void SolLiq::computeClustersQS(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist)
     {
+    std::vector<unsigned int> candidates;
     if (m_Np != Np)
         {
         m_cluster_idx = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
@@ -395,38 +422,31 @@ void SolLiq::computeClustersQS(const vec3<float> *points, unsigned int Np)
         // get the cell the point is in
         // float3 p = points[i];
         vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
+        m_lc.getNeighborCandidates(p, i, nlist, candidates);
 
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        // loop over all candidate neighbors
+        for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            unsigned int j = candidates[neigh_idx];
+            if (i != j)
                 {
-                if (i != j)
+                // compute r between the two particles
+                // float dx = float(p.x - points[j].x);
+                // float dy = float(p.y - points[j].y);
+                // float dz = float(p.z - points[j].z);
+                // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
+                vec3<float> delta = m_box.wrap(p - points[j]);
+                // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
+                float rsq = dot(delta, delta);
+                if (rsq < rmaxcluster_sq && rsq > 1e-6)  //Check distance for candidate i,j
                     {
-                    // compute r between the two particles
-                    // float dx = float(p.x - points[j].x);
-                    // float dy = float(p.y - points[j].y);
-                    // float dz = float(p.z - points[j].z);
-                    // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
-                    vec3<float> delta = m_box.wrap(p - points[j]);
-                    // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                    float rsq = dot(delta, delta);
-                    if (rsq < rmaxcluster_sq && rsq > 1e-6)  //Check distance for candidate i,j
+                    if ( (m_number_of_connections.get()[i] >= m_Sthreshold) && (m_number_of_connections.get()[j] >= m_Sthreshold) )
                         {
-                        if ( (m_number_of_connections.get()[i] >= m_Sthreshold) && (m_number_of_connections.get()[j] >= m_Sthreshold) )
-                            {
-                            // merge the two sets using the disjoint set
-                            uint32_t a = dj.find(i);
-                            uint32_t b = dj.find(j);
-                            if (a != b)
-                                dj.merge(a,b);
-                            }
+                        // merge the two sets using the disjoint set
+                        uint32_t a = dj.find(i);
+                        uint32_t b = dj.find(j);
+                        if (a != b)
+                            dj.merge(a,b);
                         }
                     }
                 }
@@ -510,8 +530,10 @@ std::vector<unsigned int> SolLiq::getClusterSizes()
 // void SolLiq::computeListOfSolidLikeNeighbors(const float3 *points,
 //                               unsigned int Np, vector< vector<unsigned int> > &SolidlikeNeighborlist)
 void SolLiq::computeListOfSolidLikeNeighbors(const vec3<float> *points,
-                              unsigned int Np, vector< vector<unsigned int> > &SolidlikeNeighborlist)
+                              unsigned int Np, vector< vector<unsigned int> > &SolidlikeNeighborlist,
+                              const locality::NeighborList *nlist)
     {
+    std::vector<unsigned int> candidates;
     m_qldot_ij.clear();     //Stores all the q dot products between all particles i,j
 
     //resize
@@ -532,62 +554,55 @@ void SolLiq::computeListOfSolidLikeNeighbors(const vec3<float> *points,
         // get the cell the point is in
         // float3 p = points[i];
         vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
+        m_lc.getNeighborCandidates(p, i, nlist, candidates);
 
         //Empty list
         SolidlikeNeighborlist[i].resize(0);
 
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        // loop over all candidate neighbors
+        for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            unsigned int j = candidates[neigh_idx];
+            if (i != j)
                 {
-                if (i != j)
-                    {
-                    // compute r between the two particles
-                    // float dx = float(p.x - points[j].x);
-                    // float dy = float(p.y - points[j].y);
-                    // float dz = float(p.z - points[j].z);
-                    // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
-                    vec3<float> delta = m_box.wrap(p - points[j]);
+                // compute r between the two particles
+                // float dx = float(p.x - points[j].x);
+                // float dy = float(p.y - points[j].y);
+                // float dz = float(p.z - points[j].z);
+                // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
+                vec3<float> delta = m_box.wrap(p - points[j]);
 
-                    // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                    float rsq = dot(delta, delta);
+                // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
+                float rsq = dot(delta, delta);
 
-                    if (rsq < rmaxsq && rsq > 1e-6)  //Check distance for candidate i,j
+                if (rsq < rmaxsq && rsq > 1e-6)  //Check distance for candidate i,j
+                    {
+                    //Calc Q dotproduct.
+                    std::complex<float> Qdot(0.0,0.0);
+                    std::complex<float> Qlminorm(0.0,0.0);//qlmi norm sq
+                    std::complex<float> Qlmjnorm(0.0,0.0);
+                    for (unsigned int k = 0; k < (2*m_l+1); ++k)  // loop over m
                         {
-                        //Calc Q dotproduct.
-                        std::complex<float> Qdot(0.0,0.0);
-                        std::complex<float> Qlminorm(0.0,0.0);//qlmi norm sq
-                        std::complex<float> Qlmjnorm(0.0,0.0);
-                        for (unsigned int k = 0; k < (2*m_l+1); ++k)  // loop over m
-                            {
-                            //Symmmetry - Could compute Qdot *twice* as fast! (I.e. m=-l and m=+l equivalent so some of these calcs redundant)
-                            //std::complex<float> temp =  m_Qlmi_array[(2*m_l+1)*i+k] * conj(m_Qlmi_array[(2*m_l+1)*j+k]);
-                            //printf("For component k=%d, real=%f, imag=%f\n",k,real(temp),imag(temp));
-                            Qdot += m_Qlmi_array.get()[(2*m_l+1)*i+k] * conj(m_Qlmi_array.get()[(2*m_l+1)*j+k]);
-                            Qlminorm += m_Qlmi_array.get()[(2*m_l+1)*i+k]*conj(m_Qlmi_array.get()[(2*m_l+1)*i+k]);
-                            Qlmjnorm += m_Qlmi_array.get()[(2*m_l+1)*j+k]*conj(m_Qlmi_array.get()[(2*m_l+1)*j+k]);
-                            }
-                        Qlminorm = sqrt(Qlminorm);
-                        Qlmjnorm = sqrt(Qlmjnorm);
-                        Qdot = Qdot/(Qlminorm*Qlmjnorm);
+                        //Symmmetry - Could compute Qdot *twice* as fast! (I.e. m=-l and m=+l equivalent so some of these calcs redundant)
+                        //std::complex<float> temp =  m_Qlmi_array[(2*m_l+1)*i+k] * conj(m_Qlmi_array[(2*m_l+1)*j+k]);
+                        //printf("For component k=%d, real=%f, imag=%f\n",k,real(temp),imag(temp));
+                        Qdot += m_Qlmi_array.get()[(2*m_l+1)*i+k] * conj(m_Qlmi_array.get()[(2*m_l+1)*j+k]);
+                        Qlminorm += m_Qlmi_array.get()[(2*m_l+1)*i+k]*conj(m_Qlmi_array.get()[(2*m_l+1)*i+k]);
+                        Qlmjnorm += m_Qlmi_array.get()[(2*m_l+1)*j+k]*conj(m_Qlmi_array.get()[(2*m_l+1)*j+k]);
+                        }
+                    Qlminorm = sqrt(Qlminorm);
+                    Qlmjnorm = sqrt(Qlmjnorm);
+                    Qdot = Qdot/(Qlminorm*Qlmjnorm);
 
-                        if(i < j)
-                            {
-                            m_qldot_ij.push_back(Qdot);
-                            }
-                        //Check if we're bonded via the threshold criterion
-                        if( real(Qdot) > m_Qthreshold)
-                            {
-                            m_number_of_connections.get()[i]++;
-                            SolidlikeNeighborlist[i].push_back(j);
-                            }
+                    if(i < j)
+                        {
+                        m_qldot_ij.push_back(Qdot);
+                        }
+                    //Check if we're bonded via the threshold criterion
+                    if( real(Qdot) > m_Qthreshold)
+                        {
+                        m_number_of_connections.get()[i]++;
+                        SolidlikeNeighborlist[i].push_back(j);
                         }
                     }
                 }
@@ -598,8 +613,10 @@ void SolLiq::computeListOfSolidLikeNeighbors(const vec3<float> *points,
 // void SolLiq::computeClustersSharedNeighbors(const float3 *points,
 //     unsigned int Np, const vector< vector<unsigned int> > &SolidlikeNeighborlist)
 void SolLiq::computeClustersSharedNeighbors(const vec3<float> *points,
-    unsigned int Np, const vector< vector<unsigned int> > &SolidlikeNeighborlist)
+    unsigned int Np, const vector< vector<unsigned int> > &SolidlikeNeighborlist,
+    const locality::NeighborList *nlist)
     {
+    std::vector<unsigned int> candidates;
 
     m_cluster_idx = std::shared_ptr<unsigned int>(new unsigned int[Np], std::default_delete<unsigned int[]>());
     m_number_of_shared_connections.clear();  //Reset.
@@ -613,60 +630,53 @@ void SolLiq::computeClustersSharedNeighbors(const vec3<float> *points,
         // get the cell the point is in
         // float3 p = points[i];
         vec3<float> p = points[i];
-        unsigned int cell = m_lc.getCell(p);
+        m_lc.getNeighborCandidates(p, i, nlist, candidates);
 
-        // loop over all neighboring cells
-        const std::vector<unsigned int>& neigh_cells = m_lc.getCellNeighbors(cell);
-        for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+        // loop over all candidate neighbors
+        for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
             {
-            unsigned int neigh_cell = neigh_cells[neigh_idx];
-
-            // iterate over the particles in that cell
-            locality::LinkCell::iteratorcell it = m_lc.itercell(neigh_cell);
-            for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+            unsigned int j = candidates[neigh_idx];
+            if (i < j)
                 {
-                if (i < j)
+                // compute r between the two particles
+                // float dx = float(p.x - points[j].x);
+                // float dy = float(p.y - points[j].y);
+                // float dz = float(p.z - points[j].z);
+                // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
+                vec3<float> delta = m_box.wrap(p - points[j]);
+
+                // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
+                float rsq = dot(delta, delta);
+                if (rsq < rmaxcluster_sq && rsq > 1e-6)  //Check distance for candidate i,j
                     {
-                    // compute r between the two particles
-                    // float dx = float(p.x - points[j].x);
-                    // float dy = float(p.y - points[j].y);
-                    // float dz = float(p.z - points[j].z);
-                    // float3 delta = m_box.wrap(make_float3(dx, dy, dz));
-                    vec3<float> delta = m_box.wrap(p - points[j]);
-
-                    // float rsq = delta.x*delta.x + delta.y*delta.y + delta.z*delta.z;
-                    float rsq = dot(delta, delta);
-                    if (rsq < rmaxcluster_sq && rsq > 1e-6)  //Check distance for candidate i,j
+                    unsigned int num_shared = 0;
+                    map<unsigned int, unsigned int> sharedneighbors;
+                    for(unsigned int k = 0; k < SolidlikeNeighborlist[i].size(); k++)
                         {
-                        unsigned int num_shared = 0;
-                        map<unsigned int, unsigned int> sharedneighbors;
-                        for(unsigned int k = 0; k < SolidlikeNeighborlist[i].size(); k++)
-                            {
-                            sharedneighbors[SolidlikeNeighborlist[i][k]]++;
-                            }
-                        for(unsigned int k = 0; k < SolidlikeNeighborlist[j].size(); k++)
-                            {
-                            sharedneighbors[SolidlikeNeighborlist[j][k]]++;
-                            }
-                        //Scan through counting number of shared neighbors in the map
-                        std::map<unsigned int, unsigned int>::const_iterator it;
-                        for(it = sharedneighbors.begin(); it != sharedneighbors.end(); ++it)
-                            {
-                            if((*it).second>=2)
-                                {
-                                num_shared++;
-                                }
-                            }
-                        m_number_of_shared_connections.push_back(num_shared);
-                        if(num_shared > m_Sthreshold)
+                        sharedneighbors[SolidlikeNeighborlist[i][k]]++;
+                        }
+                    for(unsigned int k = 0; k < SolidlikeNeighborlist[j].size(); k++)
+                        {
+                        sharedneighbors[SolidlikeNeighborlist[j][k]]++;
+                        }
+                    //Scan through counting number of shared neighbors in the map
+                    std::map<unsigned int, unsigned int>::const_iterator it;
+                    for(it = sharedneighbors.begin(); it != sharedneighbors.end(); ++it)
+                        {
+                        if((*it).second>=2)
                             {
-                            // merge the two sets using the disjoint set
-                            uint32_t a = dj.find(i);
-                            uint32_t b = dj.find(j);
-                            if (a != b)
-                                dj.merge(a,b);
+                            num_shared++;
                             }
                         }
+                    m_number_of_shared_connections.push_back(num_shared);
+                    if(num_shared > m_Sthreshold)
+                        {
+                        // merge the two sets using the disjoint set
+                        uint32_t a = dj.find(i);
+                        uint32_t b = dj.find(j);
+                        if (a != b)
+                            dj.merge(a,b);
+                        }
                     }
                 }
             }
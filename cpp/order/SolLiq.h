@@ -15,6 +15,7 @@
 
 #include "Cluster.h"
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "../../extern/fsph/src/spherical_harmonics.hpp"
 
 #include "box.h"
@@ -73,15 +74,15 @@ class SolLiq
 
         //! Compute the Solid-Liquid Order Parameter
         // void compute(const float3 *points, unsigned int Np);
-        void compute(const vec3<float> *points, unsigned int Np);
+        void compute(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist=NULL);
 
         //! Try to cluster requiring particles to have S_threshold number of shared neighbors to be clustered.  This enforces stronger conditions on orientations.
         // void computeSolLiqVariant(const float3 *points, unsigned int Np);
-        void computeSolLiqVariant(const vec3<float> *points, unsigned int Np);
+        void computeSolLiqVariant(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist=NULL);
 
         //! Compute Solid-Liquid order parameter without normalizing the dot product.  This is for comparisons with literature.
         // void computeSolLiqNoNorm(const float3 *points, unsigned int Np);
-        void computeSolLiqNoNorm(const vec3<float> *points, unsigned int Np);
+        void computeSolLiqNoNorm(const vec3<float> *points, unsigned int Np, const locality::NeighborList *nlist=NULL);
 
         //! Calculates spherical harmonic Y6m for given theta, phi using boost.
         void Ylm(const float theta, const float phi, std::vector<std::complex<float> > &Y);
@@ -262,35 +263,41 @@ class SolLiq
         // void computeClustersQ(const float3 *points,
         //                       unsigned int Np);
         void computeClustersQ(const vec3<float> *points,
-                              unsigned int Np);
+                              unsigned int Np,
+                              const locality::NeighborList *nlist);
         //! Computes the number of solid-like neighbors based on the dot product thresholds
         // void computeClustersQdot(const float3 *points,
         //                       unsigned int Np);
         void computeClustersQdot(const vec3<float> *points,
-                              unsigned int Np);
+                              unsigned int Np,
+                              const locality::NeighborList *nlist);
 
         //!Clusters particles based on values of Q_l dot product and solid-like neighbor thresholds
         // void computeClustersQS(const float3 *points,
         //                       unsigned int Np);
         void computeClustersQS(const vec3<float> *points,
-                              unsigned int Np);
+                              unsigned int Np,
+                              const locality::NeighborList *nlist);
 
         //Compute list of solidlike neighbors
         // void computeListOfSolidLikeNeighbors(const float3 *points,
         //                       unsigned int Np, std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist);
         void computeListOfSolidLikeNeighbors(const vec3<float> *points,
-                              unsigned int Np, std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist);
+                              unsigned int Np, std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist,
+                              const locality::NeighborList *nlist);
 
         //Alternate clustering method requiring same shared neighbors
         // void computeClustersSharedNeighbors(const float3 *points,
         //                       unsigned int Np, const std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist);
         void computeClustersSharedNeighbors(const vec3<float> *points,
-                              unsigned int Np, const std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist);
+                              unsigned int Np, const std::vector< std::vector<unsigned int> > &SolidlikeNeighborlist,
+                              const locality::NeighborList *nlist);
 
         // void computeClustersQdotNoNorm(const float3 *points,
         //                       unsigned int Np);
         void computeClustersQdotNoNorm(const vec3<float> *points,
-                              unsigned int Np);
+                              unsigned int Np,
+                              const locality::NeighborList *nlist);
 
         box::Box m_box;      //!< Simulation box the particles belong in
         float m_rmax;               //!< Maximum cutoff radius at which to determine local environment
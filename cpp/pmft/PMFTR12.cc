@@ -25,7 +25,9 @@ namespace freud { namespace pmft {
 PMFTR12::PMFTR12(float max_r, unsigned int nbins_r, unsigned int nbins_t1, unsigned int nbins_t2)
     : m_box(box::Box()), m_max_r(max_r), m_max_t1(2.0*M_PI), m_max_t2(2.0*M_PI),
       m_nbins_r(nbins_r), m_nbins_t1(nbins_t1), m_nbins_t2(nbins_t2), m_frame_counter(0),
-      m_n_ref(0), m_n_p(0), m_reduce(true)
+      m_n_ref(0), m_n_p(0), m_reduce(true), m_bins(nbins_t1, nbins_t2, nbins_r),
+      m_bin_counter(m_nbins_r * m_nbins_t1 * m_nbins_t2),
+      m_weighted(false), m_value_sums(0), m_value_sq_sums(0)
     {
     if (nbins_r < 1)
         throw invalid_argument("must be at least 1 bin in r");
@@ -92,71 +94,76 @@ PMFTR12::PMFTR12(float max_r, unsigned int nbins_r, unsigned int nbins_t1, unsig
     // create and populate the pcf_array
     m_pcf_array = std::shared_ptr<float>(new float[m_nbins_r*m_nbins_t1*m_nbins_t2], std::default_delete<float[]>());
     memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_nbins_r*m_nbins_t1*m_nbins_t2);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_nbins_r*m_nbins_t1*m_nbins_t2], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins_r*m_nbins_t1*m_nbins_t2);
 
     m_r_cut = m_max_r;
 
     m_lc = new locality::LinkCell(m_box, m_max_r);
+    m_lc_next = NULL;
     }
 
 PMFTR12::~PMFTR12()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
     delete m_lc;
+    delete m_lc_next;
     }
 
 //! \internal
 //! helper function to reduce the thread specific arrays into the boost array
 void PMFTR12::reducePCF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_nbins_r*m_nbins_t1*m_nbins_t2);
     memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_nbins_r*m_nbins_t1*m_nbins_t2);
-    parallel_for(blocked_range<size_t>(0,m_nbins_t1),
+    // move the counts of each thread into the 64 bit totals
+    m_bin_counter.flush();
+    const uint64_t *bin_counts = m_bin_counter.getTotals().get();
+    // mean value of the pairs in each bin, if the frames have values
+    const double *value_sums = NULL;
+    float *value_mean = NULL;
+    if (m_weighted)
+        {
+        m_value_sums.flush();
+        m_value_sq_sums.flush();
+        if (!m_value_mean)
+            m_value_mean = std::shared_ptr<float>(new float[m_nbins_r*m_nbins_t1*m_nbins_t2], std::default_delete<float[]>());
+        value_sums = m_value_sums.getTotals().get();
+        value_mean = m_value_mean.get();
+        }
+    float inv_num_dens = m_box.getVolume() / (float)m_n_p;
+    double norm_factor = 1.0 / ((double) m_frame_counter * (double) m_n_ref);
+    const BrickIndex3D b_i = m_bins;
+    // normalize pcf_array, which is in the row major order of the jacobian array whatever the layout of the counts
+    parallel_for(blocked_range<size_t>(0,m_nbins_r),
         [=] (const blocked_range<size_t>& r)
             {
-            Index3D b_i = Index3D(m_nbins_t1, m_nbins_t2, m_nbins_r);
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                for (size_t j = 0; j < m_nbins_t2; j++)
-                    {
-                    for (size_t k = 0; k < m_nbins_r; k++)
+            for (size_t k = r.begin(); k != r.end(); k++)
+                for (unsigned int j = 0; j < m_nbins_t2; j++)
+                    for (unsigned int i = 0; i < m_nbins_t1; i++)
                         {
-                        for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                             local_bins != m_local_bin_counts.end(); ++local_bins)
-                            {
-                            m_bin_counts.get()[b_i((int)i, (int)j, (int)k)] += (*local_bins)[b_i((int)i, (int)j, (int)k)];
-                            }
+                        size_t idx = (k*m_nbins_t2 + j)*m_nbins_t1 + i;
+                        size_t bin = b_i(i, j, k);
+                        m_pcf_array.get()[idx] = float((double) bin_counts[bin] * norm_factor * m_inv_jacobian_array.get()[idx] * inv_num_dens);
+                        if (value_mean != NULL)
+                            value_mean[idx] = bin_counts[bin] ? float(value_sums[bin] / (double) bin_counts[bin]) : 0.0f;
                         }
-                    }
-                }
-            });
-    float inv_num_dens = m_box.getVolume() / (float)m_n_p;
-    float norm_factor = (float) 1.0 / ((float) m_frame_counter * (float) m_n_ref);
-    // normalize pcf_array
-    // avoid need to unravel b/c arrays are in the same index order
-    parallel_for(blocked_range<size_t>(0,m_nbins_r*m_nbins_t1*m_nbins_t2),
-        [=] (const blocked_range<size_t>& r)
-            {
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                m_pcf_array.get()[i] = (float)m_bin_counts.get()[i] * norm_factor * m_inv_jacobian_array.get()[i] * inv_num_dens;
-                }
             });
     }
 
 //! Get a reference to the PCF array
-std::shared_ptr<unsigned int> PMFTR12::getBinCounts()
+std::shared_ptr<uint64_t> PMFTR12::getBinCounts()
     {
     if (m_reduce == true)
         {
         reducePCF();
         }
     m_reduce = false;
-    return m_bin_counts;
+    if (m_bins.isBricked())
+        {
+        // export the counts in the row major order of the pcf
+        if (!m_bin_counts)
+            m_bin_counts = std::shared_ptr<uint64_t>(new uint64_t[m_nbins_t1*m_nbins_t2*m_nbins_r], std::default_delete<uint64_t[]>());
+        m_bins.copyToRowMajor(m_bin_counter.getTotals().get(), m_bin_counts.get());
+        return m_bin_counts;
+        }
+    return m_bin_counter.getTotals();
     }
 
 //! Get a reference to the PCF array
@@ -170,12 +177,80 @@ std::shared_ptr<float> PMFTR12::getPCF()
     return m_pcf_array;
     }
 
-void PMFTR12::resetPCF()
+//! Get a reference to the sum of the values of the pairs in each bin
+std::shared_ptr<double> PMFTR12::getValueSums()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
+    if (m_reduce == true)
         {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_nbins_r*m_nbins_t1*m_nbins_t2);
+        reducePCF();
         }
+    m_reduce = false;
+    return exportValues(m_value_sums, m_value_sums_array);
+    }
+
+//! Get a reference to the sum of the squared values of the pairs in each bin
+std::shared_ptr<double> PMFTR12::getValueSquareSums()
+    {
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return exportValues(m_value_sq_sums, m_value_sq_sums_array);
+    }
+
+//! Get a reference to the mean value of the pairs in each bin
+std::shared_ptr<float> PMFTR12::getValueMean()
+    {
+    if (!m_weighted)
+        throw invalid_argument("no frames with values have been accumulated");
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return m_value_mean;
+    }
+
+//! \internal
+/*! \brief Get the totals of sums, in row major order like the pcf whatever the layout of the bins
+*/
+std::shared_ptr<double> PMFTR12::exportValues(util::ThreadLocalHistogram<double>& sums, std::shared_ptr<double>& row_major)
+    {
+    if (!m_weighted)
+        throw invalid_argument("no frames with values have been accumulated");
+    if (!m_bins.isBricked())
+        return sums.getTotals();
+    if (!row_major)
+        row_major = std::shared_ptr<double>(new double[m_nbins_r*m_nbins_t1*m_nbins_t2], std::default_delete<double[]>());
+    m_bins.copyToRowMajor(sums.getTotals().get(), row_major.get());
+    return row_major;
+    }
+
+//! \internal
+/*! \brief Count into bins that each thread allocates per brick of 16x16x16 bins it adds to, or into dense bins
+    Changing the bins resets the pcf.
+*/
+void PMFTR12::setSparse(bool sparse)
+    {
+    m_bins = BrickIndex3D(m_nbins_t1, m_nbins_t2, m_nbins_r, sparse);
+    m_bin_counter.resize(m_bins.getNumElements());
+    m_bin_counter.setMode(sparse ? util::SparseTiles :
+                          util::ThreadLocalHistogram<uint32_t>::defaultMode(m_bins.getNumElements()));
+    m_bin_counts.reset();
+    m_value_sums.resize(0);
+    m_value_sq_sums.resize(0);
+    m_value_sums_array.reset();
+    m_value_sq_sums_array.reset();
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+void PMFTR12::resetPCF()
+    {
+    m_bin_counter.reset();
+    m_value_sums.reset();
+    m_value_sq_sums.reset();
     m_frame_counter = 0;
     m_reduce = true;
     }
@@ -186,10 +261,99 @@ void PMFTR12::accumulate(box::Box& box,
                          unsigned int n_ref,
                          vec3<float> *points,
                          float *orientations,
-                         unsigned int n_p)
+                         unsigned int n_p,
+                         const locality::NeighborList *nlist)
+    {
+    beginValues(false);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc->computeCellList(box, points, n_p);
+    accumulateFrame(box, ref_points, ref_orientations, n_ref, points, orientations, n_p, nlist, NULL);
+    }
+
+//! \internal
+/*! \brief Accumulate as accumulate() does, adding the values of the points to the sums of their bins
+*/
+void PMFTR12::accumulateWeighted(box::Box& box,
+                                 vec3<float> *ref_points,
+                                 float *ref_orientations,
+                                 unsigned int n_ref,
+                                 vec3<float> *points,
+                                 float *orientations,
+                                 unsigned int n_p,
+                                 const float *values,
+                                 const locality::NeighborList *nlist)
+    {
+    beginValues(true);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc->computeCellList(box, points, n_p);
+    accumulateFrame(box, ref_points, ref_orientations, n_ref, points, orientations, n_p, nlist, values);
+    }
+
+//! \internal
+/*! \brief Accumulate each frame of a trajectory, building the cell list of the next frame meanwhile
+*/
+void PMFTR12::accumulateTrajectory(box::Box *boxes,
+                                   vec3<float> *ref_points,
+                                   float *ref_orientations,
+                                   unsigned int n_ref,
+                                   vec3<float> *points,
+                                   float *orientations,
+                                   unsigned int n_p,
+                                   unsigned int n_frames)
+    {
+    beginValues(false);
+    locality::pipelineCellLists(m_lc, m_lc_next, boxes, points, n_p, n_frames,
+        [=] (unsigned int frame)
+            {
+            accumulateFrame(boxes[frame], ref_points + size_t(frame)*n_ref, ref_orientations + size_t(frame)*n_ref,
+                            n_ref, points + size_t(frame)*n_p, orientations + size_t(frame)*n_p, n_p, NULL, NULL);
+            });
+    }
+
+//! \internal
+/*! \brief Check that the frames since the last reset either all have values or all have none, and allocate the
+    value sums for the first frame with values
+*/
+void PMFTR12::beginValues(bool weighted)
+    {
+    if (m_frame_counter == 0)
+        m_weighted = weighted;
+    else if (weighted != m_weighted)
+        throw invalid_argument("frames with and without values cannot be accumulated together, call resetPCF() first");
+    size_t num_bins = m_bins.getNumElements();
+    if (weighted && m_value_sums.getNumBins() != num_bins)
+        {
+        util::HistogramMode mode = m_bins.isBricked() ? util::SparseTiles : util::ThreadLocalHistogram<double>::defaultMode(num_bins);
+        m_value_sums.resize(num_bins);
+        m_value_sq_sums.resize(num_bins);
+        m_value_sums.setMode(mode);
+        m_value_sq_sums.setMode(mode);
+        }
+    }
+
+//! \internal
+/*! \brief Bin the pairs of one frame, whose cell list is in m_lc unless nlist is given
+*/
+void PMFTR12::accumulateFrame(box::Box& box,
+                              vec3<float> *ref_points,
+                              float *ref_orientations,
+                              unsigned int n_ref,
+                              vec3<float> *points,
+                              float *orientations,
+                              unsigned int n_p,
+                              const locality::NeighborList *nlist,
+                              const float *values)
     {
     m_box = box;
-    m_lc->computeCellList(m_box, points, n_p);
+    // a single bin receives at most one count per bond, or per (ref point, candidate) pair
+    if (nlist != NULL)
+        m_bin_counter.beginFrame(uint64_t(nlist->getNumBonds()));
+    else
+        m_bin_counter.beginFrame(uint64_t(n_ref) * std::min(size_t(n_p), m_lc->getMaxNumCandidates()));
     parallel_for(blocked_range<size_t>(0, n_ref),
         [=] (const blocked_range<size_t>& br)
             {
@@ -203,77 +367,76 @@ void PMFTR12::accumulate(box::Box& box,
             float dt1_inv = 1.0f / m_dt1;
             float dt2_inv = 1.0f / m_dt2;
 
-            Index3D b_i = Index3D(m_nbins_t1, m_nbins_t2, m_nbins_r);
+            const BrickIndex3D b_i = m_bins;
+
+            util::ThreadLocalHistogram<uint32_t>::Accessor local_bins = m_bin_counter.local();
+            util::ThreadLocalHistogram<double>::Accessor local_sums = m_value_sums.local();
+            util::ThreadLocalHistogram<double>::Accessor local_sq_sums = m_value_sq_sums.local();
+
+            std::vector<unsigned int> candidates;
 
-            bool exists;
-            m_local_bin_counts.local(exists);
-            if (! exists)
-                {
-                m_local_bin_counts.local() = new unsigned int [m_nbins_r*m_nbins_t1*m_nbins_t2];
-                memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_nbins_r*m_nbins_t1*m_nbins_t2);
-                }
 
             // for each reference point
             for (size_t i = br.begin(); i != br.end(); i++)
                 {
                 // get the cell the point is in
                 vec3<float> ref = ref_points[i];
-                unsigned int ref_cell = m_lc->getCell(ref);
+                m_lc->getNeighborCandidates(ref, i, nlist, candidates);
 
-                // loop over all neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                // loop over all candidate neighbors
+                for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
                     {
-                    unsigned int neigh_cell = neigh_cells[neigh_idx];
+                    unsigned int j = candidates[neigh_idx];
+                    vec3<float> delta = m_box.wrap(points[j] - ref);
 
-                    // iterate over the particles in that cell
-                    locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-                    for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+                    float rsq = dot(delta, delta);
+                    if (rsq < 1e-6)
                         {
-                        vec3<float> delta = m_box.wrap(points[j] - ref);
-
-                        float rsq = dot(delta, delta);
-                        if (rsq < 1e-6)
+                        continue;
+                        }
+                    if (rsq < maxrsq)
+                        {
+                        float r = sqrtf(rsq);
+                        // calculate angles
+                        float d_theta1 = atan2(delta.y, delta.x);
+                        float d_theta2 = atan2(-delta.y, -delta.x);
+                        float t1 = ref_orientations[i] - d_theta1;
+                        float t2 = orientations[j] - d_theta2;
+                        // make sure that t1, t2 are bounded between 0 and 2PI
+                        t1 = fmod(t1, 2*M_PI);
+                        if (t1 < 0)
                             {
-                            continue;
+                            t1 += 2*M_PI;
                             }
-                        if (rsq < maxrsq)
+                        t2 = fmod(t2, 2*M_PI);
+                        if (t2 < 0)
                             {
-                            float r = sqrtf(rsq);
-                            // calculate angles
-                            float d_theta1 = atan2(delta.y, delta.x);
-                            float d_theta2 = atan2(-delta.y, -delta.x);
-                            float t1 = ref_orientations[i] - d_theta1;
-                            float t2 = orientations[j] - d_theta2;
-                            // make sure that t1, t2 are bounded between 0 and 2PI
-                            t1 = fmod(t1, 2*M_PI);
-                            if (t1 < 0)
-                                {
-                                t1 += 2*M_PI;
-                                }
-                            t2 = fmod(t2, 2*M_PI);
-                            if (t2 < 0)
-                                {
-                                t2 += 2*M_PI;
-                                }
-                            // bin that point
-                            float bin_r = r * dr_inv;
-                            float bin_t1 = floorf(t1 * dt1_inv);
-                            float bin_t2 = floorf(t2 * dt2_inv);
-                            // fast float to int conversion with truncation
-                            #ifdef __SSE2__
-                            unsigned int ibin_r = _mm_cvtt_ss2si(_mm_load_ss(&bin_r));
-                            unsigned int ibin_t1 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t1));
-                            unsigned int ibin_t2 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t2));
-                            #else
-                            unsigned int ibin_r = (unsigned int)(bin_r);
-                            unsigned int ibin_t1 = (unsigned int)(bin_t1);
-                            unsigned int ibin_t2 = (unsigned int)(bin_t2);
-                            #endif
-
-                            if ((ibin_r < m_nbins_r) && (ibin_t1 < m_nbins_t1) && (ibin_t2 < m_nbins_t2))
+                            t2 += 2*M_PI;
+                            }
+                        // bin that point
+                        float bin_r = r * dr_inv;
+                        float bin_t1 = floorf(t1 * dt1_inv);
+                        float bin_t2 = floorf(t2 * dt2_inv);
+                        // fast float to int conversion with truncation
+                        #ifdef __SSE2__
+                        unsigned int ibin_r = _mm_cvtt_ss2si(_mm_load_ss(&bin_r));
+                        unsigned int ibin_t1 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t1));
+                        unsigned int ibin_t2 = _mm_cvtt_ss2si(_mm_load_ss(&bin_t2));
+                        #else
+                        unsigned int ibin_r = (unsigned int)(bin_r);
+                        unsigned int ibin_t1 = (unsigned int)(bin_t1);
+                        unsigned int ibin_t2 = (unsigned int)(bin_t2);
+                        #endif
+
+                        if ((ibin_r < m_nbins_r) && (ibin_t1 < m_nbins_t1) && (ibin_t2 < m_nbins_t2))
+                            {
+                            size_t bin = b_i(ibin_t1, ibin_t2, ibin_r);
+                            ++local_bins[bin];
+                            if (values != NULL)
                                 {
-                                ++m_local_bin_counts.local()[b_i(ibin_t1, ibin_t2, ibin_r)];
+                                double value = values[j];
+                                local_sums[bin] += value;
+                                local_sq_sums[bin] += value * value;
                                 }
                             }
                         }
@@ -24,7 +24,8 @@ namespace freud { namespace pmft {
 
 PMFTXY2D::PMFTXY2D(float max_x, float max_y, unsigned int n_bins_x, unsigned int n_bins_y)
     : m_box(box::Box()), m_max_x(max_x), m_max_y(max_y), m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y),
-      m_frame_counter(0), m_n_ref(0), m_n_p(0), m_reduce(true)
+      m_frame_counter(0), m_n_ref(0), m_n_p(0), m_reduce(true), m_bin_counter(m_n_bins_x * m_n_bins_y),
+      m_weighted(false), m_value_sums(0), m_value_sq_sums(0)
     {
     if (n_bins_x < 1)
         throw invalid_argument("must be at least 1 bin in x");
@@ -66,56 +67,52 @@ PMFTXY2D::PMFTXY2D(float max_x, float max_y, unsigned int n_bins_x, unsigned int
     // create and populate the pcf_array
     m_pcf_array = std::shared_ptr<float>(new float[m_n_bins_x * m_n_bins_y], std::default_delete<float[]>());
     memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_n_bins_x * m_n_bins_y], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y);
 
 
     m_r_cut = sqrtf(m_max_x*m_max_x + m_max_y*m_max_y);
 
     m_lc = new locality::LinkCell(m_box, m_r_cut);
+    m_lc_next = NULL;
     }
 
 PMFTXY2D::~PMFTXY2D()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
     delete m_lc;
+    delete m_lc_next;
     }
 
 //! \internal
 //! helper function to reduce the thread specific arrays into the boost array
 void PMFTXY2D::reducePCF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y);
     memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y);
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x),
-        [=] (const blocked_range<size_t>& r)
-            {
-            Index2D b_i = Index2D(m_n_bins_x, m_n_bins_y);
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                for (size_t j = 0; j < m_n_bins_y; j++)
-                    {
-                    for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                         local_bins != m_local_bin_counts.end(); ++local_bins)
-                        {
-                        m_bin_counts.get()[b_i((int)i, (int)j)] += (*local_bins)[b_i((int)i, (int)j)];
-                        }
-                    }
-                }
-            });
+    // move the counts of each thread into the 64 bit totals
+    m_bin_counter.flush();
+    const uint64_t *bin_counts = m_bin_counter.getTotals().get();
+    // mean value of the pairs in each bin, if the frames have values
+    const double *value_sums = NULL;
+    float *value_mean = NULL;
+    if (m_weighted)
+        {
+        m_value_sums.flush();
+        m_value_sq_sums.flush();
+        if (!m_value_mean)
+            m_value_mean = std::shared_ptr<float>(new float[m_n_bins_x*m_n_bins_y], std::default_delete<float[]>());
+        value_sums = m_value_sums.getTotals().get();
+        value_mean = m_value_mean.get();
+        }
     float inv_num_dens = m_box.getVolume() / (float)m_n_p;
     float inv_jacobian = (float) 1.0 / m_jacobian;
-    float norm_factor = (float) 1.0 / ((float) m_frame_counter * (float) m_n_ref);
+    double norm_factor = 1.0 / ((double) m_frame_counter * (double) m_n_ref);
     // normalize pcf_array
     parallel_for(blocked_range<size_t>(0,m_n_bins_x*m_n_bins_y),
         [=] (const blocked_range<size_t>& r)
             {
             for (size_t i = r.begin(); i != r.end(); i++)
                 {
-                m_pcf_array.get()[i] = (float)m_bin_counts.get()[i] * norm_factor * inv_jacobian * inv_num_dens;
+                m_pcf_array.get()[i] = float((double) bin_counts[i] * norm_factor * inv_jacobian * inv_num_dens);
+                if (value_mean != NULL)
+                    value_mean[i] = bin_counts[i] ? float(value_sums[i] / (double) bin_counts[i]) : 0.0f;
                 }
             });
     }
@@ -131,15 +128,54 @@ std::shared_ptr<float> PMFTXY2D::getPCF()
     return m_pcf_array;
     }
 
+//! Get a reference to the sum of the values of the pairs in each bin
+std::shared_ptr<double> PMFTXY2D::getValueSums()
+    {
+    if (!m_weighted)
+        throw invalid_argument("no frames with values have been accumulated");
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return m_value_sums.getTotals();
+    }
+
+//! Get a reference to the sum of the squared values of the pairs in each bin
+std::shared_ptr<double> PMFTXY2D::getValueSquareSums()
+    {
+    if (!m_weighted)
+        throw invalid_argument("no frames with values have been accumulated");
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return m_value_sq_sums.getTotals();
+    }
+
+//! Get a reference to the mean value of the pairs in each bin
+std::shared_ptr<float> PMFTXY2D::getValueMean()
+    {
+    if (!m_weighted)
+        throw invalid_argument("no frames with values have been accumulated");
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return m_value_mean;
+    }
+
 //! Get a reference to the bin counts array
-std::shared_ptr<unsigned int> PMFTXY2D::getBinCounts()
+std::shared_ptr<uint64_t> PMFTXY2D::getBinCounts()
     {
     if (m_reduce == true)
         {
         reducePCF();
         }
     m_reduce = false;
-    return m_bin_counts;
+    return m_bin_counter.getTotals();
     }
 
 //! \internal
@@ -148,10 +184,9 @@ std::shared_ptr<unsigned int> PMFTXY2D::getBinCounts()
 
 void PMFTXY2D::resetPCF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y);
-        }
+    m_bin_counter.reset();
+    m_value_sums.reset();
+    m_value_sq_sums.reset();
     m_frame_counter = 0;
     m_reduce = true;
     }
@@ -166,10 +201,99 @@ void PMFTXY2D::accumulate(box::Box& box,
                          unsigned int n_ref,
                          vec3<float> *points,
                          float *orientations,
-                         unsigned int n_p)
+                         unsigned int n_p,
+                         const locality::NeighborList *nlist)
+    {
+    beginValues(false);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc->computeCellList(box, points, n_p);
+    accumulateFrame(box, ref_points, ref_orientations, n_ref, points, orientations, n_p, nlist, NULL);
+    }
+
+//! \internal
+/*! \brief Accumulate as accumulate() does, adding the values of the points to the sums of their bins
+*/
+void PMFTXY2D::accumulateWeighted(box::Box& box,
+                                  vec3<float> *ref_points,
+                                  float *ref_orientations,
+                                  unsigned int n_ref,
+                                  vec3<float> *points,
+                                  float *orientations,
+                                  unsigned int n_p,
+                                  const float *values,
+                                  const locality::NeighborList *nlist)
+    {
+    beginValues(true);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc->computeCellList(box, points, n_p);
+    accumulateFrame(box, ref_points, ref_orientations, n_ref, points, orientations, n_p, nlist, values);
+    }
+
+//! \internal
+/*! \brief Accumulate each frame of a trajectory, building the cell list of the next frame meanwhile
+*/
+void PMFTXY2D::accumulateTrajectory(box::Box *boxes,
+                                    vec3<float> *ref_points,
+                                    float *ref_orientations,
+                                    unsigned int n_ref,
+                                    vec3<float> *points,
+                                    float *orientations,
+                                    unsigned int n_p,
+                                    unsigned int n_frames)
+    {
+    beginValues(false);
+    locality::pipelineCellLists(m_lc, m_lc_next, boxes, points, n_p, n_frames,
+        [=] (unsigned int frame)
+            {
+            accumulateFrame(boxes[frame], ref_points + size_t(frame)*n_ref, ref_orientations + size_t(frame)*n_ref,
+                            n_ref, points + size_t(frame)*n_p, orientations + size_t(frame)*n_p, n_p, NULL, NULL);
+            });
+    }
+
+//! \internal
+/*! \brief Check that the frames since the last reset either all have values or all have none, and allocate the
+    value sums for the first frame with values
+*/
+void PMFTXY2D::beginValues(bool weighted)
+    {
+    if (m_frame_counter == 0)
+        m_weighted = weighted;
+    else if (weighted != m_weighted)
+        throw invalid_argument("frames with and without values cannot be accumulated together, call resetPCF() first");
+    size_t num_bins = m_n_bins_x*m_n_bins_y;
+    if (weighted && m_value_sums.getNumBins() != num_bins)
+        {
+        util::HistogramMode mode = util::ThreadLocalHistogram<double>::defaultMode(num_bins);
+        m_value_sums.resize(num_bins);
+        m_value_sq_sums.resize(num_bins);
+        m_value_sums.setMode(mode);
+        m_value_sq_sums.setMode(mode);
+        }
+    }
+
+//! \internal
+/*! \brief Bin the pairs of one frame, whose cell list is in m_lc unless nlist is given
+*/
+void PMFTXY2D::accumulateFrame(box::Box& box,
+                               vec3<float> *ref_points,
+                               float *ref_orientations,
+                               unsigned int n_ref,
+                               vec3<float> *points,
+                               float *orientations,
+                               unsigned int n_p,
+                               const locality::NeighborList *nlist,
+                               const float *values)
     {
     m_box = box;
-    m_lc->computeCellList(m_box, points, n_p);
+    // a single bin receives at most one count per bond, or per (ref point, candidate) pair
+    if (nlist != NULL)
+        m_bin_counter.beginFrame(uint64_t(nlist->getNumBonds()));
+    else
+        m_bin_counter.beginFrame(uint64_t(n_ref) * std::min(size_t(n_p), m_lc->getMaxNumCandidates()));
     parallel_for(blocked_range<size_t>(0,n_ref),
         [=] (const blocked_range<size_t>& r)
             {
@@ -184,64 +308,63 @@ void PMFTXY2D::accumulate(box::Box& box,
 
             Index2D b_i = Index2D(m_n_bins_x, m_n_bins_y);
 
-            bool exists;
-            m_local_bin_counts.local(exists);
-            if (! exists)
-                {
-                m_local_bin_counts.local() = new unsigned int [m_n_bins_x*m_n_bins_y];
-                memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y);
-                }
+            util::ThreadLocalHistogram<uint32_t>::Accessor local_bins = m_bin_counter.local();
+            util::ThreadLocalHistogram<double>::Accessor local_sums = m_value_sums.local();
+            util::ThreadLocalHistogram<double>::Accessor local_sq_sums = m_value_sq_sums.local();
+
+            std::vector<unsigned int> candidates;
+
 
             // for each reference point
             for (size_t i = r.begin(); i != r.end(); i++)
                 {
                 vec3<float> ref = ref_points[i];
                 // get the cell the point is in
-                unsigned int ref_cell = m_lc->getCell(ref);
+                m_lc->getNeighborCandidates(ref, i, nlist, candidates);
 
-                // loop over all neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                // loop over all candidate neighbors
+                for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
                     {
-                    unsigned int neigh_cell = neigh_cells[neigh_idx];
+                    unsigned int j = candidates[neigh_idx];
+                    vec3<float> delta = m_box.wrap(points[j] - ref);
+                    float rsq = dot(delta, delta);
 
-                    // iterate over the particles in that cell
-                    locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-                    for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+                    // check that the particle is not checking itself
+                    // 1e-6 is an arbitrary value that could be set differently if needed
+                    if (rsq < 1e-6)
                         {
-                        vec3<float> delta = m_box.wrap(points[j] - ref);
-                        float rsq = dot(delta, delta);
-
-                        // check that the particle is not checking itself
-                        // 1e-6 is an arbitrary value that could be set differently if needed
-                        if (rsq < 1e-6)
-                            {
-                            continue;
-                            }
+                        continue;
+                        }
 
-                        // rotate interparticle vector
-                        vec2<float> myVec(delta.x, delta.y);
-                        rotmat2<float> myMat = rotmat2<float>::fromAngle(-ref_orientations[i]);
-                        vec2<float> rotVec = myMat * myVec;
-                        float x = rotVec.x + m_max_x;
-                        float y = rotVec.y + m_max_y;
-
-                        // find the bin to increment
-                        float binx = floorf(x * dx_inv);
-                        float biny = floorf(y * dy_inv);
-                        // fast float to int conversion with truncation
-                        #ifdef __SSE2__
-                        unsigned int ibinx = _mm_cvtt_ss2si(_mm_load_ss(&binx));
-                        unsigned int ibiny = _mm_cvtt_ss2si(_mm_load_ss(&biny));
-                        #else
-                        unsigned int ibinx = (unsigned int)(binx);
-                        unsigned int ibiny = (unsigned int)(biny);
-                        #endif
-
-                        // increment the bin
-                        if ((ibinx < m_n_bins_x) && (ibiny < m_n_bins_y))
+                    // rotate interparticle vector
+                    vec2<float> myVec(delta.x, delta.y);
+                    rotmat2<float> myMat = rotmat2<float>::fromAngle(-ref_orientations[i]);
+                    vec2<float> rotVec = myMat * myVec;
+                    float x = rotVec.x + m_max_x;
+                    float y = rotVec.y + m_max_y;
+
+                    // find the bin to increment
+                    float binx = floorf(x * dx_inv);
+                    float biny = floorf(y * dy_inv);
+                    // fast float to int conversion with truncation
+                    #ifdef __SSE2__
+                    unsigned int ibinx = _mm_cvtt_ss2si(_mm_load_ss(&binx));
+                    unsigned int ibiny = _mm_cvtt_ss2si(_mm_load_ss(&biny));
+                    #else
+                    unsigned int ibinx = (unsigned int)(binx);
+                    unsigned int ibiny = (unsigned int)(biny);
+                    #endif
+
+                    // increment the bin
+                    if ((ibinx < m_n_bins_x) && (ibiny < m_n_bins_y))
+                        {
+                        size_t bin = b_i(ibinx, ibiny);
+                        ++local_bins[bin];
+                        if (values != NULL)
                             {
-                            ++m_local_bin_counts.local()[b_i(ibinx, ibiny)];
+                            double value = values[j];
+                            local_sums[bin] += value;
+                            local_sq_sums[bin] += value * value;
                             }
                         }
                     }
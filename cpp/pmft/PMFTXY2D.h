@@ -15,7 +15,9 @@
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "box.h"
+#include "ThreadLocalHistogram.h"
 #include "Index1D.h"
 
 #ifndef _PMFTXY2D_H__
@@ -64,6 +66,18 @@ class PMFTXY2D
             resetPCF();
             }
 
+        //! Set how the threads count into the histogram (see util::HistogramMode), keeping the counts so far
+        void setHistogramMode(util::HistogramMode mode)
+            {
+            m_bin_counter.setMode(mode);
+            }
+
+        //! Get how the threads count into the histogram
+        util::HistogramMode getHistogramMode() const
+            {
+            return m_bin_counter.getMode();
+            }
+
         /*! Compute the PCF for the passed in set of points. The function will be added to previous values
             of the pcf
         */
@@ -73,7 +87,34 @@ class PMFTXY2D
                         unsigned int n_ref,
                         vec3<float> *points,
                         float *orientations,
-                        unsigned int n_p);
+                        unsigned int n_p,
+                        const locality::NeighborList *nlist=NULL);
+
+        /*! Compute the PCF as accumulate() does and add values[j] of the point of each binned pair to the sums
+            of the values in its bin, for the mean value of a per point observable at each relative position.
+        */
+        void accumulateWeighted(box::Box& box,
+                                vec3<float> *ref_points,
+                                float *ref_orientations,
+                                unsigned int n_ref,
+                                vec3<float> *points,
+                                float *orientations,
+                                unsigned int n_p,
+                                const float *values,
+                                const locality::NeighborList *nlist=NULL);
+
+        /*! Compute the PCF of every frame of a trajectory, added to previous values of the pcf. The positions
+            and orientations of the frames follow each other, with frame f of the points at points + f*n_p.
+            The cell list of each frame is built while the previous frame is binned.
+        */
+        void accumulateTrajectory(box::Box *boxes,
+                                  vec3<float> *ref_points,
+                                  float *ref_orientations,
+                                  unsigned int n_ref,
+                                  vec3<float> *points,
+                                  float *orientations,
+                                  unsigned int n_p,
+                                  unsigned int n_frames);
 
         //! \internal
         //! helper function to reduce the thread specific arrays into the boost array
@@ -83,7 +124,16 @@ class PMFTXY2D
         std::shared_ptr<float> getPCF();
 
         //! Get a reference to the bin counts array
-        std::shared_ptr<unsigned int> getBinCounts();
+        std::shared_ptr<uint64_t> getBinCounts();
+
+        //! Get a reference to the sum of the values of the pairs in each bin
+        std::shared_ptr<double> getValueSums();
+
+        //! Get a reference to the sum of the squared values of the pairs in each bin
+        std::shared_ptr<double> getValueSquareSums();
+
+        //! Get a reference to the mean value of the pairs in each bin, 0 in empty bins
+        std::shared_ptr<float> getValueMean();
 
         //! Get a reference to the x array
         std::shared_ptr<float> getX()
@@ -121,12 +171,27 @@ class PMFTXY2D
             }
 
     private:
+        //! Bin the pairs of one frame
+        void accumulateFrame(box::Box& box,
+                             vec3<float> *ref_points,
+                             float *ref_orientations,
+                             unsigned int n_ref,
+                             vec3<float> *points,
+                             float *orientations,
+                             unsigned int n_p,
+                             const locality::NeighborList *nlist,
+                             const float *values);
+
+        //! Check that frames with and without values are not mixed, and allocate the value sums
+        void beginValues(bool weighted);
+
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_max_x;                     //!< Maximum x at which to compute pcf
         float m_max_y;                     //!< Maximum y at which to compute pcf
         float m_dx;                       //!< Step size for x in the computation
         float m_dy;                       //!< Step size for y in the computation
         locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
+        locality::LinkCell* m_lc_next;     //!< LinkCell of the next frame of a trajectory
         unsigned int m_n_bins_x;             //!< Number of x bins to compute pcf over
         unsigned int m_n_bins_y;             //!< Number of y bins to compute pcf over
         float m_r_cut;                      //!< r_cut used in cell list construction
@@ -137,10 +202,13 @@ class PMFTXY2D
         bool m_reduce;
 
         std::shared_ptr<float> m_pcf_array;         //!< array of pcf computed
-        std::shared_ptr<unsigned int> m_bin_counts;         //!< array of pcf computed
+        util::ThreadLocalHistogram<uint32_t> m_bin_counter;   //!< counts of each bin since the last reset
+        bool m_weighted;                            //!< whether the frames since the last reset have values
+        util::ThreadLocalHistogram<double> m_value_sums;      //!< sum of the values of the pairs in each bin
+        util::ThreadLocalHistogram<double> m_value_sq_sums;   //!< sum of the squared values of the pairs in each bin
+        std::shared_ptr<float> m_value_mean;        //!< mean value of the pairs in each bin
         std::shared_ptr<float> m_x_array;           //!< array of x values that the pcf is computed at
         std::shared_ptr<float> m_y_array;           //!< array of y values that the pcf is computed at
-        tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
     };
 
 }; }; // end namespace freud::pmft
@@ -25,7 +25,9 @@ namespace freud { namespace pmft {
 PMFTXYT::PMFTXYT(float max_x, float max_y, unsigned int n_bins_x, unsigned int n_bins_y, unsigned int n_bins_t)
     : m_box(box::Box()), m_max_x(max_x), m_max_y(max_y), m_max_t(2.0*M_PI),
       m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y), m_n_bins_t(n_bins_t), m_frame_counter(0),
-      m_n_ref(0), m_n_p(0), m_reduce(true)
+      m_n_ref(0), m_n_p(0), m_reduce(true), m_bins(n_bins_x, n_bins_y, n_bins_t),
+      m_bin_counter(m_n_bins_x * m_n_bins_y * m_n_bins_t),
+      m_weighted(false), m_value_sums(0), m_value_sq_sums(0)
     {
     if (n_bins_x < 1)
         throw invalid_argument("must be at least 1 bin in x");
@@ -81,71 +83,77 @@ PMFTXYT::PMFTXYT(float max_x, float max_y, unsigned int n_bins_x, unsigned int n
     // create and populate the pcf_array
     m_pcf_array = std::shared_ptr<float>(new float[m_n_bins_x*m_n_bins_y*m_n_bins_t], std::default_delete<float[]>());
     memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_n_bins_x*m_n_bins_y*m_n_bins_t], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
 
     m_r_cut = sqrtf(m_max_x*m_max_x + m_max_y*m_max_y);
 
     m_lc = new locality::LinkCell(m_box, m_r_cut);
+    m_lc_next = NULL;
     }
 
 PMFTXYT::~PMFTXYT()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
     delete m_lc;
+    delete m_lc_next;
     }
 
 //! \internal
 //! helper function to reduce the thread specific arrays into the boost array
 void PMFTXYT::reducePCF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
     memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x),
-        [=] (const blocked_range<size_t>& r)
-            {
-            Index3D b_i = Index3D(m_n_bins_x, m_n_bins_y, m_n_bins_t);
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                for (size_t j = 0; j < m_n_bins_y; j++)
-                    {
-                    for (size_t k = 0; k < m_n_bins_t; k++)
-                        {
-                        for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                             local_bins != m_local_bin_counts.end(); ++local_bins)
-                            {
-                            m_bin_counts.get()[b_i((int)i, (int)j, (int)k)] += (*local_bins)[b_i((int)i, (int)j, (int)k)];
-                            }
-                        }
-                    }
-                }
-            });
+    // move the counts of each thread into the 64 bit totals
+    m_bin_counter.flush();
+    const uint64_t *bin_counts = m_bin_counter.getTotals().get();
+    // mean value of the pairs in each bin, if the frames have values
+    const double *value_sums = NULL;
+    float *value_mean = NULL;
+    if (m_weighted)
+        {
+        m_value_sums.flush();
+        m_value_sq_sums.flush();
+        if (!m_value_mean)
+            m_value_mean = std::shared_ptr<float>(new float[m_n_bins_x*m_n_bins_y*m_n_bins_t], std::default_delete<float[]>());
+        value_sums = m_value_sums.getTotals().get();
+        value_mean = m_value_mean.get();
+        }
     float inv_num_dens = m_box.getVolume() / (float)m_n_p;
     float inv_jacobian = (float) 1.0 / m_jacobian;
-    float norm_factor = (float) 1.0 / ((float) m_frame_counter * (float) m_n_ref);
-    // normalize pcf_array
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x*m_n_bins_y*m_n_bins_t),
+    double norm_factor = 1.0 / ((double) m_frame_counter * (double) m_n_ref);
+    const BrickIndex3D b_i = m_bins;
+    // normalize pcf_array, which is in row major order whatever the layout of the counts
+    parallel_for(blocked_range<size_t>(0,m_n_bins_t),
         [=] (const blocked_range<size_t>& r)
             {
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                m_pcf_array.get()[i] = (float)m_bin_counts.get()[i] * norm_factor * inv_jacobian * inv_num_dens;
-                }
+            for (size_t k = r.begin(); k != r.end(); k++)
+                for (unsigned int j = 0; j < m_n_bins_y; j++)
+                    for (unsigned int i = 0; i < m_n_bins_x; i++)
+                        {
+                        size_t idx = (k*m_n_bins_y + j)*m_n_bins_x + i;
+                        size_t bin = b_i(i, j, k);
+                        m_pcf_array.get()[idx] = float((double) bin_counts[bin] * norm_factor * inv_jacobian * inv_num_dens);
+                        if (value_mean != NULL)
+                            value_mean[idx] = bin_counts[bin] ? float(value_sums[bin] / (double) bin_counts[bin]) : 0.0f;
+                        }
             });
     }
 
 //! Get a reference to the PCF array
-std::shared_ptr<unsigned int> PMFTXYT::getBinCounts()
+std::shared_ptr<uint64_t> PMFTXYT::getBinCounts()
     {
     if (m_reduce == true)
         {
         reducePCF();
         }
     m_reduce = false;
-    return m_bin_counts;
+    if (m_bins.isBricked())
+        {
+        // export the counts in the row major order of the pcf
+        if (!m_bin_counts)
+            m_bin_counts = std::shared_ptr<uint64_t>(new uint64_t[m_n_bins_x*m_n_bins_y*m_n_bins_t], std::default_delete<uint64_t[]>());
+        m_bins.copyToRowMajor(m_bin_counter.getTotals().get(), m_bin_counts.get());
+        return m_bin_counts;
+        }
+    return m_bin_counter.getTotals();
     }
 
 //! Get a reference to the PCF array
@@ -159,12 +167,80 @@ std::shared_ptr<float> PMFTXYT::getPCF()
     return m_pcf_array;
     }
 
-void PMFTXYT::resetPCF()
+//! Get a reference to the sum of the values of the pairs in each bin
+std::shared_ptr<double> PMFTXYT::getValueSums()
+    {
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return exportValues(m_value_sums, m_value_sums_array);
+    }
+
+//! Get a reference to the sum of the squared values of the pairs in each bin
+std::shared_ptr<double> PMFTXYT::getValueSquareSums()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
+    if (m_reduce == true)
         {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
+        reducePCF();
         }
+    m_reduce = false;
+    return exportValues(m_value_sq_sums, m_value_sq_sums_array);
+    }
+
+//! Get a reference to the mean value of the pairs in each bin
+std::shared_ptr<float> PMFTXYT::getValueMean()
+    {
+    if (!m_weighted)
+        throw invalid_argument("no frames with values have been accumulated");
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return m_value_mean;
+    }
+
+//! \internal
+/*! \brief Get the totals of sums, in row major order like the pcf whatever the layout of the bins
+*/
+std::shared_ptr<double> PMFTXYT::exportValues(util::ThreadLocalHistogram<double>& sums, std::shared_ptr<double>& row_major)
+    {
+    if (!m_weighted)
+        throw invalid_argument("no frames with values have been accumulated");
+    if (!m_bins.isBricked())
+        return sums.getTotals();
+    if (!row_major)
+        row_major = std::shared_ptr<double>(new double[m_n_bins_x*m_n_bins_y*m_n_bins_t], std::default_delete<double[]>());
+    m_bins.copyToRowMajor(sums.getTotals().get(), row_major.get());
+    return row_major;
+    }
+
+//! \internal
+/*! \brief Count into bins that each thread allocates per brick of 16x16x16 bins it adds to, or into dense bins
+    Changing the bins resets the pcf.
+*/
+void PMFTXYT::setSparse(bool sparse)
+    {
+    m_bins = BrickIndex3D(m_n_bins_x, m_n_bins_y, m_n_bins_t, sparse);
+    m_bin_counter.resize(m_bins.getNumElements());
+    m_bin_counter.setMode(sparse ? util::SparseTiles :
+                          util::ThreadLocalHistogram<uint32_t>::defaultMode(m_bins.getNumElements()));
+    m_bin_counts.reset();
+    m_value_sums.resize(0);
+    m_value_sq_sums.resize(0);
+    m_value_sums_array.reset();
+    m_value_sq_sums_array.reset();
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
+void PMFTXYT::resetPCF()
+    {
+    m_bin_counter.reset();
+    m_value_sums.reset();
+    m_value_sq_sums.reset();
     m_frame_counter = 0;
     m_reduce = true;
     }
@@ -175,10 +251,99 @@ void PMFTXYT::accumulate(box::Box& box,
                          unsigned int n_ref,
                          vec3<float> *points,
                          float *orientations,
-                         unsigned int n_p)
+                         unsigned int n_p,
+                         const locality::NeighborList *nlist)
+    {
+    beginValues(false);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc->computeCellList(box, points, n_p);
+    accumulateFrame(box, ref_points, ref_orientations, n_ref, points, orientations, n_p, nlist, NULL);
+    }
+
+//! \internal
+/*! \brief Accumulate as accumulate() does, adding the values of the points to the sums of their bins
+*/
+void PMFTXYT::accumulateWeighted(box::Box& box,
+                                 vec3<float> *ref_points,
+                                 float *ref_orientations,
+                                 unsigned int n_ref,
+                                 vec3<float> *points,
+                                 float *orientations,
+                                 unsigned int n_p,
+                                 const float *values,
+                                 const locality::NeighborList *nlist)
+    {
+    beginValues(true);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc->computeCellList(box, points, n_p);
+    accumulateFrame(box, ref_points, ref_orientations, n_ref, points, orientations, n_p, nlist, values);
+    }
+
+//! \internal
+/*! \brief Accumulate each frame of a trajectory, building the cell list of the next frame meanwhile
+*/
+void PMFTXYT::accumulateTrajectory(box::Box *boxes,
+                                   vec3<float> *ref_points,
+                                   float *ref_orientations,
+                                   unsigned int n_ref,
+                                   vec3<float> *points,
+                                   float *orientations,
+                                   unsigned int n_p,
+                                   unsigned int n_frames)
+    {
+    beginValues(false);
+    locality::pipelineCellLists(m_lc, m_lc_next, boxes, points, n_p, n_frames,
+        [=] (unsigned int frame)
+            {
+            accumulateFrame(boxes[frame], ref_points + size_t(frame)*n_ref, ref_orientations + size_t(frame)*n_ref,
+                            n_ref, points + size_t(frame)*n_p, orientations + size_t(frame)*n_p, n_p, NULL, NULL);
+            });
+    }
+
+//! \internal
+/*! \brief Check that the frames since the last reset either all have values or all have none, and allocate the
+    value sums for the first frame with values
+*/
+void PMFTXYT::beginValues(bool weighted)
+    {
+    if (m_frame_counter == 0)
+        m_weighted = weighted;
+    else if (weighted != m_weighted)
+        throw invalid_argument("frames with and without values cannot be accumulated together, call resetPCF() first");
+    size_t num_bins = m_bins.getNumElements();
+    if (weighted && m_value_sums.getNumBins() != num_bins)
+        {
+        util::HistogramMode mode = m_bins.isBricked() ? util::SparseTiles : util::ThreadLocalHistogram<double>::defaultMode(num_bins);
+        m_value_sums.resize(num_bins);
+        m_value_sq_sums.resize(num_bins);
+        m_value_sums.setMode(mode);
+        m_value_sq_sums.setMode(mode);
+        }
+    }
+
+//! \internal
+/*! \brief Bin the pairs of one frame, whose cell list is in m_lc unless nlist is given
+*/
+void PMFTXYT::accumulateFrame(box::Box& box,
+                              vec3<float> *ref_points,
+                              float *ref_orientations,
+                              unsigned int n_ref,
+                              vec3<float> *points,
+                              float *orientations,
+                              unsigned int n_p,
+                              const locality::NeighborList *nlist,
+                              const float *values)
     {
     m_box = box;
-    m_lc->computeCellList(m_box, points, n_p);
+    // a single bin receives at most one count per bond, or per (ref point, candidate) pair
+    if (nlist != NULL)
+        m_bin_counter.beginFrame(uint64_t(nlist->getNumBonds()));
+    else
+        m_bin_counter.beginFrame(uint64_t(n_ref) * std::min(size_t(n_p), m_lc->getMaxNumCandidates()));
     parallel_for(blocked_range<size_t>(0, n_ref),
         [=] (const blocked_range<size_t>& r)
             {
@@ -192,73 +357,72 @@ void PMFTXYT::accumulate(box::Box& box,
             float dy_inv = 1.0f / m_dy;
             float dt_inv = 1.0f / m_dt;
 
-            Index3D b_i = Index3D(m_n_bins_x, m_n_bins_y, m_n_bins_t);
+            const BrickIndex3D b_i = m_bins;
+
+            util::ThreadLocalHistogram<uint32_t>::Accessor local_bins = m_bin_counter.local();
+            util::ThreadLocalHistogram<double>::Accessor local_sums = m_value_sums.local();
+            util::ThreadLocalHistogram<double>::Accessor local_sq_sums = m_value_sq_sums.local();
+
+            std::vector<unsigned int> candidates;
 
-            bool exists;
-            m_local_bin_counts.local(exists);
-            if (! exists)
-                {
-                m_local_bin_counts.local() = new unsigned int [m_n_bins_x*m_n_bins_y*m_n_bins_t];
-                memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_t);
-                }
 
             // for each reference point
             for (size_t i = r.begin(); i != r.end(); i++)
                 {
                 // get the cell the point is in
                 vec3<float> ref = ref_points[i];
-                unsigned int ref_cell = m_lc->getCell(ref);
+                m_lc->getNeighborCandidates(ref, i, nlist, candidates);
 
-                // loop over all neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                // loop over all candidate neighbors
+                for (unsigned int neigh_idx = 0; neigh_idx < candidates.size(); neigh_idx++)
                     {
-                    unsigned int neigh_cell = neigh_cells[neigh_idx];
+                    unsigned int j = candidates[neigh_idx];
+                    vec3<float> delta = m_box.wrap(points[j] - ref);
 
-                    // iterate over the particles in that cell
-                    locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-                    for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+                    float rsq = dot(delta, delta);
+                    if (rsq < 1e-6)
                         {
-                        vec3<float> delta = m_box.wrap(points[j] - ref);
+                        continue;
+                        }
+                    // rotate interparticle vector
+                    vec2<float> myVec(delta.x, delta.y);
+                    rotmat2<float> myMat = rotmat2<float>::fromAngle(-ref_orientations[i]);
+                    vec2<float> rotVec = myMat * myVec;
+                    float x = rotVec.x + m_max_x;
+                    float y = rotVec.y + m_max_y;
+                    // calculate angle
+                    float d_theta = atan2(-delta.y, -delta.x);
+                    float t = orientations[j] - d_theta;
+                    // make sure that t is bounded between 0 and 2PI
+                    t = fmod(t, 2*M_PI);
+                    if (t < 0)
+                        {
+                        t += 2*M_PI;
+                        }
+                    // bin that point
+                    float bin_x = floorf(x * dx_inv);
+                    float bin_y = floorf(y * dy_inv);
+                    float bin_t = floorf(t * dt_inv);
+                    // fast float to int conversion with truncation
+                    #ifdef __SSE2__
+                    unsigned int ibin_x = _mm_cvtt_ss2si(_mm_load_ss(&bin_x));
+                    unsigned int ibin_y = _mm_cvtt_ss2si(_mm_load_ss(&bin_y));
+                    unsigned int ibin_t = _mm_cvtt_ss2si(_mm_load_ss(&bin_t));
+                    #else
+                    unsigned int ibin_x = (unsigned int)(bin_x);
+                    unsigned int ibin_y = (unsigned int)(bin_y);
+                    unsigned int ibin_t = (unsigned int)(bin_t);
+                    #endif
 
-                        float rsq = dot(delta, delta);
-                        if (rsq < 1e-6)
-                            {
-                            continue;
-                            }
-                        // rotate interparticle vector
-                        vec2<float> myVec(delta.x, delta.y);
-                        rotmat2<float> myMat = rotmat2<float>::fromAngle(-ref_orientations[i]);
-                        vec2<float> rotVec = myMat * myVec;
-                        float x = rotVec.x + m_max_x;
-                        float y = rotVec.y + m_max_y;
-                        // calculate angle
-                        float d_theta = atan2(-delta.y, -delta.x);
-                        float t = orientations[j] - d_theta;
-                        // make sure that t is bounded between 0 and 2PI
-                        t = fmod(t, 2*M_PI);
-                        if (t < 0)
-                            {
-                            t += 2*M_PI;
-                            }
-                        // bin that point
-                        float bin_x = floorf(x * dx_inv);
-                        float bin_y = floorf(y * dy_inv);
-                        float bin_t = floorf(t * dt_inv);
-                        // fast float to int conversion with truncation
-                        #ifdef __SSE2__
-                        unsigned int ibin_x = _mm_cvtt_ss2si(_mm_load_ss(&bin_x));
-                        unsigned int ibin_y = _mm_cvtt_ss2si(_mm_load_ss(&bin_y));
-                        unsigned int ibin_t = _mm_cvtt_ss2si(_mm_load_ss(&bin_t));
-                        #else
-                        unsigned int ibin_x = (unsigned int)(bin_x);
-                        unsigned int ibin_y = (unsigned int)(bin_y);
-                        unsigned int ibin_t = (unsigned int)(bin_t);
-                        #endif
-
-                        if ((ibin_x < m_n_bins_x) && (ibin_y < m_n_bins_y) && (ibin_t < m_n_bins_t))
+                    if ((ibin_x < m_n_bins_x) && (ibin_y < m_n_bins_y) && (ibin_t < m_n_bins_t))
+                        {
+                        size_t bin = b_i(ibin_x, ibin_y, ibin_t);
+                        ++local_bins[bin];
+                        if (values != NULL)
                             {
-                            ++m_local_bin_counts.local()[b_i(ibin_x, ibin_y, ibin_t)];
+                            double value = values[j];
+                            local_sums[bin] += value;
+                            local_sq_sums[bin] += value * value;
                             }
                         }
                     }
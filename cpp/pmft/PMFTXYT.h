@@ -15,7 +15,9 @@
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "box.h"
+#include "ThreadLocalHistogram.h"
 
 #ifndef _PMFTXYT_H__
 #define _PMFTXYT_H__
@@ -44,6 +46,15 @@ class PMFTXYT
         //! Reset the PCF array to all zeros
         void resetPCF();
 
+        //! Count into sparse bricks of bins instead of dense bins, resetting the PCF
+        void setSparse(bool sparse);
+
+        //! Get whether the bins are sparse
+        bool getSparse() const
+            {
+            return m_bins.isBricked();
+            }
+
         /*! Compute the PCF for the passed in set of points. The function will be added to previous values
             of the pcf
         */
@@ -53,14 +64,50 @@ class PMFTXYT
                         unsigned int n_ref,
                         vec3<float> *points,
                         float *orientations,
-                        unsigned int n_p);
+                        unsigned int n_p,
+                        const locality::NeighborList *nlist=NULL);
+
+        /*! Compute the PCF as accumulate() does and add values[j] of the point of each binned pair to the sums
+            of the values in its bin, for the mean value of a per point observable at each relative position.
+        */
+        void accumulateWeighted(box::Box& box,
+                                vec3<float> *ref_points,
+                                float *ref_orientations,
+                                unsigned int n_ref,
+                                vec3<float> *points,
+                                float *orientations,
+                                unsigned int n_p,
+                                const float *values,
+                                const locality::NeighborList *nlist=NULL);
+
+        /*! Compute the PCF of every frame of a trajectory, added to previous values of the pcf. The positions
+            and orientations of the frames follow each other, with frame f of the points at points + f*n_p.
+            The cell list of each frame is built while the previous frame is binned.
+        */
+        void accumulateTrajectory(box::Box *boxes,
+                                  vec3<float> *ref_points,
+                                  float *ref_orientations,
+                                  unsigned int n_ref,
+                                  vec3<float> *points,
+                                  float *orientations,
+                                  unsigned int n_p,
+                                  unsigned int n_frames);
 
         //! \internal
         //! helper function to reduce the thread specific arrays into the boost array
         void reducePCF();
 
         //! Get a reference to the raw bin counts
-        std::shared_ptr<unsigned int> getBinCounts();
+        std::shared_ptr<uint64_t> getBinCounts();
+
+        //! Get a reference to the sum of the values of the pairs in each bin
+        std::shared_ptr<double> getValueSums();
+
+        //! Get a reference to the sum of the squared values of the pairs in each bin
+        std::shared_ptr<double> getValueSquareSums();
+
+        //! Get a reference to the mean value of the pairs in each bin, 0 in empty bins
+        std::shared_ptr<float> getValueMean();
 
         //! Get a reference to the PCF array
         std::shared_ptr<float> getPCF();
@@ -109,6 +156,23 @@ class PMFTXYT
             }
 
     private:
+        //! Bin the pairs of one frame
+        void accumulateFrame(box::Box& box,
+                             vec3<float> *ref_points,
+                             float *ref_orientations,
+                             unsigned int n_ref,
+                             vec3<float> *points,
+                             float *orientations,
+                             unsigned int n_p,
+                             const locality::NeighborList *nlist,
+                             const float *values);
+
+        //! Check that frames with and without values are not mixed, and allocate the value sums
+        void beginValues(bool weighted);
+
+        //! Get the totals of value sums in row major order
+        std::shared_ptr<double> exportValues(util::ThreadLocalHistogram<double>& sums, std::shared_ptr<double>& row_major);
+
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_max_x;                     //!< Maximum x at which to compute pcf
         float m_max_y;                     //!< Maximum y at which to compute pcf
@@ -117,6 +181,7 @@ class PMFTXYT
         float m_dy;                       //!< Step size for y in the computation
         float m_dt;                       //!< Step size for T in the computation
         locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
+        locality::LinkCell* m_lc_next;     //!< LinkCell of the next frame of a trajectory
         unsigned int m_n_bins_x;             //!< Number of x bins to compute pcf over
         unsigned int m_n_bins_y;             //!< Number of y bins to compute pcf over
         unsigned int m_n_bins_t;             //!< Number of T bins to compute pcf over
@@ -128,11 +193,18 @@ class PMFTXYT
         float m_jacobian;
 
         std::shared_ptr<float> m_pcf_array;         //!< array of pcf computed
-        std::shared_ptr<unsigned int> m_bin_counts;         //!< array of pcf computed
+        BrickIndex3D m_bins;                        //!< layout of the bins in m_bin_counter
+        util::ThreadLocalHistogram<uint32_t> m_bin_counter;   //!< counts of each bin since the last reset
+        std::shared_ptr<uint64_t> m_bin_counts;     //!< counts in row major order, for sparse bins
+        bool m_weighted;                            //!< whether the frames since the last reset have values
+        util::ThreadLocalHistogram<double> m_value_sums;      //!< sum of the values of the pairs in each bin
+        util::ThreadLocalHistogram<double> m_value_sq_sums;   //!< sum of the squared values of the pairs in each bin
+        std::shared_ptr<float> m_value_mean;        //!< mean value of the pairs in each bin
+        std::shared_ptr<double> m_value_sums_array;     //!< value sums in row major order, for sparse bins
+        std::shared_ptr<double> m_value_sq_sums_array;  //!< squared value sums in row major order, for sparse bins
         std::shared_ptr<float> m_x_array;           //!< array of x values that the pcf is computed at
         std::shared_ptr<float> m_y_array;           //!< array of y values that the pcf is computed at
         std::shared_ptr<float> m_t_array;           //!< array of T values that the pcf is computed at
-        tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
     };
 
 }; }; // end namespace freud::pmft
@@ -25,7 +25,9 @@ namespace freud { namespace pmft {
 PMFTXYZ::PMFTXYZ(float max_x, float max_y, float max_z, unsigned int n_bins_x, unsigned int n_bins_y, unsigned int n_bins_z)
     : m_box(box::Box()), m_max_x(max_x), m_max_y(max_y), m_max_z(max_z),
       m_n_bins_x(n_bins_x), m_n_bins_y(n_bins_y), m_n_bins_z(n_bins_z), m_frame_counter(0),
-      m_n_ref(0), m_n_p(0), m_n_faces(0), m_reduce(true)
+      m_n_ref(0), m_n_p(0), m_n_faces(0), m_reduce(true), m_bins(n_bins_x, n_bins_y, n_bins_z),
+      m_bin_counter(m_n_bins_x * m_n_bins_y * m_n_bins_z),
+      m_weighted(false), m_value_sums(0), m_value_sq_sums(0)
     {
     if (n_bins_x < 1)
         throw invalid_argument("must be at least 1 bin in x");
@@ -85,71 +87,99 @@ PMFTXYZ::PMFTXYZ(float max_x, float max_y, float max_z, unsigned int n_bins_x, u
     // create and populate the pcf_array
     m_pcf_array = std::shared_ptr<float>(new float[m_n_bins_x*m_n_bins_y*m_n_bins_z], std::default_delete<float[]>());
     memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-    m_bin_counts = std::shared_ptr<unsigned int>(new unsigned int[m_n_bins_x*m_n_bins_y*m_n_bins_z], std::default_delete<unsigned int[]>());
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
 
     m_r_cut = sqrtf(m_max_x*m_max_x + m_max_y*m_max_y + m_max_z*m_max_z);
 
     m_lc = new locality::LinkCell(m_box, m_r_cut);
+    m_lc->setSortPoints(true);
+    m_lc_next = NULL;
     }
 
 PMFTXYZ::~PMFTXYZ()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        delete[] (*i);
-        }
     delete m_lc;
+    delete m_lc_next;
     }
 
 //! \internal
 //! helper function to reduce the thread specific arrays into the boost array
 void PMFTXYZ::reducePCF()
     {
-    memset((void*)m_bin_counts.get(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
     memset((void*)m_pcf_array.get(), 0, sizeof(float)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x),
-        [=] (const blocked_range<size_t>& r)
-            {
-            Index3D b_i = Index3D(m_n_bins_x, m_n_bins_y, m_n_bins_z);
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                for (size_t j = 0; j < m_n_bins_y; j++)
-                    {
-                    for (size_t k = 0; k < m_n_bins_z; k++)
-                        {
-                        for (tbb::enumerable_thread_specific<unsigned int *>::const_iterator local_bins = m_local_bin_counts.begin();
-                             local_bins != m_local_bin_counts.end(); ++local_bins)
-                            {
-                            m_bin_counts.get()[b_i((int)i, (int)j, (int)k)] += (*local_bins)[b_i((int)i, (int)j, (int)k)];
-                            }
-                        }
-                    }
-                }
-            });
+    // move the counts of each thread into the 64 bit totals
+    m_bin_counter.flush();
+    foldIn();
+    const uint64_t *bin_counts = m_bin_counter.getTotals().get();
+    // mean value of the pairs in each bin, if the frames have values
+    const double *value_sums = NULL;
+    float *value_mean = NULL;
+    if (m_weighted)
+        {
+        m_value_sums.flush();
+        m_value_sq_sums.flush();
+        if (!m_value_mean)
+            m_value_mean = std::shared_ptr<float>(new float[m_n_bins_x*m_n_bins_y*m_n_bins_z], std::default_delete<float[]>());
+        value_sums = m_value_sums.getTotals().get();
+        value_mean = m_value_mean.get();
+        }
     float inv_num_dens = m_box.getVolume() / (float)m_n_p;
     float inv_jacobian = (float) 1.0 / (float) m_jacobian;
-    float norm_factor = (float) 1.0 / ((float) m_frame_counter * (float) m_n_ref * (float) m_n_faces);
-    // normalize pcf_array
-    parallel_for(blocked_range<size_t>(0,m_n_bins_x*m_n_bins_y*m_n_bins_z),
+    double norm_factor = 1.0 / ((double) m_frame_counter * (double) m_n_ref * (double) m_n_faces);
+    const BrickIndex3D b_i = m_bins;
+    // the spread of the pcf of the blocks of frames, which are normalized per frame
+    const util::BlockAverage *blocks = m_blocks.get();
+    float *pcf_error = m_blocks ? m_pcf_error.get() : NULL;
+    double error_factor = 1.0 / ((double) m_n_ref * (double) m_n_faces);
+    // normalize pcf_array, which is in row major order whatever the layout of the counts
+    parallel_for(blocked_range<size_t>(0,m_n_bins_z),
         [=] (const blocked_range<size_t>& r)
             {
-            for (size_t i = r.begin(); i != r.end(); i++)
-                {
-                m_pcf_array.get()[i] = (float)m_bin_counts.get()[i] * norm_factor * inv_jacobian * inv_num_dens;
-                }
+            for (size_t k = r.begin(); k != r.end(); k++)
+                for (unsigned int j = 0; j < m_n_bins_y; j++)
+                    for (unsigned int i = 0; i < m_n_bins_x; i++)
+                        {
+                        size_t idx = (k*m_n_bins_y + j)*m_n_bins_x + i;
+                        size_t bin = b_i(i, j, k);
+                        m_pcf_array.get()[idx] = float((double) bin_counts[bin] * norm_factor * inv_jacobian * inv_num_dens);
+                        if (pcf_error != NULL)
+                            pcf_error[idx] = float(blocks->standardError(bin) * error_factor * inv_jacobian * inv_num_dens);
+                        if (value_mean != NULL)
+                            value_mean[idx] = bin_counts[bin] ? float(value_sums[bin] / (double) bin_counts[bin]) : 0.0f;
+                        }
             });
     }
 
 //! Get a reference to the PCF array
-std::shared_ptr<unsigned int> PMFTXYZ::getBinCounts()
+std::shared_ptr<uint64_t> PMFTXYZ::getBinCounts()
+    {
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    if (m_bins.isBricked())
+        {
+        // export the counts in the row major order of the pcf
+        if (!m_bin_counts)
+            m_bin_counts = std::shared_ptr<uint64_t>(new uint64_t[m_n_bins_x*m_n_bins_y*m_n_bins_z],
+                                                     std::default_delete<uint64_t[]>());
+        m_bins.copyToRowMajor(m_bin_counter.getTotals().get(), m_bin_counts.get());
+        return m_bin_counts;
+        }
+    return m_bin_counter.getTotals();
+    }
+
+//! Get a reference to the standard error of the PCF
+std::shared_ptr<float> PMFTXYZ::getPCFStandardError()
     {
+    if (!m_blocks)
+        throw invalid_argument("the standard error needs blocks of frames, see setNumBlocks()");
     if (m_reduce == true)
         {
         reducePCF();
         }
     m_reduce = false;
-    return m_bin_counts;
+    return m_pcf_error;
     }
 
 //! Get a reference to the PCF array
@@ -163,19 +193,115 @@ std::shared_ptr<float> PMFTXYZ::getPCF()
     return m_pcf_array;
     }
 
+//! Get a reference to the sum of the values of the pairs in each bin
+std::shared_ptr<double> PMFTXYZ::getValueSums()
+    {
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return exportValues(m_value_sums, m_value_sums_array);
+    }
+
+//! Get a reference to the sum of the squared values of the pairs in each bin
+std::shared_ptr<double> PMFTXYZ::getValueSquareSums()
+    {
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return exportValues(m_value_sq_sums, m_value_sq_sums_array);
+    }
+
+//! Get a reference to the mean value of the pairs in each bin
+std::shared_ptr<float> PMFTXYZ::getValueMean()
+    {
+    if (!m_weighted)
+        throw invalid_argument("no frames with values have been accumulated");
+    if (m_reduce == true)
+        {
+        reducePCF();
+        }
+    m_reduce = false;
+    return m_value_mean;
+    }
+
+//! \internal
+/*! \brief Get the totals of sums, in row major order like the pcf whatever the layout of the bins
+*/
+std::shared_ptr<double> PMFTXYZ::exportValues(util::ThreadLocalHistogram<double>& sums, std::shared_ptr<double>& row_major)
+    {
+    if (!m_weighted)
+        throw invalid_argument("no frames with values have been accumulated");
+    if (!m_bins.isBricked())
+        return sums.getTotals();
+    if (!row_major)
+        row_major = std::shared_ptr<double>(new double[m_n_bins_x*m_n_bins_y*m_n_bins_z], std::default_delete<double[]>());
+    m_bins.copyToRowMajor(sums.getTotals().get(), row_major.get());
+    return row_major;
+    }
+
+//! \internal
+/*! \brief Count into bins that each thread allocates per brick of 16x16x16 bins it adds to, or into dense bins
+    The sparse bins only take memory around the bond vectors that occur, e.g. the neighbor shells of a crystal,
+    which makes large numbers of bins possible. Changing the bins resets the pcf.
+*/
+void PMFTXYZ::setSparse(bool sparse)
+    {
+    m_bins = BrickIndex3D(m_n_bins_x, m_n_bins_y, m_n_bins_z, sparse);
+    m_bin_counter.resize(m_bins.getNumElements());
+    m_bin_counter.setMode(sparse ? util::SparseTiles :
+                          util::ThreadLocalHistogram<uint32_t>::defaultMode(m_bins.getNumElements()));
+    m_bin_counts.reset();
+    m_value_sums.resize(0);
+    m_value_sq_sums.resize(0);
+    m_value_sums_array.reset();
+    m_value_sq_sums_array.reset();
+    m_fold_counter.reset();
+    m_fold_maps.clear();
+    if (m_blocks)
+        m_blocks = std::shared_ptr<util::BlockAverage>(
+            new util::BlockAverage(m_bins.getNumElements(), m_blocks->getNumBlocks()));
+    m_frame_counter = 0;
+    m_reduce = true;
+    }
+
 //! \internal
 /*! \brief Function to reset the pcf array if needed e.g. calculating between new particle types
 */
 void PMFTXYZ::resetPCF()
     {
-    for (tbb::enumerable_thread_specific<unsigned int *>::iterator i = m_local_bin_counts.begin(); i != m_local_bin_counts.end(); ++i)
-        {
-        memset((void*)(*i), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-        }
+    m_bin_counter.reset();
+    m_value_sums.reset();
+    m_value_sq_sums.reset();
+    if (m_fold_counter)
+        m_fold_counter->reset();
+    if (m_blocks)
+        m_blocks->reset();
     m_frame_counter = 0;
     m_reduce = true;
     }
 
+//! \internal
+/*! \brief Keep the counts of blocks of frames for the standard error of the pcf (see util::BlockAverage)
+*/
+void PMFTXYZ::setNumBlocks(unsigned int num_blocks)
+    {
+    if (num_blocks == 0)
+        {
+        m_blocks.reset();
+        m_pcf_error.reset();
+        }
+    else
+        {
+        m_blocks = std::shared_ptr<util::BlockAverage>(new util::BlockAverage(m_bins.getNumElements(), num_blocks));
+        m_pcf_error = std::shared_ptr<float>(new float[m_n_bins_x*m_n_bins_y*m_n_bins_z], std::default_delete<float[]>());
+        }
+    resetPCF();
+    }
+
 //! \internal
 /*! \brief Helper function to direct the calculation to the correct helper class
 */
@@ -187,10 +313,332 @@ void PMFTXYZ::accumulate(box::Box& box,
                         quat<float> *orientations,
                         unsigned int n_p,
                         quat<float> *face_orientations,
-                        unsigned int n_faces)
+                        unsigned int n_faces,
+                        const locality::NeighborList *nlist)
+    {
+    beginValues(false);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc->computeCellList(box, points, n_p);
+    accumulateFaces(box, ref_points, ref_orientations, n_ref, points, n_p, face_orientations, n_faces, true, nlist, NULL);
+    }
+
+//! \internal
+/*! \brief Accumulate as accumulate() or accumulateSymmetric() do, adding the values of the points to the sums
+    The faces are always rotated one at a time, as the values cannot be folded with the counts.
+*/
+void PMFTXYZ::accumulateWeighted(box::Box& box,
+                                 vec3<float> *ref_points,
+                                 quat<float> *ref_orientations,
+                                 unsigned int n_ref,
+                                 vec3<float> *points,
+                                 quat<float> *orientations,
+                                 unsigned int n_p,
+                                 quat<float> *face_orientations,
+                                 unsigned int n_faces,
+                                 bool per_reference,
+                                 const float *values,
+                                 const locality::NeighborList *nlist)
+    {
+    beginValues(true);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc->computeCellList(box, points, n_p);
+    accumulateFaces(box, ref_points, ref_orientations, n_ref, points, n_p, face_orientations, n_faces, per_reference,
+                    nlist, values);
+    }
+
+//! \internal
+/*! \brief Accumulate with the same face orientations for every reference point
+    If every face orientation only permutes and flips the x, y and z axes, and maps the bins onto themselves, the
+    counts of the faces are the counts of the unrotated bond vector with the bins permuted in the same way: each
+    bond is binned once, into m_fold_counter, and the faces are applied to the bins in foldIn(). Otherwise the
+    faces are rotated as in accumulate().
+*/
+void PMFTXYZ::accumulateSymmetric(box::Box& box,
+                                  vec3<float> *ref_points,
+                                  quat<float> *ref_orientations,
+                                  unsigned int n_ref,
+                                  vec3<float> *points,
+                                  quat<float> *orientations,
+                                  unsigned int n_p,
+                                  quat<float> *symmetry_orientations,
+                                  unsigned int n_symmetry,
+                                  const locality::NeighborList *nlist)
+    {
+    beginValues(false);
+    if (nlist != NULL)
+        nlist->validate(n_ref, n_p);
+    else
+        m_lc->computeCellList(box, points, n_p);
+    if (prepareFold(symmetry_orientations, n_symmetry))
+        accumulateFolded(box, ref_points, ref_orientations, n_ref, points, n_p, n_symmetry, nlist);
+    else
+        accumulateFaces(box, ref_points, ref_orientations, n_ref, points, n_p, symmetry_orientations, n_symmetry,
+                        false, nlist, NULL);
+    }
+
+//! \internal
+/*! \brief Accumulate each frame of a trajectory, building the cell list of the next frame meanwhile
+    \param per_reference If true, face_orientations holds n_faces orientations for each reference point, as for
+           accumulate(); if false, the same n_faces orientations apply to all of them, as for accumulateSymmetric()
+*/
+void PMFTXYZ::accumulateTrajectory(box::Box *boxes,
+                                   vec3<float> *ref_points,
+                                   quat<float> *ref_orientations,
+                                   unsigned int n_ref,
+                                   vec3<float> *points,
+                                   quat<float> *orientations,
+                                   unsigned int n_p,
+                                   unsigned int n_frames,
+                                   quat<float> *face_orientations,
+                                   unsigned int n_faces,
+                                   bool per_reference)
+    {
+    beginValues(false);
+    bool fold = !per_reference && prepareFold(face_orientations, n_faces);
+    locality::pipelineCellLists(m_lc, m_lc_next, boxes, points, n_p, n_frames,
+        [=] (unsigned int frame)
+            {
+            vec3<float> *frame_ref_points = ref_points + size_t(frame)*n_ref;
+            quat<float> *frame_ref_orientations = ref_orientations + size_t(frame)*n_ref;
+            vec3<float> *frame_points = points + size_t(frame)*n_p;
+            if (fold)
+                accumulateFolded(boxes[frame], frame_ref_points, frame_ref_orientations, n_ref, frame_points, n_p,
+                                 n_faces, NULL);
+            else
+                accumulateFaces(boxes[frame], frame_ref_points, frame_ref_orientations, n_ref, frame_points, n_p,
+                                face_orientations, n_faces, per_reference, NULL, NULL);
+            });
+    }
+
+//! \internal
+/*! \brief Set up m_fold_counter for the given orientations
+    \returns false if they cannot be folded (see accumulateSymmetric())
+*/
+bool PMFTXYZ::prepareFold(const quat<float> *orientations, unsigned int n)
+    {
+    // a single orientation has nothing to fold
+    std::vector<AxisMap> fold_maps;
+    if (n < 2 || !getAxisMaps(orientations, n, fold_maps))
+        return false;
+
+    // counts of other faces must be moved to the bins of their faces first
+    if (!(fold_maps == m_fold_maps))
+        {
+        foldIn();
+        m_fold_maps = fold_maps;
+        }
+    if (!m_fold_counter)
+        m_fold_counter = std::shared_ptr< util::ThreadLocalHistogram<uint32_t> >(
+            new util::ThreadLocalHistogram<uint32_t>(m_bins.getNumElements(), m_bin_counter.getMode()));
+    return true;
+    }
+
+//! \internal
+/*! \brief Check that the frames since the last reset either all have values or all have none, and allocate the
+    value sums for the first frame with values
+*/
+void PMFTXYZ::beginValues(bool weighted)
+    {
+    if (m_frame_counter == 0)
+        m_weighted = weighted;
+    else if (weighted != m_weighted)
+        throw invalid_argument("frames with and without values cannot be accumulated together, call resetPCF() first");
+    size_t num_bins = m_bins.getNumElements();
+    if (weighted && m_value_sums.getNumBins() != num_bins)
+        {
+        util::HistogramMode mode = m_bins.isBricked() ? util::SparseTiles : util::ThreadLocalHistogram<double>::defaultMode(num_bins);
+        m_value_sums.resize(num_bins);
+        m_value_sq_sums.resize(num_bins);
+        m_value_sums.setMode(mode);
+        m_value_sq_sums.setMode(mode);
+        }
+    }
+
+//! \internal
+/*! \brief Bin the unrotated bond vectors of one frame into m_fold_counter, whose faces are set by prepareFold()
+*/
+void PMFTXYZ::accumulateFolded(box::Box& box,
+                               vec3<float> *ref_points,
+                               quat<float> *ref_orientations,
+                               unsigned int n_ref,
+                               vec3<float> *points,
+                               unsigned int n_p,
+                               unsigned int n_symmetry,
+                               const locality::NeighborList *nlist)
+    {
+    m_box = box;
+    // a single bin receives at most one count per bond, or per (ref point, candidate) pair
+    if (nlist != NULL)
+        m_fold_counter->beginFrame(uint64_t(nlist->getNumBonds()));
+    else
+        m_fold_counter->beginFrame(uint64_t(n_ref) * std::min(size_t(n_p), m_lc->getMaxNumCandidates()));
+    util::ThreadLocalHistogram<uint32_t> *fold_counter = m_fold_counter.get();
+    parallel_for(blocked_range<size_t>(0,n_ref),
+        [=] (const blocked_range<size_t>& r)
+            {
+            float dx_inv = 1.0f / m_dx;
+            float dy_inv = 1.0f / m_dy;
+            float dz_inv = 1.0f / m_dz;
+            const BrickIndex3D b_i = m_bins;
+            util::ThreadLocalHistogram<uint32_t>::Accessor local_bins = fold_counter->local();
+
+            // only points within r_cut can fall into a bin
+            const locality::DistanceKernel kernel(m_box, m_r_cut);
+            std::vector<unsigned int> neighbors;
+            std::vector< vec3<float> > deltas;
+
+            for (size_t i = r.begin(); i != r.end(); i++)
+                {
+                vec3<float> ref = ref_points[i];
+                rotmat3<float> rot(conj(ref_orientations[i]));
+                m_lc->getNeighbors(ref, i, nlist, points, kernel, neighbors, deltas);
+
+                for (unsigned int neigh_idx = 0; neigh_idx < neighbors.size(); neigh_idx++)
+                    {
+                    vec3<float> delta = deltas[neigh_idx];
+                    // check that the particle is not checking itself
+                    if (dot(delta, delta) < 1e-6)
+                        continue;
+                    vec3<float> v = rot * delta;
+                    float x = v.x + m_max_x;
+                    float y = v.y + m_max_y;
+                    float z = v.z + m_max_z;
+                    if (x < 0.0f || y < 0.0f || z < 0.0f)
+                        continue;
+                    unsigned int ibinx = (unsigned int)(x * dx_inv);
+                    unsigned int ibiny = (unsigned int)(y * dy_inv);
+                    unsigned int ibinz = (unsigned int)(z * dz_inv);
+                    if ((ibinx < m_n_bins_x) && (ibiny < m_n_bins_y) && (ibinz < m_n_bins_z))
+                        ++local_bins[b_i(ibinx, ibiny, ibinz)];
+                    }
+                }
+            });
+    m_frame_counter++;
+    endBlockFrame();
+    m_n_ref = n_ref;
+    m_n_p = n_p;
+    m_n_faces = n_symmetry;
+    m_reduce = true;
+    }
+
+//! \internal
+/*! \brief Find how each orientation permutes and flips the axes, if it maps the bins onto themselves
+    \returns false if some orientation is not such a signed permutation
+*/
+bool PMFTXYZ::getAxisMaps(const quat<float> *orientations, unsigned int n, std::vector<AxisMap>& maps) const
+    {
+    const unsigned int n_bins[3] = {m_n_bins_x, m_n_bins_y, m_n_bins_z};
+    const float max[3] = {m_max_x, m_max_y, m_max_z};
+    maps.resize(n);
+    for (unsigned int k = 0; k < n; k++)
+        {
+        rotmat3<float> rot(orientations[k]);
+        const vec3<float> rows[3] = {rot.row0, rot.row1, rot.row2};
+        for (unsigned int a = 0; a < 3; a++)
+            {
+            const float row[3] = {rows[a].x, rows[a].y, rows[a].z};
+            unsigned int num_nonzero = 0;
+            for (unsigned int b = 0; b < 3; b++)
+                {
+                if (fabs(fabs(row[b]) - 1.0f) < 1e-4f)
+                    {
+                    num_nonzero++;
+                    maps[k].axis[a] = b;
+                    maps[k].flip[a] = row[b] < 0.0f;
+                    }
+                else if (fabs(row[b]) > 1e-4f)
+                    return false;
+                }
+            // rotated coordinate a is +-coordinate b, so both directions need the same bins
+            unsigned int b = maps[k].axis[a];
+            if (num_nonzero != 1 || n_bins[a] != n_bins[b] || fabs(max[a] - max[b]) > 1e-6f * max[a])
+                return false;
+            }
+        }
+    return true;
+    }
+
+//! \internal
+/*! \brief Add the counts of m_fold_counter to the bins of each of the faces in m_fold_maps
+    The face maps the bond vector u to the bin of (s_0 u_{p_0}, s_1 u_{p_1}, s_2 u_{p_2}), so bin (i_0, i_1, i_2)
+    of the face receives the count of the bin with index i_a, or n - 1 - i_a if flipped, in direction p_a.
+*/
+void PMFTXYZ::foldIn()
+    {
+    if (!m_fold_counter)
+        return;
+    m_fold_counter->flush();
+    const uint64_t *fold_counts = m_fold_counter->getTotals().get();
+    uint64_t *bin_counts = m_bin_counter.getTotals().get();
+    const Index3D d_i = Index3D(m_n_bins_x, m_n_bins_y, m_n_bins_z);
+    const BrickIndex3D b_i = m_bins;
+    const AxisMap *maps = m_fold_maps.data();
+    const unsigned int n_maps = m_fold_maps.size();
+    parallel_for(blocked_range<size_t>(0, d_i.getNumElements()),
+        [=] (const blocked_range<size_t>& r)
+            {
+            const unsigned int n_bins[3] = {d_i.getW(), d_i.getH(), d_i.getD()};
+            for (size_t bin = r.begin(); bin != r.end(); bin++)
+                {
+                vec3<unsigned int> idx = d_i(bin);
+                const unsigned int face_idx[3] = {idx.x, idx.y, idx.z};
+                uint64_t count = 0;
+                for (unsigned int k = 0; k < n_maps; k++)
+                    {
+                    unsigned int src[3];
+                    for (unsigned int a = 0; a < 3; a++)
+                        src[maps[k].axis[a]] = maps[k].flip[a] ? n_bins[a] - 1 - face_idx[a] : face_idx[a];
+                    count += fold_counts[b_i(src[0], src[1], src[2])];
+                    }
+                bin_counts[b_i(idx.x, idx.y, idx.z)] += count;
+                }
+            });
+    m_fold_counter->reset();
+    }
+
+//! \internal
+/*! \brief Store the counts of the block of frames if the frame just binned completes it; the counts are flushed
+    and folded first
+*/
+void PMFTXYZ::endBlockFrame()
+    {
+    if (m_blocks && m_blocks->endFrame())
+        {
+        m_bin_counter.flush();
+        foldIn();
+        m_blocks->endBlock(m_bin_counter.getTotals().get());
+        }
+    }
+
+//! \internal
+/*! \brief Bin the bond vectors of one frame rotated into the frame of each face of the reference point
+    The cell list of the frame must be in m_lc unless nlist is given. The rotations of the faces, combined with the inverse rotation of the reference point, are turned into
+    matrices once per reference point, stored so that the loop over the faces vectorizes.
+    \param per_reference If true, face_orientations holds n_faces orientations for each reference point; if false,
+           the same n_faces orientations apply to all of them
+*/
+void PMFTXYZ::accumulateFaces(box::Box& box,
+                              vec3<float> *ref_points,
+                              quat<float> *ref_orientations,
+                              unsigned int n_ref,
+                              vec3<float> *points,
+                              unsigned int n_p,
+                              quat<float> *face_orientations,
+                              unsigned int n_faces,
+                              bool per_reference,
+                              const locality::NeighborList *nlist,
+                              const float *values)
     {
     m_box = box;
-    m_lc->computeCellList(m_box, points, n_p);
+    // a single bin receives at most one count per bond, or per (ref point, candidate) pair, for each face
+    if (nlist != NULL)
+        m_bin_counter.beginFrame(uint64_t(nlist->getNumBonds()) * n_faces);
+    else
+        m_bin_counter.beginFrame(uint64_t(n_ref) * std::min(size_t(n_p), m_lc->getMaxNumCandidates()) * n_faces);
     parallel_for(blocked_range<size_t>(0,n_ref),
         [=] (const blocked_range<size_t>& r)
             {
@@ -204,17 +652,25 @@ void PMFTXYZ::accumulate(box::Box& box,
             float dx_inv = 1.0f / m_dx;
             float dy_inv = 1.0f / m_dy;
             float dz_inv = 1.0f / m_dz;
-
-            Index3D b_i = Index3D(m_n_bins_x, m_n_bins_y, m_n_bins_z);
-            Index2D q_i = Index2D(n_faces, n_p);
-
-            bool exists;
-            m_local_bin_counts.local(exists);
-            if (! exists)
-                {
-                m_local_bin_counts.local() = new unsigned int [m_n_bins_x*m_n_bins_y*m_n_bins_z];
-                memset((void*)m_local_bin_counts.local(), 0, sizeof(unsigned int)*m_n_bins_x*m_n_bins_y*m_n_bins_z);
-                }
+            const int n_bins_x = m_n_bins_x;
+            const int n_bins_y = m_n_bins_y;
+            const int n_bins_z = m_n_bins_z;
+            const BrickIndex3D b_i = m_bins;
+
+            util::ThreadLocalHistogram<uint32_t>::Accessor local_bins = m_bin_counter.local();
+            util::ThreadLocalHistogram<double>::Accessor local_sums = m_value_sums.local();
+            util::ThreadLocalHistogram<double>::Accessor local_sq_sums = m_value_sq_sums.local();
+
+            // only points within r_cut can fall into a bin
+            const locality::DistanceKernel kernel(m_box, m_r_cut);
+            std::vector<unsigned int> neighbors;
+            std::vector< vec3<float> > deltas;
+
+            // element (a, b) of the rotation of face k is face_rot[(3*a + b)*n_faces + k]
+            std::vector<float> face_rot(9*n_faces);
+            std::vector<int> face_bins(n_faces);
+            float *rot = face_rot.data();
+            int *bins = face_bins.data();
 
             // for each reference point
             for (size_t i = r.begin(); i != r.end(); i++)
@@ -223,64 +679,64 @@ void PMFTXYZ::accumulate(box::Box& box,
                 vec3<float> ref = ref_points[i];
                 // create the reference point quaternion
                 quat<float> ref_q(ref_orientations[i]);
-                unsigned int ref_cell = m_lc->getCell(ref);
+                const quat<float> *faces = face_orientations + (per_reference ? i*n_faces : 0);
+                for (unsigned int k = 0; k < n_faces; k++)
+                    {
+                    // rotate(qe, rotate(conj(ref_q), v)) as a single matrix
+                    rotmat3<float> face_rotation(faces[k] * conj(ref_q));
+                    const vec3<float> rows[3] = {face_rotation.row0, face_rotation.row1, face_rotation.row2};
+                    for (unsigned int a = 0; a < 3; a++)
+                        {
+                        rot[(3*a + 0)*n_faces + k] = rows[a].x;
+                        rot[(3*a + 1)*n_faces + k] = rows[a].y;
+                        rot[(3*a + 2)*n_faces + k] = rows[a].z;
+                        }
+                    }
+                m_lc->getNeighbors(ref, i, nlist, points, kernel, neighbors, deltas);
 
-                // loop over all neighboring cells
-                const std::vector<unsigned int>& neigh_cells = m_lc->getCellNeighbors(ref_cell);
-                for (unsigned int neigh_idx = 0; neigh_idx < neigh_cells.size(); neigh_idx++)
+                // loop over all neighbors, whose bond vectors are already wrapped into the box
+                for (unsigned int neigh_idx = 0; neigh_idx < neighbors.size(); neigh_idx++)
                     {
-                    unsigned int neigh_cell = neigh_cells[neigh_idx];
+                    vec3<float> delta = deltas[neigh_idx];
+                    float rsq = dot(delta, delta);
 
-                    // iterate over the particles in that cell
-                    locality::LinkCell::iteratorcell it = m_lc->itercell(neigh_cell);
-                    for (unsigned int j = it.next(); !it.atEnd(); j=it.next())
+                    // check that the particle is not checking itself
+                    // 1e-6 is an arbitrary value that could be set differently if needed
+                    if (rsq < 1e-6)
                         {
-                        // make sure that the particles are wrapped into the box
-                        vec3<float> delta = m_box.wrap(points[j] - ref);
-                        float rsq = dot(delta, delta);
+                        continue;
+                        }
 
-                        // check that the particle is not checking itself
-                        // 1e-6 is an arbitrary value that could be set differently if needed
-                        if (rsq < 1e-6)
-                            {
-                            continue;
-                            }
-                        for (unsigned int k=0; k<n_faces; k++)
+                    // bin the vector in the frame of every face, -1 outside of the bins
+                    for (unsigned int k = 0; k < n_faces; k++)
+                        {
+                        float x = rot[0*n_faces + k]*delta.x + rot[1*n_faces + k]*delta.y + rot[2*n_faces + k]*delta.z + m_max_x;
+                        float y = rot[3*n_faces + k]*delta.x + rot[4*n_faces + k]*delta.y + rot[5*n_faces + k]*delta.z + m_max_y;
+                        float z = rot[6*n_faces + k]*delta.x + rot[7*n_faces + k]*delta.y + rot[8*n_faces + k]*delta.z + m_max_z;
+                        // truncation is the floor of the non negative values, which are the only ones kept
+                        int ibinx = int(x * dx_inv);
+                        int ibiny = int(y * dy_inv);
+                        int ibinz = int(z * dz_inv);
+                        bool inside = (x >= 0.0f) && (y >= 0.0f) && (z >= 0.0f)
+                                      && (ibinx < n_bins_x) && (ibiny < n_bins_y) && (ibinz < n_bins_z);
+                        bins[k] = inside ? int(b_i(ibinx, ibiny, ibinz)) : -1;
+                        }
+
+                    // increment the bins
+                    for (unsigned int k = 0; k < n_faces; k++)
+                        {
+                        if (bins[k] >= 0)
+                            ++local_bins[bins[k]];
+                        }
+                    if (values != NULL)
+                        {
+                        double value = values[neighbors[neigh_idx]];
+                        for (unsigned int k = 0; k < n_faces; k++)
                             {
-                            // create tmp vector
-                            vec3<float> my_vector(delta);
-                            // rotate vector
-                            // create the extra quaternion
-                            quat<float> qe(face_orientations[q_i(k, i)]);
-                            // create point vector
-                            vec3<float> v(delta);
-                            // rotate the vector
-                            v = rotate(conj(ref_q), v);
-                            v = rotate(qe, v);
-
-                            float x = v.x + m_max_x;
-                            float y = v.y + m_max_y;
-                            float z = v.z + m_max_z;
-
-                            // bin that point
-                            float binx = floorf(x * dx_inv);
-                            float biny = floorf(y * dy_inv);
-                            float binz = floorf(z * dz_inv);
-                            // fast float to int conversion with truncation
-                            #ifdef __SSE2__
-                            unsigned int ibinx = _mm_cvtt_ss2si(_mm_load_ss(&binx));
-                            unsigned int ibiny = _mm_cvtt_ss2si(_mm_load_ss(&biny));
-                            unsigned int ibinz = _mm_cvtt_ss2si(_mm_load_ss(&binz));
-                            #else
-                            unsigned int ibinx = (unsigned int)(binx);
-                            unsigned int ibiny = (unsigned int)(biny);
-                            unsigned int ibinz = (unsigned int)(binz);
-                            #endif
-
-                            // increment the bin
-                            if ((ibinx < m_n_bins_x) && (ibiny < m_n_bins_y) && (ibinz < m_n_bins_z))
+                            if (bins[k] >= 0)
                                 {
-                                ++m_local_bin_counts.local()[b_i(ibinx, ibiny, ibinz)];
+                                local_sums[bins[k]] += value;
+                                local_sq_sums[bins[k]] += value * value;
                                 }
                             }
                         }
@@ -288,6 +744,7 @@ void PMFTXYZ::accumulate(box::Box& box,
                 } // done looping over reference points
             });
     m_frame_counter++;
+    endBlockFrame();
     m_n_ref = n_ref;
     m_n_p = n_p;
     m_n_faces = n_faces;
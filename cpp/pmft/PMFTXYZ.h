@@ -10,12 +10,16 @@
 #define __APPLE__
 
 #include <memory>
+#include <vector>
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
 
 #include "LinkCell.h"
+#include "NeighborList.h"
 #include "box.h"
+#include "ThreadLocalHistogram.h"
+#include "BlockAverage.h"
 #include "Index1D.h"
 
 #ifndef _PMFTXYZ_H__
@@ -56,6 +60,25 @@ class PMFTXYZ
         //! Reset the PCF array to all zeros
         void resetPCF();
 
+        //! Count into sparse bricks of bins instead of dense bins, resetting the PCF
+        void setSparse(bool sparse);
+
+        //! Keep the counts of up to num_blocks blocks of frames for the standard error of the PCF, or none if 0;
+        //! resets the PCF
+        void setNumBlocks(unsigned int num_blocks);
+
+        //! Get the number of blocks kept for the standard error, 0 if none
+        unsigned int getNumBlocks() const
+            {
+            return m_blocks ? m_blocks->getNumBlocks() : 0;
+            }
+
+        //! Get whether the bins are sparse
+        bool getSparse() const
+            {
+            return m_bins.isBricked();
+            }
+
         /*! Compute the PCF for the passed in set of points. The function will be added to previous values
             of the pcf
         */
@@ -67,7 +90,59 @@ class PMFTXYZ
                         quat<float> *orientations,
                         unsigned int n_p,
                         quat<float> *face_orientations,
-                        unsigned int n_faces);
+                        unsigned int n_faces,
+                        const locality::NeighborList *nlist=NULL);
+
+        /*! Compute the PCF as accumulate() does and add values[j] of the point of each binned pair to the sums
+            of the values in its bin, for the mean value of a per point observable at each relative position.
+            face_orientations holds n_faces orientations for each reference point if per_reference is true, as
+            for accumulate(), and the same n_faces orientations for all of them otherwise.
+        */
+        void accumulateWeighted(box::Box& box,
+                                vec3<float> *ref_points,
+                                quat<float> *ref_orientations,
+                                unsigned int n_ref,
+                                vec3<float> *points,
+                                quat<float> *orientations,
+                                unsigned int n_p,
+                                quat<float> *face_orientations,
+                                unsigned int n_faces,
+                                bool per_reference,
+                                const float *values,
+                                const locality::NeighborList *nlist=NULL);
+
+        /*! Compute the PCF with the same set of symmetry orientations applied to every reference point, which
+            is much faster when they map the bins onto themselves (e.g. the 24 rotations of a cube with the
+            same bins in x, y and z). The function will be added to previous values of the pcf
+        */
+        void accumulateSymmetric(box::Box& box,
+                                 vec3<float> *ref_points,
+                                 quat<float> *ref_orientations,
+                                 unsigned int n_ref,
+                                 vec3<float> *points,
+                                 quat<float> *orientations,
+                                 unsigned int n_p,
+                                 quat<float> *symmetry_orientations,
+                                 unsigned int n_symmetry,
+                                 const locality::NeighborList *nlist=NULL);
+
+        /*! Compute the PCF of every frame of a trajectory, added to previous values of the pcf. The positions
+            and orientations of the frames follow each other, with frame f of the points at points + f*n_p; the
+            face orientations are the same in every frame, either for each reference point (as for accumulate())
+            or for all of them (as for accumulateSymmetric()). The cell list of each frame is built while the
+            previous frame is binned.
+        */
+        void accumulateTrajectory(box::Box *boxes,
+                                  vec3<float> *ref_points,
+                                  quat<float> *ref_orientations,
+                                  unsigned int n_ref,
+                                  vec3<float> *points,
+                                  quat<float> *orientations,
+                                  unsigned int n_p,
+                                  unsigned int n_frames,
+                                  quat<float> *face_orientations,
+                                  unsigned int n_faces,
+                                  bool per_reference);
 
         //! \internal
         //! helper function to reduce the thread specific arrays into the boost array
@@ -76,8 +151,20 @@ class PMFTXYZ
         //! Get a reference to the PCF array
         std::shared_ptr<float> getPCF();
 
+        //! Get a reference to the standard error of the PCF, from the blocks of frames
+        std::shared_ptr<float> getPCFStandardError();
+
         //! Get a reference to the bin counts array
-        std::shared_ptr<unsigned int> getBinCounts();
+        std::shared_ptr<uint64_t> getBinCounts();
+
+        //! Get a reference to the sum of the values of the pairs in each bin
+        std::shared_ptr<double> getValueSums();
+
+        //! Get a reference to the sum of the squared values of the pairs in each bin
+        std::shared_ptr<double> getValueSquareSums();
+
+        //! Get a reference to the mean value of the pairs in each bin, 0 in empty bins
+        std::shared_ptr<float> getValueMean();
 
         //! Get a reference to the x array
         std::shared_ptr<float> getX()
@@ -123,6 +210,63 @@ class PMFTXYZ
             }
 
     private:
+        //! How a face orientation that only permutes and flips axes maps the bond vector: component a of the
+        //! rotated vector is component axis[a] of the vector, negated if flip[a]
+        struct AxisMap
+            {
+            unsigned int axis[3];
+            bool flip[3];
+
+            bool operator==(const AxisMap& other) const
+                {
+                for (unsigned int a = 0; a < 3; a++)
+                    if (axis[a] != other.axis[a] || flip[a] != other.flip[a])
+                        return false;
+                return true;
+                }
+            };
+
+        //! Bin the bond vectors of one frame rotated into the frame of each face
+        void accumulateFaces(box::Box& box,
+                             vec3<float> *ref_points,
+                             quat<float> *ref_orientations,
+                             unsigned int n_ref,
+                             vec3<float> *points,
+                             unsigned int n_p,
+                             quat<float> *face_orientations,
+                             unsigned int n_faces,
+                             bool per_reference,
+                             const locality::NeighborList *nlist,
+                             const float *values);
+
+        //! Check that frames with and without values are not mixed, and allocate the value sums
+        void beginValues(bool weighted);
+
+        //! Get the totals of value sums in row major order
+        std::shared_ptr<double> exportValues(util::ThreadLocalHistogram<double>& sums, std::shared_ptr<double>& row_major);
+
+        //! Set up the folded counts for the orientations, if they can be folded
+        bool prepareFold(const quat<float> *orientations, unsigned int n);
+
+        //! Bin the unrotated bond vectors of one frame for folding
+        void accumulateFolded(box::Box& box,
+                              vec3<float> *ref_points,
+                              quat<float> *ref_orientations,
+                              unsigned int n_ref,
+                              vec3<float> *points,
+                              unsigned int n_p,
+                              unsigned int n_symmetry,
+                              const locality::NeighborList *nlist);
+
+        //! Find the axis maps of the orientations, if they all map the bins onto themselves
+        bool getAxisMaps(const quat<float> *orientations, unsigned int n, std::vector<AxisMap>& maps) const;
+
+        //! Add the counts of the unrotated bond vectors to the bins of every face
+        void foldIn();
+
+        //! Complete the block of frames if the frame just binned is its last
+        void endBlockFrame();
+
         box::Box m_box;            //!< Simulation box the particles belong in
         float m_max_x;                     //!< Maximum x at which to compute pcf
         float m_max_y;                     //!< Maximum y at which to compute pcf
@@ -131,6 +275,7 @@ class PMFTXYZ
         float m_dy;                       //!< Step size for y in the computation
         float m_dz;                       //!< Step size for z in the computation
         locality::LinkCell* m_lc;          //!< LinkCell to bin particles for the computation
+        locality::LinkCell* m_lc_next;     //!< LinkCell of the next frame of a trajectory
         unsigned int m_n_bins_x;             //!< Number of x bins to compute pcf over
         unsigned int m_n_bins_y;             //!< Number of y bins to compute pcf over
         unsigned int m_n_bins_z;             //!< Number of z bins to compute pcf over
@@ -143,11 +288,22 @@ class PMFTXYZ
         bool m_reduce;
 
         std::shared_ptr<float> m_pcf_array;         //!< array of pcf computed
-        std::shared_ptr<unsigned int> m_bin_counts;         //!< array of pcf computed
+        BrickIndex3D m_bins;                        //!< layout of the bins in m_bin_counter
+        util::ThreadLocalHistogram<uint32_t> m_bin_counter;   //!< counts of each bin since the last reset
+        std::shared_ptr<uint64_t> m_bin_counts;     //!< counts in row major order, for sparse bins
+        bool m_weighted;                            //!< whether the frames since the last reset have values
+        util::ThreadLocalHistogram<double> m_value_sums;      //!< sum of the values of the pairs in each bin
+        util::ThreadLocalHistogram<double> m_value_sq_sums;   //!< sum of the squared values of the pairs in each bin
+        std::shared_ptr<float> m_value_mean;        //!< mean value of the pairs in each bin
+        std::shared_ptr<double> m_value_sums_array;     //!< value sums in row major order, for sparse bins
+        std::shared_ptr<double> m_value_sq_sums_array;  //!< squared value sums in row major order, for sparse bins
+        std::shared_ptr< util::ThreadLocalHistogram<uint32_t> > m_fold_counter;   //!< counts of the unrotated bond vectors, not yet added for each face
+        std::vector<AxisMap> m_fold_maps;           //!< faces that m_fold_counter is added for
+        std::shared_ptr<util::BlockAverage> m_blocks;   //!< counts of blocks of frames, if the error is computed
+        std::shared_ptr<float> m_pcf_error;         //!< standard error of the pcf, in row major order
         std::shared_ptr<float> m_x_array;           //!< array of x values that the pcf is computed at
         std::shared_ptr<float> m_y_array;           //!< array of y values that the pcf is computed at
         std::shared_ptr<float> m_z_array;           //!< array of z values that the pcf is computed at
-        tbb::enumerable_thread_specific<unsigned int *> m_local_bin_counts;
     };
 
 }; }; // end namespace freud::pmft
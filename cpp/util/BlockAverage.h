@@ -0,0 +1,145 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+#include <stdint.h>
+
+#ifndef _BLOCK_AVERAGE_H__
+#define _BLOCK_AVERAGE_H__
+
+/*! \file BlockAverage.h
+    \brief Block averages of histograms accumulated frame by frame, for the standard error of their mean
+*/
+
+namespace freud { namespace util {
+
+//! Counts of a histogram in consecutive blocks of frames
+/*! The frames are grouped into at most num_blocks consecutive blocks of equal length, starting with one frame per
+    block. The counts of each complete block are kept; once all num_blocks blocks are complete, neighboring pairs
+    are merged and the block length doubles. The blocks therefore always span the whole accumulation, however
+    long, for num_blocks times the memory of the histogram. Frames of the incomplete last block only count in the
+    totals.
+
+    The owner calls endFrame() after adding each frame to its histogram, and when it returns true passes the
+    (flushed) totals to endBlock(). The counts of a block are the difference of the totals at its end and at its
+    start.
+
+    standardError() is the standard error of the mean counts per frame of a bin, sqrt(s^2 / n), from the variance
+    s^2 of the mean counts per frame of the n complete blocks, computed with Welford's single pass update. It is
+    only an estimate of the uncertainty once the blocks are longer than the correlation time of the frames.
+*/
+class BlockAverage
+    {
+    public:
+        //! Constructor
+        BlockAverage(size_t num_bins, unsigned int num_blocks)
+            : m_num_bins(num_bins), m_num_blocks(num_blocks), m_num_complete(0), m_block_length(1),
+              m_block_frames(0)
+            {
+            // merging leaves num_blocks / 2 complete blocks, of which there must be 2 for a standard error
+            if (num_blocks < 4 || num_blocks % 2 != 0)
+                throw std::invalid_argument("the number of blocks must be even and at least 4");
+            m_blocks.assign(size_t(num_blocks) * num_bins, 0);
+            m_start.assign(num_bins, 0);
+            }
+
+        //! Get the largest number of blocks
+        unsigned int getNumBlocks() const
+            {
+            return m_num_blocks;
+            }
+
+        //! Get the number of complete blocks
+        unsigned int getNumComplete() const
+            {
+            return m_num_complete;
+            }
+
+        //! Get the number of frames in each complete block
+        unsigned int getBlockLength() const
+            {
+            return m_block_length;
+            }
+
+        //! Discard all blocks, for a histogram that was reset
+        void reset()
+            {
+            std::fill(m_blocks.begin(), m_blocks.end(), 0);
+            std::fill(m_start.begin(), m_start.end(), 0);
+            m_num_complete = 0;
+            m_block_length = 1;
+            m_block_frames = 0;
+            }
+
+        //! Count a frame
+        /*! \returns true if the frame completes a block, whose totals must then be passed to endBlock()
+        */
+        bool endFrame()
+            {
+            return ++m_block_frames == m_block_length;
+            }
+
+        //! Store the counts of the block that ends with the given totals of the histogram
+        void endBlock(const uint64_t *totals)
+            {
+            uint64_t *block = &m_blocks[size_t(m_num_complete) * m_num_bins];
+            for (size_t i = 0; i < m_num_bins; i++)
+                {
+                block[i] = totals[i] - m_start[i];
+                m_start[i] = totals[i];
+                }
+            m_num_complete++;
+            m_block_frames = 0;
+
+            // merge neighboring blocks once all of them are complete
+            if (m_num_complete == m_num_blocks)
+                {
+                for (unsigned int k = 0; k < m_num_blocks / 2; k++)
+                    {
+                    uint64_t *merged = &m_blocks[size_t(k) * m_num_bins];
+                    const uint64_t *first = &m_blocks[size_t(2*k) * m_num_bins];
+                    const uint64_t *second = &m_blocks[size_t(2*k + 1) * m_num_bins];
+                    for (size_t i = 0; i < m_num_bins; i++)
+                        merged[i] = first[i] + second[i];
+                    }
+                m_num_complete = m_num_blocks / 2;
+                m_block_length *= 2;
+                }
+            }
+
+        //! Get the standard error of the mean counts per frame of a bin, NaN with fewer than 2 complete blocks
+        double standardError(size_t bin) const
+            {
+            if (m_num_complete < 2)
+                return std::numeric_limits<double>::quiet_NaN();
+            double inv_length = 1.0 / double(m_block_length);
+            double mean = 0.0;
+            double m2 = 0.0;
+            for (unsigned int k = 0; k < m_num_complete; k++)
+                {
+                double x = double(m_blocks[size_t(k) * m_num_bins + bin]) * inv_length;
+                double delta = x - mean;
+                mean += delta / double(k + 1);
+                m2 += delta * (x - mean);
+                }
+            double variance = m2 / double(m_num_complete - 1);
+            return sqrt(variance / double(m_num_complete));
+            }
+
+    private:
+        size_t m_num_bins;                  //!< Number of bins of the histogram
+        unsigned int m_num_blocks;          //!< Largest number of blocks
+        unsigned int m_num_complete;        //!< Number of complete blocks
+        unsigned int m_block_length;        //!< Number of frames in each block
+        unsigned int m_block_frames;        //!< Number of frames in the incomplete block
+        std::vector<uint64_t> m_blocks;     //!< Counts of each complete block
+        std::vector<uint64_t> m_start;      //!< Totals of the histogram at the start of the incomplete block
+    };
+
+}; }; // end namespace freud::util
+
+#endif // _BLOCK_AVERAGE_H__
@@ -0,0 +1,188 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include "FFT.h"
+
+#include <stdexcept>
+#include <cmath>
+#include <tbb/tbb.h>
+
+using namespace std;
+
+using namespace tbb;
+
+/*! \file FFT.cc
+    \brief Fast Fourier transforms of complex data on 1D lines and 3D grids
+*/
+
+namespace freud { namespace util {
+
+FFT1D::FFT1D(size_t n)
+    : m_n(n), m_pow2((n & (n - 1)) == 0)
+    {
+    if (n == 0)
+        throw invalid_argument("FFT length must be positive");
+
+    if (m_pow2)
+        {
+        // bit reversal permutation and the twiddle factors of the radix 2 butterflies
+        m_bitrev.resize(m_n);
+        unsigned int num_bits = 0;
+        while ((size_t(1) << num_bits) < m_n)
+            num_bits++;
+        for (size_t i = 0; i < m_n; i++)
+            {
+            size_t rev = 0;
+            for (unsigned int b = 0; b < num_bits; b++)
+                if (i & (size_t(1) << b))
+                    rev |= size_t(1) << (num_bits - 1 - b);
+            m_bitrev[i] = rev;
+            }
+        m_twiddles.resize(m_n / 2);
+        for (size_t k = 0; k < m_n / 2; k++)
+            m_twiddles[k] = polar(1.0, -2.0 * M_PI * double(k) / double(m_n));
+        }
+    else
+        {
+        /* Bluestein: with jk = (j^2 + k^2 - (k - j)^2)/2, X_k = c_k sum_j (x_j c_j) conj(c_{k-j}) for the chirp
+           c_j = exp(-i pi j^2 / n), a convolution that is done with power of two transforms of length
+           m >= 2n - 1. j^2 is reduced modulo 2n so that the phases stay accurate for long transforms.
+        */
+        size_t m = 1;
+        while (m < 2 * m_n - 1)
+            m <<= 1;
+        m_conv = std::shared_ptr<FFT1D>(new FFT1D(m));
+
+        m_chirp.resize(m_n);
+        for (size_t j = 0; j < m_n; j++)
+            m_chirp[j] = polar(1.0, -M_PI * double((j * j) % (2 * m_n)) / double(m_n));
+
+        m_chirp_ft.assign(m, complex<double>(0.0, 0.0));
+        m_chirp_ft[0] = conj(m_chirp[0]);
+        for (size_t j = 1; j < m_n; j++)
+            {
+            m_chirp_ft[j] = conj(m_chirp[j]);
+            m_chirp_ft[m - j] = conj(m_chirp[j]);
+            }
+        m_conv->transformPow2(&m_chirp_ft[0], false);
+        }
+    }
+
+void FFT1D::transformPow2(complex<double> *data, bool inverse) const
+    {
+    for (size_t i = 0; i < m_n; i++)
+        {
+        size_t j = m_bitrev[i];
+        if (i < j)
+            swap(data[i], data[j]);
+        }
+
+    for (size_t len = 2; len <= m_n; len <<= 1)
+        {
+        size_t half = len / 2;
+        size_t step = m_n / len;
+        for (size_t start = 0; start < m_n; start += len)
+            {
+            for (size_t j = 0; j < half; j++)
+                {
+                complex<double> w = inverse ? conj(m_twiddles[j * step]) : m_twiddles[j * step];
+                complex<double> u = data[start + j];
+                complex<double> v = data[start + j + half] * w;
+                data[start + j] = u + v;
+                data[start + j + half] = u - v;
+                }
+            }
+        }
+
+    if (inverse)
+        {
+        double scale = 1.0 / double(m_n);
+        for (size_t i = 0; i < m_n; i++)
+            data[i] *= scale;
+        }
+    }
+
+void FFT1D::transform(complex<double> *data, bool inverse, vector< complex<double> >& work) const
+    {
+    if (m_pow2)
+        {
+        transformPow2(data, inverse);
+        return;
+        }
+
+    // the inverse transform is the conjugate of the forward transform of the conjugate, divided by n
+    size_t m = m_conv->size();
+    work.assign(m, complex<double>(0.0, 0.0));
+    for (size_t j = 0; j < m_n; j++)
+        work[j] = (inverse ? conj(data[j]) : data[j]) * m_chirp[j];
+
+    m_conv->transformPow2(&work[0], false);
+    for (size_t k = 0; k < m; k++)
+        work[k] *= m_chirp_ft[k];
+    m_conv->transformPow2(&work[0], true);
+
+    for (size_t k = 0; k < m_n; k++)
+        {
+        complex<double> value = work[k] * m_chirp[k];
+        data[k] = inverse ? conj(value) / double(m_n) : value;
+        }
+    }
+
+FFT3D::FFT3D(size_t nx, size_t ny, size_t nz)
+    {
+    m_n[0] = nx;
+    m_n[1] = ny;
+    m_n[2] = nz;
+    for (unsigned int axis = 0; axis < 3; axis++)
+        m_fft[axis] = std::shared_ptr<FFT1D>(new FFT1D(m_n[axis]));
+    }
+
+void FFT3D::forward(complex<double> *grid) const
+    {
+    for (unsigned int axis = 0; axis < 3; axis++)
+        transformAxis(grid, axis, false);
+    }
+
+void FFT3D::inverse(complex<double> *grid) const
+    {
+    for (unsigned int axis = 0; axis < 3; axis++)
+        transformAxis(grid, axis, true);
+    }
+
+void FFT3D::transformAxis(complex<double> *grid, unsigned int axis, bool inverse) const
+    {
+    size_t n = m_n[axis];
+    if (n == 1)
+        return;
+
+    // the points of a line along axis are stride apart; lines are numbered by their position in the other two
+    // directions
+    size_t stride = 1;
+    for (unsigned int a = 0; a < axis; a++)
+        stride *= m_n[a];
+    size_t num_lines = getNumElements() / n;
+    const FFT1D *fft = m_fft[axis].get();
+
+    parallel_for(blocked_range<size_t>(0, num_lines),
+        [=] (const blocked_range<size_t>& r)
+        {
+        vector< complex<double> > line(stride == 1 ? 0 : n);
+        vector< complex<double> > work;
+        for (size_t l = r.begin(); l != r.end(); l++)
+            {
+            complex<double> *start = grid + (l % stride) + (l / stride) * stride * n;
+            if (stride == 1)
+                {
+                fft->transform(start, inverse, work);
+                continue;
+                }
+            for (size_t i = 0; i < n; i++)
+                line[i] = start[i * stride];
+            fft->transform(&line[0], inverse, work);
+            for (size_t i = 0; i < n; i++)
+                start[i * stride] = line[i];
+            }
+        });
+    }
+
+}; }; // end namespace freud::util
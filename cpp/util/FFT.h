@@ -0,0 +1,90 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+#ifndef _FFT_H__
+#define _FFT_H__
+
+/*! \file FFT.h
+    \brief Fast Fourier transforms of complex data on 1D lines and 3D grids
+*/
+
+namespace freud { namespace util {
+
+//! Discrete Fourier transform of a fixed length
+/*! The forward transform is X_k = sum_j x_j exp(-2 pi i j k / n) and the inverse transform is its inverse,
+    including the factor 1/n. Powers of two use an iterative radix 2 transform with precomputed twiddle factors;
+    any other length is written as a convolution of a power of two length (Bluestein's algorithm), so every length
+    costs O(n log n).
+
+    The transforms are const: one FFT1D may be used by many threads at once, each with its own work array.
+*/
+class FFT1D
+    {
+    public:
+        //! Constructor
+        FFT1D(size_t n);
+
+        //! Get the length of the transform
+        size_t size() const
+            {
+            return m_n;
+            }
+
+        //! Transform n contiguous values in place
+        /*! \param data Values to transform
+            \param inverse Compute the inverse transform if true
+            \param work Scratch space, resized as needed
+        */
+        void transform(std::complex<double> *data, bool inverse, std::vector< std::complex<double> >& work) const;
+
+    private:
+        //! In place radix 2 transform, only for power of two lengths
+        void transformPow2(std::complex<double> *data, bool inverse) const;
+
+        size_t m_n;                                     //!< Length of the transform
+        bool m_pow2;                                    //!< True if the length is a power of two
+        std::vector<size_t> m_bitrev;                   //!< Bit reversal permutation (power of two lengths)
+        std::vector< std::complex<double> > m_twiddles; //!< exp(-2 pi i k / n) for k < n/2 (power of two lengths)
+        std::vector< std::complex<double> > m_chirp;    //!< exp(-i pi j^2 / n) for j < n (other lengths)
+        std::vector< std::complex<double> > m_chirp_ft; //!< Transform of the conjugate chirp filter (other lengths)
+        std::shared_ptr<FFT1D> m_conv;                  //!< Power of two transform of the convolution (other lengths)
+    };
+
+//! Discrete Fourier transform of a 3D grid
+/*! The grid is stored with x varying fastest, so that point (i, j, k) is at Index3D(nx, ny, nz)(i, j, k). The
+    transform is done along x, then y, then z; the lines of each direction are transformed in parallel. Directions
+    of size 1 (e.g. nz = 1 for a 2D grid) are skipped.
+*/
+class FFT3D
+    {
+    public:
+        //! Constructor
+        FFT3D(size_t nx, size_t ny, size_t nz);
+
+        //! Get the number of points in the grid
+        size_t getNumElements() const
+            {
+            return m_n[0] * m_n[1] * m_n[2];
+            }
+
+        //! Forward transform of the grid in place
+        void forward(std::complex<double> *grid) const;
+
+        //! Inverse transform of the grid in place, including the factor 1/(nx ny nz)
+        void inverse(std::complex<double> *grid) const;
+
+    private:
+        //! Transform all the lines along one direction
+        void transformAxis(std::complex<double> *grid, unsigned int axis, bool inverse) const;
+
+        size_t m_n[3];                      //!< Grid size in each direction
+        std::shared_ptr<FFT1D> m_fft[3];    //!< Transform along each direction
+    };
+
+}; }; // end namespace freud::util
+
+#endif // _FFT_H__
@@ -67,12 +67,12 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 class Index2D
     {
     public:
-        //! Contstructor
+        //! Constructor
         /*! \param w Width of the square 2D array
         */
         HOSTDEVICE inline Index2D(unsigned int w) : m_w(w), m_h(w) {}
 
-        //! Contstructor
+        //! Constructor
         /*! \param w Width of the rectangular 2D array
             \param h Height of the rectangular 2D array
         */
@@ -116,7 +116,7 @@ class Index2D
 class Index2DUpperTriangular
     {
     public:
-        //! Contstructor
+        //! Constructor
         /*! \param w Width of the 2D upper triangular array
         */
         HOSTDEVICE inline Index2DUpperTriangular(unsigned int w) : m_w(w)
@@ -162,12 +162,12 @@ class Index2DUpperTriangular
 class Index3D
     {
     public:
-        //! Contstructor
+        //! Constructor
         /*! \param w Width of the cubic 3D array
         */
         HOSTDEVICE inline Index3D(unsigned int w=0) : m_w(w), m_h(w), m_d(w) {}
 
-        //! Contstructor
+        //! Constructor
         /*! \param w Width of the 3D array
             \param h Height of the 3D array
             \param d Depth of the 3D array
@@ -230,5 +230,82 @@ class Index3D
         unsigned int m_d;   //!< Depth of the 3D array
     };
 
+//! Index a 3D array stored in cubic bricks
+/*! The array is split into bricks of 16 x 16 x 16 elements, each stored contiguously in row major order, with the
+    bricks themselves in row major order and the array padded to whole bricks. Elements that are close in all three
+    directions are then close in memory, so that storage allocated per block of 4096 elements (e.g. the SparseTiles
+    of a ThreadLocalHistogram) only covers the regions of the array that are used. Unbricked, the mapping is that of
+    Index3D.
+    \ingroup utils
+*/
+class BrickIndex3D
+    {
+    public:
+        //! log2 of the brick width
+        static const unsigned int BRICK_SHIFT = 4;
+
+        //! Constructor
+        /*! \param w Width of the 3D array
+            \param h Height of the 3D array
+            \param d Depth of the 3D array
+            \param bricked Store the array in bricks if true, in row major order if false
+        */
+        HOSTDEVICE inline BrickIndex3D(unsigned int w=0, unsigned int h=0, unsigned int d=0, bool bricked=false)
+            : m_w(w), m_h(h), m_d(d), m_bricked(bricked)
+            {
+            m_bw = (w + (1 << BRICK_SHIFT) - 1) >> BRICK_SHIFT;
+            m_bh = (h + (1 << BRICK_SHIFT) - 1) >> BRICK_SHIFT;
+            m_bd = (d + (1 << BRICK_SHIFT) - 1) >> BRICK_SHIFT;
+            }
+
+        //! Calculate an index
+        /*! \param i index along the width
+            \param j index up the height
+            \param k index along the depth
+            \returns 1D array index of the element (\a i, \a j, \a k)
+        */
+        HOSTDEVICE inline unsigned int operator()(unsigned int i, unsigned int j, unsigned int k) const
+            {
+            if (!m_bricked)
+                return k*m_w*m_h + j*m_w + i;
+            const unsigned int mask = (1 << BRICK_SHIFT) - 1;
+            unsigned int brick = ((k >> BRICK_SHIFT)*m_bh + (j >> BRICK_SHIFT))*m_bw + (i >> BRICK_SHIFT);
+            return (brick << (3*BRICK_SHIFT)) | ((k & mask) << (2*BRICK_SHIFT)) | ((j & mask) << BRICK_SHIFT) | (i & mask);
+            }
+
+        //! Get the number of 1D elements stored, including the padding of the bricks
+        HOSTDEVICE inline unsigned int getNumElements() const
+            {
+            if (!m_bricked)
+                return m_w * m_h * m_d;
+            return (m_bw * m_bh * m_bd) << (3*BRICK_SHIFT);
+            }
+
+        //! Get whether the array is stored in bricks
+        HOSTDEVICE inline bool isBricked() const
+            {
+            return m_bricked;
+            }
+
+        //! Copy an array in this layout to a w x h x d array in row major order
+        template<typename T>
+        void copyToRowMajor(const T *src, T *dst) const
+            {
+            for (unsigned int k = 0; k < m_d; k++)
+                for (unsigned int j = 0; j < m_h; j++)
+                    for (unsigned int i = 0; i < m_w; i++)
+                        dst[(k*m_h + j)*m_w + i] = src[(*this)(i, j, k)];
+            }
+
+    private:
+        unsigned int m_w;   //!< Width of the 3D array
+        unsigned int m_h;   //!< Height of the 3D array
+        unsigned int m_d;   //!< Depth of the 3D array
+        unsigned int m_bw;  //!< Number of bricks along the width
+        unsigned int m_bh;  //!< Number of bricks up the height
+        unsigned int m_bd;  //!< Number of bricks along the depth
+        bool m_bricked;     //!< True if the array is stored in bricks
+    };
+
 #endif
 
@@ -0,0 +1,473 @@
+// Copyright (c) 2010-2016 The Regents of the University of Michigan
+// This file is part of the Freud project, released under the BSD 3-Clause License.
+
+#include <tbb/tbb.h>
+#include <memory>
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <stdint.h>
+
+#ifndef _THREAD_LOCAL_HISTOGRAM_H__
+#define _THREAD_LOCAL_HISTOGRAM_H__
+
+/*! \file ThreadLocalHistogram.h
+    \brief Histograms filled by many threads at once, reduced into wide totals
+*/
+
+namespace freud { namespace util {
+
+//! Type of the totals that the thread local bins of type T are flushed into, and how much a single bin can hold
+/*! Floating point bins (weights) are summed into totals of the same type and never need to be flushed before
+    they are read.
+*/
+template<typename T>
+struct BinTraits
+    {
+    typedef T total_type;
+    static uint64_t maxCount()
+        {
+        return UINT64_MAX;
+        }
+    };
+
+//! 32 bit thread local counts are flushed into 64 bit totals before they can overflow
+template<>
+struct BinTraits<uint32_t>
+    {
+    typedef uint64_t total_type;
+    static uint64_t maxCount()
+        {
+        return UINT32_MAX;
+        }
+    };
+
+//! Single precision thread local weights are summed into double precision totals
+template<>
+struct BinTraits<float>
+    {
+    typedef double total_type;
+    static uint64_t maxCount()
+        {
+        return UINT64_MAX;
+        }
+    };
+
+//! \internal
+//! Add value to *target from any thread; floating point types retry a compare and swap
+template<typename T>
+inline void atomicAdd(T *target, T value)
+    {
+    T expected, desired;
+    __atomic_load(target, &expected, __ATOMIC_RELAXED);
+    do
+        {
+        desired = expected + value;
+        } while (!__atomic_compare_exchange(target, &expected, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    }
+
+//! \internal
+//! Integer totals have a single instruction atomic add
+inline void atomicAdd(uint64_t *target, uint64_t value)
+    {
+    __atomic_fetch_add(target, value, __ATOMIC_RELAXED);
+    }
+
+//! \internal
+//! Complex totals are added one part at a time (std::complex is laid out as two values)
+template<typename R>
+inline void atomicAdd(std::complex<R> *target, std::complex<R> value)
+    {
+    R *parts = reinterpret_cast<R *>(target);
+    atomicAdd(parts, value.real());
+    atomicAdd(parts + 1, value.imag());
+    }
+
+//! How the threads of a ThreadLocalHistogram add to it
+/*! - DenseTiles: every thread has a copy of all bins, allocated when the thread first adds to the histogram.
+      Fastest while the copies of all threads fit in memory.
+    - SparseTiles: a thread only allocates the tiles (blocks of bins) it adds to, and the tiles are freed when
+      they are flushed into the totals. For histograms where each thread only fills a part of the bins.
+    - AtomicAdd: all threads add straight to the totals with atomic operations, without any copies. For large
+      histograms, where two threads rarely add to the same bin at the same time.
+*/
+enum HistogramMode {
+    DenseTiles,
+    SparseTiles,
+    AtomicAdd};
+
+//! Histogram filled by many threads at once
+/*! Each thread adds to its own bins of type Local, so that no atomic operations are needed, and the bins of all
+    threads are summed into one array of totals (see BinTraits) by flush(). With Local = uint32_t the thread bins
+    take half the cache of 64 bit counters while the totals cannot overflow: accumulate() methods call
+    beginFrame() with the largest number of counts a single bin can receive in one frame from all threads
+    together, and the thread bins are flushed first whenever that could overflow them. A frame that could
+    overflow them even right after a flush is counted with atomic additions to the totals instead (see
+    beginFrame()). Local = uint64_t never needs flushing, and floating point types sum weights instead of counts.
+
+    The bins of a thread are stored as tiles of TILE_SIZE bins, which are allocated when first added to (see
+    HistogramMode). flush() adds the tiles of the threads together pairwise, in log2(threads) parallel rounds, and
+    then adds the remaining tiles to the totals, so that the work per bin does not grow with the number of
+    threads on the critical path. Tiles that exist in only one of a pair are moved instead of added.
+
+    Threads add through the Accessor returned by local(), which is looked up once per task rather than once per
+    count:
+    \code
+    ThreadLocalHistogram<uint32_t>::Accessor local_bins = m_bin_counter.local();
+    ++local_bins[bin];
+    \endcode
+
+    Only one frame may be counted at a time: beginFrame(), flush(), reset() and setMode() must not be called while
+    threads are adding to the histogram.
+*/
+template<typename Local>
+class ThreadLocalHistogram
+    {
+    public:
+        typedef typename BinTraits<Local>::total_type Total;
+
+        //! log2 of the number of bins in a tile
+        static const unsigned int TILE_SHIFT = 12;
+        //! Number of bins in a tile
+        static const size_t TILE_SIZE = size_t(1) << TILE_SHIFT;
+
+        //! Handle that a thread adds to the histogram through
+        class Accessor
+            {
+            public:
+                //! A single bin, so that ++bins[i] and bins[i] += w read as for a plain array
+                class Bin
+                    {
+                    public:
+                        Bin(const Accessor& accessor, size_t bin)
+                            : m_accessor(accessor), m_bin(bin)
+                            {
+                            }
+
+                        void operator++() const
+                            {
+                            m_accessor.add(m_bin, Local(1));
+                            }
+
+                        void operator+=(const Local& value) const
+                            {
+                            m_accessor.add(m_bin, value);
+                            }
+
+                    private:
+                        const Accessor& m_accessor;
+                        size_t m_bin;
+                    };
+
+                Bin operator[](size_t bin) const
+                    {
+                    return Bin(*this, bin);
+                    }
+
+                //! Add value to a bin
+                void add(size_t bin, const Local& value) const
+                    {
+                    if (m_single_tile != NULL)
+                        {
+                        m_single_tile[bin] += value;
+                        return;
+                        }
+                    if (m_tiles == NULL)
+                        {
+                        atomicAdd(m_totals + bin, Total(value));
+                        return;
+                        }
+                    Local *&tile = m_tiles[bin >> TILE_SHIFT];
+                    if (tile == NULL)
+                        tile = m_histogram->allocateTile(bin >> TILE_SHIFT);
+                    tile[bin & (TILE_SIZE - 1)] += value;
+                    }
+
+            private:
+                friend class ThreadLocalHistogram;
+
+                Accessor(const ThreadLocalHistogram *histogram, Local **tiles, Total *totals)
+                    : m_histogram(histogram), m_tiles(tiles), m_totals(totals), m_single_tile(NULL)
+                    {
+                    // small histograms skip the tile lookup
+                    if (m_tiles != NULL && histogram->m_num_tiles == 1)
+                        {
+                        if (m_tiles[0] == NULL)
+                            m_tiles[0] = histogram->allocateTile(0);
+                        m_single_tile = m_tiles[0];
+                        }
+                    }
+
+                const ThreadLocalHistogram *m_histogram;    //!< Histogram the tiles belong to
+                Local **m_tiles;                            //!< Tiles of the thread, NULL in AtomicAdd mode
+                Total *m_totals;                            //!< Totals, added to in AtomicAdd mode
+                Local *m_single_tile;                       //!< The only tile of the thread, if there is one
+            };
+
+        //! Constructor, choosing the mode from the size of the histogram (see defaultMode())
+        ThreadLocalHistogram(size_t num_bins)
+            : m_num_bins(num_bins), m_num_tiles((num_bins + TILE_SIZE - 1) / TILE_SIZE),
+              m_mode(defaultMode(num_bins)), m_pending(0), m_wide_frame(false), m_frame_mode(m_mode)
+            {
+            m_totals = std::shared_ptr<Total>(new Total[m_num_bins], std::default_delete<Total[]>());
+            std::fill(m_totals.get(), m_totals.get() + m_num_bins, Total());
+            }
+
+        //! Constructor with a given mode
+        ThreadLocalHistogram(size_t num_bins, HistogramMode mode)
+            : m_num_bins(num_bins), m_num_tiles((num_bins + TILE_SIZE - 1) / TILE_SIZE),
+              m_mode(mode), m_pending(0), m_wide_frame(false), m_frame_mode(mode)
+            {
+            m_totals = std::shared_ptr<Total>(new Total[m_num_bins], std::default_delete<Total[]>());
+            std::fill(m_totals.get(), m_totals.get() + m_num_bins, Total());
+            }
+
+        //! Destructor
+        ~ThreadLocalHistogram()
+            {
+            freeTiles();
+            }
+
+        //! Mode used when none is given: thread copies while all of them take at most MAX_COPY_BYTES, atomic
+        //! additions to the totals beyond that
+        static HistogramMode defaultMode(size_t num_bins)
+            {
+            size_t num_copies = size_t(tbb::this_task_arena::max_concurrency());
+            return (num_bins * sizeof(Local) * num_copies <= MAX_COPY_BYTES) ? DenseTiles : AtomicAdd;
+            }
+
+        //! Get the number of bins
+        size_t getNumBins() const
+            {
+            return m_num_bins;
+            }
+
+        //! Get the mode
+        HistogramMode getMode() const
+            {
+            return m_mode;
+            }
+
+        //! Change the mode, keeping the counts so far
+        void setMode(HistogramMode mode)
+            {
+            flush();
+            if (mode != DenseTiles)
+                releaseTiles();
+            m_mode = mode;
+            m_wide_frame = false;
+            }
+
+        //! Change the number of bins, discarding all counts
+        void resize(size_t num_bins)
+            {
+            freeTiles();
+            m_local_tiles.clear();
+            m_num_bins = num_bins;
+            m_num_tiles = (num_bins + TILE_SIZE - 1) / TILE_SIZE;
+            m_pending = 0;
+            m_totals = std::shared_ptr<Total>(new Total[m_num_bins], std::default_delete<Total[]>());
+            std::fill(m_totals.get(), m_totals.get() + m_num_bins, Total());
+            }
+
+        //! Get the handle that the calling thread adds through, allocating its tiles on first use
+        Accessor local()
+            {
+            if (m_mode == AtomicAdd)
+                return Accessor(this, NULL, m_totals.get());
+
+            bool exists;
+            Local **&tiles = m_local_tiles.local(exists);
+            if (! exists)
+                {
+                tiles = new Local*[m_num_tiles];
+                for (size_t t = 0; t < m_num_tiles; t++)
+                    tiles[t] = (m_mode == DenseTiles) ? allocateTile(t) : NULL;
+                }
+            return Accessor(this, tiles, m_totals.get());
+            }
+
+        //! Prepare for a frame that adds at most max_count to any single bin
+        /*! If max_count is more than a thread bin can hold, the frame is counted in AtomicAdd mode, straight into
+            the totals; the mode set before is restored by the next frame that fits.
+        */
+        void beginFrame(uint64_t max_count)
+            {
+            const uint64_t limit = BinTraits<Local>::maxCount();
+            if (max_count > limit)
+                {
+                if (! m_wide_frame)
+                    {
+                    HistogramMode mode = m_mode;
+                    setMode(AtomicAdd);
+                    m_frame_mode = mode;
+                    m_wide_frame = true;
+                    }
+                return;
+                }
+            if (m_wide_frame)
+                setMode(m_frame_mode);
+            if (max_count > limit - m_pending)
+                flush();
+            m_pending += max_count;
+            }
+
+        //! Move the bins of all threads into the totals
+        void flush()
+            {
+            m_pending = 0;
+            std::vector<Local **> copies(m_local_tiles.begin(), m_local_tiles.end());
+            if (copies.empty())
+                return;
+
+            // after the round with a given stride, copy i (a multiple of 2 stride) holds the sum of the copies
+            // i ... i + 2 stride - 1; the sums cannot overflow as beginFrame() bounds the total of all threads
+            Local ***tiles = &copies[0];
+            const size_t num_copies = copies.size();
+            const size_t num_tiles = m_num_tiles;
+            const bool keep = (m_mode == DenseTiles);
+            for (size_t stride = 1; stride < num_copies; stride *= 2)
+                {
+                size_t num_pairs = (num_copies + stride - 1) / (2 * stride);
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, num_pairs * num_tiles),
+                    [=] (const tbb::blocked_range<size_t>& r)
+                    {
+                    for (size_t task = r.begin(); task != r.end(); task++)
+                        {
+                        size_t pair = task / num_tiles;
+                        size_t t = task % num_tiles;
+                        mergeTile(tiles[2 * stride * pair][t], tiles[2 * stride * pair + stride][t], t, keep);
+                        }
+                    });
+                }
+
+            Total *totals = m_totals.get();
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, num_tiles),
+                [=] (const tbb::blocked_range<size_t>& r)
+                {
+                for (size_t t = r.begin(); t != r.end(); t++)
+                    {
+                    Local *&tile = tiles[0][t];
+                    if (tile == NULL)
+                        continue;
+                    size_t size = tileSize(t);
+                    Total *tile_totals = totals + t * TILE_SIZE;
+                    for (size_t i = 0; i < size; i++)
+                        tile_totals[i] += Total(tile[i]);
+                    clearTile(tile, t, keep);
+                    }
+                });
+            }
+
+        //! Zero the bins of all threads and the totals
+        void reset()
+            {
+            for (typename tbb::enumerable_thread_specific<Local **>::iterator i = m_local_tiles.begin();
+                 i != m_local_tiles.end(); ++i)
+                {
+                for (size_t t = 0; t < m_num_tiles; t++)
+                    if ((*i)[t] != NULL)
+                        clearTile((*i)[t], t, m_mode == DenseTiles);
+                }
+            std::fill(m_totals.get(), m_totals.get() + m_num_bins, Total());
+            m_pending = 0;
+            }
+
+        //! Get the totals; counts added since the last flush() are not included
+        std::shared_ptr<Total> getTotals() const
+            {
+            return m_totals;
+            }
+
+    private:
+        //! Largest memory taken by the thread copies of a histogram in DenseTiles mode by default
+        static const size_t MAX_COPY_BYTES = size_t(256) << 20;
+
+        //! Number of bins in tile t; the last tile may be partial
+        size_t tileSize(size_t t) const
+            {
+            return std::min(TILE_SIZE, m_num_bins - t * TILE_SIZE);
+            }
+
+        //! Allocate tile t, zeroed
+        Local *allocateTile(size_t t) const
+            {
+            size_t size = tileSize(t);
+            Local *tile = new Local[size];
+            std::fill(tile, tile + size, Local());
+            return tile;
+            }
+
+        //! Zero tile t, or free it if it is not kept
+        void clearTile(Local *&tile, size_t t, bool keep) const
+            {
+            if (keep)
+                {
+                std::fill(tile, tile + tileSize(t), Local());
+                }
+            else
+                {
+                delete[] tile;
+                tile = NULL;
+                }
+            }
+
+        //! Add tile t of one thread to that of another, leaving the source zeroed (or freed)
+        void mergeTile(Local *&target, Local *&source, size_t t, bool keep) const
+            {
+            if (source == NULL)
+                return;
+            if (target == NULL)
+                {
+                std::swap(target, source);
+                return;
+                }
+            size_t size = tileSize(t);
+            for (size_t i = 0; i < size; i++)
+                target[i] += source[i];
+            clearTile(source, t, keep);
+            }
+
+        //! Free the tiles of all threads, which must have been flushed
+        void releaseTiles()
+            {
+            for (typename tbb::enumerable_thread_specific<Local **>::iterator i = m_local_tiles.begin();
+                 i != m_local_tiles.end(); ++i)
+                {
+                for (size_t t = 0; t < m_num_tiles; t++)
+                    {
+                    delete[] (*i)[t];
+                    (*i)[t] = NULL;
+                    }
+                }
+            }
+
+        //! Free the tiles of all threads and their tile tables
+        void freeTiles()
+            {
+            for (typename tbb::enumerable_thread_specific<Local **>::iterator i = m_local_tiles.begin();
+                 i != m_local_tiles.end(); ++i)
+                {
+                for (size_t t = 0; t < m_num_tiles; t++)
+                    delete[] (*i)[t];
+                delete[] (*i);
+                }
+            }
+
+        size_t m_num_bins;                  //!< Number of bins
+        size_t m_num_tiles;                 //!< Number of tiles the bins of a thread are split into
+        HistogramMode m_mode;               //!< How the threads add to the histogram
+        uint64_t m_pending;                 //!< Largest count a thread bin may hold since the last flush
+        bool m_wide_frame;                  //!< True while counting a frame too large for the thread bins
+        HistogramMode m_frame_mode;         //!< Mode to restore after frames too large for the thread bins
+        std::shared_ptr<Total> m_totals;    //!< Totals of all flushed counts
+        tbb::enumerable_thread_specific<Local **> m_local_tiles;   //!< Tile pointers of each thread
+    };
+
+template<typename Local> const unsigned int ThreadLocalHistogram<Local>::TILE_SHIFT;
+template<typename Local> const size_t ThreadLocalHistogram<Local>::TILE_SIZE;
+template<typename Local> const size_t ThreadLocalHistogram<Local>::MAX_COPY_BYTES;
+
+}; }; // end namespace freud::util
+
+#endif // _THREAD_LOCAL_HISTOGRAM_H__
@@ -5,6 +5,7 @@ from libcpp cimport bool
 from freud.util._VectorMath cimport vec3
 from freud.util._Boost cimport shared_array
 cimport freud._box as box
+cimport freud._locality as locality
 from libcpp.vector cimport vector
 from libc.stdint cimport uint32_t
 
@@ -12,7 +13,7 @@ cdef extern from "Cluster.h" namespace "freud::cluster":
     cdef cppclass Cluster:
         Cluster(const box.Box&, float)
         const box.Box &getBox() const
-        void computeClusters(const vec3[float]*, unsigned int) nogil except +
+        void computeClusters(const vec3[float]*, unsigned int, const locality.NeighborList*) nogil except +
         void computeClusterMembership(const unsigned int*) nogil except +
         unsigned int getNumClusters()
         unsigned int getNumParticles()
@@ -3,7 +3,11 @@
 
 from freud.util._VectorMath cimport vec3
 from freud.util._Boost cimport shared_array
+from libc.stdint cimport uint64_t
+from libcpp.vector cimport vector
 cimport freud._box as box
+cimport freud._locality as locality
+from freud.util._ThreadLocalHistogram cimport HistogramMode
 
 cdef extern from "CorrelationFunction.h" namespace "freud::density":
     cdef cppclass CorrelationFunction[T]:
@@ -11,14 +15,33 @@ cdef extern from "CorrelationFunction.h" namespace "freud::density":
         const box.Box &getBox() const
         void resetCorrelationFunction()
         void accumulate(const box.Box &, const vec3[float]*, const T*,
-            unsigned int, const vec3[float]*, const T*, unsigned int) nogil except +
+            unsigned int, const vec3[float]*, const T*, unsigned int, const locality.NeighborList*) nogil except +
         void reduceCorrelationFunction()
         shared_array[T] getRDF()
-        shared_array[unsigned int] getCounts()
+        shared_array[uint64_t] getCounts()
         shared_array[float] getR()
         unsigned int getNBins() const
 
+cdef extern from "MultiCorrelationFunction.h" namespace "freud::density":
+    cdef cppclass MultiCorrelationFunction[T]:
+        MultiCorrelationFunction(float, float, unsigned int) except +
+        const box.Box &getBox() const
+        void resetCorrelationFunction()
+        void accumulate(const box.Box &, const vec3[float]*, const T*,
+            unsigned int, const vec3[float]*, const T*, unsigned int, const locality.NeighborList*) nogil except +
+        void reduceCorrelationFunction()
+        shared_array[T] getRDF()
+        shared_array[uint64_t] getCounts()
+        shared_array[float] getR()
+        unsigned int getNBins() const
+        unsigned int getNumChannels() const
+
 cdef extern from "GaussianDensity.h" namespace "freud::density":
+    ctypedef enum GaussianDensityMethod:
+        DirectSum
+        Separable
+        FFTConvolution
+
     cdef cppclass GaussianDensity:
         GaussianDensity(unsigned int, float, float)
         GaussianDensity(unsigned int, unsigned int, unsigned int, float, float)
@@ -30,13 +53,23 @@ cdef extern from "GaussianDensity.h" namespace "freud::density":
         unsigned int getWidthX()
         unsigned int getWidthY()
         unsigned int getWidthZ()
+        void setMethod(GaussianDensityMethod)
+        GaussianDensityMethod getMethod() const
 
 cdef extern from "LocalDensity.h" namespace "freud::density":
+    ctypedef enum LocalDensityWeight:
+        LinearWeight
+        CubicSplineWeight
+        GaussianWeight
+
     cdef cppclass LocalDensity:
-        LocalDensity(float, float, float)
+        LocalDensity(float, float, float) except +
+        LocalDensity(const vector[float]&, float, float, LocalDensityWeight) except +
         const box.Box &getBox() const
-        void compute(const box.Box &, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int) nogil except +
+        void compute(const box.Box &, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int,
+                     const locality.NeighborList*) nogil except +
         unsigned int getNRef()
+        unsigned int getNumRCut() const
         shared_array[float] getDensity()
         shared_array[float] getNumNeighbors()
 
@@ -45,13 +78,42 @@ cdef extern from "RDF.h" namespace "freud::density":
         RDF(float, float)
         const box.Box& getBox() const
         void resetRDF()
+        void setNumBlocks(unsigned int) except +
+        unsigned int getNumBlocks() const
+        void setHistogramMode(HistogramMode)
+        HistogramMode getHistogramMode() const
         void accumulate(box.Box&,
                         const vec3[float]*,
                         unsigned int,
                         const vec3[float]*,
-                        unsigned int) nogil except +
+                        unsigned int,
+                        const locality.NeighborList*) nogil except +
+        void accumulateTrajectory(box.Box*,
+                                  const vec3[float]*,
+                                  unsigned int,
+                                  const vec3[float]*,
+                                  unsigned int,
+                                  unsigned int) nogil except +
+        void reduceRDF()
+        shared_array[float] getRDF()
+        shared_array[float] getR()
+        shared_array[float] getRDFStandardError() except +
+        shared_array[float] getNr()
+        unsigned int getNBins()
+
+cdef extern from "PartialRDF.h" namespace "freud::density":
+    cdef cppclass PartialRDF:
+        PartialRDF(float, float, unsigned int) except +
+        const box.Box& getBox() const
+        void resetRDF()
+        void accumulate(box.Box&,
+                        const vec3[float]*,
+                        const unsigned int*,
+                        unsigned int,
+                        const locality.NeighborList*) nogil except +
         void reduceRDF()
         shared_array[float] getRDF()
         shared_array[float] getR()
         shared_array[float] getNr()
         unsigned int getNBins()
+        unsigned int getNumTypes()
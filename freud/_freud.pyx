@@ -5,9 +5,9 @@
 # cython: embedsignature=True
 
 include "box.pxi"
+include "locality.pxi"
 include "bond.pxi"
 include "interface.pxi"
-include "locality.pxi"
 include "density.pxi"
 include "pmft.pxi"
 include "order.pxi"
@@ -5,8 +5,10 @@ from libcpp cimport bool
 from freud.util._VectorMath cimport vec3
 from freud.util._Boost cimport shared_array
 cimport freud._box as box
+cimport freud._locality as locality
 
 cdef extern from "InterfaceMeasure.h" namespace "freud::interface":
     cdef cppclass InterfaceMeasure:
         InterfaceMeasure(const box.Box&, float)
-        unsigned int compute(const vec3[float]*, unsigned int, const vec3[float]*, unsigned int)
+        unsigned int compute(const vec3[float]*, unsigned int, const vec3[float]*, unsigned int,
+                             const locality.NeighborList*) except +
@@ -4,6 +4,8 @@
 from freud.util._Boost cimport shared_array
 from freud.util._VectorMath cimport vec3, quat
 from libcpp.complex cimport complex
+from libc.stdint cimport uint64_t
+cimport freud._box as box
 
 cdef extern from "kspace.h" namespace "freud::kspace":
     cdef cppclass FTdelta:
@@ -12,23 +14,28 @@ cdef extern from "kspace.h" namespace "freud::kspace":
         void set_rq(unsigned int, vec3[float]*, quat[float]*)
         void set_density(float complex)
         void compute() nogil except +
+        void computeView(const vec3[float]*, unsigned int, const vec3[float]*, const quat[float]*, unsigned int,
+            float complex*) nogil except +
         shared_array[float complex] getFT()
 
-    cdef cppclass FTsphere:
+    cdef cppclass FTsphere(FTdelta):
         FTsphere()
-        void set_K(vec3[float]*, unsigned int)
-        void set_rq(unsigned int, vec3[float]*, quat[float]*)
-        void set_density(float complex)
-        void compute() nogil except +
-        shared_array[float complex] getFT()
         void set_radius(const float)
 
-    cdef cppclass FTpolyhedron:
+    cdef cppclass FTpolyhedron(FTdelta):
         FTpolyhedron()
-        void set_K(vec3[float]*, unsigned int)
-        void set_rq(unsigned int, vec3[float]*, quat[float]*)
-        void set_density(float complex)
         void set_params(unsigned int, vec3[float]*, unsigned int, unsigned int *, unsigned int *, \
             vec3[float]* norm, float *d, float *area, float volume)
-        void compute() nogil except +
-        shared_array[float complex] getFT()
+
+cdef extern from "StructureFactorGrid.h" namespace "freud::kspace":
+    cdef cppclass StructureFactorGrid:
+        StructureFactorGrid(unsigned int, float, float, unsigned int) except +
+        StructureFactorGrid(unsigned int, unsigned int, unsigned int, float, float, unsigned int) except +
+        const box.Box &getBox() const
+        void resetStructureFactor()
+        void accumulate(const box.Box &, const vec3[float]*, unsigned int) nogil except +
+        void reduceStructureFactor()
+        shared_array[float] getStructureFactor()
+        shared_array[uint64_t] getCounts()
+        shared_array[float] getK()
+        unsigned int getNBins() const
@@ -8,15 +8,51 @@ from freud.util._Boost cimport shared_array
 cimport freud._box as box
 from libcpp.vector cimport vector
 
+cdef extern from "NeighborList.h" namespace "freud::locality":
+    cdef cppclass NeighborList:
+        NeighborList()
+        NeighborList(size_t)
+
+        size_t getNumBonds() const
+        size_t getNumI() const
+        size_t getNumJ() const
+        size_t getCapacity() const
+        size_t *getIndexI()
+        size_t *getIndexJ()
+        float *getDistances()
+        float *getWeights()
+        const size_t *getSegments() const
+        const unsigned int *getCounts() const
+        void resize(size_t, size_t, size_t) except +
+        void updateSegments() except +
+        void validate(size_t, size_t) except +
+        void filterR(float, float) except +
+
+cdef extern from "DistanceKernel.h" namespace "freud::locality":
+    cdef cppclass DistanceKernel:
+        DistanceKernel(const box.Box&, float, float) except +
+        float getRMax() const
+        @staticmethod
+        unsigned int getVectorWidth()
+        unsigned int compute(const vec3[float]&, const float*, const float*, const float*, unsigned int,
+            unsigned int, unsigned int*, float*, unsigned int*, vec3[float]*) nogil
+        unsigned int computeImage(const vec3[float]&, const float*, const float*, const float*, unsigned int,
+            unsigned int, unsigned int*, float*, unsigned int*, vec3[float]*) nogil
+
 cdef extern from "LinkCell.h" namespace "freud::locality":
     cdef cppclass IteratorLinkCell:
         IteratorLinkCell()
-        IteratorLinkCell(const shared_array[unsigned int] &, unsigned int, unsigned int, unsigned int)
+        IteratorLinkCell(const shared_array[unsigned int] &, unsigned int, unsigned int)
         void copy(const IteratorLinkCell&);
         bool atEnd()
         unsigned int next()
         unsigned int begin()
 
+    cdef cppclass CellNeighbors:
+        CellNeighbors()
+        unsigned int size() const
+        unsigned int operator[](unsigned int) const
+
     cdef cppclass LinkCell:
         LinkCell(const box.Box&, float)
         LinkCell()
@@ -30,17 +66,44 @@ cdef extern from "LinkCell.h" namespace "freud::locality":
         float getCellWidth() const
         unsigned int getCell(const vec3[float]&) const
         IteratorLinkCell itercell(unsigned int) const
-        vector[unsigned int] getCellNeighbors(unsigned int) const
+        CellNeighbors getCellNeighbors(unsigned int) const
+        unsigned int getNumCellNeighbors() const
         void computeCellList(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        void compute(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int, bool) nogil except +
+        NeighborList *getNList()
+
+cdef extern from "GhostCellList.h" namespace "freud::locality":
+    cdef cppclass GhostCellList:
+        GhostCellList(const box.Box&, float) except +
+        const box.Box &getBox() const
+        float getRMax() const
+        unsigned int getNumCells() const
+        unsigned int getNumGhosts() const
+        void computeCellList(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        void compute(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int, bool) nogil except +
+        NeighborList *getNList()
+
+cdef extern from "KdTree.h" namespace "freud::locality":
+    cdef cppclass KdTree:
+        KdTree(const box.Box&, float) except +
+        const box.Box &getBox() const
+        float getRMax() const
+        unsigned int getNumPoints() const
+        unsigned int getNumNodes() const
+        void computeTree(const box.Box&, const vec3[float]*, unsigned int) nogil except +
+        void compute(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int, bool) nogil except +
+        void computeNearest(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int, unsigned int, bool) nogil except +
+        NeighborList *getNList()
 
 cdef extern from "NearestNeighbors.h" namespace "freud::locality":
     cdef cppclass NearestNeighbors:
         NearestNeighbors()
-        NearestNeighbors(float, unsigned int, float, bool)
+        NearestNeighbors(float, unsigned int, bool)
 
         void setRMax(float)
         const box.Box &getBox() const
         unsigned int getNumNeighbors() const
+        unsigned int getNumDeficient() const
         float getRMax() const
         unsigned int getUINTMAX() const
         unsigned int getNref() const
@@ -51,3 +114,4 @@ cdef extern from "NearestNeighbors.h" namespace "freud::locality":
         shared_array[vec3[float]] getWrappedVectors() const
         void setCutMode(const bool)
         void compute(const box.Box&, const vec3[float]*, unsigned int, const vec3[float]*, unsigned int) nogil except +
+        NeighborList *getNList()
@@ -10,6 +10,7 @@ from libcpp.complex cimport complex
 from libcpp.vector cimport vector
 from libcpp.map cimport map
 cimport freud._box as box
+cimport freud._locality as locality
 
 cdef extern from "BondOrder.h" namespace "freud::order":
     cdef cppclass BondOrder:
@@ -102,9 +103,11 @@ cdef extern from "LocalQl.h" namespace "freud::order":
         const box.Box& getBox() const
         void setBox(const box.Box)
         void compute(const vec3[float]*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*) nogil except +
         void computeAve(const vec3[float]*,
-                        unsigned int) nogil except +
+                        unsigned int,
+                        const locality.NeighborList*) nogil except +
         void computeNorm(const vec3[float]*,
                          unsigned int) nogil except +
         void computeAveNorm(const vec3[float]*,
@@ -186,11 +189,14 @@ cdef extern from "SolLiq.h" namespace "freud::order":
         void setBox(const box.Box)
         void setClusteringRadius(float)
         void compute(const vec3[float]*,
-                     unsigned int) nogil except +
+                     unsigned int,
+                     const locality.NeighborList*) nogil except +
         void computeSolLiqVariant(const vec3[float]*,
-                                  unsigned int) nogil except +
+                                  unsigned int,
+                                  const locality.NeighborList*) nogil except +
         void computeSolLiqNoNorm(const vec3[float]*,
-                                 unsigned int) nogil except +
+                                 unsigned int,
+                                 const locality.NeighborList*) nogil except +
         unsigned int getLargestClusterSize()
         vector[unsigned int] getClusterSizes()
         shared_array[float complex] getQlmi()
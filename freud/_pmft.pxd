@@ -4,7 +4,10 @@
 from freud.util._VectorMath cimport vec3
 from freud.util._VectorMath cimport quat
 from libcpp.memory cimport shared_ptr
+from libc.stdint cimport uint64_t
 cimport freud._box as box
+cimport freud._locality as locality
+from freud.util._ThreadLocalHistogram cimport HistogramMode
 
 cdef extern from "PMFTR12.h" namespace "freud::pmft":
     cdef cppclass PMFTR12:
@@ -12,15 +15,38 @@ cdef extern from "PMFTR12.h" namespace "freud::pmft":
 
         const box.Box& getBox() const
         void resetPCF()
+        void setSparse(bint)
+        bint getSparse() const
         void accumulate(box.Box&,
                         vec3[float]*,
                         float*,
                         unsigned int,
                         vec3[float]*,
                         float*,
-                        unsigned int) nogil
+                        unsigned int,
+                        const locality.NeighborList*) nogil except +
+        void accumulateWeighted(box.Box&,
+                                vec3[float]*,
+                                float*,
+                                unsigned int,
+                                vec3[float]*,
+                                float*,
+                                unsigned int,
+                                const float*,
+                                const locality.NeighborList*) nogil except +
+        void accumulateTrajectory(box.Box*,
+                                  vec3[float]*,
+                                  float*,
+                                  unsigned int,
+                                  vec3[float]*,
+                                  float*,
+                                  unsigned int,
+                                  unsigned int) nogil except +
         void reducePCF()
-        shared_ptr[unsigned int] getBinCounts()
+        shared_ptr[uint64_t] getBinCounts()
+        shared_ptr[double] getValueSums() except +
+        shared_ptr[double] getValueSquareSums() except +
+        shared_ptr[float] getValueMean() except +
         shared_ptr[float] getPCF()
         shared_ptr[float] getR()
         shared_ptr[float] getT1()
@@ -37,15 +63,38 @@ cdef extern from "PMFTXYT.h" namespace "freud::pmft":
 
         const box.Box& getBox() const
         void resetPCF()
+        void setSparse(bint)
+        bint getSparse() const
         void accumulate(box.Box&,
                         vec3[float]*,
                         float*,
                         unsigned int,
                         vec3[float]*,
                         float*,
-                        unsigned int) nogil
+                        unsigned int,
+                        const locality.NeighborList*) nogil except +
+        void accumulateWeighted(box.Box&,
+                                vec3[float]*,
+                                float*,
+                                unsigned int,
+                                vec3[float]*,
+                                float*,
+                                unsigned int,
+                                const float*,
+                                const locality.NeighborList*) nogil except +
+        void accumulateTrajectory(box.Box*,
+                                  vec3[float]*,
+                                  float*,
+                                  unsigned int,
+                                  vec3[float]*,
+                                  float*,
+                                  unsigned int,
+                                  unsigned int) nogil except +
         void reducePCF()
-        shared_ptr[unsigned int] getBinCounts()
+        shared_ptr[uint64_t] getBinCounts()
+        shared_ptr[double] getValueSums() except +
+        shared_ptr[double] getValueSquareSums() except +
+        shared_ptr[float] getValueMean() except +
         shared_ptr[float] getPCF()
         shared_ptr[float] getX()
         shared_ptr[float] getY()
@@ -62,15 +111,38 @@ cdef extern from "PMFTXY2D.h" namespace "freud::pmft":
 
         const box.Box& getBox() const
         void resetPCF()
+        void setHistogramMode(HistogramMode)
+        HistogramMode getHistogramMode() const
         void accumulate(box.Box&,
                         vec3[float]*,
                         float*,
                         unsigned int,
                         vec3[float]*,
                         float*,
-                        unsigned int) nogil
+                        unsigned int,
+                        const locality.NeighborList*) nogil except +
+        void accumulateWeighted(box.Box&,
+                                vec3[float]*,
+                                float*,
+                                unsigned int,
+                                vec3[float]*,
+                                float*,
+                                unsigned int,
+                                const float*,
+                                const locality.NeighborList*) nogil except +
+        void accumulateTrajectory(box.Box*,
+                                  vec3[float]*,
+                                  float*,
+                                  unsigned int,
+                                  vec3[float]*,
+                                  float*,
+                                  unsigned int,
+                                  unsigned int) nogil except +
         void reducePCF()
-        shared_ptr[unsigned int] getBinCounts()
+        shared_ptr[uint64_t] getBinCounts()
+        shared_ptr[double] getValueSums() except +
+        shared_ptr[double] getValueSquareSums() except +
+        shared_ptr[float] getValueMean() except +
         shared_ptr[float] getPCF()
         shared_ptr[float] getX()
         shared_ptr[float] getY()
@@ -85,6 +157,10 @@ cdef extern from "PMFTXYZ.h" namespace "freud::pmft":
 
         const box.Box& getBox() const
         void resetPCF()
+        void setSparse(bint)
+        bint getSparse() const
+        void setNumBlocks(unsigned int) except +
+        unsigned int getNumBlocks() const
         void accumulate(box.Box&,
                         vec3[float]*,
                         quat[float]*,
@@ -93,10 +169,48 @@ cdef extern from "PMFTXYZ.h" namespace "freud::pmft":
                         quat[float]*,
                         unsigned int,
                         quat[float]*,
-                        unsigned int) nogil
+                        unsigned int,
+                        const locality.NeighborList*) nogil except +
+        void accumulateSymmetric(box.Box&,
+                                 vec3[float]*,
+                                 quat[float]*,
+                                 unsigned int,
+                                 vec3[float]*,
+                                 quat[float]*,
+                                 unsigned int,
+                                 quat[float]*,
+                                 unsigned int,
+                                 const locality.NeighborList*) nogil except +
+        void accumulateWeighted(box.Box&,
+                                vec3[float]*,
+                                quat[float]*,
+                                unsigned int,
+                                vec3[float]*,
+                                quat[float]*,
+                                unsigned int,
+                                quat[float]*,
+                                unsigned int,
+                                bint,
+                                const float*,
+                                const locality.NeighborList*) nogil except +
+        void accumulateTrajectory(box.Box*,
+                                  vec3[float]*,
+                                  quat[float]*,
+                                  unsigned int,
+                                  vec3[float]*,
+                                  quat[float]*,
+                                  unsigned int,
+                                  unsigned int,
+                                  quat[float]*,
+                                  unsigned int,
+                                  bint) nogil except +
         void reducePCF()
         shared_ptr[float] getPCF()
-        shared_ptr[unsigned int] getBinCounts()
+        shared_ptr[uint64_t] getBinCounts()
+        shared_ptr[double] getValueSums() except +
+        shared_ptr[double] getValueSquareSums() except +
+        shared_ptr[float] getValueMean() except +
+        shared_ptr[float] getPCFStandardError() except +
         shared_ptr[float] getX()
         shared_ptr[float] getY()
         shared_ptr[float] getZ()
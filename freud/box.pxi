@@ -7,6 +7,7 @@ cimport freud._box as box
 import numpy as np
 cimport numpy as np
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 from libc.string cimport memcpy
 # Numpy must be initialized. When using numpy from C or Cython you must
 # _always_ do that, or you will have segfaults
@@ -343,3 +344,17 @@ cdef BoxFromCPP(const box.Box& cppbox):
     """
     """
     return Box(cppbox.getLx(), cppbox.getLy(), cppbox.getLz(), cppbox.getTiltFactorXY(), cppbox.getTiltFactorXZ(), cppbox.getTiltFactorYZ(), cppbox.is2D())
+
+cdef vector[box.Box] _box_vector(boxes, unsigned int n_frames) except *:
+    """
+    Convert a single :py:class:`freud.box.Box`, used for every frame, or a sequence of one box per frame
+    """
+    cdef vector[box.Box] result
+    if isinstance(boxes, Box):
+        boxes = [boxes]*n_frames
+    if len(boxes) != n_frames:
+        raise ValueError("boxes must be a single box or one box per frame")
+    for b in boxes:
+        result.push_back(box.Box(b.getLx(), b.getLy(), b.getLz(), b.getTiltFactorXY(), b.getTiltFactorXZ(),
+            b.getTiltFactorYZ(), b.is2D()))
+    return result
@@ -3,6 +3,7 @@
 
 from freud.util._VectorMath cimport vec3
 cimport freud._cluster as cluster
+cimport freud._locality as locality
 cimport freud._box as _box
 import numpy as np
 cimport numpy as np
@@ -59,19 +60,22 @@ cdef class Cluster:
         """
         return BoxFromCPP(self.thisptr.getBox())
 
-    def computeClusters(self, points):
+    def computeClusters(self, points, nlist=None):
         """Compute the clusters for the given set of points
 
         :param points: particle coordinates
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True)
         if points.shape[1] != 3:
             raise RuntimeError('Need a list of 3D points for computeClusters()')
         cdef np.ndarray cPoints = points
         cdef unsigned int Np = points.shape[0]
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
         with nogil:
-            self.thisptr.computeClusters(<vec3[float]*> cPoints.data, Np)
+            self.thisptr.computeClusters(<vec3[float]*> cPoints.data, Np, nlist_ptr)
 
     def computeClusterMembership(self, keys):
         """Compute the clusters with key membership
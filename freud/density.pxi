@@ -5,7 +5,11 @@ from freud.util._VectorMath cimport vec3
 from freud.util._Boost cimport shared_array
 cimport freud._box as _box
 cimport freud._density as density
+cimport freud._locality as locality
+cimport freud.util._ThreadLocalHistogram as histogram
 from libc.string cimport memcpy
+from libc.stdint cimport uint64_t
+from libcpp.vector cimport vector
 import numpy as np
 cimport numpy as np
 
@@ -54,7 +58,7 @@ cdef class FloatCF:
     def __dealloc__(self):
         del self.thisptr
 
-    def accumulate(self, box, ref_points, refValues, points, values):
+    def accumulate(self, box, ref_points, refValues, points, values, nlist=None):
         """
         Calculates the correlation function and adds to the current histogram.
 
@@ -63,11 +67,13 @@ cdef class FloatCF:
         :param refValues: values to use in computation
         :param points: points to calculate the local density
         :param values: values to use in computation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float64`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float64`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -93,9 +99,10 @@ cdef class FloatCF:
         cdef unsigned int n_p = <unsigned int> points.shape[0]
         cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
             box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
         with nogil:
             self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, <double*>l_refValues.data, n_ref,
-                <vec3[float]*>l_points.data, <double*>l_values.data, n_p)
+                <vec3[float]*>l_points.data, <double*>l_values.data, n_p, nlist_ptr)
 
     def getRDF(self):
         """
@@ -123,7 +130,7 @@ cdef class FloatCF:
         """
         self.thisptr.resetCorrelationFunction()
 
-    def compute(self, box, ref_points, refValues, points, values):
+    def compute(self, box, ref_points, refValues, points, values, nlist=None):
         """
         Calculates the correlation function for the given points. Will overwrite the current histogram.
 
@@ -132,14 +139,16 @@ cdef class FloatCF:
         :param refValues: values to use in computation
         :param points: points to calculate the local density
         :param values: values to use in computation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float64`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float64`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         self.thisptr.resetCorrelationFunction()
-        self.accumulate(box, ref_points, refValues, points, values)
+        self.accumulate(box, ref_points, refValues, points, values, nlist=nlist)
 
     def reduceCorrelationFunction(self):
         """
@@ -151,12 +160,12 @@ cdef class FloatCF:
     def getCounts(self):
         """
         :return: counts of each histogram bin
-        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.int32`
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.uint64`
         """
-        cdef unsigned int *counts = self.thisptr.getCounts().get()
+        cdef uint64_t *counts = self.thisptr.getCounts().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>counts)
+        cdef np.ndarray[np.uint64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT64, <void*>counts)
         return result
 
     def getR(self):
@@ -211,7 +220,7 @@ cdef class ComplexCF:
     def __dealloc__(self):
         del self.thisptr
 
-    def accumulate(self, box, ref_points, refValues, points, values):
+    def accumulate(self, box, ref_points, refValues, points, values, nlist=None):
         """
         Calculates the correlation function and adds to the current histogram.
 
@@ -220,11 +229,13 @@ cdef class ComplexCF:
         :param refValues: values to use in computation
         :param points: points to calculate the local density
         :param values: values to use in computation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.complex128`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.complex128`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -250,9 +261,10 @@ cdef class ComplexCF:
         cdef unsigned int n_p = <unsigned int> points.shape[0]
         cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
             box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
         with nogil:
             self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, <np.complex128_t*>l_refValues.data, n_ref,
-                <vec3[float]*>l_points.data, <np.complex128_t*>l_values.data, n_p)
+                <vec3[float]*>l_points.data, <np.complex128_t*>l_values.data, n_p, nlist_ptr)
 
     def getRDF(self):
         """
@@ -278,7 +290,7 @@ cdef class ComplexCF:
         """
         self.thisptr.resetCorrelationFunction()
 
-    def compute(self, box, ref_points, refValues, points, values):
+    def compute(self, box, ref_points, refValues, points, values, nlist=None):
         """
         Calculates the correlation function for the given points. Will overwrite the current histogram.
 
@@ -287,14 +299,16 @@ cdef class ComplexCF:
         :param refValues: values to use in computation
         :param points: points to calculate the local density
         :param values: values to use in computation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.complex128`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.complex128`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         self.thisptr.resetCorrelationFunction()
-        self.accumulate(box, ref_points, refValues, points, values)
+        self.accumulate(box, ref_points, refValues, points, values, nlist=nlist)
 
     def reduceCorrelationFunction(self):
         """
@@ -306,12 +320,332 @@ cdef class ComplexCF:
     def getCounts(self):
         """
         :return: counts of each histogram bin
-        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.int32`
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.uint64`
         """
-        cdef unsigned int *counts = self.thisptr.getCounts().get()
+        cdef uint64_t *counts = self.thisptr.getCounts().get()
         cdef np.npy_intp nbins[1]
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
-        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>counts)
+        cdef np.ndarray[np.uint64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT64, <void*>counts)
+        return result
+
+    def getR(self):
+        """
+        :return: values of bin centers
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *r = self.thisptr.getR().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>r)
+        return result
+
+cdef class FloatMultiCF:
+    """Computes several pairwise correlation functions :math:`\\left< p_c*q_c \\right> \\left( r \\right)` \
+    between two sets of points with real values :math:`p_c` and :math:`q_c` in :math:`N_{channels}` channels.
+
+    Like :py:class:`freud.density.FloatCF`, but each point carries one value per channel, and the correlation \
+    functions of all channels are accumulated in a single pass over the pairs of points. This is much faster \
+    than computing the correlation function of each channel separately, since the pair search dominates the cost.
+
+    2D: MultiCorrelationFunction properly handles 2D boxes. As with everything
+    else in freud, 2D points must be passed in as 3 component vectors
+    x,y,0. Failing to set 0 in the third component will lead to
+    undefined behavior.
+
+    Self-correlation: If given the same arrays for both points and ref_points, we omit accumulating the
+    self-correlation value in the first bin.
+
+    :param r_max: distance over which to calculate
+    :param dr: bin size
+    :param num_channels: number of values per point
+    :type r_max: float
+    :type dr: float
+    :type num_channels: unsigned int
+    """
+    cdef density.MultiCorrelationFunction[double] *thisptr
+
+    def __cinit__(self, float rmax, float dr, unsigned int num_channels):
+        if dr <= 0.0:
+            raise ValueError("dr must be > 0")
+        self.thisptr = new density.MultiCorrelationFunction[double](rmax, dr, num_channels)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def accumulate(self, box, ref_points, refValues, points, values, nlist=None):
+        """
+        Calculates the correlation functions and adds to the current histograms.
+
+        :param box: simulation box
+        :param ref_points: reference points to calculate the correlation functions
+        :param refValues: values of the reference points, one column per channel
+        :param points: points to calculate the correlation functions
+        :param values: values of the points, one column per channel
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{channels}`), dtype= :class:`numpy.float64`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{channels}`), dtype= :class:`numpy.float64`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        refValues = freud.common.convert_array(refValues, 2, dtype=np.float64, contiguous=True,
+            dim_message="refValues must be a 2 dimensional array")
+        values = freud.common.convert_array(values, 2, dtype=np.float64, contiguous=True,
+            dim_message="values must be a 2 dimensional array")
+        if ref_points.shape[1] != 3 or points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        if refValues.shape != (ref_points.shape[0], self.thisptr.getNumChannels()) or \
+                values.shape != (points.shape[0], self.thisptr.getNumChannels()):
+            raise ValueError("values must have one row per point and one column per channel")
+        cdef np.ndarray[float, ndim=2] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=2] l_points;
+        if ref_points is points:
+            l_points = l_ref_points;
+        else:
+            l_points = points
+        cdef np.ndarray[np.float64_t, ndim=2] l_refValues = refValues
+        cdef np.ndarray[np.float64_t, ndim=2] l_values
+        if values is refValues:
+            l_values = l_refValues
+        else:
+            l_values = values
+        cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
+            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, <double*>l_refValues.data, n_ref,
+                <vec3[float]*>l_points.data, <double*>l_values.data, n_p, nlist_ptr)
+
+    def getRDF(self):
+        """
+        :return: expected (average) product of the values of each channel at a given radial distance
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`, :math:`N_{channels}`), dtype= :class:`numpy.float64`
+        """
+        cdef double *rdf = self.thisptr.getRDF().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumChannels()
+        cdef np.ndarray[np.float64_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT64, <void*>rdf)
+        return result
+
+    def getBox(self):
+        """
+        Get the box used in the calculation
+
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(<box.Box> self.thisptr.getBox())
+
+    def resetCorrelationFunction(self):
+        """
+        resets the values of the correlation function histograms in memory
+        """
+        self.thisptr.resetCorrelationFunction()
+
+    def compute(self, box, ref_points, refValues, points, values, nlist=None):
+        """
+        Calculates the correlation functions for the given points. Will overwrite the current histograms.
+
+        :param box: simulation box
+        :param ref_points: reference points to calculate the correlation functions
+        :param refValues: values of the reference points, one column per channel
+        :param points: points to calculate the correlation functions
+        :param values: values of the points, one column per channel
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{channels}`), dtype= :class:`numpy.float64`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{channels}`), dtype= :class:`numpy.float64`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        self.thisptr.resetCorrelationFunction()
+        self.accumulate(box, ref_points, refValues, points, values, nlist=nlist)
+
+    def reduceCorrelationFunction(self):
+        """
+        Reduces the histograms over N processors to single histograms. This is called automatically by
+        :py:meth:`freud.density.FloatMultiCF.getRDF()`.
+        """
+        self.thisptr.reduceCorrelationFunction()
+
+    def getCounts(self):
+        """
+        :return: counts of each histogram bin
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.uint64`
+        """
+        cdef uint64_t *counts = self.thisptr.getCounts().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.uint64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT64, <void*>counts)
+        return result
+
+    def getR(self):
+        """
+        :return: values of bin centers
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *r = self.thisptr.getR().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>r)
+        return result
+
+cdef class ComplexMultiCF:
+    """Computes several pairwise correlation functions :math:`\\left< p_c*q_c \\right> \\left( r \\right)` \
+    between two sets of points with complex values :math:`p_c` and :math:`q_c` in :math:`N_{channels}` channels.
+
+    Like :py:class:`freud.density.ComplexCF`, but each point carries one value per channel, and the correlation \
+    functions of all channels are accumulated in a single pass over the pairs of points. This is much faster \
+    than computing the correlation function of each channel separately, since the pair search dominates the cost.
+
+    2D: MultiCorrelationFunction properly handles 2D boxes. As with everything
+    else in freud, 2D points must be passed in as 3 component vectors
+    x,y,0. Failing to set 0 in the third component will lead to
+    undefined behavior.
+
+    Self-correlation: If given the same arrays for both points and ref_points, we omit accumulating the
+    self-correlation value in the first bin.
+
+    :param r_max: distance over which to calculate
+    :param dr: bin size
+    :param num_channels: number of values per point
+    :type r_max: float
+    :type dr: float
+    :type num_channels: unsigned int
+    """
+    cdef density.MultiCorrelationFunction[np.complex128_t] *thisptr
+
+    def __cinit__(self, float rmax, float dr, unsigned int num_channels):
+        if dr <= 0.0:
+            raise ValueError("dr must be > 0")
+        self.thisptr = new density.MultiCorrelationFunction[np.complex128_t](rmax, dr, num_channels)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def accumulate(self, box, ref_points, refValues, points, values, nlist=None):
+        """
+        Calculates the correlation functions and adds to the current histograms.
+
+        :param box: simulation box
+        :param ref_points: reference points to calculate the correlation functions
+        :param refValues: values of the reference points, one column per channel
+        :param points: points to calculate the correlation functions
+        :param values: values of the points, one column per channel
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{channels}`), dtype= :class:`numpy.complex128`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{channels}`), dtype= :class:`numpy.complex128`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        refValues = freud.common.convert_array(refValues, 2, dtype=np.complex128, contiguous=True,
+            dim_message="refValues must be a 2 dimensional array")
+        values = freud.common.convert_array(values, 2, dtype=np.complex128, contiguous=True,
+            dim_message="values must be a 2 dimensional array")
+        if ref_points.shape[1] != 3 or points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        if refValues.shape != (ref_points.shape[0], self.thisptr.getNumChannels()) or \
+                values.shape != (points.shape[0], self.thisptr.getNumChannels()):
+            raise ValueError("values must have one row per point and one column per channel")
+        cdef np.ndarray[float, ndim=2] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=2] l_points;
+        if ref_points is points:
+            l_points = l_ref_points;
+        else:
+            l_points = points
+        cdef np.ndarray[np.complex128_t, ndim=2] l_refValues = refValues
+        cdef np.ndarray[np.complex128_t, ndim=2] l_values
+        if values is refValues:
+            l_values = l_refValues
+        else:
+            l_values = values
+        cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
+            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, <np.complex128_t*>l_refValues.data, n_ref,
+                <vec3[float]*>l_points.data, <np.complex128_t*>l_values.data, n_p, nlist_ptr)
+
+    def getRDF(self):
+        """
+        :return: expected (average) product of the values of each channel at a given radial distance
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`, :math:`N_{channels}`), dtype= :class:`numpy.complex128`
+        """
+        cdef np.complex128_t *rdf = self.thisptr.getRDF().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumChannels()
+        cdef np.ndarray[np.complex128_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_COMPLEX128, <void*>rdf)
+        return result
+
+    def getBox(self):
+        """
+        Get the box used in the calculation
+
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(<box.Box> self.thisptr.getBox())
+
+    def resetCorrelationFunction(self):
+        """
+        resets the values of the correlation function histograms in memory
+        """
+        self.thisptr.resetCorrelationFunction()
+
+    def compute(self, box, ref_points, refValues, points, values, nlist=None):
+        """
+        Calculates the correlation functions for the given points. Will overwrite the current histograms.
+
+        :param box: simulation box
+        :param ref_points: reference points to calculate the correlation functions
+        :param refValues: values of the reference points, one column per channel
+        :param points: points to calculate the correlation functions
+        :param values: values of the points, one column per channel
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type refValues: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{channels}`), dtype= :class:`numpy.complex128`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type values: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, :math:`N_{channels}`), dtype= :class:`numpy.complex128`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        self.thisptr.resetCorrelationFunction()
+        self.accumulate(box, ref_points, refValues, points, values, nlist=nlist)
+
+    def reduceCorrelationFunction(self):
+        """
+        Reduces the histograms over N processors to single histograms. This is called automatically by
+        :py:meth:`freud.density.ComplexMultiCF.getRDF()`.
+        """
+        self.thisptr.reduceCorrelationFunction()
+
+    def getCounts(self):
+        """
+        :return: counts of each histogram bin
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.uint64`
+        """
+        cdef uint64_t *counts = self.thisptr.getCounts().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.uint64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT64, <void*>counts)
         return result
 
     def getR(self):
@@ -332,6 +666,17 @@ cdef class GaussianDensity:
     distance of the grid cell from the center of the Gaussian. The dimensions of the image (grid) are set in the
     constructor.
 
+    The method sets how the Gaussians are added up:
+
+    - 'direct' evaluates the Gaussian of every particle at every grid point within r_cut
+    - 'separable' gives the same density, evaluating the Gaussian as a product of one factor per direction; it is
+      faster and needs no image per thread
+    - 'fft' assigns the particles to the grid and convolves them with the Gaussian by fast Fourier transforms, at a
+      cost independent of sigma and r_cut. The assignment smooths the density by about a pixel, so use it for
+      Gaussians several pixels wide
+
+    'separable' and 'fft' wrap along each box axis separately, so compute() raises a ValueError for a tilted box.
+
     .. moduleauthor:: Joshua Anderson <joaander@umich.edu>
 
     :param width: number of pixels to make the image
@@ -346,6 +691,8 @@ cdef class GaussianDensity:
     :type width_z: unsigned int
     :type r_cut: float
     :type sigma: float
+    :param method: 'direct', 'separable' or 'fft'
+    :type method: str
 
     - Constructor Calls:
 
@@ -359,7 +706,13 @@ cdef class GaussianDensity:
     """
     cdef density.GaussianDensity *thisptr
 
-    def __cinit__(self, *args):
+    known_methods = {'direct': density.DirectSum,
+                     'separable': density.Separable,
+                     'fft': density.FFTConvolution}
+
+    def __cinit__(self, *args, method='direct'):
+        if method not in self.known_methods:
+            raise ValueError('Unknown GaussianDensity method: {}'.format(method))
         if len(args) == 3:
             self.thisptr = new density.GaussianDensity(args[0], args[1], args[2])
         elif len(args) == 5:
@@ -367,6 +720,7 @@ cdef class GaussianDensity:
                                                        args[3], args[4])
         else:
             raise TypeError('GaussianDensity takes exactly 3 or 5 arguments')
+        self.thisptr.setMethod(self.known_methods[method])
 
     def getBox(self):
         """
@@ -433,23 +787,44 @@ cdef class LocalDensity:
     calculate the local density. volume is the volume of a single particle. diameter is the diameter of the circumsphere
     of an individual particle.
 
+    Neighbors close to the surface of the sphere of radius r_cut are counted partially, with a weight that falls from
+    1 to 0 over a width of about one diameter; weight chooses how:
+
+    - 'linear': linearly from r_cut - diameter/2 to r_cut + diameter/2
+    - 'cubic': as a cubic spline with a continuous slope, over the same range
+    - 'gaussian': as an error function with the same variance as the linear weight, cut off at 3 standard deviations
+
+    r_cut may also be a list of increasing radii; the density at all of them is then computed in a single pass over
+    the neighbors within the largest, and the results have one column per radius.
+
     2D:
     RDF properly handles 2D boxes. Requires the points to be passed in [x, y, 0]. Failing to z=0 will lead to undefined
     behavior.
 
     .. moduleauthor:: Joshua Anderson <joaander@umich.edu>
 
-    :param r_cut: maximum distance over which to calculate the density
+    :param r_cut: maximum distance over which to calculate the density, or a list of them
     :param volume: volume of a single particle
     :param diameter: diameter of particle circumsphere
-    :type r_cut: float
+    :param weight: 'linear', 'cubic' or 'gaussian'
+    :type r_cut: float or list of floats
     :type volume: float
     :type diameter: float
+    :type weight: str
     """
     cdef density.LocalDensity *thisptr
+    cdef bint multiple_r_cut
 
-    def __cinit__(self, float r_cut, float volume, float diameter):
-        self.thisptr = new density.LocalDensity(r_cut, volume, diameter)
+    known_weights = {'linear': density.LinearWeight,
+                     'cubic': density.CubicSplineWeight,
+                     'gaussian': density.GaussianWeight}
+
+    def __cinit__(self, r_cut, float volume, float diameter, weight='linear'):
+        if weight not in self.known_weights:
+            raise ValueError('Unknown LocalDensity weight: {}'.format(weight))
+        self.multiple_r_cut = not np.isscalar(r_cut)
+        cdef vector[float] l_r_cuts = [float(r) for r in np.atleast_1d(r_cut)]
+        self.thisptr = new density.LocalDensity(l_r_cuts, volume, diameter, self.known_weights[weight])
 
     def getBox(self):
         """
@@ -458,16 +833,18 @@ cdef class LocalDensity:
         """
         return BoxFromCPP(self.thisptr.getBox())
 
-    def compute(self, box, ref_points, points=None):
+    def compute(self, box, ref_points, points=None, nlist=None):
         """
         Calculates the local density for the specified points. Does not accumulate (will overwrite current data).
 
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param points: (optional) points to calculate the local density
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         if points is None:
             points = ref_points
@@ -483,31 +860,43 @@ cdef class LocalDensity:
         cdef unsigned int n_p = <unsigned int> points.shape[0]
         cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
             box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
         with nogil:
-            self.thisptr.compute(l_box, <vec3[float]*>l_ref_points.data, n_ref, <vec3[float]*>l_points.data, n_p)
+            self.thisptr.compute(l_box, <vec3[float]*>l_ref_points.data, n_ref, <vec3[float]*>l_points.data, n_p, nlist_ptr)
 
     def getDensity(self):
         """
         :return: Density array for each particle
-        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`) or (:math:`N_{particles}`, :math:`N_{r_{cut}}`) \
+            for a list of r_cut, dtype= :class:`numpy.float32`
         """
         cdef float *density = self.thisptr.getDensity().get()
         cdef np.npy_intp nref[1]
-        nref[0] = <np.npy_intp>self.thisptr.getNRef()
+        nref[0] = <np.npy_intp>(self.thisptr.getNRef() * self.thisptr.getNumRCut())
         cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nref, np.NPY_FLOAT32, <void*>density)
+        if self.multiple_r_cut:
+            return np.reshape(result, (self.thisptr.getNRef(), self.thisptr.getNumRCut()))
         return result
 
     def getNumNeighbors(self):
         """
         :return: Number of neighbors for each particle
-        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.float32`
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`) or (:math:`N_{particles}`, \
+            :math:`N_{r_{cut}}`) for a list of r_cut, dtype= :class:`numpy.float32`
         """
         cdef float *neighbors = self.thisptr.getNumNeighbors().get()
         cdef np.npy_intp nref[1]
-        nref[0] = <np.npy_intp>self.thisptr.getNRef()
+        nref[0] = <np.npy_intp>(self.thisptr.getNRef() * self.thisptr.getNumRCut())
         cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nref, np.NPY_FLOAT32, <void*>neighbors)
+        if self.multiple_r_cut:
+            return np.reshape(result, (self.thisptr.getNRef(), self.thisptr.getNumRCut()))
         return result
 
+# how the threads of a histogram count into it; also used by the PMFTs
+_histogram_modes = {'dense': histogram.DenseTiles,
+                    'sparse': histogram.SparseTiles,
+                    'atomic': histogram.AtomicAdd}
+
 cdef class RDF:
     """ Computes RDF for supplied data
 
@@ -526,15 +915,21 @@ cdef class RDF:
 
     :param rmax: maximum distance to calculate
     :param dr: distance between histogram bins
+    :param n_blocks: keep the counts of up to this many (an even number, at least 4) consecutive blocks of frames, \
+        whose spread gives the standard error of the rdf (see :py:meth:`freud.density.RDF.getRDFStandardError()`); \
+        0 to only keep the mean
     :type rmax: float
     :type dr: float
+    :type n_blocks: unsigned int
     """
     cdef density.RDF *thisptr
 
-    def __cinit__(self, float rmax, float dr):
+    def __cinit__(self, float rmax, float dr, unsigned int n_blocks=0):
         if dr <= 0.0:
             raise ValueError("dr must be > 0")
         self.thisptr = new density.RDF(rmax, dr)
+        if n_blocks:
+            self.thisptr.setNumBlocks(n_blocks)
 
     def __dealloc__(self):
         del self.thisptr
@@ -546,16 +941,18 @@ cdef class RDF:
         """
         return BoxFromCPP(self.thisptr.getBox())
 
-    def accumulate(self, box, ref_points, points):
+    def accumulate(self, box, ref_points, points, nlist=None):
         """
         Calculates the rdf and adds to the current rdf histogram.
 
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param points: points to calculate the local density
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -569,22 +966,57 @@ cdef class RDF:
         cdef unsigned int n_p = <unsigned int> points.shape[0]
         cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
             box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, n_ref, <vec3[float]*>l_points.data, n_p, nlist_ptr)
+
+    def accumulateTrajectory(self, boxes, ref_points, points):
+        """
+        Calculates the rdf of every frame of a trajectory and adds it to the current rdf histogram. The cell list
+        of each frame is built while the previous frame is counted, in a single call.
+
+        :param boxes: simulation box of each frame, or a single box for all frames
+        :param ref_points: reference points of each frame
+        :param points: points of each frame
+        :type boxes: :py:class:`freud.box.Box` or list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{frames}`, :math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{frames}`, :math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3 or points.shape[2] != 3:
+            raise ValueError("the 3rd dimension must have 3 values: x, y, z")
+        if ref_points.shape[0] != points.shape[0]:
+            raise ValueError("ref_points and points must have the same number of frames")
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef unsigned int n_frames = <unsigned int> points.shape[0]
+        cdef unsigned int n_ref = <unsigned int> ref_points.shape[1]
+        cdef unsigned int n_p = <unsigned int> points.shape[1]
+        cdef vector[_box.Box] l_boxes = _box_vector(boxes, n_frames)
+        if n_frames == 0:
+            return
         with nogil:
-            self.thisptr.accumulate(l_box, <vec3[float]*>l_ref_points.data, n_ref, <vec3[float]*>l_points.data, n_p)
+            self.thisptr.accumulateTrajectory(&l_boxes[0], <vec3[float]*>l_ref_points.data, n_ref,
+                                              <vec3[float]*>l_points.data, n_p, n_frames)
 
-    def compute(self, box, ref_points, points):
+    def compute(self, box, ref_points, points, nlist=None):
         """
         Calculates the rdf for the specified points. Will overwrite the current histogram.
 
         :param box: simulation box
         :param ref_points: reference points to calculate the local density
         :param points: points to calculate the local density
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type box: :py:meth:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         self.thisptr.resetRDF()
-        self.accumulate(box, ref_points, points)
+        self.accumulate(box, ref_points, points, nlist=nlist)
 
     def resetRDF(self):
         """
@@ -592,6 +1024,29 @@ cdef class RDF:
         """
         self.thisptr.resetRDF()
 
+    def setHistogramMode(self, mode):
+        """Set how the threads count into the histogram, keeping the counts so far. By default each thread counts
+        into its own copy of the bins ('dense'), unless the copies of all threads would take more than 256 MB; then
+        all threads add to the totals with atomic operations ('atomic'). With 'sparse', a thread only allocates the
+        blocks of 4096 bins it adds to.
+
+        :param mode: 'dense', 'sparse' or 'atomic'
+        :type mode: str
+        """
+        if mode not in _histogram_modes:
+            raise ValueError('Unknown histogram mode: {}'.format(mode))
+        self.thisptr.setHistogramMode(_histogram_modes[mode])
+
+    def getHistogramMode(self):
+        """
+        :return: how the threads count into the histogram, see :py:meth:`freud.density.RDF.setHistogramMode()`
+        :rtype: str
+        """
+        cdef histogram.HistogramMode mode = self.thisptr.getHistogramMode()
+        for name in _histogram_modes:
+            if _histogram_modes[name] == mode:
+                return name
+
     def reduceRDF(self):
         """
         Reduces the histogram in the values over N processors to a single histogram. This is called automatically by
@@ -610,6 +1065,21 @@ cdef class RDF:
         cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>rdf)
         return result
 
+    def getRDFStandardError(self):
+        """
+        Get the standard error of the rdf, from the spread of the rdf of the blocks of frames. The frames are split into
+        consecutive blocks of equal length, which double in length whenever all n_blocks are complete, and the frames
+        after the last complete block are not included. NaN until 2 blocks are complete.
+
+        :return: standard error of the rdf
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *rdf_error = self.thisptr.getRDFStandardError().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>rdf_error)
+        return result
+
     def getR(self):
         """
         :return: values of the histogram bin centers
@@ -631,3 +1101,137 @@ cdef class RDF:
         nbins[0] = <np.npy_intp>self.thisptr.getNBins()
         cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>Nr)
         return result
+
+cdef class PartialRDF:
+    """ Computes the partial RDFs between all pairs of particle types for supplied data
+
+    The partial RDF :math:`g_{ab} \\left( r \\right)` is the density of type :math:`b` points around the type \
+    :math:`a` points relative to the average density of type :math:`b`. All :math:`N_{types}^2` partial RDFs are \
+    computed in a single pass over the pairs of points, and are normalized like :py:class:`freud.density.RDF`.
+
+    The values of :math:`r` to compute the rdf are set by the values of rmax, dr in the constructor. rmax sets the maximum
+    distance at which to calculate the :math:`g_{ab} \\left( r \\right)` while dr determines the step size for each bin.
+
+    .. note::
+        2D: PartialRDF properly handles 2D boxes. Requires the points to be passed in [x, y, 0]. Failing to z=0 will \
+        lead to undefined behavior.
+
+    :param rmax: maximum distance to calculate
+    :param dr: distance between histogram bins
+    :param num_types: number of particle types
+    :type rmax: float
+    :type dr: float
+    :type num_types: unsigned int
+    """
+    cdef density.PartialRDF *thisptr
+
+    def __cinit__(self, float rmax, float dr, unsigned int num_types):
+        if dr <= 0.0:
+            raise ValueError("dr must be > 0")
+        self.thisptr = new density.PartialRDF(rmax, dr, num_types)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def accumulate(self, box, points, types, nlist=None):
+        """
+        Calculates the partial rdfs and adds to the current histograms.
+
+        :param box: simulation box
+        :param points: points to calculate the partial rdfs of
+        :param types: type of each point, from 0 to num_types - 1
+        :param nlist: neighbor list of the points to use instead of building a cell list (optional)
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type types: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        types = freud.common.convert_array(types, 1, dtype=np.uint32, contiguous=True,
+            dim_message="types must be a 1 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        if types.shape[0] != points.shape[0]:
+            raise ValueError("there must be one type per point")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef np.ndarray[np.uint32_t, ndim=1] l_types = types
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
+            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_points.data, <unsigned int*>l_types.data, n_p, nlist_ptr)
+
+    def compute(self, box, points, types, nlist=None):
+        """
+        Calculates the partial rdfs for the specified points. Will overwrite the current histograms.
+
+        :param box: simulation box
+        :param points: points to calculate the partial rdfs of
+        :param types: type of each point, from 0 to num_types - 1
+        :param nlist: neighbor list of the points to use instead of building a cell list (optional)
+        :type box: :py:meth:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type types: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`), dtype= :class:`numpy.uint32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        """
+        self.thisptr.resetRDF()
+        self.accumulate(box, points, types, nlist=nlist)
+
+    def resetRDF(self):
+        """
+        resets the values of the partial rdfs in memory
+        """
+        self.thisptr.resetRDF()
+
+    def reduceRDF(self):
+        """
+        Reduces the histograms over N processors to single histograms. This is called automatically by
+        :py:meth:`freud.density.PartialRDF.getRDF()`, :py:meth:`freud.density.PartialRDF.getNr()`.
+        """
+        self.thisptr.reduceRDF()
+
+    def getRDF(self):
+        """
+        :return: partial rdf of each pair of types
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{types}`, :math:`N_{types}`, :math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *rdf = self.thisptr.getRDF().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumTypes()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumTypes()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>rdf)
+        return result
+
+    def getR(self):
+        """
+        :return: values of the histogram bin centers
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *r = self.thisptr.getR().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>r)
+        return result
+
+    def getNr(self):
+        """
+        :return: average number of type b points within r of a type a point
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{types}`, :math:`N_{types}`, :math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *Nr = self.thisptr.getNr().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumTypes()
+        nbins[1] = <np.npy_intp>self.thisptr.getNumTypes()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>Nr)
+        return result
@@ -11,8 +11,11 @@ __all__ = ['RDF']
 from ._freud import GaussianDensity;
 from ._freud import LocalDensity;
 from ._freud import RDF;
+from ._freud import PartialRDF;
 from ._freud import ComplexCF;
 from ._freud import FloatCF;
+from ._freud import ComplexMultiCF;
+from ._freud import FloatMultiCF;
 
 # continue handling deprecated API
 from ._freud import ComplexCF as ComplexWRDF;
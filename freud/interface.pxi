@@ -3,6 +3,7 @@
 
 from freud.util._VectorMath cimport vec3
 cimport freud._interface as interface
+cimport freud._locality as locality
 cimport freud._box as _box;
 from cython.operator cimport dereference
 import numpy as np
@@ -27,14 +28,16 @@ cdef class InterfaceMeasure:
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, ref_points, points):
+    def compute(self, ref_points, points, nlist=None):
         """Compute and return the number of particles at the interface between
         the two given sets of points.
 
         :param ref_points: one set of particle positions
         :param points: other set of particle positions
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type ref_points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -46,4 +49,5 @@ cdef class InterfaceMeasure:
         cdef unsigned int n_ref = ref_points.shape[0]
         cdef np.ndarray cPoints = points
         cdef unsigned int Np = points.shape[0]
-        return self.thisptr.compute(<vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np)
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        return self.thisptr.compute(<vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np, nlist_ptr)
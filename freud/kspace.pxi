@@ -4,11 +4,51 @@
 from freud.util._Boost cimport shared_array
 from freud.util._VectorMath cimport vec3, quat
 from libcpp.complex cimport complex
+from libc.stdint cimport uint64_t
 import numpy as np
 cimport numpy as np
 cimport freud._kspace as kspace
+cimport freud._box as _box
 from cython.operator cimport dereference
 
+cdef _compute_view(kspace.FTdelta *ft, K, position, orientation, out):
+    """Check the arrays given to compute_view, converting them only if they do not have the right type and
+    layout already, allocate the output if needed and compute the transform of ft into it"""
+    K = freud.common.convert_array(K, 2, dtype=np.float32, contiguous=True,
+        dim_message="K must be a 2 dimensional array")
+    if K.shape[1] != 3:
+        raise TypeError('K should be an Nx3 array')
+    position = freud.common.convert_array(position, 2, dtype=np.float32, contiguous=True,
+        dim_message="position must be a 2 dimensional array")
+    if position.shape[1] != 3:
+        raise TypeError('position should be an Nx3 array')
+    if orientation is not None:
+        orientation = freud.common.convert_array(orientation, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientation must be a 2 dimensional array")
+        if orientation.shape[1] != 4:
+            raise TypeError('orientation should be an Nx4 array')
+        if position.shape[0] != orientation.shape[0]:
+            raise TypeError('position and orientation should have the same length')
+    if out is None:
+        out = np.empty(K.shape[0], dtype=np.complex64)
+    elif not isinstance(out, np.ndarray) or out.dtype != np.complex64 or out.shape != (K.shape[0],) or \
+            not out.flags.c_contiguous or not out.flags.writeable:
+        raise TypeError('out should be a writeable contiguous complex64 array with one value per K point')
+
+    cdef np.ndarray[float, ndim=2] cK = K
+    cdef np.ndarray[float, ndim=2] cr = position
+    cdef quat[float] *q_ptr = NULL
+    cdef np.ndarray[float, ndim=2] cq
+    if orientation is not None:
+        cq = orientation
+        q_ptr = <quat[float]*>cq.data
+    cdef np.ndarray[np.complex64_t, ndim=1] cout = out
+    cdef unsigned int NK = <unsigned int> K.shape[0]
+    cdef unsigned int Np = <unsigned int> position.shape[0]
+    with nogil:
+        ft.computeView(<vec3[float]*>cK.data, NK, <vec3[float]*>cr.data, q_ptr, Np, <float complex*>cout.data)
+    return out
+
 cdef class FTdelta:
     """Compute the Fourier transform of a set of delta peaks at a list of
     K points.
@@ -31,6 +71,27 @@ cdef class FTdelta:
         """Perform transform and store result internally"""
         self.thisptr.compute()
 
+    def compute_view(self, K, position, orientation=None, out=None):
+        """Perform transform of the given arrays without storing them, and return the FT values
+
+        The arrays are used in place when they are already contiguous with the types below, and the FT values are
+        written directly to out; :py:meth:`~.FTdelta.set_K` and :py:meth:`~.FTdelta.set_rq` copy their arrays
+        instead. The K points and particles set with those methods, and the values of
+        :py:meth:`~.FTdelta.getFT`, are left unchanged.
+
+        :param K: K values to evaluate
+        :param position: particle position vectors
+        :param orientation: particle orientation quaternions (optional, unused)
+        :param out: array to write the FT values to (optional)
+        :type K: :class:`numpy.ndarray`, shape=(:math:`N_{K}`, 3), dtype= :class:`numpy.float32`
+        :type position: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type orientation: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 4), dtype= :class:`numpy.float32`
+        :type out: :class:`numpy.ndarray`, shape=(:math:`N_{K}`), dtype= :class:`numpy.complex64`
+        :return: FT values
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{K}`), dtype= :class:`numpy.complex64`
+        """
+        return _compute_view(self.thisptr, K, position, orientation, out)
+
     def getFT(self):
         """Return the FT values"""
         cdef (float complex)* ft_points = self.thisptr.getFT().get()
@@ -109,6 +170,27 @@ cdef class FTsphere:
         """Perform transform and store result internally"""
         self.thisptr.compute()
 
+    def compute_view(self, K, position, orientation=None, out=None):
+        """Perform transform of the given arrays without storing them, and return the FT values
+
+        The arrays are used in place when they are already contiguous with the types below, and the FT values are
+        written directly to out; :py:meth:`~.FTsphere.set_K` and :py:meth:`~.FTsphere.set_rq` copy their arrays
+        instead. The K points and particles set with those methods, and the values of
+        :py:meth:`~.FTsphere.getFT`, are left unchanged.
+
+        :param K: K values to evaluate
+        :param position: particle position vectors
+        :param orientation: particle orientation quaternions (optional, unused)
+        :param out: array to write the FT values to (optional)
+        :type K: :class:`numpy.ndarray`, shape=(:math:`N_{K}`, 3), dtype= :class:`numpy.float32`
+        :type position: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type orientation: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 4), dtype= :class:`numpy.float32`
+        :type out: :class:`numpy.ndarray`, shape=(:math:`N_{K}`), dtype= :class:`numpy.complex64`
+        :return: FT values
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{K}`), dtype= :class:`numpy.complex64`
+        """
+        return _compute_view(self.thisptr, K, position, orientation, out)
+
     def getFT(self):
         """Return the FT values"""
         cdef (float complex)* ft_points = self.thisptr.getFT().get()
@@ -186,6 +268,29 @@ cdef class FTpolyhedron:
         """Perform transform and store result internally"""
         self.thisptr.compute()
 
+    def compute_view(self, K, position, orientation=None, out=None):
+        """Perform transform of the given arrays without storing them, and return the FT values
+
+        The arrays are used in place when they are already contiguous with the types below, and the FT values are
+        written directly to out; :py:meth:`~.FTpolyhedron.set_K` and :py:meth:`~.FTpolyhedron.set_rq` copy their arrays
+        instead. The K points and particles set with those methods, and the values of
+        :py:meth:`~.FTpolyhedron.getFT`, are left unchanged.
+
+        :param K: K values to evaluate
+        :param position: particle position vectors
+        :param orientation: particle orientation quaternions
+        :param out: array to write the FT values to (optional)
+        :type K: :class:`numpy.ndarray`, shape=(:math:`N_{K}`, 3), dtype= :class:`numpy.float32`
+        :type position: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        :type orientation: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 4), dtype= :class:`numpy.float32`
+        :type out: :class:`numpy.ndarray`, shape=(:math:`N_{K}`), dtype= :class:`numpy.complex64`
+        :return: FT values
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{K}`), dtype= :class:`numpy.complex64`
+        """
+        if orientation is None:
+            raise TypeError('orientation is needed for polyhedra')
+        return _compute_view(self.thisptr, K, position, orientation, out)
+
     def getFT(self):
         """Return the FT values"""
         cdef (float complex)* ft_points = self.thisptr.getFT().get()
@@ -221,8 +326,8 @@ cdef class FTpolyhedron:
         :param area: facet areas
         :param volume: polyhedron volume
         :type verts: :class:`numpy.ndarray`, shape=(:math:`N_{vertices}`, 3), dtype= :class:`numpy.float32`
-        :type facet_offs: :class:`numpy.ndarray`, shape=(:math:`N_{facets}`), dtype= :class:`numpy.float32`
-        :type facets: :class:`numpy.ndarray`, shape=(:math:`N_{facets}`), dtype= :class:`numpy.float32`
+        :type facet_offs: :class:`numpy.ndarray`, shape=(:math:`N_{facets}+1`), dtype= :class:`numpy.uint32`
+        :type facets: :class:`numpy.ndarray`, shape=(:math:`N_{facet vertices}`), dtype= :class:`numpy.uint32`
         :type norms: :class:`numpy.ndarray`, shape=(:math:`N_{facets}`, 3), dtype= :class:`numpy.float32`
         :type d: :class:`numpy.ndarray`, shape=(:math:`N_{facets}`), dtype= :class:`numpy.float32`
         :type area: :class:`numpy.ndarray`, shape=(:math:`N_{facets}`), dtype= :class:`numpy.float32`
@@ -233,10 +338,10 @@ cdef class FTpolyhedron:
         if verts.shape[1] != 3:
             raise TypeError('verts should be an Nx3 array')
 
-        facet_offs = freud.common.convert_array(facet_offs, 1, dtype=np.float32, contiguous=True,
+        facet_offs = freud.common.convert_array(facet_offs, 1, dtype=np.uint32, contiguous=True,
             dim_message="facet_offs must be a 1 dimensional array")
 
-        facets = freud.common.convert_array(facets, 1, dtype=np.float32, contiguous=True,
+        facets = freud.common.convert_array(facets, 1, dtype=np.uint32, contiguous=True,
             dim_message="facets must be a 1 dimensional array")
 
         norms = freud.common.convert_array(norms, 2, dtype=np.float32, contiguous=True,
@@ -299,3 +404,138 @@ cdef class FTpolyhedron:
         :type density: float complex
         """
         self.thisptr.set_density(density)
+
+cdef class StructureFactorGrid:
+    """Computes the spherically averaged static structure factor :math:`S\\left(\\left|k\\right|\\right)` of \
+    the whole periodic box from a fast Fourier transform of the density.
+
+    The points are assigned to a periodic grid spanning the box, spreading each point over the nearest 1 (NGP), 2 \
+    (CIC) or 3 (TSC) grid nodes in each direction. One fast Fourier transform of the grid gives \
+    :math:`\\rho\\left(\\vec{k}\\right) = \\sum_j \\exp\\left(-i\\vec{k}\\cdot\\vec{r}_j\\right)` at every \
+    wave vector of the box up to the Nyquist frequency of the grid, which is divided by the Fourier transform of \
+    the assignment (deconvolution). :math:`S\\left(\\vec{k}\\right) = \\left|\\rho\\left(\\vec{k}\\right)\\right|^2/N` \
+    of all the wave vectors with :math:`0 < \\left|\\vec{k}\\right| < k_{max}` is then averaged over spherical \
+    shells of width :math:`dk`. This is much faster than evaluating the sum directly with \
+    :py:class:`freud.kspace.FTdelta`, and agrees with it well below the Nyquist frequency; finer grids or higher \
+    orders reduce the remaining aliasing close to it.
+
+    The wave vectors are those of the (possibly tilted) periodic box. In 2D boxes the z direction of the grid is \
+    ignored. Grid widths that are powers of two are the fastest, but any width can be used.
+
+    :param width: number of grid nodes in each direction
+    :param width_x: number of grid nodes in x
+    :param width_y: number of grid nodes in y
+    :param width_z: number of grid nodes in z
+    :param k_max: largest wave vector magnitude
+    :param dk: width of the shells
+    :param order: 1 (nearest grid point), 2 (cloud in cell) or 3 (triangular shaped cloud)
+    :type width: unsigned int
+    :type width_x: unsigned int
+    :type width_y: unsigned int
+    :type width_z: unsigned int
+    :type k_max: float
+    :type dk: float
+    :type order: unsigned int
+
+    - Constructor Calls:
+
+        Initialize with all dimensions identical::
+
+            freud.kspace.StructureFactorGrid(width, k_max, dk, order=2)
+
+        Initialize with each dimension specified::
+
+            freud.kspace.StructureFactorGrid(width_x, width_y, width_z, k_max, dk, order=2)
+    """
+    cdef kspace.StructureFactorGrid *thisptr
+
+    def __cinit__(self, *args, unsigned int order=2):
+        if len(args) == 3:
+            self.thisptr = new kspace.StructureFactorGrid(args[0], args[1], args[2], order)
+        elif len(args) == 5:
+            self.thisptr = new kspace.StructureFactorGrid(args[0], args[1], args[2], args[3], args[4], order)
+        else:
+            raise TypeError('StructureFactorGrid takes exactly 3 or 5 positional arguments')
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def accumulate(self, box, points):
+        """
+        Calculates the structure factor of the points and adds their wave vectors to the shell averages.
+
+        :param box: simulation box
+        :param points: points to calculate the structure factor of
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise ValueError("the 2nd dimension must have 3 values: x, y, z")
+        cdef np.ndarray[float, ndim=2] l_points = points
+        cdef unsigned int n_p = <unsigned int> points.shape[0]
+        cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
+            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        with nogil:
+            self.thisptr.accumulate(l_box, <vec3[float]*>l_points.data, n_p)
+
+    def compute(self, box, points):
+        """
+        Calculates the structure factor of the points, replacing the current shell averages.
+
+        :param box: simulation box
+        :param points: points to calculate the structure factor of
+        :type box: :py:class:`freud.box.Box`
+        :type points: :class:`numpy.ndarray`, shape=(:math:`N_{particles}`, 3), dtype= :class:`numpy.float32`
+        """
+        self.thisptr.resetStructureFactor()
+        self.accumulate(box, points)
+
+    def getS(self):
+        """
+        :return: structure factor averaged over each shell, 0 for shells without wave vectors
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *sk = self.thisptr.getStructureFactor().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>sk)
+        return result
+
+    def getCounts(self):
+        """
+        :return: number of wave vectors in each shell
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.uint64`
+        """
+        cdef uint64_t *counts = self.thisptr.getCounts().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.uint64_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT64, <void*>counts)
+        return result
+
+    def getK(self):
+        """
+        :return: centers of the shells
+        :rtype: :class:`numpy.ndarray`, shape=(:math:`N_{bins}`), dtype= :class:`numpy.float32`
+        """
+        cdef float *k = self.thisptr.getK().get()
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBins()
+        cdef np.ndarray[np.float32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>k)
+        return result
+
+    def getBox(self):
+        """
+        Get the box used in the calculation
+
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(<_box.Box> self.thisptr.getBox())
+
+    def resetStructureFactor(self):
+        """
+        resets the shell averages in memory
+        """
+        self.thisptr.resetStructureFactor()
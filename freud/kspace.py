@@ -8,6 +8,7 @@ from math import *
 from ._freud import FTdelta as _FTdelta
 from ._freud import FTsphere as _FTsphere
 from ._freud import FTpolyhedron as _FTpolyhedron
+from ._freud import StructureFactorGrid
 
 ## \package freud.kspace
 #
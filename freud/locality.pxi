@@ -2,13 +2,209 @@
 # This file is part of the Freud project, released under the BSD 3-Clause License.
 
 import sys
+import warnings
 from freud.util._VectorMath cimport vec3
 cimport freud._locality as locality
 cimport freud._box as _box;
 from cython.operator cimport dereference
+from libc.string cimport memcpy
 import numpy as np
 cimport numpy as np
 
+cdef class NeighborList:
+    """Stores the bonds between a set of reference points and a set of points, as found by
+    :py:meth:`freud.locality.LinkCell.compute` or :py:meth:`freud.locality.NearestNeighbors.compute`.
+
+    Bonds are stored sorted by reference point index, in compressed sparse row layout: the bonds of reference point
+    i are ``index_j[segments[i]:segments[i+1]]``. A NeighborList can be passed to the ``nlist`` argument of most
+    analyses so that they skip their own neighbor search. Analyses still apply their own cutoff to each bond, so a
+    list built with a large radius can be shared between analyses with smaller cutoffs.
+
+    .. note::
+
+       The arrays returned by the getter methods point directly into the memory of the list. They are only valid
+       until the list (or the object that produced it) is recomputed.
+
+    Example::
+
+       lc = freud.locality.LinkCell(box, 3.0)
+       nlist = lc.compute(box, positions).getNList()
+       rdf.compute(box, positions, positions, nlist=nlist)
+       ld.compute(box, positions, positions, nlist=nlist)
+    """
+    cdef locality.NeighborList *thisptr
+    cdef char _managed
+    cdef _base
+
+    def __cinit__(self):
+        self._managed = True
+        self.thisptr = new locality.NeighborList()
+
+    def __dealloc__(self):
+        if self._managed:
+            del self.thisptr
+
+    cdef refer_to(self, locality.NeighborList *other, base):
+        """Make this object a view of a NeighborList owned by base"""
+        if self._managed:
+            del self.thisptr
+        self._managed = False
+        self.thisptr = other
+        self._base = base
+
+    cdef locality.NeighborList *get_ptr(self):
+        return self.thisptr
+
+    @classmethod
+    def from_arrays(cls, num_i, num_j, index_i, index_j, distances, weights=None):
+        """Create a NeighborList from arrays of bonds
+
+        :param num_i: number of reference points
+        :param num_j: number of points
+        :param index_i: reference point index of each bond
+        :param index_j: point index of each bond
+        :param distances: length of each bond
+        :param weights: weight of each bond (defaults to 1)
+        :type num_i: unsigned int
+        :type num_j: unsigned int
+        :type index_i: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`
+        :type index_j: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`
+        :type distances: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        :type weights: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        :return: the new neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        index_i = np.asarray(index_i, dtype=np.uintp).ravel()
+        index_j = np.asarray(index_j, dtype=np.uintp).ravel()
+        distances = np.asarray(distances, dtype=np.float32).ravel()
+        if weights is None:
+            weights = np.ones(len(index_i), dtype=np.float32)
+        weights = np.asarray(weights, dtype=np.float32).ravel()
+        if not (len(index_i) == len(index_j) == len(distances) == len(weights)):
+            raise TypeError('index_i, index_j, distances, and weights must have the same length')
+        if len(index_i) and (index_i.max() >= num_i or index_j.max() >= num_j):
+            raise ValueError('bond indices must be smaller than num_i and num_j')
+
+        # bonds must be sorted by reference point index
+        order = np.argsort(index_i, kind='mergesort')
+
+        cdef NeighborList result = cls()
+        cdef size_t num_bonds = len(index_i)
+        result.thisptr.resize(num_bonds, num_i, num_j)
+        cdef np.ndarray[np.uintp_t, ndim=1] l_index_i = np.ascontiguousarray(index_i[order])
+        cdef np.ndarray[np.uintp_t, ndim=1] l_index_j = np.ascontiguousarray(index_j[order])
+        cdef np.ndarray[float, ndim=1] l_distances = np.ascontiguousarray(distances[order])
+        cdef np.ndarray[float, ndim=1] l_weights = np.ascontiguousarray(weights[order])
+        if num_bonds:
+            memcpy(result.thisptr.getIndexI(), l_index_i.data, num_bonds*sizeof(size_t))
+            memcpy(result.thisptr.getIndexJ(), l_index_j.data, num_bonds*sizeof(size_t))
+            memcpy(result.thisptr.getDistances(), l_distances.data, num_bonds*sizeof(float))
+            memcpy(result.thisptr.getWeights(), l_weights.data, num_bonds*sizeof(float))
+        result.thisptr.updateSegments()
+        return result
+
+    def getNumBonds(self):
+        """
+        :return: the number of bonds in the list
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumBonds()
+
+    def getNumI(self):
+        """
+        :return: the number of reference points the list was built for
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumI()
+
+    def getNumJ(self):
+        """
+        :return: the number of points the list was built for
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumJ()
+
+    def getIndexI(self):
+        """
+        :return: reference point index of each bond
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.uintp`
+        """
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        cdef np.ndarray[np.uintp_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINTP, <void*>self.thisptr.getIndexI())
+        return result
+
+    def getIndexJ(self):
+        """
+        :return: point index of each bond
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.uintp`
+        """
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        cdef np.ndarray[np.uintp_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINTP, <void*>self.thisptr.getIndexJ())
+        return result
+
+    def getDistances(self):
+        """
+        :return: length of each bond
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        cdef np.ndarray[float, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>self.thisptr.getDistances())
+        return result
+
+    def getWeights(self):
+        """
+        :return: weight of each bond
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{bonds}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumBonds()
+        cdef np.ndarray[float, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_FLOAT32, <void*>self.thisptr.getWeights())
+        return result
+
+    def getSegments(self):
+        """
+        :return: index of the first bond of each reference point
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}+1\\right)`, dtype= :class:`numpy.uintp`
+        """
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>(self.thisptr.getNumI() + 1)
+        cdef np.ndarray[np.uintp_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINTP, <void*>self.thisptr.getSegments())
+        return result
+
+    def getNeighborCounts(self):
+        """
+        :return: number of bonds of each reference point
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        cdef np.npy_intp nbins[1]
+        nbins[0] = <np.npy_intp>self.thisptr.getNumI()
+        cdef np.ndarray[np.uint32_t, ndim=1] result = np.PyArray_SimpleNewFromData(1, nbins, np.NPY_UINT32, <void*>self.thisptr.getCounts())
+        return result
+
+    def filterR(self, float rmin, float rmax):
+        """Remove all bonds whose length is not in [rmin, rmax)
+
+        :param rmin: minimum bond length to keep
+        :param rmax: maximum bond length to keep
+        :type rmin: float
+        :type rmax: float
+        :return: self
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        self.thisptr.filterR(rmin, rmax)
+        return self
+
+cdef locality.NeighborList *_nlist_ptr(nlist) except? NULL:
+    """Get the C++ NeighborList behind an optional nlist argument (NULL for None)"""
+    if nlist is None:
+        return NULL
+    if not isinstance(nlist, NeighborList):
+        raise TypeError('nlist must be a freud.locality.NeighborList')
+    return (<NeighborList>nlist).get_ptr()
+
 cdef class IteratorLinkCell:
     """Iterates over the particles in a cell.
 
@@ -141,8 +337,9 @@ cdef class LinkCell:
         :return: array of cell neighbors
         :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{neighbors}\\right)`, dtype= :class:`numpy.uint32`
         """
-        neighbors = self.thisptr.getCellNeighbors(int(cell))
+        cdef locality.CellNeighbors neighbors = self.thisptr.getCellNeighbors(int(cell))
         result = np.zeros(neighbors.size(), dtype=np.uint32)
+        cdef unsigned int i
         for i in range(neighbors.size()):
             result[i] = neighbors[i]
         return result
@@ -166,21 +363,423 @@ cdef class LinkCell:
         with nogil:
             self.thisptr.computeCellList(cBox, <vec3[float]*> cPoints.data, Np)
 
+    def compute(self, box, ref_points, points=None, exclude_ii=None):
+        """Update the cell list for points and find all (ref_point, point) pairs closer than cell_width
+
+        :param box: simulation box
+        :param ref_points: reference point coordinates
+        :param points: point coordinates (defaults to ref_points)
+        :param exclude_ii: exclude bonds between a point and itself (defaults to True when points is None)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type exclude_ii: bool
+        :return: self
+        :rtype: :py:class:`freud.locality.LinkCell`
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
+            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef bint c_exclude_ii = exclude_ii
+        with nogil:
+            self.thisptr.compute(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np,
+                c_exclude_ii)
+        return self
+
+    def getNList(self):
+        """
+        :return: the neighbor list computed by the last call to :py:meth:`compute`
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getNList(), self)
+        return result
+
+cdef class GhostCellList:
+    """Finds all pairs of points closer than rmax with a cell list padded by the periodic images (ghosts) of the
+    points near the box faces. Neighbor searches then never wrap bond vectors, and boxes too small for three
+    :py:class:`freud.locality.LinkCell` cells per dimension are handled as well.
+
+    :param box: simulation box
+    :param rmax: Maximum distance to find particles within
+    :type box: :py:class:`freud.box.Box`
+    :type rmax: float
+
+    Example::
+
+       # assume we have position as Nx3 array
+       gcl = GhostCellList(box, 1.5)
+       nlist = gcl.compute(box, positions).getNList()
+    """
+    cdef locality.GhostCellList *thisptr
+
+    def __cinit__(self, box, rmax):
+        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        self.thisptr = new locality.GhostCellList(cBox, float(rmax))
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def getRMax(self):
+        """
+        :return: the cutoff
+        :rtype: float
+        """
+        return self.thisptr.getRMax()
+
+    def getNumCells(self):
+        """
+        :return: the number of cells of the padded box
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumCells()
+
+    def getNumGhosts(self):
+        """
+        :return: the number of ghosts made by the last call to :py:meth:`compute`
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumGhosts()
+
+    def compute(self, box, ref_points, points=None, exclude_ii=None):
+        """Make the ghosts of points and find all (ref_point, point) pairs closer than rmax
+
+        :param box: simulation box
+        :param ref_points: reference point coordinates, inside the box
+        :param points: point coordinates (defaults to ref_points)
+        :param exclude_ii: exclude bonds between a point and itself (defaults to True when points is None)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type exclude_ii: bool
+        :return: self
+        :rtype: :py:class:`freud.locality.GhostCellList`
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
+            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef bint c_exclude_ii = exclude_ii
+        with nogil:
+            self.thisptr.compute(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np,
+                c_exclude_ii)
+        return self
+
+    def getNList(self):
+        """
+        :return: the neighbor list computed by the last call to :py:meth:`compute`
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getNList(), self)
+        return result
+
+cdef class DistanceKernel:
+    """Batched minimum image distance test between a reference point and a block of points, using the widest SIMD
+    instruction set freud was compiled for. This is the kernel the neighbor searches are built on; it is exposed
+    mostly for testing.
+
+    :param box: simulation box
+    :param rmax: cutoff; points at a distance of rmax or more are rejected
+    :param dr: bin width of the distance bins
+    :type box: :py:class:`freud.box.Box`
+    :type rmax: float
+    :type dr: float
+    """
+    cdef locality.DistanceKernel *thisptr
+    cdef np.ndarray idx
+    cdef np.ndarray r
+    cdef np.ndarray bins
+    cdef np.ndarray delta
+
+    def __cinit__(self, box, rmax, dr=1.0):
+        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        self.thisptr = new locality.DistanceKernel(cBox, float(rmax), float(dr))
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getRMax(self):
+        """
+        :return: the cutoff
+        :rtype: float
+        """
+        return self.thisptr.getRMax()
+
+    @staticmethod
+    def getVectorWidth():
+        """
+        :return: the number of points tested per instruction
+        :rtype: unsigned int
+        """
+        return locality.DistanceKernel.getVectorWidth()
+
+    def compute(self, ref_point, points, wrap=True):
+        """Find the points closer than rmax to ref_point
+
+        :param ref_point: reference point
+        :param points: points to test
+        :param wrap: apply the minimum image convention to the bond vectors
+        :type ref_point: :class:`numpy.ndarray`, shape= :math:`\\left(3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type wrap: bool
+        :return: self
+        :rtype: :py:class:`freud.locality.DistanceKernel`
+        """
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef np.ndarray[float, ndim=1] l_ref = np.ascontiguousarray(ref_point, dtype=np.float32).reshape(3)
+        cdef np.ndarray[float, ndim=1] l_x = np.ascontiguousarray(points[:, 0])
+        cdef np.ndarray[float, ndim=1] l_y = np.ascontiguousarray(points[:, 1])
+        cdef np.ndarray[float, ndim=1] l_z = np.ascontiguousarray(points[:, 2])
+        cdef unsigned int Np = points.shape[0]
+        cdef np.ndarray[np.uint32_t, ndim=1] l_idx = np.zeros(Np, dtype=np.uint32)
+        cdef np.ndarray[float, ndim=1] l_r = np.zeros(Np, dtype=np.float32)
+        cdef np.ndarray[np.uint32_t, ndim=1] l_bins = np.zeros(Np, dtype=np.uint32)
+        cdef np.ndarray[float, ndim=2] l_delta = np.zeros((Np, 3), dtype=np.float32)
+        cdef vec3[float] c_ref = vec3[float](l_ref[0], l_ref[1], l_ref[2])
+        cdef bint c_wrap = wrap
+        cdef unsigned int n
+        with nogil:
+            if c_wrap:
+                n = self.thisptr.compute(c_ref, <float*> l_x.data, <float*> l_y.data, <float*> l_z.data, 0, Np,
+                    <unsigned int*> l_idx.data, <float*> l_r.data, <unsigned int*> l_bins.data,
+                    <vec3[float]*> l_delta.data)
+            else:
+                n = self.thisptr.computeImage(c_ref, <float*> l_x.data, <float*> l_y.data, <float*> l_z.data, 0,
+                    Np, <unsigned int*> l_idx.data, <float*> l_r.data, <unsigned int*> l_bins.data,
+                    <vec3[float]*> l_delta.data)
+        self.idx = l_idx[:n]
+        self.r = l_r[:n]
+        self.bins = l_bins[:n]
+        self.delta = l_delta[:n]
+        return self
+
+    def getIndices(self):
+        """
+        :return: indices of the points found by the last call to :py:meth:`compute`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{found}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        return self.idx
+
+    def getDistances(self):
+        """
+        :return: distances of the points found by the last call to :py:meth:`compute`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{found}\\right)`, dtype= :class:`numpy.float32`
+        """
+        return self.r
+
+    def getBins(self):
+        """
+        :return: distance bins of the points found by the last call to :py:meth:`compute`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{found}\\right)`, dtype= :class:`numpy.uint32`
+        """
+        return self.bins
+
+    def getBondVectors(self):
+        """
+        :return: bond vectors from ref_point to the points found by the last call to :py:meth:`compute`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{found}, 3\\right)`, dtype= :class:`numpy.float32`
+        """
+        return self.delta
+
+cdef class KdTree:
+    """Finds neighbors with a periodic k-d tree. The tree adapts to the local density of the points, so it suits
+    systems of very uneven density (clusters, interfaces, vapor) for which the cells of
+    :py:class:`freud.locality.LinkCell` are too crowded or mostly empty. It finds either all pairs closer than rmax
+    or the k nearest neighbors of each point, without growing a cutoff like
+    :py:class:`freud.locality.NearestNeighbors`. Searches reach at most half the distance between opposite box faces.
+
+    :param box: simulation box
+    :param rmax: Maximum distance to find particles within in :py:meth:`compute`
+    :type box: :py:class:`freud.box.Box`
+    :type rmax: float
+
+    Example::
+
+       # assume we have position as Nx3 array
+       kd = KdTree(box, 1.5)
+       nlist = kd.compute(box, positions).getNList()
+       nearest = kd.computeNearest(box, positions, 12).getNList()
+    """
+    cdef locality.KdTree *thisptr
+
+    def __cinit__(self, box, rmax):
+        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        self.thisptr = new locality.KdTree(cBox, float(rmax))
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def getBox(self):
+        """
+        :return: Freud Box
+        :rtype: :py:class:`freud.box.Box`
+        """
+        return BoxFromCPP(self.thisptr.getBox())
+
+    def getRMax(self):
+        """
+        :return: the cutoff
+        :rtype: float
+        """
+        return self.thisptr.getRMax()
+
+    def getNumPoints(self):
+        """
+        :return: the number of points in the tree
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumPoints()
+
+    def getNumNodes(self):
+        """
+        :return: the number of nodes of the tree
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumNodes()
+
+    def compute(self, box, ref_points, points=None, exclude_ii=None):
+        """Build the tree over points and find all (ref_point, point) pairs closer than rmax
+
+        :param box: simulation box
+        :param ref_points: reference point coordinates, inside the box
+        :param points: point coordinates (defaults to ref_points)
+        :param exclude_ii: exclude bonds between a point and itself (defaults to True when points is None)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type exclude_ii: bool
+        :return: self
+        :rtype: :py:class:`freud.locality.KdTree`
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
+            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef bint c_exclude_ii = exclude_ii
+        with nogil:
+            self.thisptr.compute(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np,
+                c_exclude_ii)
+        return self
+
+    def computeNearest(self, box, ref_points, num_neighbors, points=None, exclude_ii=None):
+        """Build the tree over points and find the num_neighbors nearest points of each ref_point. The bonds of
+        each ref_point are ordered nearest first.
+
+        :param box: simulation box
+        :param ref_points: reference point coordinates, inside the box
+        :param num_neighbors: number of neighbors to find for each ref_point
+        :param points: point coordinates (defaults to ref_points)
+        :param exclude_ii: exclude bonds between a point and itself (defaults to True when points is None)
+        :type box: :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{ref}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type num_neighbors: unsigned int
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{points}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type exclude_ii: bool
+        :return: self
+        :rtype: :py:class:`freud.locality.KdTree`
+        """
+        if exclude_ii is None:
+            exclude_ii = points is None
+        if points is None:
+            points = ref_points
+        ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 2 dimensional array")
+        if ref_points.shape[1] != 3:
+            raise TypeError('ref_points should be an Nx3 array')
+        points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 2 dimensional array")
+        if points.shape[1] != 3:
+            raise TypeError('points should be an Nx3 array')
+        cdef _box.Box cBox = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(),
+            box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef np.ndarray cRef_points = ref_points
+        cdef unsigned int n_ref = ref_points.shape[0]
+        cdef np.ndarray cPoints = points
+        cdef unsigned int Np = points.shape[0]
+        cdef unsigned int c_num_neighbors = num_neighbors
+        cdef bint c_exclude_ii = exclude_ii
+        with nogil:
+            self.thisptr.computeNearest(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data,
+                Np, c_num_neighbors, c_exclude_ii)
+        return self
+
+    def getNList(self):
+        """
+        :return: the neighbor list computed by the last call to :py:meth:`compute` or :py:meth:`computeNearest`
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getNList(), self)
+        return result
+
 cdef class NearestNeighbors:
     """Supports efficiently finding the N nearest neighbors of each point
     in a set for some fixed integer N.
 
     - strict_cut = True: rmax will be strictly obeyed, and any particle which has fewer than N neighbors will have \
         values of UINT_MAX assigned
-    - strict_cut = False: rmax will be expanded to find requested number of neighbors. If rmax increases to the \
-        point that a cell list cannot be constructed, a warning will be raised and neighbors found will be returned
+    - strict_cut = False: each particle searches shells of cells around itself until it has found N neighbors; \
+        rmax only sets the cell size. Particles with enough neighbors are never searched again
 
     .. moduleauthor:: Eric Harper <harperic@umich.edu>
 
     :param rmax: Initial guess of a distance to search within to find N neighbors
     :param n_neigh: Number of neighbors to find for each point
-    :param scale: multiplier by which to automatically increase rmax value by if requested number of neighbors is not \
-        found. Only utilized if strict_cut is False. Scale must be greater than 1
+    :param scale: deprecated and ignored, searches are extended shell by shell
     :param strict_cut: whether to use a strict rmax or allow for automatic expansion
     :type rmax: float
     :type n_neigh: unsigned int
@@ -189,10 +788,11 @@ cdef class NearestNeighbors:
     """
     cdef locality.NearestNeighbors *thisptr
 
-    def __cinit__(self, float rmax, unsigned int n_neigh, float scale=1.1, strict_cut=False):
-        if scale < 1:
-            raise RuntimeError("scale must be greater than 1")
-        self.thisptr = new locality.NearestNeighbors(float(rmax), int(n_neigh), float(scale), bool(strict_cut))
+    def __cinit__(self, float rmax, unsigned int n_neigh, scale=None, strict_cut=False):
+        if scale is not None:
+            warnings.warn("NearestNeighbors no longer uses scale; searches are extended shell by shell",
+                DeprecationWarning)
+        self.thisptr = new locality.NearestNeighbors(float(rmax), int(n_neigh), bool(strict_cut))
 
     def __dealloc__(self):
         del self.thisptr
@@ -225,6 +825,13 @@ cdef class NearestNeighbors:
         """
         return self.thisptr.getNref()
 
+    def getNumDeficient(self):
+        """
+        :return: the number of reference points that had fewer than N neighbors within rmax in the last compute
+        :rtype: unsigned int
+        """
+        return self.thisptr.getNumDeficient()
+
     def setRMax(self, float rmax):
         """Update the neighbor search distance guess
         :param rmax: nearest neighbors search radius
@@ -238,8 +845,7 @@ cdef class NearestNeighbors:
 
         - strict_cut = True: rmax will be strictly obeyed, and any particle which has fewer than N neighbors will have \
             values of UINT_MAX assigned
-        - strict_cut = False: rmax will be expanded to find requested number of neighbors. If rmax increases to the \
-            point that a cell list cannot be constructed, a warning will be raised and neighbors found will be returned
+        - strict_cut = False: each particle searches shells of cells around itself until it has found N neighbors
 
         :param strict_cut: whether to use a strict rmax or allow for automatic expansion
         :type strict_cut: bool
@@ -359,3 +965,15 @@ cdef class NearestNeighbors:
         cdef unsigned int Np = points.shape[0]
         with nogil:
             self.thisptr.compute(cBox, <vec3[float]*> cRef_points.data, n_ref, <vec3[float]*> cPoints.data, Np)
+        return self
+
+    def getNList(self):
+        """Return the neighbors found by the last call to :py:meth:`compute` as a NeighborList. Missing neighbors
+        (padded with UINT_MAX in :py:meth:`getNeighborList`) are not included.
+
+        :return: neighbor list
+        :rtype: :py:class:`freud.locality.NeighborList`
+        """
+        cdef NeighborList result = NeighborList()
+        result.refer_to(self.thisptr.getNList(), self)
+        return result
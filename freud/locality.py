@@ -7,6 +7,9 @@
 #
 
 # bring related c++ classes into the locality module
+from ._freud import NeighborList
 from ._freud import LinkCell
 from ._freud import IteratorLinkCell
+from ._freud import GhostCellList
+from ._freud import KdTree
 from ._freud import NearestNeighbors
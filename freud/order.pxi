@@ -6,6 +6,7 @@ from freud.util._VectorMath cimport quat
 from freud.util._Boost cimport shared_array
 cimport freud._box as _box
 cimport freud._order as order
+cimport freud._locality as locality
 from libcpp.complex cimport complex
 from libcpp.vector cimport vector
 from libcpp.map cimport map
@@ -785,11 +786,13 @@ cdef class LocalQl:
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, points):
+    def compute(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -798,13 +801,16 @@ cdef class LocalQl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        self.thisptr.compute(<vec3[float]*>l_points.data, nP, nlist_ptr)
 
-    def computeAve(self, points):
+    def computeAve(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -813,14 +819,17 @@ cdef class LocalQl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        self.thisptr.compute(<vec3[float]*>l_points.data, nP, nlist_ptr)
+        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP, nlist_ptr)
 
-    def computeNorm(self, points):
+    def computeNorm(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -829,14 +838,17 @@ cdef class LocalQl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        self.thisptr.compute(<vec3[float]*>l_points.data, nP, nlist_ptr)
         self.thisptr.computeNorm(<vec3[float]*>l_points.data, nP)
 
-    def computeAveNorm(self, points):
+    def computeAveNorm(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3 \\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -845,8 +857,9 @@ cdef class LocalQl:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
-        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        self.thisptr.compute(<vec3[float]*>l_points.data, nP, nlist_ptr)
+        self.thisptr.computeAve(<vec3[float]*>l_points.data, nP, nlist_ptr)
         self.thisptr.computeAveNorm(<vec3[float]*>l_points.data, nP)
 
     def getBox(self):
@@ -1543,11 +1556,13 @@ cdef class SolLiq:
     def __dealloc__(self):
         del self.thisptr
 
-    def compute(self, points):
+    def compute(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1556,13 +1571,16 @@ cdef class SolLiq:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.compute(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        self.thisptr.compute(<vec3[float]*>l_points.data, nP, nlist_ptr)
 
-    def computeSolLiqVariant(self, points):
+    def computeSolLiqVariant(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1571,13 +1589,16 @@ cdef class SolLiq:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.computeSolLiqVariant(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        self.thisptr.computeSolLiqVariant(<vec3[float]*>l_points.data, nP, nlist_ptr)
 
-    def computeSolLiqNoNorm(self, points):
+    def computeSolLiqNoNorm(self, points, nlist=None):
         """Compute the local rotationally invariant Ql order parameter.
 
         :param points: points to calculate the order parameter
+        :param nlist: neighbor list to use instead of building a cell list (optional)
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
         """
         points = freud.common.convert_array(points, 2, dtype=np.float32, contiguous=True,
             dim_message="points must be a 2 dimensional array")
@@ -1586,7 +1607,8 @@ cdef class SolLiq:
 
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        self.thisptr.computeSolLiqNoNorm(<vec3[float]*>l_points.data, nP)
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        self.thisptr.computeSolLiqNoNorm(<vec3[float]*>l_points.data, nP, nlist_ptr)
 
     def getBox(self):
         """
@@ -5,7 +5,11 @@ from freud.util._VectorMath cimport vec3
 from freud.util._VectorMath cimport quat
 cimport freud._box as _box
 cimport freud._pmft as pmft
+cimport freud._locality as locality
+cimport freud.util._ThreadLocalHistogram as histogram
 from libc.string cimport memcpy
+from libc.stdint cimport uint64_t
+from libcpp.vector cimport vector
 from cython.operator cimport dereference as deref
 import numpy as np
 cimport numpy as np
@@ -33,16 +37,21 @@ cdef class PMFTR12:
     :param n_r: number of bins in r
     :param n_t1: number of bins in t1
     :param n_t2: number of bins in t2
+    :param sparse: count into bricks of 16x16x16 bins that each thread only allocates where it adds to, instead of \
+        dense bins; for large numbers of bins that are mostly empty
     :type r_max: float
     :type n_r: unsigned int
     :type n_t1: unsigned int
     :type n_t2: unsigned int
+    :type sparse: bool
 
     """
     cdef pmft.PMFTR12 *thisptr
 
-    def __cinit__(self, r_max, n_r, n_t1, n_t2):
+    def __cinit__(self, r_max, n_r, n_t1, n_t2, sparse=False):
         self.thisptr = new pmft.PMFTR12(r_max, n_r, n_t1, n_t2)
+        if sparse:
+            self.thisptr.setSparse(True)
 
     def __dealloc__(self):
         del self.thisptr
@@ -62,7 +71,7 @@ cdef class PMFTR12:
         """
         self.thisptr.resetPCF()
 
-    def accumulate(self, box, ref_points, ref_orientations, points, orientations):
+    def accumulate(self, box, ref_points, ref_orientations, points, orientations, nlist=None, values=None):
         """
         Calculates the positional correlation function and adds to the current histogram.
 
@@ -71,11 +80,15 @@ cdef class PMFTR12:
         :param ref_orientations: angles of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: angles of particles to use in calculation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :param values: value of each point, summed over the pairs in each bin for the mean value at each position (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type values: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -100,6 +113,25 @@ cdef class PMFTR12:
         cdef unsigned int nRef = <unsigned int> ref_points.shape[0]
         cdef unsigned int nP = <unsigned int> points.shape[0]
         cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        cdef np.ndarray[float, ndim=1] l_values
+        if values is not None:
+            values = freud.common.convert_array(values, 1, dtype=np.float32, contiguous=True,
+                dim_message="values must be a 1 dimensional array")
+            if values.shape[0] != points.shape[0]:
+                raise ValueError("there must be a value for every point")
+            l_values = values
+            with nogil:
+                self.thisptr.accumulateWeighted(l_box,
+                                                <vec3[float]*>l_ref_points.data,
+                                                <float*>l_ref_orientations.data,
+                                                nRef,
+                                                <vec3[float]*>l_points.data,
+                                                <float*>l_orientations.data,
+                                                nP,
+                                                <float*>l_values.data,
+                                                nlist_ptr)
+            return
         with nogil:
             self.thisptr.accumulate(l_box,
                                     <vec3[float]*>l_ref_points.data,
@@ -107,9 +139,61 @@ cdef class PMFTR12:
                                     nRef,
                                     <vec3[float]*>l_points.data,
                                     <float*>l_orientations.data,
-                                    nP)
+                                    nP,
+                                    nlist_ptr)
+
+    def accumulateTrajectory(self, boxes, ref_points, ref_orientations, points, orientations):
+        """
+        Calculates the positional correlation function of every frame of a trajectory and adds it to the current
+        histogram. The cell list of each frame is built while the previous frame is binned, in a single call.
+
+        :param boxes: simulation box of each frame, or a single box for all frames
+        :param ref_points: reference points of each frame
+        :param ref_orientations: angles of the reference points of each frame
+        :param points: points of each frame
+        :param orientations: angles of the points of each frame
+        :type boxes: :py:class:`freud.box.Box` or list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3 or points.shape[2] != 3:
+            raise TypeError('ref_points and points should be FxNx3 arrays')
+        ref_orientations = freud.common.convert_array(ref_orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 2 dimensional array")
+        orientations = freud.common.convert_array(orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 2 dimensional array")
+        if ref_orientations.shape != ref_points.shape[:2] or orientations.shape != points.shape[:2]:
+            raise ValueError("there must be an orientation for every point of every frame")
+        if ref_points.shape[0] != points.shape[0]:
+            raise ValueError("ref_points and points must have the same number of frames")
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=2] l_orientations = orientations
+        cdef unsigned int nFrames = <unsigned int> points.shape[0]
+        cdef unsigned int nRef = <unsigned int> ref_points.shape[1]
+        cdef unsigned int nP = <unsigned int> points.shape[1]
+        cdef vector[_box.Box] l_boxes = _box_vector(boxes, nFrames)
+        if nFrames == 0:
+            return
+        with nogil:
+            self.thisptr.accumulateTrajectory(&l_boxes[0],
+                                              <vec3[float]*>l_ref_points.data,
+                                              <float*>l_ref_orientations.data,
+                                              nRef,
+                                              <vec3[float]*>l_points.data,
+                                              <float*>l_orientations.data,
+                                              nP,
+                                              nFrames)
+
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None, values=None):
         """
         Calculates the positional correlation function for the given points. Will overwrite the current histogram.
 
@@ -118,14 +202,18 @@ cdef class PMFTR12:
         :param ref_orientations: angles of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: angles of particles to use in calculation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :param values: value of each point, summed over the pairs in each bin for the mean value at each position (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type values: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         self.thisptr.resetPCF()
-        self.accumulate(box, ref_points, ref_orientations, points, orientations)
+        self.accumulate(box, ref_points, ref_orientations, points, orientations, nlist=nlist, values=values)
 
     def reducePCF(self):
         """
@@ -139,14 +227,59 @@ cdef class PMFTR12:
         Get the raw bin counts.
 
         :return: Bin Counts
-        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.uint32`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.uint64`
+        """
+        cdef uint64_t* bin_counts = self.thisptr.getBinCounts().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsT2()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsT1()
+        cdef np.ndarray[np.uint64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_UINT64, <void*>bin_counts)
+        return result
+
+    def getValueSums(self):
+        """
+        Get the sum of the values of the points of the pairs in each bin.
+
+        :return: Value sums
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.float64`
         """
-        cdef unsigned int* bin_counts = self.thisptr.getBinCounts().get()
+        cdef double* values = self.thisptr.getValueSums().get()
         cdef np.npy_intp nbins[3]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsT2()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsT1()
-        cdef np.ndarray[np.uint32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_UINT32, <void*>bin_counts)
+        cdef np.ndarray[np.float64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT64, <void*>values)
+        return result
+
+    def getValueSquareSums(self):
+        """
+        Get the sum of the squared values of the points of the pairs in each bin.
+
+        :return: Squared value sums
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.float64`
+        """
+        cdef double* values = self.thisptr.getValueSquareSums().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsT2()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsT1()
+        cdef np.ndarray[np.float64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT64, <void*>values)
+        return result
+
+    def getValueMean(self):
+        """
+        Get the mean value of the points of the pairs in each bin, 0 in empty bins.
+
+        :return: Mean values
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{r}, N_{\\theta1}, N_{\\theta2}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float* values = self.thisptr.getValueMean().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsR()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsT2()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsT1()
+        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>values)
         return result
 
     def getPCF(self):
@@ -289,17 +422,22 @@ cdef class PMFTXYT:
     :param n_x: number of bins in x
     :param n_y: number of bins in y
     :param n_t: number of bins in t
+    :param sparse: count into bricks of 16x16x16 bins that each thread only allocates where it adds to, instead of \
+        dense bins; for large numbers of bins that are mostly empty
     :type x_max: float
     :type y_max: float
     :type n_x: unsigned int
     :type n_y: unsigned int
     :type n_t: unsigned int
+    :type sparse: bool
 
     """
     cdef pmft.PMFTXYT *thisptr
 
-    def __cinit__(self, x_max, y_max, n_x, n_y, n_t):
+    def __cinit__(self, x_max, y_max, n_x, n_y, n_t, sparse=False):
         self.thisptr = new pmft.PMFTXYT(x_max, y_max, n_x, n_y, n_t)
+        if sparse:
+            self.thisptr.setSparse(True)
 
     def __dealloc__(self):
         del self.thisptr
@@ -319,7 +457,7 @@ cdef class PMFTXYT:
         """
         self.thisptr.resetPCF()
 
-    def accumulate(self, box, ref_points, ref_orientations, points, orientations):
+    def accumulate(self, box, ref_points, ref_orientations, points, orientations, nlist=None, values=None):
         """
         Calculates the positional correlation function and adds to the current histogram.
 
@@ -328,11 +466,15 @@ cdef class PMFTXYT:
         :param ref_orientations: angles of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: angles of particles to use in calculation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :param values: value of each point, summed over the pairs in each bin for the mean value at each position (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type values: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -357,6 +499,25 @@ cdef class PMFTXYT:
         cdef unsigned int nRef = <unsigned int> ref_points.shape[0]
         cdef unsigned int nP = <unsigned int> points.shape[0]
         cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        cdef np.ndarray[float, ndim=1] l_values
+        if values is not None:
+            values = freud.common.convert_array(values, 1, dtype=np.float32, contiguous=True,
+                dim_message="values must be a 1 dimensional array")
+            if values.shape[0] != points.shape[0]:
+                raise ValueError("there must be a value for every point")
+            l_values = values
+            with nogil:
+                self.thisptr.accumulateWeighted(l_box,
+                                                <vec3[float]*>l_ref_points.data,
+                                                <float*>l_ref_orientations.data,
+                                                nRef,
+                                                <vec3[float]*>l_points.data,
+                                                <float*>l_orientations.data,
+                                                nP,
+                                                <float*>l_values.data,
+                                                nlist_ptr)
+            return
         with nogil:
             self.thisptr.accumulate(l_box,
                                     <vec3[float]*>l_ref_points.data,
@@ -364,9 +525,61 @@ cdef class PMFTXYT:
                                     nRef,
                                     <vec3[float]*>l_points.data,
                                     <float*>l_orientations.data,
-                                    nP)
+                                    nP,
+                                    nlist_ptr)
+
+    def accumulateTrajectory(self, boxes, ref_points, ref_orientations, points, orientations):
+        """
+        Calculates the positional correlation function of every frame of a trajectory and adds it to the current
+        histogram. The cell list of each frame is built while the previous frame is binned, in a single call.
+
+        :param boxes: simulation box of each frame, or a single box for all frames
+        :param ref_points: reference points of each frame
+        :param ref_orientations: angles of the reference points of each frame
+        :param points: points of each frame
+        :param orientations: angles of the points of each frame
+        :type boxes: :py:class:`freud.box.Box` or list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3 or points.shape[2] != 3:
+            raise TypeError('ref_points and points should be FxNx3 arrays')
+        ref_orientations = freud.common.convert_array(ref_orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 2 dimensional array")
+        orientations = freud.common.convert_array(orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 2 dimensional array")
+        if ref_orientations.shape != ref_points.shape[:2] or orientations.shape != points.shape[:2]:
+            raise ValueError("there must be an orientation for every point of every frame")
+        if ref_points.shape[0] != points.shape[0]:
+            raise ValueError("ref_points and points must have the same number of frames")
+
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=2] l_orientations = orientations
+        cdef unsigned int nFrames = <unsigned int> points.shape[0]
+        cdef unsigned int nRef = <unsigned int> ref_points.shape[1]
+        cdef unsigned int nP = <unsigned int> points.shape[1]
+        cdef vector[_box.Box] l_boxes = _box_vector(boxes, nFrames)
+        if nFrames == 0:
+            return
+        with nogil:
+            self.thisptr.accumulateTrajectory(&l_boxes[0],
+                                              <vec3[float]*>l_ref_points.data,
+                                              <float*>l_ref_orientations.data,
+                                              nRef,
+                                              <vec3[float]*>l_points.data,
+                                              <float*>l_orientations.data,
+                                              nP,
+                                              nFrames)
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None, values=None):
         """
         Calculates the positional correlation function for the given points. Will overwrite the current histogram.
 
@@ -375,14 +588,18 @@ cdef class PMFTXYT:
         :param ref_orientations: angles of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: angles of particles to use in calculation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :param values: value of each point, summed over the pairs in each bin for the mean value at each position (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type values: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         self.thisptr.resetPCF()
-        self.accumulate(box, ref_points, ref_orientations, points, orientations)
+        self.accumulate(box, ref_points, ref_orientations, points, orientations, nlist=nlist, values=values)
 
     def reducePCF(self):
         """
@@ -396,14 +613,59 @@ cdef class PMFTXYT:
         Get the raw bin counts.
 
         :return: Bin Counts
-        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint32`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint64`
+        """
+        cdef uint64_t* bin_counts = self.thisptr.getBinCounts().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsT()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.uint64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_UINT64, <void*>bin_counts)
+        return result
+
+    def getValueSums(self):
+        """
+        Get the sum of the values of the points of the pairs in each bin.
+
+        :return: Value sums
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float64`
         """
-        cdef unsigned int* bin_counts = self.thisptr.getBinCounts().get()
+        cdef double* values = self.thisptr.getValueSums().get()
         cdef np.npy_intp nbins[3]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsT()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.uint32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_UINT32, <void*>bin_counts)
+        cdef np.ndarray[np.float64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT64, <void*>values)
+        return result
+
+    def getValueSquareSums(self):
+        """
+        Get the sum of the squared values of the points of the pairs in each bin.
+
+        :return: Squared value sums
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float64`
+        """
+        cdef double* values = self.thisptr.getValueSquareSums().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsT()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.float64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT64, <void*>values)
+        return result
+
+    def getValueMean(self):
+        """
+        Get the mean value of the points of the pairs in each bin, 0 in empty bins.
+
+        :return: Mean values
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{\\theta}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float* values = self.thisptr.getValueMean().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsT()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>values)
         return result
 
     def getPCF(self):
@@ -566,7 +828,30 @@ cdef class PMFTXY2D:
         """
         self.thisptr.resetPCF()
 
-    def accumulate(self, box, ref_points, ref_orientations, points, orientations):
+    def setHistogramMode(self, mode):
+        """Set how the threads count into the histogram, keeping the counts so far. By default each thread counts
+        into its own copy of the bins ('dense'), unless the copies of all threads would take more than 256 MB; then
+        all threads add to the totals with atomic operations ('atomic'). With 'sparse', a thread only allocates the
+        blocks of 4096 bins it adds to.
+
+        :param mode: 'dense', 'sparse' or 'atomic'
+        :type mode: str
+        """
+        if mode not in _histogram_modes:
+            raise ValueError('Unknown histogram mode: {}'.format(mode))
+        self.thisptr.setHistogramMode(_histogram_modes[mode])
+
+    def getHistogramMode(self):
+        """
+        :return: how the threads count into the histogram, see :py:meth:`freud.pmft.PMFTXY2D.setHistogramMode()`
+        :rtype: str
+        """
+        cdef histogram.HistogramMode mode = self.thisptr.getHistogramMode()
+        for name in _histogram_modes:
+            if _histogram_modes[name] == mode:
+                return name
+
+    def accumulate(self, box, ref_points, ref_orientations, points, orientations, nlist=None, values=None):
         """
         Calculates the positional correlation function and adds to the current histogram.
 
@@ -575,11 +860,15 @@ cdef class PMFTXY2D:
         :param ref_orientations: orientations of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: orientations of particles to use in calculation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :param values: value of each point, summed over the pairs in each bin for the mean value at each position (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type values: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -604,6 +893,25 @@ cdef class PMFTXY2D:
         cdef unsigned int n_ref = <unsigned int> ref_points.shape[0]
         cdef unsigned int n_p = <unsigned int> points.shape[0]
         cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        cdef np.ndarray[float, ndim=1] l_values
+        if values is not None:
+            values = freud.common.convert_array(values, 1, dtype=np.float32, contiguous=True,
+                dim_message="values must be a 1 dimensional array")
+            if values.shape[0] != points.shape[0]:
+                raise ValueError("there must be a value for every point")
+            l_values = values
+            with nogil:
+                self.thisptr.accumulateWeighted(l_box,
+                                                <vec3[float]*>l_ref_points.data,
+                                                <float*>l_ref_orientations.data,
+                                                n_ref,
+                                                <vec3[float]*>l_points.data,
+                                                <float*>l_orientations.data,
+                                                n_p,
+                                                <float*>l_values.data,
+                                                nlist_ptr)
+            return
         with nogil:
             self.thisptr.accumulate(l_box,
                                     <vec3[float]*>l_ref_points.data,
@@ -611,9 +919,61 @@ cdef class PMFTXY2D:
                                     n_ref,
                                     <vec3[float]*>l_points.data,
                                     <float*>l_orientations.data,
-                                    n_p)
+                                    n_p,
+                                    nlist_ptr)
+
+    def accumulateTrajectory(self, boxes, ref_points, ref_orientations, points, orientations):
+        """
+        Calculates the positional correlation function of every frame of a trajectory and adds it to the current
+        histogram. The cell list of each frame is built while the previous frame is binned, in a single call.
+
+        :param boxes: simulation box of each frame, or a single box for all frames
+        :param ref_points: reference points of each frame
+        :param ref_orientations: angles of the reference points of each frame
+        :param points: points of each frame
+        :param orientations: angles of the points of each frame
+        :type boxes: :py:class:`freud.box.Box` or list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3 or points.shape[2] != 3:
+            raise TypeError('ref_points and points should be FxNx3 arrays')
+        ref_orientations = freud.common.convert_array(ref_orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 2 dimensional array")
+        orientations = freud.common.convert_array(orientations, 2, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 2 dimensional array")
+        if ref_orientations.shape != ref_points.shape[:2] or orientations.shape != points.shape[:2]:
+            raise ValueError("there must be an orientation for every point of every frame")
+        if ref_points.shape[0] != points.shape[0]:
+            raise ValueError("ref_points and points must have the same number of frames")
+
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=2] l_orientations = orientations
+        cdef unsigned int nFrames = <unsigned int> points.shape[0]
+        cdef unsigned int nRef = <unsigned int> ref_points.shape[1]
+        cdef unsigned int nP = <unsigned int> points.shape[1]
+        cdef vector[_box.Box] l_boxes = _box_vector(boxes, nFrames)
+        if nFrames == 0:
+            return
+        with nogil:
+            self.thisptr.accumulateTrajectory(&l_boxes[0],
+                                              <vec3[float]*>l_ref_points.data,
+                                              <float*>l_ref_orientations.data,
+                                              nRef,
+                                              <vec3[float]*>l_points.data,
+                                              <float*>l_orientations.data,
+                                              nP,
+                                              nFrames)
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations):
+    def compute(self, box, ref_points, ref_orientations, points, orientations, nlist=None, values=None):
         """
         Calculates the positional correlation function for the given points. Will overwrite the current histogram.
 
@@ -622,14 +982,18 @@ cdef class PMFTXY2D:
         :param ref_orientations: orientations of reference points to use in calculation
         :param points: points to calculate the local density
         :param orientations: orientations of particles to use in calculation
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :param values: value of each point, summed over the pairs in each bin for the mean value at each position (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type values: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         self.thisptr.resetPCF()
-        self.accumulate(box, ref_points, ref_orientations, points, orientations)
+        self.accumulate(box, ref_points, ref_orientations, points, orientations, nlist=nlist, values=values)
 
     def reducePCF(self):
         """
@@ -666,13 +1030,55 @@ cdef class PMFTXY2D:
         Get the raw bin counts (non-normalized).
 
         :return: Bin Counts
-        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint32`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint64`
         """
-        cdef unsigned int* bin_counts = self.thisptr.getBinCounts().get()
+        cdef uint64_t* bin_counts = self.thisptr.getBinCounts().get()
         cdef np.npy_intp nbins[2]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.uint32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT32, <void*>bin_counts)
+        cdef np.ndarray[np.uint64_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_UINT64, <void*>bin_counts)
+        return result
+
+    def getValueSums(self):
+        """
+        Get the sum of the values of the points of the pairs in each bin.
+
+        :return: Value sums
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float64`
+        """
+        cdef double* values = self.thisptr.getValueSums().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.float64_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT64, <void*>values)
+        return result
+
+    def getValueSquareSums(self):
+        """
+        Get the sum of the squared values of the points of the pairs in each bin.
+
+        :return: Squared value sums
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float64`
+        """
+        cdef double* values = self.thisptr.getValueSquareSums().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.float64_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT64, <void*>values)
+        return result
+
+    def getValueMean(self):
+        """
+        Get the mean value of the points of the pairs in each bin, 0 in empty bins.
+
+        :return: Mean values
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float* values = self.thisptr.getValueMean().get()
+        cdef np.npy_intp nbins[2]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.float32_t, ndim=2] result = np.PyArray_SimpleNewFromData(2, nbins, np.NPY_FLOAT32, <void*>values)
         return result
 
     def getX(self):
@@ -763,17 +1169,28 @@ cdef class PMFTXYZ:
     :param n_x: number of bins in x
     :param n_y: number of bins in y
     :param n_z: number of bins in z
+    :param sparse: count into bricks of 16x16x16 bins that each thread only allocates where it adds to, instead of \
+        dense bins; for large numbers of bins that are mostly empty
+    :param n_blocks: keep the counts of up to this many (an even number, at least 4) consecutive blocks of frames, \
+        whose spread gives the standard error of the pcf (see :py:meth:`freud.pmft.PMFTXYZ.getPCFStandardError()`); \
+        0 to only keep the mean
     :type x_max: float
     :type y_max: float
     :type z_max: float
     :type n_x: unsigned int
     :type n_y: unsigned int
     :type n_z: unsigned int
+    :type sparse: bool
+    :type n_blocks: unsigned int
     """
     cdef pmft.PMFTXYZ *thisptr
 
-    def __cinit__(self, x_max, y_max, z_max, n_x, n_y, n_z):
+    def __cinit__(self, x_max, y_max, z_max, n_x, n_y, n_z, sparse=False, n_blocks=0):
         self.thisptr = new pmft.PMFTXYZ(x_max, y_max, z_max, n_x, n_y, n_z)
+        if sparse:
+            self.thisptr.setSparse(True)
+        if n_blocks:
+            self.thisptr.setNumBlocks(n_blocks)
 
     def __dealloc__(self):
         del self.thisptr
@@ -793,7 +1210,7 @@ cdef class PMFTXYZ:
         """
         self.thisptr.resetPCF()
 
-    def accumulate(self, box, ref_points, ref_orientations, points, orientations, face_orientations=None):
+    def accumulate(self, box, ref_points, ref_orientations, points, orientations, face_orientations=None, nlist=None, values=None):
         """
         Calculates the positional correlation function and adds to the current histogram.
 
@@ -805,7 +1222,10 @@ cdef class PMFTXYZ:
         :param face_orientations: Optional - orientations of particle faces to account for particle symmetry.
             * If not supplied by user, unit quaternions will be supplied.
             * If a 2D array of shape (:math:`N_f`, :math:`4`) is supplied, the supplied quaternions will be broadcast\
-                for all particles
+                for all particles. Bond vectors are then binned only once when every quaternion maps the bins onto\
+                themselves, e.g. the 24 rotations of a cube with the same bins in x, y, and z
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :param values: value of each point, summed over the pairs in each bin for the mean value at each position (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
@@ -813,6 +1233,8 @@ cdef class PMFTXYZ:
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
         :type face_orientations: :class:`numpy.ndarray`, shape= :math:`\\left( \\left(N_{particles}, \\right), N_{faces}, 4\\right)`, \
             dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type values: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         ref_points = freud.common.convert_array(ref_points, 2, dtype=np.float32, contiguous=True,
             dim_message="ref_points must be a 2 dimensional array")
@@ -837,8 +1259,8 @@ cdef class PMFTXYZ:
         # handle multiple ways to input
         if face_orientations is None:
             # set to unit quaternion q = [1,0,0,0]
-            face_orientations = np.zeros(shape=(ref_points.shape[0], 1, 4), dtype=np.float32)
-            face_orientations[:,:,0] = 1.0
+            face_orientations = np.zeros(shape=(1, 4), dtype=np.float32)
+            face_orientations[:,0] = 1.0
         else:
             if (len(face_orientations.shape) < 2) or (len(face_orientations.shape) > 3):
                 raise ValueError("points must be a 2 or 3 dimensional array")
@@ -847,10 +1269,6 @@ cdef class PMFTXYZ:
             if face_orientations.ndim == 2:
                 if face_orientations.shape[1] != 4:
                     raise ValueError("2nd dimension for orientations must have 4 values: s, x, y, z")
-                # need to broadcast into new array
-                tmp_face_orientations = np.zeros(shape=(ref_points.shape[0], face_orientations.shape[0], face_orientations.shape[1]), dtype=np.float32)
-                tmp_face_orientations[:] = face_orientations
-                face_orientations = tmp_face_orientations
             else:
                 if face_orientations.shape[2] != 4:
                     raise ValueError("2nd dimension for orientations must have 4 values: s, x, y, z")
@@ -859,11 +1277,47 @@ cdef class PMFTXYZ:
         cdef np.ndarray[float, ndim=2] l_points = points
         cdef np.ndarray[float, ndim=2] l_ref_orientations = ref_orientations
         cdef np.ndarray[float, ndim=2] l_orientations = orientations
-        cdef np.ndarray[float, ndim=3] l_face_orientations = face_orientations
+        cdef np.ndarray l_face_orientations = face_orientations
+        cdef bint shared_faces = face_orientations.ndim == 2
         cdef unsigned int nRef = <unsigned int> ref_points.shape[0]
         cdef unsigned int nP = <unsigned int> points.shape[0]
-        cdef unsigned int nFaces = <unsigned int> face_orientations.shape[1]
+        cdef unsigned int nFaces = <unsigned int> face_orientations.shape[face_orientations.ndim - 2]
         cdef _box.Box l_box = _box.Box(box.getLx(), box.getLy(), box.getLz(), box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ(), box.is2D())
+        cdef locality.NeighborList *nlist_ptr = _nlist_ptr(nlist)
+        cdef np.ndarray[float, ndim=1] l_values
+        if values is not None:
+            values = freud.common.convert_array(values, 1, dtype=np.float32, contiguous=True,
+                dim_message="values must be a 1 dimensional array")
+            if values.shape[0] != points.shape[0]:
+                raise ValueError("there must be a value for every point")
+            l_values = values
+            with nogil:
+                self.thisptr.accumulateWeighted(l_box,
+                                                <vec3[float]*>l_ref_points.data,
+                                                <quat[float]*>l_ref_orientations.data,
+                                                nRef,
+                                                <vec3[float]*>l_points.data,
+                                                <quat[float]*>l_orientations.data,
+                                                nP,
+                                                <quat[float]*>l_face_orientations.data,
+                                                nFaces,
+                                                not shared_faces,
+                                                <float*>l_values.data,
+                                                nlist_ptr)
+            return
+        if shared_faces:
+            with nogil:
+                self.thisptr.accumulateSymmetric(l_box,
+                                                 <vec3[float]*>l_ref_points.data,
+                                                 <quat[float]*>l_ref_orientations.data,
+                                                 nRef,
+                                                 <vec3[float]*>l_points.data,
+                                                 <quat[float]*>l_orientations.data,
+                                                 nP,
+                                                 <quat[float]*>l_face_orientations.data,
+                                                 nFaces,
+                                                 nlist_ptr)
+            return
         with nogil:
             self.thisptr.accumulate(l_box,
                                     <vec3[float]*>l_ref_points.data,
@@ -873,9 +1327,83 @@ cdef class PMFTXYZ:
                                     <quat[float]*>l_orientations.data,
                                     nP,
                                     <quat[float]*>l_face_orientations.data,
-                                    nFaces)
+                                    nFaces,
+                                    nlist_ptr)
+
+    def accumulateTrajectory(self, boxes, ref_points, ref_orientations, points, orientations, face_orientations=None):
+        """
+        Calculates the positional correlation function of every frame of a trajectory and adds it to the current
+        histogram. The cell list of each frame is built while the previous frame is binned, in a single call.
+
+        :param boxes: simulation box of each frame, or a single box for all frames
+        :param ref_points: reference points of each frame
+        :param ref_orientations: orientations of the reference points of each frame
+        :param points: points of each frame
+        :param orientations: orientations of the points of each frame
+        :param face_orientations: Optional - orientations of particle faces, the same in every frame, as for \
+            :py:meth:`accumulate()`
+        :type boxes: :py:class:`freud.box.Box` or list of :py:class:`freud.box.Box`
+        :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
+        :type points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
+        :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{frames}, N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
+        :type face_orientations: :class:`numpy.ndarray`, shape= :math:`\\left( \\left(N_{particles}, \\right), N_{faces}, 4\\right)`, \
+            dtype= :class:`numpy.float32`
+        """
+        ref_points = freud.common.convert_array(ref_points, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_points must be a 3 dimensional array")
+        points = freud.common.convert_array(points, 3, dtype=np.float32, contiguous=True,
+            dim_message="points must be a 3 dimensional array")
+        if ref_points.shape[2] != 3 or points.shape[2] != 3:
+            raise TypeError('ref_points and points should be FxNx3 arrays')
+        ref_orientations = freud.common.convert_array(ref_orientations, 3, dtype=np.float32, contiguous=True,
+            dim_message="ref_orientations must be a 3 dimensional array")
+        orientations = freud.common.convert_array(orientations, 3, dtype=np.float32, contiguous=True,
+            dim_message="orientations must be a 3 dimensional array")
+        if ref_orientations.shape != ref_points.shape[:2] + (4,) or orientations.shape != points.shape[:2] + (4,):
+            raise ValueError("there must be a quaternion q0, q1, q2, q3 for every point of every frame")
+        if ref_points.shape[0] != points.shape[0]:
+            raise ValueError("ref_points and points must have the same number of frames")
 
-    def compute(self, box, ref_points, ref_orientations, points, orientations, face_orientations):
+        if face_orientations is None:
+            face_orientations = np.zeros(shape=(1, 4), dtype=np.float32)
+            face_orientations[:,0] = 1.0
+        if (len(face_orientations.shape) < 2) or (len(face_orientations.shape) > 3):
+            raise ValueError("face_orientations must be a 2 or 3 dimensional array")
+        face_orientations = freud.common.convert_array(face_orientations, face_orientations.ndim, dtype=np.float32, contiguous=True,
+            dim_message="face_orientations must be a {} dimensional array".format(face_orientations.ndim))
+        if face_orientations.shape[-1] != 4:
+            raise ValueError("last dimension for face_orientations must have 4 values: s, x, y, z")
+        if face_orientations.ndim == 3 and face_orientations.shape[0] != ref_points.shape[1]:
+            raise ValueError("3 dimensional face_orientations must have the orientations of each reference point")
+
+        cdef np.ndarray[float, ndim=3] l_ref_points = ref_points
+        cdef np.ndarray[float, ndim=3] l_points = points
+        cdef np.ndarray[float, ndim=3] l_ref_orientations = ref_orientations
+        cdef np.ndarray[float, ndim=3] l_orientations = orientations
+        cdef np.ndarray l_face_orientations = face_orientations
+        cdef bint per_reference = face_orientations.ndim == 3
+        cdef unsigned int nFrames = <unsigned int> points.shape[0]
+        cdef unsigned int nRef = <unsigned int> ref_points.shape[1]
+        cdef unsigned int nP = <unsigned int> points.shape[1]
+        cdef unsigned int nFaces = <unsigned int> face_orientations.shape[face_orientations.ndim - 2]
+        cdef vector[_box.Box] l_boxes = _box_vector(boxes, nFrames)
+        if nFrames == 0:
+            return
+        with nogil:
+            self.thisptr.accumulateTrajectory(&l_boxes[0],
+                                              <vec3[float]*>l_ref_points.data,
+                                              <quat[float]*>l_ref_orientations.data,
+                                              nRef,
+                                              <vec3[float]*>l_points.data,
+                                              <quat[float]*>l_orientations.data,
+                                              nP,
+                                              nFrames,
+                                              <quat[float]*>l_face_orientations.data,
+                                              nFaces,
+                                              per_reference)
+
+    def compute(self, box, ref_points, ref_orientations, points, orientations, face_orientations, nlist=None, values=None):
         """
         Calculates the positional correlation function for the given points. Will overwrite the current histogram.
 
@@ -885,6 +1413,8 @@ cdef class PMFTXYZ:
         :param points: points to calculate the local density
         :param orientations: orientations of particles to use in calculation
         :param face_orientations: orientations of particle faces to account for particle symmetry
+        :param nlist: neighbor list to use instead of building a cell list (optional)
+        :param values: value of each point, summed over the pairs in each bin for the mean value at each position (optional)
         :type box: :py:class:`freud.box.Box`
         :type ref_points: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 3\\right)`, dtype= :class:`numpy.float32`
         :type ref_orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
@@ -892,9 +1422,11 @@ cdef class PMFTXYZ:
         :type orientations: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}, 4\\right)`, dtype= :class:`numpy.float32`
         :type face_orientations: :class:`numpy.ndarray`, shape= :math:`\\left( \\left(N_{particles}, \\right), N_{faces}, 4\\right)`, \
             dtype= :class:`numpy.float32`
+        :type nlist: :py:class:`freud.locality.NeighborList`
+        :type values: :class:`numpy.ndarray`, shape= :math:`\\left(N_{particles}\\right)`, dtype= :class:`numpy.float32`
         """
         self.thisptr.resetPCF()
-        self.accumulate(box, ref_points, ref_orientations, points, orientations, face_orientations)
+        self.accumulate(box, ref_points, ref_orientations, points, orientations, face_orientations, nlist=nlist, values=values)
 
     def reducePCF(self):
         """
@@ -908,14 +1440,59 @@ cdef class PMFTXYZ:
         Get the raw bin counts.
 
         :return: Bin Counts
-        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint32`
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.uint64`
+        """
+        cdef uint64_t* bin_counts = self.thisptr.getBinCounts().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsZ()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.uint64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_UINT64, <void*>bin_counts)
+        return result
+
+    def getValueSums(self):
+        """
+        Get the sum of the values of the points of the pairs in each bin.
+
+        :return: Value sums
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float64`
         """
-        cdef unsigned int* bin_counts = self.thisptr.getBinCounts().get()
+        cdef double* values = self.thisptr.getValueSums().get()
         cdef np.npy_intp nbins[3]
         nbins[0] = <np.npy_intp>self.thisptr.getNBinsZ()
         nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
         nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
-        cdef np.ndarray[np.uint32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_UINT32, <void*>bin_counts)
+        cdef np.ndarray[np.float64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT64, <void*>values)
+        return result
+
+    def getValueSquareSums(self):
+        """
+        Get the sum of the squared values of the points of the pairs in each bin.
+
+        :return: Squared value sums
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float64`
+        """
+        cdef double* values = self.thisptr.getValueSquareSums().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsZ()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.float64_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT64, <void*>values)
+        return result
+
+    def getValueMean(self):
+        """
+        Get the mean value of the points of the pairs in each bin, 0 in empty bins.
+
+        :return: Mean values
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float* values = self.thisptr.getValueMean().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsZ()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>values)
         return result
 
     def getPCF(self):
@@ -942,6 +1519,24 @@ cdef class PMFTXYZ:
         """
         return -np.log(np.copy(self.getPCF()))
 
+    def getPCFStandardError(self):
+        """
+        Get the standard error of the positional correlation function, from the spread of the pcf of the blocks of
+        frames. The frames are split into consecutive blocks of equal length, which double in length whenever all
+        n_blocks are complete, and the frames after the last complete block are not included. NaN until 2 blocks are
+        complete.
+
+        :return: standard error of the PCF
+        :rtype: :class:`numpy.ndarray`, shape= :math:`\\left(N_{z}, N_{y}, N_{x}\\right)`, dtype= :class:`numpy.float32`
+        """
+        cdef float* pcf_error = self.thisptr.getPCFStandardError().get()
+        cdef np.npy_intp nbins[3]
+        nbins[0] = <np.npy_intp>self.thisptr.getNBinsZ()
+        nbins[1] = <np.npy_intp>self.thisptr.getNBinsY()
+        nbins[2] = <np.npy_intp>self.thisptr.getNBinsX()
+        cdef np.ndarray[np.float32_t, ndim=3] result = np.PyArray_SimpleNewFromData(3, nbins, np.NPY_FLOAT32, <void*>pcf_error)
+        return result
+
     def getX(self):
         """
         Get the array of x-values for the PCF histogram
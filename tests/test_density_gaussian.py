@@ -25,5 +25,53 @@ class TestDensity(unittest.TestCase):
         myDiff = fftshift(myDiff)[:,:]
         npt.assert_equal(np.where(myDiff==np.max(myDiff)), (np.array([50]), np.array([50])))
 
+    def test_separable_matches_direct(self):
+        width = 32
+        rcut = 1.5
+        sigma = 0.5
+        box_size = 10.0
+        np.random.seed(0)
+        points = np.random.uniform(-box_size/2, box_size/2, (500, 3)).astype(np.float32)
+        testBox = box.Box.cube(box_size)
+        direct = density.GaussianDensity(width, rcut, sigma)
+        direct.compute(testBox, points)
+        separable = density.GaussianDensity(width, rcut, sigma, method='separable')
+        separable.compute(testBox, points)
+        npt.assert_allclose(separable.getGaussianDensity(), direct.getGaussianDensity(), rtol=1e-4, atol=1e-5)
+
+    def test_fft_matches_direct(self):
+        width = 32
+        sigma = 1.5
+        rcut = 4*sigma
+        box_size = 16.0
+        np.random.seed(0)
+        points = np.random.uniform(-box_size/2, box_size/2, (500, 3)).astype(np.float32)
+        points[:,2] = 0
+        testBox = box.Box.square(box_size)
+        direct = density.GaussianDensity(width, rcut, sigma)
+        direct.compute(testBox, points)
+        fft_density = density.GaussianDensity(width, rcut, sigma, method='fft')
+        fft_density.compute(testBox, points)
+        result = direct.getGaussianDensity()
+        npt.assert_allclose(fft_density.getGaussianDensity(), result, atol=1e-2*np.max(result))
+
+    def test_tilted_box(self):
+        np.random.seed(0)
+        points = np.random.uniform(-4, 4, (100, 3)).astype(np.float32)
+        tilted = box.Box(Lx=10, Ly=10, Lz=10, xy=0.3, xz=0, yz=0, is2D=False)
+        for method in ['separable', 'fft']:
+            gd = density.GaussianDensity(16, 1.5, 0.5, method=method)
+            with self.assertRaises(ValueError):
+                gd.compute(tilted, points)
+            # an orthorhombic box is fine
+            gd.compute(box.Box.cube(10), points)
+        direct = density.GaussianDensity(16, 1.5, 0.5)
+        direct.compute(tilted, points)
+        self.assertGreater(np.sum(direct.getGaussianDensity()), 0)
+
+    def test_unknown_method(self):
+        with self.assertRaises(ValueError):
+            density.GaussianDensity(32, 1.0, 0.5, method='spline')
+
 if __name__ == '__main__':
     unittest.main()
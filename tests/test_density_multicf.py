@@ -0,0 +1,59 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, density, locality
+import unittest
+
+class TestMultiCF(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+
+    def test_matches_single_channels(self):
+        rmax = 3.0
+        dr = 0.5
+        box_size = 12.0
+        num_channels = 3
+        fbox = box.Box.cube(box_size)
+        points = np.random.uniform(-box_size/2, box_size/2, (500, 3)).astype(np.float32)
+        values = np.random.uniform(-1, 1, (len(points), num_channels))
+
+        mcf = density.FloatMultiCF(rmax, dr, num_channels)
+        mcf.compute(fbox, points, values, points, values)
+        result = mcf.getRDF()
+        self.assertEqual(result.shape, (int(rmax/dr), num_channels))
+
+        for c in range(num_channels):
+            cf = density.FloatCF(rmax, dr)
+            channel = np.ascontiguousarray(values[:, c])
+            cf.compute(fbox, points, channel, points, channel)
+            npt.assert_allclose(result[:, c], cf.getRDF(), rtol=1e-5, atol=1e-8)
+            npt.assert_equal(mcf.getCounts(), cf.getCounts())
+
+    def test_complex_nlist(self):
+        rmax = 2.0
+        dr = 0.25
+        box_size = 10.0
+        num_channels = 2
+        fbox = box.Box.square(box_size)
+        points = np.random.uniform(-box_size/2, box_size/2, (400, 3)).astype(np.float32)
+        points[:, 2] = 0
+        angles = np.random.uniform(0, 2*np.pi, (len(points), num_channels))
+        values = np.exp(1j*angles)
+
+        mcf = density.ComplexMultiCF(rmax, dr, num_channels)
+        mcf.compute(fbox, points, values, points, np.conj(values))
+        nlist = locality.LinkCell(fbox, rmax).compute(fbox, points, points).getNList()
+        mcf_nlist = density.ComplexMultiCF(rmax, dr, num_channels)
+        mcf_nlist.compute(fbox, points, values, points, np.conj(values), nlist=nlist)
+
+        npt.assert_allclose(mcf.getRDF(), mcf_nlist.getRDF(), atol=1e-6)
+        npt.assert_equal(mcf.getCounts(), mcf_nlist.getCounts())
+
+    def test_bad_shape(self):
+        fbox = box.Box.cube(10)
+        points = np.zeros((4, 3), dtype=np.float32)
+        mcf = density.FloatMultiCF(3.0, 0.5, 2)
+        with self.assertRaises(ValueError):
+            mcf.compute(fbox, points, np.zeros((4, 3)), points, np.zeros((4, 3)))
+
+if __name__ == '__main__':
+    unittest.main()
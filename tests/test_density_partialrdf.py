@@ -0,0 +1,60 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, density
+import unittest
+
+class TestPartialRDF(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+
+    def test_single_type(self):
+        rmax = 3.0
+        dr = 0.1
+        box_size = 10.0
+        points = np.random.uniform(-box_size/2, box_size/2, (1000, 3)).astype(np.float32)
+        fbox = box.Box.cube(box_size)
+        types = np.zeros(len(points), dtype=np.uint32)
+
+        prdf = density.PartialRDF(rmax, dr, 1)
+        prdf.compute(fbox, points, types)
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points)
+
+        npt.assert_allclose(prdf.getRDF()[0, 0], rdf.getRDF(), rtol=1e-4, atol=1e-6)
+        npt.assert_allclose(prdf.getNr()[0, 0], rdf.getNr(), rtol=1e-4, atol=1e-4)
+
+    def test_brute_force(self):
+        rmax = 3.0
+        dr = 0.5
+        box_size = 10.0
+        num_types = 3
+        points = np.random.uniform(-box_size/2, box_size/2, (400, 3)).astype(np.float32)
+        fbox = box.Box.cube(box_size)
+        types = np.random.randint(0, num_types, len(points)).astype(np.uint32)
+
+        prdf = density.PartialRDF(rmax, dr, num_types)
+        prdf.compute(fbox, points, types)
+        g = prdf.getRDF()
+        self.assertEqual(g.shape, (num_types, num_types, int(rmax/dr)))
+
+        delta = points[np.newaxis, :, :] - points[:, np.newaxis, :]
+        delta -= box_size*np.round(delta/box_size)
+        r = np.sqrt(np.sum(delta**2, axis=-1))
+        np.fill_diagonal(r, np.inf)
+        edges = np.arange(0, rmax + dr/2, dr)
+        volumes = 4.0/3.0*np.pi*(edges[1:]**3 - edges[:-1]**3)
+        for a in range(num_types):
+            for b in range(num_types):
+                counts = np.histogram(r[types == a][:, types == b], bins=edges)[0]
+                expected = counts / np.sum(types == a) / volumes / (np.sum(types == b) / box_size**3)
+                npt.assert_allclose(g[a, b, 1:], expected[1:], rtol=1e-4, atol=1e-5)
+
+    def test_bad_type(self):
+        fbox = box.Box.cube(10)
+        points = np.zeros((2, 3), dtype=np.float32)
+        prdf = density.PartialRDF(3.0, 0.1, 2)
+        with self.assertRaises(ValueError):
+            prdf.compute(fbox, points, np.array([0, 2], dtype=np.uint32))
+
+if __name__ == '__main__':
+    unittest.main()
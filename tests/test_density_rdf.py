@@ -1,6 +1,6 @@
 import numpy as np
 import numpy.testing as npt
-from freud import box, density
+from freud import box, density, parallel
 import unittest
 
 class TestR(unittest.TestCase):
@@ -35,5 +35,132 @@ class TestRDF(unittest.TestCase):
         absolute_tolerance = 0.1
         npt.assert_allclose(rdf.getRDF(), correct, atol=absolute_tolerance)
 
+    def test_symmetric(self):
+        # passing the same array twice visits each pair once; a copy takes the full traversal
+        rmax = 3.0
+        dr = 0.1
+        num_points = 2000
+        box_size = rmax*4.1
+        points = np.random.random_sample((num_points,3)).astype(np.float32)*box_size - box_size/2
+        rdf_self = density.RDF(rmax, dr)
+        rdf_self.compute(box.Box.cube(box_size), points, points)
+        rdf_full = density.RDF(rmax, dr)
+        rdf_full.compute(box.Box.cube(box_size), points, points.copy())
+
+        npt.assert_allclose(rdf_self.getRDF(), rdf_full.getRDF(), rtol=1e-5)
+        npt.assert_allclose(rdf_self.getNr(), rdf_full.getNr(), rtol=1e-5)
+
+    def test_streaming(self):
+        # reading g(r) between frames must not change the accumulated result
+        rmax = 3.0
+        dr = 0.1
+        box_size = rmax*4.1
+        fbox = box.Box.cube(box_size)
+        frames = [np.random.random_sample((1000,3)).astype(np.float32)*box_size - box_size/2 for _ in range(3)]
+        rdf_polled = density.RDF(rmax, dr)
+        rdf_once = density.RDF(rmax, dr)
+        for points in frames:
+            rdf_polled.accumulate(fbox, points, points)
+            first = np.copy(rdf_polled.getRDF())
+            npt.assert_equal(rdf_polled.getRDF(), first)
+            rdf_polled.getNr()
+            rdf_once.accumulate(fbox, points, points)
+
+        npt.assert_allclose(rdf_polled.getRDF(), rdf_once.getRDF(), rtol=1e-6)
+        npt.assert_allclose(rdf_polled.getNr(), rdf_once.getNr(), rtol=1e-6)
+
+        rdf_polled.resetRDF()
+        rdf_polled.accumulate(fbox, frames[0], frames[0])
+        rdf_single = density.RDF(rmax, dr)
+        rdf_single.accumulate(fbox, frames[0], frames[0])
+        npt.assert_allclose(rdf_polled.getRDF(), rdf_single.getRDF(), rtol=1e-6)
+
+    def test_trajectory(self):
+        # one call over all frames must match accumulating the frames one at a time
+        rmax = 3.0
+        dr = 0.1
+        box_size = rmax*4.1
+        frames = np.random.random_sample((3, 1000, 3)).astype(np.float32)*box_size - box_size/2
+        boxes = [box.Box.cube(box_size*(1 + 0.05*f)) for f in range(len(frames))]
+        rdf_frames = density.RDF(rmax, dr)
+        for f in range(len(frames)):
+            rdf_frames.accumulate(boxes[f], frames[f], frames[f])
+        rdf_trajectory = density.RDF(rmax, dr)
+        rdf_trajectory.accumulateTrajectory(boxes, frames, frames)
+        npt.assert_allclose(rdf_trajectory.getRDF(), rdf_frames.getRDF(), rtol=1e-6)
+        npt.assert_allclose(rdf_trajectory.getNr(), rdf_frames.getNr(), rtol=1e-6)
+
+    def test_standard_error(self):
+        # 6 frames in 4 blocks: the first 4 frames merge into 2 blocks of 2 frames, then frames 5 and 6 make a third
+        rmax = 3.0
+        dr = 0.1
+        box_size = rmax*4.1
+        fbox = box.Box.cube(box_size)
+        frames = np.random.random_sample((6, 500, 3)).astype(np.float32)*box_size - box_size/2
+        rdf = density.RDF(rmax, dr, n_blocks=4)
+        frame_rdfs = []
+        for f in range(len(frames)):
+            rdf.accumulate(fbox, frames[f], frames[f])
+            frame_rdf = density.RDF(rmax, dr)
+            frame_rdf.accumulate(fbox, frames[f], frames[f])
+            frame_rdfs.append(np.copy(frame_rdf.getRDF()))
+        block_rdfs = np.array(frame_rdfs).reshape(3, 2, -1).mean(axis=1)
+        correct = np.std(block_rdfs, axis=0, ddof=1)/np.sqrt(3)
+        npt.assert_allclose(rdf.getRDFStandardError(), correct, rtol=1e-4, atol=1e-6)
+
+    def test_standard_error_blocks(self):
+        rdf = density.RDF(3.0, 0.1, n_blocks=4)
+        points = np.random.random_sample((100, 3)).astype(np.float32)*10 - 5
+        rdf.accumulate(box.Box.cube(10), points, points)
+        self.assertTrue(np.all(np.isnan(rdf.getRDFStandardError())))
+        self.assertRaises(ValueError, density.RDF, 3.0, 0.1, n_blocks=3)
+        self.assertRaises(ValueError, density.RDF(3.0, 0.1).getRDFStandardError)
+
+class TestRDFHistogramModes(unittest.TestCase):
+    # 10000 bins make two full tiles of 4096 bins and a partial last one; with several threads the thread bins
+    # are added together pairwise when they are flushed
+    def setUp(self):
+        np.random.seed(0)
+        parallel.setNumThreads(4)
+        self.rmax = 10.0
+        self.dr = 0.001
+        self.box_size = self.rmax*2.5
+        self.frames = np.random.random_sample((3, 2000, 3)).astype(np.float32)*self.box_size - self.box_size/2
+
+    def tearDown(self):
+        parallel.setNumThreads()
+
+    def accumulate(self, rdf):
+        fbox = box.Box.cube(self.box_size)
+        for points in self.frames:
+            rdf.accumulate(fbox, points, points)
+
+    def test_modes(self):
+        dense = density.RDF(self.rmax, self.dr)
+        dense.setHistogramMode('dense')
+        self.accumulate(dense)
+        self.assertGreater(np.sum(dense.getNr()), 0)
+        for mode in ['sparse', 'atomic']:
+            rdf = density.RDF(self.rmax, self.dr)
+            rdf.setHistogramMode(mode)
+            self.assertEqual(rdf.getHistogramMode(), mode)
+            self.accumulate(rdf)
+            npt.assert_equal(rdf.getRDF(), dense.getRDF())
+            npt.assert_equal(rdf.getNr(), dense.getNr())
+
+    def test_switch_modes(self):
+        # changing the mode between frames keeps the counts of the earlier frames
+        dense = density.RDF(self.rmax, self.dr)
+        dense.setHistogramMode('dense')
+        self.accumulate(dense)
+        rdf = density.RDF(self.rmax, self.dr)
+        fbox = box.Box.cube(self.box_size)
+        for mode, points in zip(['sparse', 'atomic', 'dense'], self.frames):
+            rdf.setHistogramMode(mode)
+            rdf.accumulate(fbox, points, points)
+        npt.assert_equal(rdf.getRDF(), dense.getRDF())
+        npt.assert_equal(rdf.getNr(), dense.getNr())
+        self.assertRaises(ValueError, rdf.setHistogramMode, 'tiled')
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,106 @@
+import numpy as np
+import numpy.testing as npt
+from freud import kspace
+import unittest
+
+class TestFTdeltaView(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+        self.K = np.random.uniform(-2, 2, (40, 3)).astype(np.float32)
+        self.position = np.random.uniform(-5, 5, (300, 3)).astype(np.float32)
+        self.orientation = np.zeros((len(self.position), 4), dtype=np.float32)
+        self.orientation[:, 0] = 1
+
+    def test_matches_copy(self):
+        for FT in (kspace._FTdelta, kspace._FTsphere):
+            ft = FT()
+            ft.set_K(self.K)
+            ft.set_rq(self.position, self.orientation)
+            ft.compute()
+            expected = ft.getFT().copy()
+
+            out = np.empty(len(self.K), dtype=np.complex64)
+            result = FT().compute_view(self.K, self.position, self.orientation, out=out)
+            self.assertIs(result, out)
+            npt.assert_allclose(out, expected, rtol=1e-5, atol=1e-4)
+
+    def test_direct_sum(self):
+        ft = kspace._FTdelta()
+        result = ft.compute_view(self.K, self.position)
+        expected = np.exp(-1j*self.K.astype(np.float64).dot(self.position.T.astype(np.float64))).sum(axis=1)
+        npt.assert_allclose(result, expected, rtol=1e-4, atol=1e-3)
+
+    def test_keeps_stored_arrays(self):
+        ft = kspace._FTdelta()
+        ft.set_K(self.K)
+        ft.set_rq(self.position, self.orientation)
+        ft.compute()
+        expected = ft.getFT().copy()
+        ft.compute_view(self.K[:5], self.position[:10], self.orientation[:10])
+        npt.assert_equal(ft.getFT(), expected)
+        ft.compute()
+        npt.assert_allclose(ft.getFT(), expected)
+
+    def test_bad_out(self):
+        ft = kspace._FTdelta()
+        with self.assertRaises(TypeError):
+            ft.compute_view(self.K, self.position, out=np.empty(len(self.K), dtype=np.complex128))
+
+class TestFTDirectSum(unittest.TestCase):
+    """Compare the polynomial sin/cos sums of FTdelta and FTsphere with numpy. With K along x and the particles on
+    the x axis, K.r is a single float product, so the reference sees exactly the argument the kernel reduces, and
+    every particle may contribute an error of at most 1e-5."""
+    def setUp(self):
+        np.random.seed(0)
+        self.Np = 64
+        self.tol = 1e-5*self.Np
+        # |K.r| up to 1e5, where the range reduction of the argument dominates the error
+        self.K = np.zeros((200, 3), dtype=np.float32)
+        self.K[:, 0] = np.random.uniform(-1000, 1000, len(self.K))
+        self.K[:10, 0] = [0, 1e-3, -1e-3, np.pi/4, np.pi/2, np.pi, 3*np.pi/2, 2*np.pi, 999.5, -999.5]
+        self.position = np.zeros((self.Np, 3), dtype=np.float32)
+        self.position[:, 0] = np.random.uniform(-100, 100, self.Np)
+        phase = (self.K[:, np.newaxis, 0]*self.position[np.newaxis, :, 0]).astype(np.float64)
+        self.S = np.exp(-1j*phase).sum(axis=1)
+
+    def test_delta(self):
+        result = kspace._FTdelta().compute_view(self.K, self.position)
+        npt.assert_allclose(result, self.S, rtol=0, atol=self.tol)
+
+    def test_delta_density(self):
+        density = 0.5 - 2j
+        ft = kspace._FTdelta()
+        ft.set_density(density)
+        result = ft.compute_view(self.K, self.position)
+        npt.assert_allclose(result, density*self.S, rtol=0, atol=abs(density)*self.tol)
+
+    def test_sphere(self):
+        radius = 0.7
+        # the single precision form factor cancels badly for 0 < |K|R << 1, which is not what is tested here
+        keep = (self.K[:, 0] == 0) | (np.abs(self.K[:, 0]) > 0.5)
+        ft = kspace._FTsphere()
+        ft.set_radius(radius)
+        result = ft.compute_view(self.K[keep], self.position)
+
+        K = np.abs(self.K[keep, 0].astype(np.float64))
+        f = np.empty(len(K))
+        scale = np.empty(len(K))
+        f[K == 0] = scale[K == 0] = 4*np.pi*radius**3/3
+        KR = K[K > 0]*radius
+        scale[K > 0] = 4*np.pi*radius/K[K > 0]**2
+        f[K > 0] = scale[K > 0]*(np.sin(KR)/KR - np.cos(KR))
+        # |f| <= 2*scale, and the form factor itself is evaluated in single precision
+        S = self.S[keep]
+        bound = scale*(2*self.tol + 1e-5*np.abs(S))
+        self.assertTrue(np.all(np.abs(result - f*S) <= bound))
+
+    def test_general_directions(self):
+        # K and r in general directions with |K.r| up to ~500; the single precision dot product sets the error
+        K = np.random.uniform(-5, 5, (100, 3)).astype(np.float32)
+        position = np.random.uniform(-30, 30, (self.Np, 3)).astype(np.float32)
+        expected = np.exp(-1j*K.astype(np.float64).dot(position.T.astype(np.float64))).sum(axis=1)
+        result = kspace._FTdelta().compute_view(K, position)
+        npt.assert_allclose(result, expected, rtol=0, atol=1e-4*self.Np)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,60 @@
+import numpy as np
+import numpy.testing as npt
+from freud import kspace
+import unittest
+
+def cube_params():
+    # unit cube, facets counterclockwise seen from outside
+    verts = np.array([[x, y, z] for z in (-0.5, 0.5) for y in (-0.5, 0.5) for x in (-0.5, 0.5)], dtype=np.float32)
+    facets = np.array([[0, 2, 3, 1], [4, 5, 7, 6], [0, 1, 5, 4], [2, 6, 7, 3], [0, 4, 6, 2], [1, 3, 7, 5]],
+                      dtype=np.uint32)
+    norms = np.array([[0, 0, -1], [0, 0, 1], [0, -1, 0], [0, 1, 0], [-1, 0, 0], [1, 0, 0]], dtype=np.float32)
+    facet_offs = np.arange(0, 25, 4, dtype=np.uint32)
+    d = np.full(6, 0.5, dtype=np.float32)
+    area = np.ones(6, dtype=np.float32)
+    return verts, facet_offs, facets.flatten(), norms, d, area, 1.0
+
+def rotation_matrices(q):
+    w, x, y, z = q.T
+    return np.array([[1 - 2*(y*y + z*z), 2*(x*y - w*z), 2*(x*z + w*y)],
+                     [2*(x*y + w*z), 1 - 2*(x*x + z*z), 2*(y*z - w*x)],
+                     [2*(x*z - w*y), 2*(y*z + w*x), 1 - 2*(x*x + y*y)]]).transpose(2, 0, 1)
+
+def cube_form_factor(K):
+    # FT of the unit cube: product of sinc(K_i/2) = sin(K_i/2)/(K_i/2)
+    return np.prod(np.sinc(K/(2*np.pi)), axis=-1)
+
+class TestFTpolyhedron(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+
+    def test_direct_sum(self):
+        Np = 50
+        K = np.random.uniform(-8, 8, (60, 3)).astype(np.float32)
+        K[0] = 0
+        position = np.random.uniform(-10, 10, (Np, 3)).astype(np.float32)
+        orientation = np.random.normal(size=(Np, 4))
+        orientation /= np.linalg.norm(orientation, axis=1)[:, np.newaxis]
+        orientation = orientation.astype(np.float32)
+
+        ft = kspace._FTpolyhedron()
+        ft.set_params(*cube_params())
+        result = ft.compute_view(K, position, orientation)
+
+        # the FT of a rotated cube at K is the FT of the unrotated cube at R^T K
+        R = rotation_matrices(orientation.astype(np.float64))
+        K_body = np.einsum('pji,kj->kpi', R, K.astype(np.float64))
+        phase = K.astype(np.float64).dot(position.T.astype(np.float64))
+        expected = np.sum(cube_form_factor(K_body)*np.exp(-1j*phase), axis=1)
+        # |K.r| reaches ~400; each particle may contribute an error of at most 2e-5
+        npt.assert_allclose(result, expected, rtol=0, atol=2e-5*Np)
+        npt.assert_allclose(result[0], Np, rtol=1e-6)
+
+        # compute() on the stored arrays gives the same values
+        ft.set_K(K)
+        ft.set_rq(position, orientation)
+        ft.compute()
+        npt.assert_allclose(ft.getFT(), result, rtol=1e-6, atol=1e-6)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,58 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, kspace
+import unittest
+
+class TestStructureFactorGrid(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+
+    def direct(self, fbox, points, k_max, dk, n_max):
+        # average |sum_j exp(-i k.r_j)|^2/N over the wave vectors of the box in each shell
+        L = fbox.getLx()
+        h = np.arange(-n_max, n_max + 1)
+        hkl = np.array(np.meshgrid(h, h, h)).reshape(3, -1).T
+        hkl = hkl[np.any(hkl != 0, axis=1)]
+        k = 2*np.pi/L*hkl
+        kmag = np.linalg.norm(k, axis=1)
+        k = k[kmag < k_max]
+        kmag = kmag[kmag < k_max]
+        rho = np.exp(-1j*k.dot(points.T)).sum(axis=1)
+        s = np.abs(rho)**2/len(points)
+        bins = (kmag/dk).astype(int)
+        nbins = int(k_max/dk)
+        counts = np.bincount(bins, minlength=nbins)
+        sums = np.bincount(bins, weights=s, minlength=nbins)
+        return np.where(counts > 0, sums/np.maximum(counts, 1), 0), counts
+
+    def test_matches_direct_sum(self):
+        box_size = 10.0
+        k_max = 4.0
+        dk = 0.5
+        fbox = box.Box.cube(box_size)
+        points = np.random.uniform(-box_size/2, box_size/2, (1000, 3)).astype(np.float32)
+        expected, expected_counts = self.direct(fbox, points, k_max, dk, 7)
+
+        for order in (2, 3):
+            sfg = kspace.StructureFactorGrid(64, k_max, dk, order=order)
+            sfg.compute(fbox, points)
+            npt.assert_equal(sfg.getCounts(), expected_counts)
+            npt.assert_allclose(sfg.getS(), expected, rtol=5e-3, atol=1e-6)
+
+    def test_non_power_of_two(self):
+        box_size = 10.0
+        fbox = box.Box.cube(box_size)
+        points = np.random.uniform(-box_size/2, box_size/2, (500, 3)).astype(np.float32)
+        sfg = kspace.StructureFactorGrid(48, 3.0, 0.5, order=3)
+        sfg.compute(fbox, points)
+        sfg_xyz = kspace.StructureFactorGrid(48, 50, 45, 3.0, 0.5, order=3)
+        sfg_xyz.compute(fbox, points)
+        npt.assert_equal(sfg.getCounts(), sfg_xyz.getCounts())
+        npt.assert_allclose(sfg.getS(), sfg_xyz.getS(), rtol=1e-2)
+
+    def test_bad_order(self):
+        with self.assertRaises(ValueError):
+            kspace.StructureFactorGrid(32, 3.0, 0.5, order=4)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -48,3 +48,27 @@ class TestLD:
         neighbors = self.ld.getNumNeighbors();
         for i in range(0,len(neighbors)):
             assert_less(math.fabs(neighbors[i]-1130.973355292), 200);
+
+    def test_multiple_r_cut(self):
+        """Test that a list of r_cut gives the same densities as one LocalDensity per r_cut"""
+        r_cuts = [1.0, 1.5, 2.0, 3.0]
+        ld = density.LocalDensity(r_cuts, 1, 1);
+        ld.compute(self.box, self.pos);
+        densities = ld.getDensity();
+        assert_equal(densities.shape, (len(self.pos), len(r_cuts)));
+
+        for c, r_cut in enumerate(r_cuts):
+            single = density.LocalDensity(r_cut, 1, 1);
+            single.compute(self.box, self.pos);
+            assert_less(numpy.max(numpy.abs(densities[:, c] - single.getDensity())), 1e-4);
+
+    def test_weights(self):
+        """Test that all weights count the same neighbors on average"""
+        for weight in ['linear', 'cubic', 'gaussian']:
+            ld = density.LocalDensity(3, 1, 1, weight=weight);
+            ld.compute(self.box, self.pos);
+            assert_less(math.fabs(numpy.mean(ld.getNumNeighbors())-1130.973355292), 20);
+
+    @raises(ValueError)
+    def test_unsorted_r_cut(self):
+        density.LocalDensity([2.0, 1.0], 1, 1);
@@ -0,0 +1,59 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, locality
+import unittest
+
+def box_points(fbox, N):
+    lattice = np.array([fbox.getLatticeVector(i) for i in range(3)], dtype=np.float32)
+    fractions = np.random.uniform(0, 1, (N, 3)).astype(np.float32)
+    return (fractions.dot(lattice) - 0.5*lattice.sum(axis=0)).astype(np.float32)
+
+class TestDistanceKernel(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+
+    def check_against_wrap(self, fbox, rmax, dr):
+        kernel = locality.DistanceKernel(fbox, rmax, dr)
+        width = locality.DistanceKernel.getVectorWidth()
+        # full blocks, partial tail blocks and blocks shorter than one vector
+        for N in sorted(set([1, 3, width - 1, width, width + 1, 2*width + 3, 100])):
+            if N < 1:
+                continue
+            points = box_points(fbox, N)
+            ref = box_points(fbox, 1)[0]
+            kernel.compute(ref, points)
+
+            delta = points - ref
+            fbox.wrap(delta)
+            r = np.sqrt(np.sum(delta.astype(np.float64)**2, axis=-1))
+            # points within rounding of the cutoff may go either way
+            ambiguous = np.abs(r - rmax) < 1e-4
+            expected = np.nonzero((r < rmax) & ~ambiguous)[0]
+
+            idx = kernel.getIndices()
+            kept = ~ambiguous[idx]
+            npt.assert_equal(idx[kept], expected)
+            npt.assert_allclose(kernel.getDistances()[kept], r[expected], rtol=1e-5, atol=1e-6)
+            npt.assert_allclose(kernel.getBondVectors()[kept], delta[expected], rtol=1e-5, atol=1e-5)
+            npt.assert_equal(kernel.getBins(),
+                             np.floor(kernel.getDistances()*(np.float32(1)/np.float32(dr))).astype(np.uint32))
+
+    def test_cube(self):
+        self.check_against_wrap(box.Box.cube(10), 4.0, 0.1)
+
+    def test_triclinic(self):
+        fbox = box.Box(Lx=9, Ly=10, Lz=8, xy=0.5, xz=-0.3, yz=0.2, is2D=False)
+        self.check_against_wrap(fbox, 3.5, 0.25)
+
+    def test_no_wrap(self):
+        fbox = box.Box.cube(10)
+        kernel = locality.DistanceKernel(fbox, 4.0)
+        points = box_points(fbox, 37)
+        ref = np.zeros(3, dtype=np.float32)
+        kernel.compute(ref, points, wrap=False)
+        r = np.sqrt(np.sum(points.astype(np.float64)**2, axis=-1))
+        npt.assert_equal(kernel.getIndices(), np.nonzero(r < 4.0)[0])
+        npt.assert_allclose(kernel.getBondVectors(), points[r < 4.0], rtol=1e-6)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,62 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, density, locality
+import unittest
+
+def bond_set(nlist):
+    return set(zip(nlist.getIndexI(), nlist.getIndexJ()))
+
+class TestGhostCellList(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+
+    def test_matches_linkcell(self):
+        rcut = 1.5
+        fbox = box.Box(Lx=9, Ly=10, Lz=8, xy=0.5, xz=-0.3, yz=0.2, is2D=False)
+        lattice = np.array([fbox.getLatticeVector(i) for i in range(3)], dtype=np.float32)
+        fractions = np.random.uniform(0, 1, (500, 3)).astype(np.float32)
+        points = (fractions.dot(lattice) - 0.5*lattice.sum(axis=0)).astype(np.float32)
+
+        gcl = locality.GhostCellList(fbox, rcut).compute(fbox, points)
+        self.assertGreater(gcl.getNumGhosts(), 0)
+        nlist = gcl.getNList()
+        lc_nlist = locality.LinkCell(fbox, rcut).compute(fbox, points).getNList()
+
+        self.assertEqual(bond_set(nlist), bond_set(lc_nlist))
+        npt.assert_equal(nlist.getNeighborCounts(), lc_nlist.getNeighborCounts())
+        self.assertTrue(np.all(nlist.getDistances() < rcut))
+
+    def test_small_box(self):
+        # only two cells fit along each dimension, each pair must still be found once
+        L = 5
+        rcut = 2.4
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (200, 3)).astype(np.float32)
+        nlist = locality.GhostCellList(fbox, rcut).compute(fbox, points).getNList()
+
+        delta = points[np.newaxis, :, :] - points[:, np.newaxis, :]
+        delta -= L*np.round(delta/L)
+        rsq = np.sum(delta**2, axis=-1)
+        np.fill_diagonal(rsq, np.inf)
+        self.assertEqual(bond_set(nlist), set(zip(*np.nonzero(rsq < rcut**2))))
+
+    def test_rdf(self):
+        L = 10
+        rmax = 3.0
+        dr = 0.1
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (400, 3)).astype(np.float32)
+        nlist = locality.GhostCellList(fbox, rmax).compute(fbox, points, exclude_ii=False).getNList()
+
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(fbox, points, points)
+        rdf_nlist = density.RDF(rmax, dr)
+        rdf_nlist.compute(fbox, points, points, nlist=nlist)
+        npt.assert_allclose(rdf_nlist.getRDF(), rdf.getRDF(), rtol=1e-5)
+
+    def test_too_wide(self):
+        with self.assertRaises(RuntimeError):
+            locality.GhostCellList(box.Box.cube(4), 2.5)
+
+if __name__ == '__main__':
+    unittest.main()
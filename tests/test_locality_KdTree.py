@@ -0,0 +1,53 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, locality
+import unittest
+
+def bond_set(nlist):
+    return set(zip(nlist.getIndexI(), nlist.getIndexJ()))
+
+class TestKdTree(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+
+    def test_matches_linkcell(self):
+        rcut = 1.5
+        fbox = box.Box(Lx=9, Ly=10, Lz=8, xy=0.5, xz=-0.3, yz=0.2, is2D=False)
+        lattice = np.array([fbox.getLatticeVector(i) for i in range(3)], dtype=np.float32)
+        fractions = np.random.uniform(0, 1, (500, 3)).astype(np.float32)
+        # a dense cluster in a dilute background
+        fractions[:400] = 0.5 + 0.05*(fractions[:400] - 0.5)
+        points = (fractions.dot(lattice) - 0.5*lattice.sum(axis=0)).astype(np.float32)
+
+        nlist = locality.KdTree(fbox, rcut).compute(fbox, points).getNList()
+        lc_nlist = locality.LinkCell(fbox, rcut).compute(fbox, points).getNList()
+
+        self.assertEqual(bond_set(nlist), bond_set(lc_nlist))
+        npt.assert_equal(nlist.getNeighborCounts(), lc_nlist.getNeighborCounts())
+        self.assertTrue(np.all(nlist.getDistances() < rcut))
+
+    def test_nearest(self):
+        L = 10
+        num_neighbors = 8
+        fbox = box.Box.cube(L)
+        points = np.random.uniform(-L/2, L/2, (300, 3)).astype(np.float32)
+        points[:200] *= 0.1
+        nlist = locality.KdTree(fbox, 1.0).computeNearest(fbox, points, num_neighbors).getNList()
+
+        delta = points[np.newaxis, :, :] - points[:, np.newaxis, :]
+        delta -= L*np.round(delta/L)
+        r = np.sqrt(np.sum(delta**2, axis=-1))
+        np.fill_diagonal(r, np.inf)
+        npt.assert_equal(nlist.getNeighborCounts(), num_neighbors)
+        npt.assert_equal(nlist.getIndexI(), np.repeat(np.arange(len(points)), num_neighbors))
+        npt.assert_allclose(nlist.getDistances().reshape((-1, num_neighbors)),
+                            np.sort(r, axis=1)[:, :num_neighbors], rtol=1e-5)
+
+    def test_too_wide(self):
+        fbox = box.Box.cube(4)
+        points = np.random.uniform(-2, 2, (10, 3)).astype(np.float32)
+        with self.assertRaises(RuntimeError):
+            locality.KdTree(fbox, 2.5).compute(fbox, points)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -68,5 +68,92 @@ class TestLinkCell(unittest.TestCase):
             # if i is a neighbor of j, then j should be a neighbor of i
             self.assertEqual(neighbors_ij, neighbors_ji)
 
+    def test_cell_contents(self):
+        L = 10 #Box Dimensions
+        rcut = 2 #Cutoff radius
+        N = 500 # number of particles
+
+        points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        fbox = box.Box.cube(L)
+        cl = locality.LinkCell(fbox, rcut)
+        cl.computeCellList(fbox, points)
+
+        # every point is found exactly once, in its own cell, and each cell lists its points in ascending order
+        found = []
+        for cell in range(cl.getNumCells()):
+            members = list(cl.itercell(cell))
+            self.assertEqual(members, sorted(members))
+            for j in members:
+                self.assertEqual(cl.getCell(points[j]), cell)
+            found.extend(members)
+        npt.assert_equal(np.sort(found), np.arange(N))
+
+    def test_changing_box(self):
+        rcut = 2 #Cutoff radius
+        N = 200 # number of particles
+
+        # reuse one cell list while the box (and the number of cells) changes, as in an NPT trajectory
+        cl = locality.LinkCell(box.Box.cube(10), rcut)
+        for L in [10, 13, 9, 16, 10]:
+            fbox = box.Box.cube(L)
+            points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+            cl.computeCellList(fbox, points)
+
+            ncells = int(L/rcut)**3
+            self.assertEqual(cl.getNumCells(), ncells)
+            for cell in range(ncells):
+                self.assertEqual(len(np.unique(cl.getCellNeighbors(cell))), 27)
+            found = np.concatenate([list(cl.itercell(cell)) for cell in range(ncells)])
+            npt.assert_equal(np.sort(found), np.arange(N))
+
+    def test_triclinic(self):
+        # bonds found in a sheared box must match a brute force minimum image search
+        np.random.seed(0)
+        rcut = 1.5
+        N = 400
+        fbox = box.Box(Lx=9, Ly=10, Lz=8, xy=0.5, xz=-0.3, yz=0.2, is2D=False)
+        lattice = np.array([fbox.getLatticeVector(i) for i in range(3)], dtype=np.float32)
+        fractions = np.random.uniform(0, 1, (N, 3)).astype(np.float32)
+        points = fractions.dot(lattice) - 0.5*lattice.sum(axis=0)
+        points = points.astype(np.float32)
+
+        cl = locality.LinkCell(fbox, rcut).compute(fbox, points)
+        nlist = cl.getNList()
+        bonds = set(zip(nlist.getIndexI(), nlist.getIndexJ()))
+
+        # minimum image through the fractional coordinates; the box is wide enough for a single image
+        frac = np.linalg.solve(lattice.T, (points[np.newaxis, :, :] - points[:, np.newaxis, :]).reshape(-1, 3).T).T
+        frac -= np.round(frac)
+        rsq = np.sum(frac.dot(lattice)**2, axis=-1).reshape(N, N)
+        np.fill_diagonal(rsq, np.inf)
+        expected = set(zip(*np.nonzero(rsq < rcut**2)))
+        self.assertEqual(bonds, expected)
+
+    def test_distinct_arrays_keep_ii(self):
+        # bonds (i, i) between two different arrays are real and must be kept
+        np.random.seed(0)
+        L = 10
+        rcut = 2
+        N = 100
+        fbox = box.Box.cube(L)
+        ref_points = np.random.uniform(-L/2, L/2, (N, 3)).astype(np.float32)
+        points = ref_points + np.float32(0.1)
+        for nlist in [locality.LinkCell(fbox, rcut).compute(fbox, ref_points, points).getNList(),
+                      locality.GhostCellList(fbox, rcut).compute(fbox, ref_points, points).getNList(),
+                      locality.KdTree(fbox, rcut).compute(fbox, ref_points, points).getNList()]:
+            bonds = set(zip(nlist.getIndexI(), nlist.getIndexJ()))
+            self.assertTrue(all((i, i) in bonds for i in range(N)))
+
+            delta = points[np.newaxis, :, :] - ref_points[:, np.newaxis, :]
+            delta -= L*np.round(delta/L)
+            rsq = np.sum(delta**2, axis=-1)
+            self.assertEqual(bonds, set(zip(*np.nonzero(rsq < rcut**2))))
+
+        num_neighbors = 4
+        nlist = locality.KdTree(fbox, rcut).computeNearest(fbox, ref_points, num_neighbors, points).getNList()
+        index_j = nlist.getIndexJ().reshape((N, num_neighbors))
+        for i in range(N):
+            self.assertIn(i, index_j[i])
+
 if __name__ == '__main__':
     unittest.main()
@@ -100,5 +100,75 @@ class TestNearestNeighbors(unittest.TestCase):
         npt.assert_equal(rsq_list[0,0], 1.0)
         npt.assert_equal(rsq_list[0,1], -1.0)
 
+    def test_uneven_density(self):
+        # a dense cluster in a dilute background; the sparse particles must search far beyond rmax
+        L = 10
+        rcut = 0.5
+        num_neighbors = 8
+        np.random.seed(0)
+        fbox = box.Box.cube(L)
+        cl = locality.NearestNeighbors(rcut, num_neighbors)
+
+        points = np.random.uniform(-L/2, L/2, (300, 3)).astype(np.float32)
+        points[:250] *= 0.1
+        cl.compute(fbox, points, points)
+
+        delta = points[np.newaxis, :, :] - points[:, np.newaxis, :]
+        delta -= L*np.round(delta/L)
+        rsq = np.sum(delta**2, axis=-1)
+        np.fill_diagonal(rsq, np.inf)
+        npt.assert_allclose(cl.getRsqList(), np.sort(rsq, axis=1)[:, :num_neighbors], rtol=1e-5)
+        self.assertEqual(cl.getRMax(), rcut)
+
+    def test_clustered(self):
+        # small tight clusters far apart: most points have fewer than num_neighbors neighbors within rmax and are
+        # queued for the shell search
+        L = 20
+        rcut = 1.0
+        num_neighbors = 8
+        np.random.seed(1)
+        fbox = box.Box.cube(L)
+        centers = np.random.uniform(-L/2, L/2, (40, 3))
+        sizes = np.random.randint(2, 12, len(centers))
+        points = np.concatenate([c + np.random.normal(0, 0.1, (n, 3)) for c, n in zip(centers, sizes)])
+        points = points.astype(np.float32)
+        fbox.wrap(points)
+        N = len(points)
+
+        delta = points[np.newaxis, :, :] - points[:, np.newaxis, :]
+        delta -= L*np.round(delta/L)
+        rsq = np.sum(delta.astype(np.float64)**2, axis=-1)
+        np.fill_diagonal(rsq, np.inf)
+        sorted_rsq = np.sort(rsq, axis=1)[:, :num_neighbors]
+        num_within = np.sum(rsq < rcut**2, axis=1)
+
+        cl = locality.NearestNeighbors(rcut, num_neighbors)
+        cl.compute(fbox, points, points)
+        num_deficient = np.sum(num_within < num_neighbors)
+        self.assertGreater(num_deficient, N//2)
+        self.assertEqual(cl.getNumDeficient(), num_deficient)
+        npt.assert_allclose(cl.getRsqList(), sorted_rsq, rtol=1e-4, atol=1e-5)
+        neighbors = cl.getNeighborList()
+        npt.assert_allclose(rsq[np.arange(N)[:, np.newaxis], neighbors], sorted_rsq, rtol=1e-4, atol=1e-5)
+        nlist = cl.getNList()
+        npt.assert_equal(nlist.getNeighborCounts(), num_neighbors)
+        npt.assert_equal(nlist.getIndexJ(), neighbors.flatten())
+
+        # with a strict cut nothing is queued, and the points short of neighbors keep only those within rmax
+        cl = locality.NearestNeighbors(rcut, num_neighbors, strict_cut=True)
+        cl.compute(fbox, points, points)
+        self.assertEqual(cl.getNumDeficient(), 0)
+        expected = np.where(sorted_rsq < rcut**2, sorted_rsq, -1)
+        npt.assert_allclose(cl.getRsqList(), expected, rtol=1e-4, atol=1e-5)
+        neighbors = cl.getNeighborList()
+        npt.assert_equal(neighbors == cl.getUINTMAX(), expected < 0)
+        nlist = cl.getNList()
+        npt.assert_equal(nlist.getNeighborCounts(), np.minimum(num_within, num_neighbors))
+        npt.assert_equal(nlist.getIndexJ(), neighbors[neighbors != cl.getUINTMAX()])
+
+    def test_scale_deprecated(self):
+        with self.assertWarns(DeprecationWarning):
+            locality.NearestNeighbors(1.0, 4, 1.1)
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,100 @@
+import numpy as np
+import numpy.testing as npt
+from freud import box, cluster, density, locality
+import unittest
+
+class TestNeighborList(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(0)
+        self.L = 10
+        self.rcut = 2.0
+        self.fbox = box.Box.cube(self.L)
+        self.points = np.random.uniform(-self.L/2, self.L/2, (400, 3)).astype(np.float32)
+
+    def test_segments(self):
+        lc = locality.LinkCell(self.fbox, self.rcut).compute(self.fbox, self.points)
+        nlist = lc.getNList()
+
+        self.assertEqual(nlist.getNumI(), len(self.points))
+        self.assertEqual(nlist.getNumJ(), len(self.points))
+        index_i = nlist.getIndexI()
+        index_j = nlist.getIndexJ()
+        segments = nlist.getSegments()
+        counts = nlist.getNeighborCounts()
+
+        # bonds are sorted by i and the segments agree with the counts
+        self.assertTrue(np.all(np.diff(index_i.astype(np.int64)) >= 0))
+        npt.assert_equal(np.diff(segments), counts)
+        self.assertEqual(segments[-1], nlist.getNumBonds())
+        self.assertFalse(np.any(index_i == index_j))
+        self.assertTrue(np.all(nlist.getDistances() < self.rcut))
+        npt.assert_equal(nlist.getWeights(), 1)
+
+        # compare with a brute force search
+        delta = self.points[np.newaxis, :, :] - self.points[:, np.newaxis, :]
+        delta -= self.L*np.round(delta/self.L)
+        rsq = np.sum(delta**2, axis=-1)
+        np.fill_diagonal(rsq, np.inf)
+        npt.assert_equal(counts, np.sum(rsq < self.rcut**2, axis=1))
+
+    def test_filter_r(self):
+        nlist = locality.LinkCell(self.fbox, self.rcut).compute(self.fbox, self.points).getNList()
+        distances = nlist.getDistances().copy()
+        nlist.filterR(0.5, 1.5)
+        self.assertEqual(nlist.getNumBonds(), np.sum((distances >= 0.5) & (distances < 1.5)))
+        self.assertTrue(np.all(nlist.getDistances() >= 0.5))
+        self.assertTrue(np.all(nlist.getDistances() < 1.5))
+        npt.assert_equal(np.diff(nlist.getSegments()), nlist.getNeighborCounts())
+
+    def test_from_arrays(self):
+        index_i = np.array([2, 0, 0, 1], dtype=np.uint64)
+        index_j = np.array([1, 1, 2, 0], dtype=np.uint64)
+        distances = np.array([1, 2, 3, 4], dtype=np.float32)
+        nlist = locality.NeighborList.from_arrays(3, 3, index_i, index_j, distances)
+
+        npt.assert_equal(nlist.getIndexI(), [0, 0, 1, 2])
+        npt.assert_equal(nlist.getIndexJ(), [1, 2, 0, 1])
+        npt.assert_equal(nlist.getDistances(), [2, 3, 4, 1])
+        npt.assert_equal(nlist.getSegments(), [0, 2, 3, 4])
+        npt.assert_equal(nlist.getNeighborCounts(), [2, 1, 1])
+
+    def test_rdf(self):
+        rmax = 2.0
+        dr = 0.1
+        lc = locality.LinkCell(self.fbox, rmax).compute(self.fbox, self.points, exclude_ii=False)
+
+        rdf = density.RDF(rmax, dr)
+        rdf.compute(self.fbox, self.points, self.points)
+        rdf_nlist = density.RDF(rmax, dr)
+        rdf_nlist.compute(self.fbox, self.points, self.points, nlist=lc.getNList())
+
+        npt.assert_allclose(rdf_nlist.getRDF(), rdf.getRDF(), rtol=1e-5)
+
+    def test_shared_nlist(self):
+        # a single list can be reused by analyses with smaller cutoffs
+        nlist = locality.LinkCell(self.fbox, self.rcut).compute(self.fbox, self.points).getNList()
+
+        clust = cluster.Cluster(self.fbox, 1.0)
+        clust.computeClusters(self.points)
+        clust_nlist = cluster.Cluster(self.fbox, 1.0)
+        clust_nlist.computeClusters(self.points, nlist=nlist)
+        self.assertEqual(clust_nlist.getNumClusters(), clust.getNumClusters())
+
+        ld = density.LocalDensity(1.0, 1.0, 0.0)
+        ld.compute(self.fbox, self.points)
+        ld_nlist = density.LocalDensity(1.0, 1.0, 0.0)
+        ld_nlist.compute(self.fbox, self.points, nlist=nlist)
+        # the cell list search includes each point itself
+        npt.assert_allclose(ld_nlist.getNumNeighbors() + 1, ld.getNumNeighbors())
+
+    def test_wrong_size(self):
+        nlist = locality.LinkCell(self.fbox, self.rcut).compute(self.fbox, self.points).getNList()
+        rdf = density.RDF(self.rcut, 0.1)
+        with self.assertRaises(ValueError):
+            rdf.compute(self.fbox, self.points[:10], self.points, nlist=nlist)
+
+        with self.assertRaises(TypeError):
+            rdf.compute(self.fbox, self.points, self.points, nlist=np.zeros(3))
+
+if __name__ == '__main__':
+    unittest.main()
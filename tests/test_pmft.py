@@ -1,6 +1,6 @@
 import numpy
 import numpy.testing as npt
-from freud import box, pmft
+from freud import box, parallel, pmft
 import unittest
 
 class TestBins(unittest.TestCase):
@@ -169,6 +169,23 @@ class TestPMFXY2DAccumulate(unittest.TestCase):
         pcfArray = myPMFT.getBinCounts()
         npt.assert_allclose(pcfArray, correct, atol=absoluteTolerance)
 
+    def test_repeatedAccumulate(self):
+        boxSize = 16.0
+        points = numpy.array([[-1.0, 0.0, 0.0], [1.0, 0.0, 0.0]], dtype=numpy.float32)
+        angles = numpy.array([0.0, 0.0], dtype=numpy.float32)
+        myPMFT = pmft.PMFTXY2D(3.0, 3.0, 60, 60)
+        fbox = box.Box.square(boxSize)
+        for i in range(10):
+            myPMFT.accumulate(fbox, points, angles, points, angles)
+        # reading the counts in between frames must not change the totals
+        counts = numpy.copy(myPMFT.getBinCounts())
+        for i in range(10):
+            myPMFT.accumulate(fbox, points, angles, points, angles)
+        pcfArray = myPMFT.getBinCounts()
+        self.assertEqual(pcfArray.dtype, numpy.uint64)
+        npt.assert_equal(pcfArray, 2*counts)
+        self.assertEqual(numpy.sum(pcfArray), 40)
+
 class TestPMFXY2DCompute(unittest.TestCase):
     def test_twoParticlesWithCellList(self):
         boxSize = 16.0
@@ -238,6 +255,272 @@ class TestPMFXY2DCompute(unittest.TestCase):
         pcfArray = myPMFT.getBinCounts()
         npt.assert_allclose(pcfArray, correct, atol=absoluteTolerance)
 
+class TestPMFTXYZSymmetry(unittest.TestCase):
+    def cubeRotations(self):
+        # the 24 elements of the octahedral group, with the first nonzero component of each quaternion positive
+        quats = []
+        h = 0.5
+        r = numpy.sqrt(0.5)
+        for i in range(4):
+            q = numpy.zeros(4)
+            q[i] = 1.0
+            quats.append(q)
+        for signs in range(8):
+            quats.append(numpy.array([h, h*(-1)**(signs & 1), h*(-1)**(signs >> 1 & 1), h*(-1)**(signs >> 2 & 1)]))
+        for i in range(4):
+            for j in range(i + 1, 4):
+                for sign in [1, -1]:
+                    q = numpy.zeros(4)
+                    q[i] = r
+                    q[j] = sign*r
+                    quats.append(q)
+        return numpy.array(quats, dtype=numpy.float32)
+
+    def randomSystem(self, N, L):
+        numpy.random.seed(0)
+        points = numpy.random.uniform(-L/2, L/2, size=(N, 3)).astype(numpy.float32)
+        orientations = numpy.random.normal(size=(N, 4)).astype(numpy.float32)
+        orientations /= numpy.linalg.norm(orientations, axis=1)[:, numpy.newaxis]
+        return points, orientations
+
+    def test_sharedFacesMatchPerParticleFaces(self):
+        L = 10.0
+        fbox = box.Box.cube(L)
+        points, orientations = self.randomSystem(200, L)
+        faces = self.cubeRotations()
+        self.assertEqual(len(faces), 24)
+
+        # the cube rotations map the bins onto themselves, so the bond vectors are only binned once
+        folded = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+        folded.compute(fbox, points, orientations, points, orientations, faces)
+        rotated = pmft.PMFTXYZ(2.0, 2.0, 2.0, 20, 20, 20)
+        rotated.compute(fbox, points, orientations, points, orientations,
+                        numpy.tile(faces, (len(points), 1, 1)))
+
+        folded_counts = numpy.copy(folded.getBinCounts()).astype(numpy.int64)
+        rotated_counts = numpy.copy(rotated.getBinCounts()).astype(numpy.int64)
+        self.assertGreater(numpy.sum(rotated_counts), 0)
+        # bond vectors on the edge of a bin may be rounded differently
+        self.assertLess(numpy.sum(numpy.abs(folded_counts - rotated_counts)), 1e-3*numpy.sum(rotated_counts))
+        npt.assert_allclose(folded.getPCF(), rotated.getPCF(), atol=0.1*numpy.max(rotated.getPCF()))
+
+    def test_sharedFacesWithoutFolding(self):
+        L = 10.0
+        fbox = box.Box.cube(L)
+        points, orientations = self.randomSystem(200, L)
+        # different bins in z, so the rotations are done for every face
+        faces = self.cubeRotations()[:6]
+        shared = pmft.PMFTXYZ(2.0, 2.0, 1.5, 20, 20, 15)
+        shared.compute(fbox, points, orientations, points, orientations, faces)
+        tiled = pmft.PMFTXYZ(2.0, 2.0, 1.5, 20, 20, 15)
+        tiled.compute(fbox, points, orientations, points, orientations,
+                      numpy.tile(faces, (len(points), 1, 1)))
+        npt.assert_equal(shared.getBinCounts(), tiled.getBinCounts())
+
+class TestPMFTSparse(unittest.TestCase):
+    def setUp(self):
+        numpy.random.seed(0)
+        self.L = 10.0
+        self.points = numpy.random.uniform(-self.L/2, self.L/2, size=(300, 3)).astype(numpy.float32)
+        self.angles = numpy.random.uniform(0, 2*numpy.pi, size=300).astype(numpy.float32)
+        self.quats = numpy.random.normal(size=(300, 4)).astype(numpy.float32)
+        self.quats /= numpy.linalg.norm(self.quats, axis=1)[:, numpy.newaxis]
+
+    def checkSame(self, dense, sparse):
+        self.assertGreater(numpy.sum(dense.getBinCounts()), 0)
+        npt.assert_equal(sparse.getBinCounts(), dense.getBinCounts())
+        npt.assert_equal(sparse.getPCF(), dense.getPCF())
+
+    def test_PMFTXYZ(self):
+        fbox = box.Box.cube(self.L)
+        dense = pmft.PMFTXYZ(2.0, 2.0, 2.0, 37, 21, 18)
+        sparse = pmft.PMFTXYZ(2.0, 2.0, 2.0, 37, 21, 18, sparse=True)
+        for myPMFT in [dense, sparse]:
+            for i in range(2):
+                myPMFT.accumulate(fbox, self.points, self.quats, self.points, self.quats)
+        self.checkSame(dense, sparse)
+
+    def test_PMFTXYT(self):
+        fbox = box.Box.square(self.L)
+        points = numpy.copy(self.points)
+        points[:, 2] = 0
+        dense = pmft.PMFTXYT(2.0, 2.0, 37, 21, 18)
+        sparse = pmft.PMFTXYT(2.0, 2.0, 37, 21, 18, sparse=True)
+        for myPMFT in [dense, sparse]:
+            myPMFT.compute(fbox, points, self.angles, points, self.angles)
+        self.checkSame(dense, sparse)
+
+    def test_PMFTR12(self):
+        fbox = box.Box.square(self.L)
+        points = numpy.copy(self.points)
+        points[:, 2] = 0
+        dense = pmft.PMFTR12(2.0, 37, 21, 18)
+        sparse = pmft.PMFTR12(2.0, 37, 21, 18, sparse=True)
+        for myPMFT in [dense, sparse]:
+            myPMFT.compute(fbox, points, self.angles, points, self.angles)
+        self.checkSame(dense, sparse)
+
+class TestPMFTTrajectory(unittest.TestCase):
+    def setUp(self):
+        numpy.random.seed(0)
+        self.L = 10.0
+        self.points = numpy.random.uniform(-self.L/2, self.L/2, size=(4, 200, 3)).astype(numpy.float32)
+        self.angles = numpy.random.uniform(0, 2*numpy.pi, size=(4, 200)).astype(numpy.float32)
+        self.quats = numpy.random.normal(size=(4, 200, 4)).astype(numpy.float32)
+        self.quats /= numpy.linalg.norm(self.quats, axis=2)[:, :, numpy.newaxis]
+
+    def checkSame(self, frames, trajectory):
+        self.assertGreater(numpy.sum(frames.getBinCounts()), 0)
+        npt.assert_equal(trajectory.getBinCounts(), frames.getBinCounts())
+
+    def test_2D(self):
+        boxes = [box.Box.square(self.L*(1 + 0.05*f)) for f in range(len(self.points))]
+        points = numpy.copy(self.points)
+        points[:, :, 2] = 0
+        for frames, trajectory in [(pmft.PMFTXY2D(2.0, 2.0, 37, 21), pmft.PMFTXY2D(2.0, 2.0, 37, 21)),
+                                   (pmft.PMFTXYT(2.0, 2.0, 37, 21, 18), pmft.PMFTXYT(2.0, 2.0, 37, 21, 18)),
+                                   (pmft.PMFTR12(2.0, 37, 21, 18), pmft.PMFTR12(2.0, 37, 21, 18))]:
+            for f in range(len(points)):
+                frames.accumulate(boxes[f], points[f], self.angles[f], points[f], self.angles[f])
+            trajectory.accumulateTrajectory(boxes, points, self.angles, points, self.angles)
+            self.checkSame(frames, trajectory)
+
+    def test_PMFTXYZ(self):
+        fbox = box.Box.cube(self.L)
+        faces = numpy.array([[1, 0, 0, 0], [0, 1, 0, 0]], dtype=numpy.float32)
+        per_particle = numpy.tile(faces, (self.points.shape[1], 1, 1))
+        for face_orientations in [None, faces, per_particle]:
+            frames = pmft.PMFTXYZ(2.0, 2.0, 2.0, 37, 21, 18)
+            trajectory = pmft.PMFTXYZ(2.0, 2.0, 2.0, 37, 21, 18)
+            for f in range(len(self.points)):
+                frames.accumulate(fbox, self.points[f], self.quats[f], self.points[f], self.quats[f],
+                                  face_orientations)
+            trajectory.accumulateTrajectory(fbox, self.points, self.quats, self.points, self.quats,
+                                            face_orientations)
+            self.checkSame(frames, trajectory)
+
+class TestPMFTWeighted(unittest.TestCase):
+    def setUp(self):
+        numpy.random.seed(0)
+        self.L = 10.0
+        self.points = numpy.random.uniform(-self.L/2, self.L/2, size=(200, 3)).astype(numpy.float32)
+        self.points[:, 2] = 0
+        self.angles = numpy.random.uniform(0, 2*numpy.pi, size=200).astype(numpy.float32)
+        self.values = numpy.random.normal(size=200).astype(numpy.float32)
+
+    def test_PMFTXY2D(self):
+        fbox = box.Box.square(self.L)
+        myPMFT = pmft.PMFTXY2D(3.0, 3.0, 12, 12)
+        myPMFT.compute(fbox, self.points, self.angles, self.points, self.angles, values=self.values)
+
+        # every pair, in the frame of the reference point
+        delta = self.points[numpy.newaxis, :, :2] - self.points[:, numpy.newaxis, :2]
+        delta -= self.L*numpy.round(delta/self.L)
+        c = numpy.cos(self.angles)[:, numpy.newaxis]
+        s = numpy.sin(self.angles)[:, numpy.newaxis]
+        x = c*delta[:, :, 0] + s*delta[:, :, 1]
+        y = -s*delta[:, :, 0] + c*delta[:, :, 1]
+        keep = numpy.sum(delta**2, axis=2) > 1e-6
+        values = numpy.tile(self.values, (len(self.points), 1))
+        sums = numpy.histogram2d(y[keep], x[keep], bins=12, range=[[-3, 3], [-3, 3]], weights=values[keep])[0]
+        square_sums = numpy.histogram2d(y[keep], x[keep], bins=12, range=[[-3, 3], [-3, 3]],
+                                        weights=values[keep]**2)[0]
+
+        counts = myPMFT.getBinCounts()
+        npt.assert_allclose(myPMFT.getValueSums(), sums, atol=1e-3)
+        npt.assert_allclose(myPMFT.getValueSquareSums(), square_sums, atol=1e-3)
+        npt.assert_allclose(myPMFT.getValueMean(), numpy.where(counts > 0, sums/numpy.maximum(counts, 1), 0),
+                            atol=1e-4)
+
+    def test_sameCounts(self):
+        fbox = box.Box.square(self.L)
+        weighted = pmft.PMFTXYT(2.0, 2.0, 17, 15, 9, sparse=True)
+        counted = pmft.PMFTXYT(2.0, 2.0, 17, 15, 9)
+        weighted.accumulate(fbox, self.points, self.angles, self.points, self.angles,
+                            values=numpy.ones(len(self.points), dtype=numpy.float32))
+        counted.accumulate(fbox, self.points, self.angles, self.points, self.angles)
+        npt.assert_equal(weighted.getBinCounts(), counted.getBinCounts())
+        npt.assert_equal(weighted.getValueSums(), counted.getBinCounts())
+        npt.assert_equal(weighted.getValueMean()[counted.getBinCounts() > 0], 1)
+
+    def test_PMFTXYZ(self):
+        fbox = box.Box.cube(self.L)
+        points = numpy.random.uniform(-self.L/2, self.L/2, size=(200, 3)).astype(numpy.float32)
+        quats = numpy.zeros((200, 4), dtype=numpy.float32)
+        quats[:, 0] = 1
+        faces = numpy.array([[1, 0, 0, 0], [0, 0, 0, 1]], dtype=numpy.float32)
+        weighted = pmft.PMFTXYZ(2.0, 2.0, 2.0, 17, 17, 17)
+        counted = pmft.PMFTXYZ(2.0, 2.0, 2.0, 17, 17, 17)
+        weighted.compute(fbox, points, quats, points, quats, faces, values=2*numpy.ones(200, dtype=numpy.float32))
+        counted.compute(fbox, points, quats, points, quats, faces)
+        npt.assert_equal(weighted.getBinCounts(), counted.getBinCounts())
+        npt.assert_equal(weighted.getValueSums(), 2*counted.getBinCounts())
+        npt.assert_equal(weighted.getValueSquareSums(), 4*counted.getBinCounts())
+
+    def test_mixedFrames(self):
+        fbox = box.Box.square(self.L)
+        myPMFT = pmft.PMFTR12(3.0, 10, 9, 8)
+        myPMFT.accumulate(fbox, self.points, self.angles, self.points, self.angles, values=self.values)
+        with self.assertRaises(ValueError):
+            myPMFT.accumulate(fbox, self.points, self.angles, self.points, self.angles)
+        myPMFT.resetPCF()
+        myPMFT.accumulate(fbox, self.points, self.angles, self.points, self.angles)
+
+class TestPMFTStandardError(unittest.TestCase):
+    def test_PMFTXYZ(self):
+        # 6 frames in 4 blocks: the first 4 frames merge into 2 blocks of 2 frames, then frames 5 and 6 make a third
+        numpy.random.seed(0)
+        L = 8.0
+        fbox = box.Box.cube(L)
+        frames = numpy.random.uniform(-L/2, L/2, size=(6, 200, 3)).astype(numpy.float32)
+        quats = numpy.zeros((200, 4), dtype=numpy.float32)
+        quats[:, 0] = 1
+        for sparse in [False, True]:
+            myPMFT = pmft.PMFTXYZ(2.0, 2.0, 2.0, 8, 8, 8, sparse=sparse, n_blocks=4)
+            frame_pcfs = []
+            for points in frames:
+                myPMFT.accumulate(fbox, points, quats, points, quats)
+                framePMFT = pmft.PMFTXYZ(2.0, 2.0, 2.0, 8, 8, 8)
+                framePMFT.accumulate(fbox, points, quats, points, quats)
+                frame_pcfs.append(numpy.copy(framePMFT.getPCF()))
+            block_pcfs = numpy.array(frame_pcfs).reshape((3, 2) + frame_pcfs[0].shape).mean(axis=1)
+            correct = numpy.std(block_pcfs, axis=0, ddof=1)/numpy.sqrt(3)
+            npt.assert_allclose(myPMFT.getPCFStandardError(), correct, rtol=1e-4, atol=1e-4)
+
+            myPMFT.resetPCF()
+            myPMFT.accumulate(fbox, frames[0], quats, frames[0], quats)
+            self.assertTrue(numpy.all(numpy.isnan(myPMFT.getPCFStandardError())))
+
+class TestPMFTHistogramModes(unittest.TestCase):
+    # 100x100 bins make two full tiles of 4096 bins and a partial last one
+    def setUp(self):
+        numpy.random.seed(0)
+        parallel.setNumThreads(4)
+        self.L = 20.0
+        self.points = numpy.random.uniform(-self.L/2, self.L/2, size=(3, 2000, 3)).astype(numpy.float32)
+        self.points[:, :, 2] = 0
+        self.angles = numpy.random.uniform(0, 2*numpy.pi, size=(3, 2000)).astype(numpy.float32)
+
+    def tearDown(self):
+        parallel.setNumThreads()
+
+    def test_modes(self):
+        fbox = box.Box.square(self.L)
+        dense = pmft.PMFTXY2D(3.0, 3.0, 100, 100)
+        dense.setHistogramMode('dense')
+        for f in range(len(self.points)):
+            dense.accumulate(fbox, self.points[f], self.angles[f], self.points[f], self.angles[f])
+        self.assertGreater(numpy.sum(dense.getBinCounts()), 0)
+        for modes in [['sparse']*3, ['atomic']*3, ['sparse', 'atomic', 'dense']]:
+            myPMFT = pmft.PMFTXY2D(3.0, 3.0, 100, 100)
+            for f in range(len(self.points)):
+                myPMFT.setHistogramMode(modes[f])
+                self.assertEqual(myPMFT.getHistogramMode(), modes[f])
+                myPMFT.accumulate(fbox, self.points[f], self.angles[f], self.points[f], self.angles[f])
+            npt.assert_equal(myPMFT.getBinCounts(), dense.getBinCounts())
+            npt.assert_equal(myPMFT.getPCF(), dense.getPCF())
+        self.assertRaises(ValueError, myPMFT.setHistogramMode, 'tiled')
+
 if __name__ == '__main__':
     print("testing pmft")
     unittest.main()